@@ -0,0 +1,61 @@
+#!/usr/bin/env python
+#
+# Generates a synthetic BGP table for the BGPTableInjector: unique prefixes
+# with lengths between /16 and /24 (mostly /24, like a real full table) and
+# AS paths of 1 to 6 hops, shared by about 20 prefixes on average.
+#
+# Usage: ./genroutes.py <number of routes> [seed] > routes.txt
+#
+
+import random
+import sys
+
+# ASes of the example network; they must not appear in the paths
+RESERVED_AS = set([64500, 64512, 64513])
+
+
+def random_path(rnd):
+    path = []
+    hops = rnd.randint(1, 6)
+    while len(path) < hops:
+        asNumber = rnd.randint(1, 64000)
+        if asNumber not in RESERVED_AS and asNumber not in path:
+            path.append(asNumber)
+    return path
+
+
+def random_prefix(rnd):
+    length = rnd.choice([16, 19, 20, 21, 22, 23, 24, 24, 24, 24, 24, 24])
+    # unicast space outside 0/8, 10/8 (used by the example), 127/8 and multicast
+    while True:
+        first = rnd.randint(1, 223)
+        if first not in (10, 127):
+            break
+    address = (first << 24) | rnd.randint(0, (1 << 24) - 1)
+    address &= ~((1 << (32 - length)) - 1) & 0xffffffff
+    return (address, length)
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.stderr.write('usage: %s <number of routes> [seed]\n' % sys.argv[0])
+        sys.exit(1)
+    count = int(sys.argv[1])
+    rnd = random.Random(int(sys.argv[2]) if len(sys.argv) > 2 else 1)
+
+    paths = [random_path(rnd) for i in range(max(1, count // 20))]
+    prefixes = set()
+    out = sys.stdout
+    out.write('# %d synthetic routes\n' % count)
+    while len(prefixes) < count:
+        prefix = random_prefix(rnd)
+        if prefix in prefixes:
+            continue
+        prefixes.add(prefix)
+        (address, length) = prefix
+        out.write('%d.%d.%d.%d/%d %s\n' % (address >> 24, (address >> 16) & 255, (address >> 8) & 255, address & 255,
+                                           length, ' '.join([str(a) for a in rnd.choice(paths)])))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,52 @@
+#!/usr/bin/env python
+#
+# Generates the label tables of the LSRs with the given number of LSPs,
+# all of them from host1 to host2: LSR1 pushes label k for LSP k, LSR2
+# swaps it and LSR3 pops it. The classifier of LSR1 maps the traffic to
+# the last LSP, whose entries are the last ones in the tables.
+#
+# Usage: ./genlib.py <number of LSPs>
+#
+# writes LSR1_fec_<n>.xml and LSR{1,2,3}_lib_<n>.xml
+#
+
+import sys
+
+
+def write_lib(fileName, count, inInterface, outInterface, op):
+    out = open(fileName, 'w')
+    out.write('<?xml version="1.0"?>\n<libtable>\n')
+    for label in range(1, count + 1):
+        out.write('\t<libentry>\n')
+        out.write('\t\t<inLabel>%d</inLabel>\n' % label)
+        out.write('\t\t<inInterface>%s</inInterface>\n' % inInterface)
+        out.write('\t\t<outInterface>%s</outInterface>\n' % outInterface)
+        if op == 'pop':
+            out.write('\t\t<outLabel><op code="pop"/></outLabel>\n')
+        else:
+            out.write('\t\t<outLabel><op code="%s" value="%d"/></outLabel>\n' % (op, label))
+        out.write('\t\t<color>100</color>\n')
+        out.write('\t</libentry>\n')
+    out.write('</libtable>\n')
+    out.close()
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.stderr.write('usage: %s <number of LSPs>\n' % sys.argv[0])
+        sys.exit(1)
+    count = int(sys.argv[1])
+
+    out = open('LSR1_fec_%d.xml' % count, 'w')
+    out.write('<?xml version="1.0"?>\n<fectable>\n')
+    out.write('\t<fecentry>\n\t\t<id>1</id>\n\t\t<destination>host2</destination>\n\t\t<label>%d</label>\n\t</fecentry>\n' % count)
+    out.write('</fectable>\n')
+    out.close()
+
+    write_lib('LSR1_lib_%d.xml' % count, count, 'any', 'ppp0', 'push')
+    write_lib('LSR2_lib_%d.xml' % count, count, 'ppp0', 'ppp1', 'swap')
+    write_lib('LSR3_lib_%d.xml' % count, count, 'ppp0', 'ppp1', 'pop')
+
+
+if __name__ == '__main__':
+    main()
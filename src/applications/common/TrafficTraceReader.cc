@@ -0,0 +1,86 @@
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <string.h>
+
+#include "TrafficTraceReader.h"
+
+
+#define BUFFER_RECORDS  65536
+
+TrafficTraceReader::TrafficTraceReader()
+{
+    file = NULL;
+    readPos = endPos = 0;
+}
+
+TrafficTraceReader::~TrafficTraceReader()
+{
+    close();
+}
+
+void TrafficTraceReader::open(const char *name)
+{
+    close();
+    fileName = name;
+    file = fopen(name, "rb");
+    if (!file)
+        throw cRuntimeError("Cannot open traffic trace file '%s'", name);
+    buffer.resize(BUFFER_RECORDS * RECORD_SIZE);
+    readPos = endPos = 0;
+}
+
+void TrafficTraceReader::close()
+{
+    if (file)
+    {
+        fclose(file);
+        file = NULL;
+    }
+}
+
+bool TrafficTraceReader::fillBuffer()
+{
+    // keep the partial record at the end of the buffer
+    size_t remaining = endPos - readPos;
+    if (remaining > 0)
+        memmove(&buffer[0], &buffer[readPos], remaining);
+    readPos = 0;
+    endPos = remaining + fread(&buffer[remaining], 1, buffer.size() - remaining, file);
+    if (endPos == 0)
+        return false;
+    if (endPos < RECORD_SIZE)
+        throw cRuntimeError("Traffic trace file '%s' ends with a partial record", fileName.c_str());
+    return true;
+}
+
+bool TrafficTraceReader::readPacket(long& length, simtime_t& interval)
+{
+    if (!file)
+        return false;
+    if (endPos - readPos < RECORD_SIZE && !fillBuffer())
+        return false;
+
+    uint32 len;
+    double dt;
+    memcpy(&len, &buffer[readPos], sizeof(len));
+    memcpy(&dt, &buffer[readPos + sizeof(len)], sizeof(dt));
+    readPos += RECORD_SIZE;
+    if (dt < 0)
+        throw cRuntimeError("Negative inter-arrival time in traffic trace file '%s'", fileName.c_str());
+    length = len;
+    interval = dt;
+    return true;
+}
@@ -0,0 +1,64 @@
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef __INET_TRAFFICTRACEREADER_H
+#define __INET_TRAFFICTRACEREADER_H
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "INETDefs.h"
+
+/**
+ * Reads the packets of a binary traffic trace, for the trace replay mode
+ * of the traffic generators. Every record of the file is a packet length
+ * (32-bit unsigned integer, in bytes) followed by the time until the next
+ * packet (64-bit IEEE double, in seconds), in host byte order, without
+ * padding. The file is read in large blocks, so the trace can be much
+ * larger than the memory.
+ */
+class INET_API TrafficTraceReader
+{
+  public:
+    enum { RECORD_SIZE = 12 };
+
+  protected:
+    std::string fileName;
+    FILE *file;
+    std::vector<char> buffer;
+    size_t readPos;
+    size_t endPos;
+
+  protected:
+    bool fillBuffer();
+
+  public:
+    TrafficTraceReader();
+    ~TrafficTraceReader();
+
+    /** Opens the trace file; throws an error if it cannot be opened. */
+    void open(const char *fileName);
+    void close();
+    bool isOpen() const { return file != NULL; }
+
+    /**
+     * Reads the next packet of the trace. Returns false at the end of the
+     * trace; throws an error if the file ends with a partial record.
+     */
+    bool readPacket(long& length, simtime_t& interval);
+};
+
+#endif
@@ -91,9 +91,17 @@ void EtherTrafGen::handleMessage(cMessage *msg)
             // if no dest address given, nothing to do
             if (destMACAddress.isUnspecified())
                 return;
+            const char *traceFile = par("traceFile");
+            if (*traceFile)
+                trace.open(traceFile);
+        }
+        if (trace.isOpen())
+            sendTracePacket();
+        else
+        {
+            sendBurstPackets();
+            scheduleNextPacket(simTime());
         }
-        sendBurstPackets();
-        scheduleNextPacket(simTime());
     }
     else
         receivePacket(check_and_cast<cPacket*>(msg));
@@ -177,27 +185,44 @@ void EtherTrafGen::sendBurstPackets()
 {
     int n = numPacketsPerBurst->longValue();
     for (int i = 0; i < n; i++)
+        sendPacket(packetLength->longValue());
+}
+
+void EtherTrafGen::sendTracePacket()
+{
+    // one event per packet, like one event per burst in the default mode
+    long length;
+    simtime_t interval;
+    if (!trace.readPacket(length, interval))
+        return; // end of the trace
+    sendPacket(length);
+    simtime_t next = simTime() + interval;
+    if (stopTime < SIMTIME_ZERO || next < stopTime)
     {
-        seqNum++;
+        timerMsg->setKind(NEXT);
+        scheduleAt(next, timerMsg);
+    }
+}
 
-        char msgname[40];
-        sprintf(msgname, "pk-%d-%ld", getId(), seqNum);
-        EV << "Generating packet `" << msgname << "'\n";
+void EtherTrafGen::sendPacket(long length)
+{
+    seqNum++;
 
-        cPacket *datapacket = new cPacket(msgname, IEEE802CTRL_DATA);
+    char msgname[40];
+    sprintf(msgname, "pk-%d-%ld", getId(), seqNum);
+    EV << "Generating packet `" << msgname << "'\n";
 
-        long len = packetLength->longValue();
-        datapacket->setByteLength(len);
+    cPacket *datapacket = new cPacket(msgname, IEEE802CTRL_DATA);
+    datapacket->setByteLength(length);
 
-        Ieee802Ctrl *etherctrl = new Ieee802Ctrl();
-        etherctrl->setEtherType(etherType);
-        etherctrl->setDest(destMACAddress);
-        datapacket->setControlInfo(etherctrl);
+    Ieee802Ctrl *etherctrl = new Ieee802Ctrl();
+    etherctrl->setEtherType(etherType);
+    etherctrl->setDest(destMACAddress);
+    datapacket->setControlInfo(etherctrl);
 
-        emit(sentPkSignal, datapacket);
-        send(datapacket, "out");
-        packetsSent++;
-    }
+    emit(sentPkSignal, datapacket);
+    send(datapacket, "out");
+    packetsSent++;
 }
 
 void EtherTrafGen::receivePacket(cPacket *msg)
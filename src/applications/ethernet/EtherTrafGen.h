@@ -23,6 +23,7 @@
 #include "MACAddress.h"
 #include "NodeStatus.h"
 #include "ILifecycle.h"
+#include "TrafficTraceReader.h"
 
 
 /**
@@ -39,6 +40,7 @@ class INET_API EtherTrafGen : public cSimpleModule, public ILifecycle
     cPar *sendInterval;
     cPar *numPacketsPerBurst;
     cPar *packetLength;
+    TrafficTraceReader trace;
     int etherType;
     MACAddress destMACAddress;
     NodeStatus *nodeStatus;
@@ -74,6 +76,8 @@ class INET_API EtherTrafGen : public cSimpleModule, public ILifecycle
     virtual MACAddress resolveDestMACAddress();
 
     virtual void sendBurstPackets();
+    virtual void sendTracePacket();
+    virtual void sendPacket(long length);
     virtual void receivePacket(cPacket *msg);
 };
 
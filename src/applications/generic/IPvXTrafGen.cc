@@ -86,6 +86,9 @@ void IPvXTrafGen::initialize(int stage)
 
 void IPvXTrafGen::startApp()
 {
+    const char *traceFile = par("traceFile");
+    if (*traceFile)
+        trace.open(traceFile);
     if (isEnabled())
         scheduleNextPacket(-1);
 }
@@ -114,9 +117,14 @@ void IPvXTrafGen::handleMessage(cMessage *msg)
         }
         if (!destAddresses.empty())
         {
-            sendPacket();
-            if (isEnabled())
-                scheduleNextPacket(simTime());
+            if (trace.isOpen())
+                sendTracePacket();
+            else
+            {
+                sendPacket();
+                if (isEnabled())
+                    scheduleNextPacket(simTime());
+            }
         }
     }
     else
@@ -188,12 +196,33 @@ IPvXAddress IPvXTrafGen::chooseDestAddr()
 }
 
 void IPvXTrafGen::sendPacket()
+{
+    sendPacket(packetLengthPar->longValue());
+}
+
+void IPvXTrafGen::sendTracePacket()
+{
+    // one event per packet, like in the default mode
+    long length;
+    simtime_t interval;
+    if (!trace.readPacket(length, interval))
+        return; // end of the trace
+    sendPacket(length);
+    simtime_t next = simTime() + interval;
+    if (isEnabled() && (stopTime < SIMTIME_ZERO || next < stopTime))
+    {
+        timer->setKind(NEXT);
+        scheduleAt(next, timer);
+    }
+}
+
+void IPvXTrafGen::sendPacket(long length)
 {
     char msgName[32];
     sprintf(msgName, "appData-%d", numSent);
 
     cPacket *payload = new cPacket(msgName);
-    payload->setByteLength(packetLengthPar->longValue());
+    payload->setByteLength(length);
 
     IPvXAddress destAddr = chooseDestAddr();
     const char *gate;
@@ -28,6 +28,7 @@
 #include "IPvXTrafSink.h"
 #include "ILifecycle.h"
 #include "NodeStatus.h"
+#include "TrafficTraceReader.h"
 
 /**
  * IP traffic generator application. See NED for more info.
@@ -46,6 +47,7 @@ class INET_API IPvXTrafGen : public cSimpleModule, public ILifecycle
     std::vector<IPvXAddress> destAddresses;
     cPar *sendIntervalPar;
     cPar *packetLengthPar;
+    TrafficTraceReader trace;
     NodeStatus *nodeStatus;
 
     int numSent;
@@ -66,6 +68,8 @@ class INET_API IPvXTrafGen : public cSimpleModule, public ILifecycle
     // chooses random destination address
     virtual IPvXAddress chooseDestAddr();
     virtual void sendPacket();
+    virtual void sendPacket(long length);
+    virtual void sendTracePacket();
 
     virtual int numInitStages() const { return 4; }
     virtual void initialize(int stage);
@@ -73,7 +73,7 @@ void TCPGenericSrvApp::sendOrSchedule(cMessage *msg, simtime_t delay)
 
 void TCPGenericSrvApp::sendBack(cMessage *msg)
 {
-    GenericAppMsg *appmsg = dynamic_cast<GenericAppMsg*>(msg);
+    GenericAppMsg *appmsg = msg->getKind() == TCP_C_SEND ? dynamic_cast<GenericAppMsg*>(msg) : NULL;
 
     if (appmsg)
     {
@@ -130,7 +130,17 @@ void TCPGenericSrvApp::handleMessage(cMessage *msg)
 
         if (requestedBytes==0)
         {
-            delete msg;
+            if (doClose)
+            {
+                // no reply: the request, which already carries a TCPCommand
+                // with the connId, is turned into the close command
+                appmsg->setName("close");
+                appmsg->setKind(TCP_C_CLOSE);
+                sendOrSchedule(appmsg, delay+maxMsgDelay);
+                doClose = false;
+            }
+            else
+                delete msg;
         }
         else
         {
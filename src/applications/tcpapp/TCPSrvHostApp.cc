@@ -17,6 +17,7 @@
 #include "IPvXAddressResolver.h"
 #include "ModuleAccess.h"
 #include "NodeStatus.h"
+#include "TCPCommand_m.h"
 
 Define_Module(TCPSrvHostApp);
 
@@ -25,7 +26,18 @@ void TCPSrvHostApp::initialize(int stage)
 {
     cSimpleModule::initialize(stage);
 
-    if (stage == 3)
+    if (stage == 0)
+    {
+        int poolSize = par("threadPoolSize");
+        if (poolSize < 0)
+            throw cRuntimeError("Invalid threadPoolSize=%d, must be >= 0", poolSize);
+        threadPoolSize = poolSize;
+        numThreads = 0;
+        numAccepted = 0;
+        WATCH(numThreads);
+        WATCH(numAccepted);
+    }
+    else if (stage == 3)
     {
         const char *localAddress = par("localAddress");
         int localPort = par("localPort");
@@ -43,13 +55,30 @@ void TCPSrvHostApp::initialize(int stage)
     }
 }
 
+TCPSrvHostApp::~TCPSrvHostApp()
+{
+    for (ThreadTable::iterator it = threadTable.begin(); it != threadTable.end(); ++it)
+    {
+        if (it->thread)
+        {
+            delete it->thread->getSocket();
+            delete it->thread;
+        }
+    }
+    for (ThreadPool::iterator it = threadPool.begin(); it != threadPool.end(); ++it)
+    {
+        delete (*it)->getSocket();
+        delete *it;
+    }
+}
+
 void TCPSrvHostApp::updateDisplay()
 {
     if (!ev.isGUI())
         return;
 
     char buf[32];
-    sprintf(buf, "%d threads", socketMap.size());
+    sprintf(buf, "%d threads", numThreads);
     getDisplayString().setTagArg("t", 0, buf);
 }
 
@@ -62,42 +91,128 @@ void TCPSrvHostApp::handleMessage(cMessage *msg)
     }
     else
     {
-        TCPSocket *socket = socketMap.findSocketFor(msg);
+        TCPCommand *ind = dynamic_cast<TCPCommand *>(msg->getControlInfo());
+        if (!ind)
+            throw cRuntimeError("Message (%s)%s has no TCPCommand control info (not from TCP?)", msg->getClassName(), msg->getName());
+
+        TCPServerThreadBase *thread = findThread(ind->getConnId());
 
-        if (!socket)
+        if (!thread)
         {
             // new connection -- create new socket object and server process
-            socket = new TCPSocket(msg);
-            socket->setOutputGate(gate("tcpOut"));
-
-            const char *serverThreadClass = par("serverThreadClass");
-            TCPServerThreadBase *proc =
-                    check_and_cast<TCPServerThreadBase *>(createOne(serverThreadClass));
+            thread = createThread(msg);
+            updateDisplay();
+        }
 
-            socket->setCallbackObject(proc);
-            proc->init(this, socket);
+        thread->getSocket()->processMessage(msg);
+    }
+}
 
-            socketMap.addSocket(socket);
+void TCPSrvHostApp::finish()
+{
+    recordScalar("acceptedConnections", numAccepted);
+}
 
-            updateDisplay();
+TCPSrvHostApp::ThreadTable::iterator TCPSrvHostApp::lowerBound(int connId)
+{
+    // binary search; the table is ordered by connId
+    ThreadTable::iterator first = threadTable.begin();
+    int count = threadTable.size();
+    while (count > 0)
+    {
+        int step = count / 2;
+        ThreadTable::iterator it = first + step;
+        if (it->connId < connId)
+        {
+            first = it + 1;
+            count -= step + 1;
         }
+        else
+            count = step;
+    }
+    return first;
+}
+
+TCPServerThreadBase *TCPSrvHostApp::findThread(int connId)
+{
+    ThreadTable::iterator it = lowerBound(connId);
+    return (it != threadTable.end() && it->connId == connId) ? it->thread : NULL;
+}
 
-        socket->processMessage(msg);
+TCPServerThreadBase *TCPSrvHostApp::createThread(cMessage *msg)
+{
+    TCPServerThreadBase *thread;
+    TCPSocket *socket;
+
+    if (!threadPool.empty())
+    {
+        thread = threadPool.back();
+        threadPool.pop_back();
+        socket = thread->getSocket();
+        *socket = TCPSocket(msg);
+        thread->recycle();
     }
+    else
+    {
+        socket = new TCPSocket(msg);
+        const char *serverThreadClass = par("serverThreadClass");
+        thread = check_and_cast<TCPServerThreadBase *>(createOne(serverThreadClass));
+    }
+
+    socket->setOutputGate(gate("tcpOut"));
+    socket->setCallbackObject(thread);
+    thread->init(this, socket);
+
+    // TCP assigns connIds in increasing order, so this is normally an append
+    int connId = socket->getConnectionId();
+    ThreadTable::iterator it = lowerBound(connId);
+    if (it != threadTable.end() && it->connId == connId)
+        it->thread = thread;
+    else
+    {
+        ThreadEntry entry;
+        entry.connId = connId;
+        entry.thread = thread;
+        threadTable.insert(it, entry);
+    }
+    numThreads++;
+    numAccepted++;
+
+    return thread;
 }
 
-void TCPSrvHostApp::finish()
+void TCPSrvHostApp::compactThreadTable()
 {
+    ThreadTable::iterator dest = threadTable.begin();
+    for (ThreadTable::iterator it = threadTable.begin(); it != threadTable.end(); ++it)
+        if (it->thread)
+            *dest++ = *it;
+    threadTable.erase(dest, threadTable.end());
 }
 
 void TCPSrvHostApp::removeThread(TCPServerThreadBase *thread)
 {
-    // remove socket
-    socketMap.removeSocket(thread->getSocket());
+    // the entry is only marked as removed, and the table is compacted
+    // when most of it consists of removed entries
+    ThreadTable::iterator it = lowerBound(thread->getSocket()->getConnectionId());
+    if (it != threadTable.end() && it->thread == thread)
+    {
+        it->thread = NULL;
+        numThreads--;
+        if ((int)threadTable.size() > 2 * numThreads + 16)
+            compactThreadTable();
+    }
 
-    // remove thread object
-    delete thread;
+    if (threadPool.size() < threadPoolSize)
+    {
+        // keep the thread object and its socket for the next connection
+        threadPool.push_back(thread);
+    }
+    else
+    {
+        delete thread->getSocket();
+        delete thread;
+    }
 
     updateDisplay();
 }
-
@@ -14,9 +14,10 @@
 #ifndef __INET_TCPSRVHOSTAPP_H
 #define __INET_TCPSRVHOSTAPP_H
 
+#include <vector>
+
 #include "INETDefs.h"
 #include "TCPSocket.h"
-#include "TCPSocketMap.h"
 #include "ILifecycle.h"
 #include "LifecycleOperation.h"
 
@@ -31,8 +32,21 @@ class TCPServerThreadBase;
 class INET_API TCPSrvHostApp : public cSimpleModule, public ILifecycle
 {
   protected:
+    // dispatch table entry; thread is NULL after the thread was removed
+    struct ThreadEntry
+    {
+        int connId;
+        TCPServerThreadBase *thread;
+    };
+    typedef std::vector<ThreadEntry> ThreadTable;
+    typedef std::vector<TCPServerThreadBase *> ThreadPool;
+
     TCPSocket serverSocket;
-    TCPSocketMap socketMap;
+    ThreadTable threadTable;   // ordered by connId
+    int numThreads;            // number of live entries in threadTable
+    ThreadPool threadPool;     // idle thread objects, with their sockets
+    unsigned int threadPoolSize;
+    long numAccepted;
 
   protected:
     virtual void initialize(int stage);
@@ -42,7 +56,22 @@ class INET_API TCPSrvHostApp : public cSimpleModule, public ILifecycle
 
     virtual void updateDisplay();
 
+    /** Returns the first entry of threadTable whose connId is not less than the given one. */
+    virtual ThreadTable::iterator lowerBound(int connId);
+
+    /** Returns the thread serving the given connection, or NULL. */
+    virtual TCPServerThreadBase *findThread(int connId);
+
+    /** Creates a thread (or takes one from the pool) for a new connection. */
+    virtual TCPServerThreadBase *createThread(cMessage *msg);
+
+    /** Removes the dead entries from threadTable. */
+    virtual void compactThreadTable();
+
   public:
+    TCPSrvHostApp() : numThreads(0), threadPoolSize(0), numAccepted(0) {}
+    virtual ~TCPSrvHostApp();
+
     virtual void removeThread(TCPServerThreadBase *thread);
 
     virtual bool handleOperationStage(LifecycleOperation *operation, int stage, IDoneCallback *doneCallback)
@@ -59,7 +88,7 @@ class INET_API TCPServerThreadBase : public cObject, public TCPSocket::CallbackI
 {
   protected:
     TCPSrvHostApp *hostmod;
-    TCPSocket *sock; // ptr into socketMap managed by TCPSrvHostApp
+    TCPSocket *sock; // owned by TCPSrvHostApp
 
   protected:
     // internal: TCPSocket::CallbackInterface methods
@@ -73,6 +102,14 @@ class INET_API TCPServerThreadBase : public cObject, public TCPSocket::CallbackI
     // internal: called by TCPSrvHostApp after creating this module
     virtual void init(TCPSrvHostApp *hostmodule, TCPSocket *socket) {hostmod = hostmodule; sock = socket;}
 
+    /**
+     * Called by TCPSrvHostApp before a pooled thread object is reused for
+     * a new connection (see the threadPoolSize parameter). Threads that keep
+     * per-connection state must redefine it to reset that state; pending
+     * timers must be cancelled before the connection closes.
+     */
+    virtual void recycle() {}
+
   public:
     TCPServerThreadBase()  {sock = NULL;}
     virtual ~TCPServerThreadBase() {}
@@ -22,6 +22,7 @@
 
 #include "ModuleAccess.h"
 #include "NodeStatus.h"
+#include "NodeOperations.h"
 #include "UDPSocket.h"
 
 Define_Module(TraCIDemo);
@@ -38,7 +39,6 @@ void TraCIDemo::initialize(int stage)
     }
     else if (stage == 3)
     {
-        bool isOperational;
         NodeStatus *nodeStatus = dynamic_cast<NodeStatus *>(findContainingNode(this)->getSubmodule("status"));
         isOperational = (!nodeStatus) || nodeStatus->getState() == NodeStatus::UP;
         if (!isOperational)
@@ -51,6 +51,28 @@ void TraCIDemo::initialize(int stage)
     }
 }
 
+bool TraCIDemo::handleOperationStage(LifecycleOperation *operation, int stage, IDoneCallback *doneCallback) {
+    Enter_Method_Silent();
+    if (dynamic_cast<NodeStartOperation *>(operation)) {
+        if (stage == NodeStartOperation::STAGE_APPLICATION_LAYER) {
+            // the module may be reused for another vehicle; UDP dropped the socket on shutdown
+            sentMessage = false;
+            isOperational = true;
+            setupLowerLayer();
+        }
+    }
+    else if (dynamic_cast<NodeShutdownOperation *>(operation)) {
+        if (stage == NodeShutdownOperation::STAGE_APPLICATION_LAYER)
+            isOperational = false;
+    }
+    else if (dynamic_cast<NodeCrashOperation *>(operation)) {
+        if (stage == NodeCrashOperation::STAGE_CRASH)
+            isOperational = false;
+    }
+    else throw cRuntimeError("Unsupported lifecycle operation '%s'", operation->getClassName());
+    return true;
+}
+
 void TraCIDemo::setupLowerLayer() {
     socket.setOutputGate(gate("udp$o"));
     socket.joinLocalMulticastGroups();
@@ -70,13 +92,13 @@ void TraCIDemo::handleSelfMsg(cMessage* msg) {
 }
 
 void TraCIDemo::handleLowerMsg(cMessage* msg) {
-    if (!sentMessage) sendMessage();
+    if (isOperational && !sentMessage) sendMessage();
     delete msg;
 }
 
 void TraCIDemo::receiveSignal(cComponent *source, simsignal_t signalID, cObject *obj) {
     Enter_Method_Silent();
-    if (signalID == mobilityStateChangedSignal) {
+    if (signalID == mobilityStateChangedSignal && isOperational) {
         handlePositionUpdate();
     }
 }
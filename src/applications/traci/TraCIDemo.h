@@ -33,8 +33,7 @@
 class TraCIDemo : public cSimpleModule, protected cListener, public ILifecycle
 {
     public:
-        virtual bool handleOperationStage(LifecycleOperation *operation, int stage, IDoneCallback *doneCallback)
-        { Enter_Method_Silent(); throw cRuntimeError("Unsupported lifecycle operation '%s'", operation->getClassName()); return true; }
+        virtual bool handleOperationStage(LifecycleOperation *operation, int stage, IDoneCallback *doneCallback);
 
         virtual void receiveSignal(cComponent *source, simsignal_t signalID, cObject *obj);
 
@@ -45,6 +44,7 @@ class TraCIDemo : public cSimpleModule, protected cListener, public ILifecycle
 
     protected:
         TraCIMobility* traci;
+        bool isOperational;
         bool sentMessage;
         UDPSocket socket;
         static simsignal_t mobilityStateChangedSignal;
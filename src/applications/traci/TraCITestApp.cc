@@ -21,6 +21,7 @@
 #include "applications/traci/TraCITestApp.h"
 #include "ModuleAccess.h"
 #include "NodeStatus.h"
+#include "NodeOperations.h"
 #include <cmath>
 
 Define_Module(TraCITestApp);
@@ -40,12 +41,12 @@ void TraCITestApp::initialize(int stage)
 
         visitedEdges.clear();
         hasStopped = false;
+        isOperational = true; // checked against the node status in stage 3
 
         EV_DEBUG << "TraCITestApp initialized with testNumber=" << testNumber << std::endl;
     }
     else if (stage == 3)
     {
-        bool isOperational;
         NodeStatus *nodeStatus = dynamic_cast<NodeStatus *>(findContainingNode(this)->getSubmodule("status"));
         isOperational = (!nodeStatus) || nodeStatus->getState() == NodeStatus::UP;
         if (!isOperational)
@@ -56,6 +57,28 @@ void TraCITestApp::initialize(int stage)
 void TraCITestApp::finish() {
 }
 
+bool TraCITestApp::handleOperationStage(LifecycleOperation *operation, int stage, IDoneCallback *doneCallback) {
+    Enter_Method_Silent();
+    if (dynamic_cast<NodeStartOperation *>(operation)) {
+        if (stage == NodeStartOperation::STAGE_APPLICATION_LAYER) {
+            // the module may be reused for another vehicle, so start the tests afresh
+            visitedEdges.clear();
+            hasStopped = false;
+            isOperational = true;
+        }
+    }
+    else if (dynamic_cast<NodeShutdownOperation *>(operation)) {
+        if (stage == NodeShutdownOperation::STAGE_APPLICATION_LAYER)
+            isOperational = false;
+    }
+    else if (dynamic_cast<NodeCrashOperation *>(operation)) {
+        if (stage == NodeCrashOperation::STAGE_CRASH)
+            isOperational = false;
+    }
+    else throw cRuntimeError("Unsupported lifecycle operation '%s'", operation->getClassName());
+    return true;
+}
+
 void TraCITestApp::handleSelfMsg(cMessage *msg) {
 }
 
@@ -73,7 +96,7 @@ void TraCITestApp::handleMessage(cMessage* msg) {
 
 
 void TraCITestApp::receiveSignal(cComponent *source, simsignal_t signalID, cObject *obj) {
-    if (signalID == mobilityStateChangedSignal) {
+    if (signalID == mobilityStateChangedSignal && isOperational) {
         handlePositionUpdate();
     }
 }
@@ -35,8 +35,7 @@
 class TraCITestApp : public cSimpleModule, protected cListener, public ILifecycle
 {
     public:
-        virtual bool handleOperationStage(LifecycleOperation *operation, int stage, IDoneCallback *doneCallback)
-        { Enter_Method_Silent(); throw cRuntimeError("Unsupported lifecycle operation '%s'", operation->getClassName()); return true; }
+        virtual bool handleOperationStage(LifecycleOperation *operation, int stage, IDoneCallback *doneCallback);
 
     protected:
         virtual int numInitStages() const { return 4; }
@@ -47,6 +46,7 @@ class TraCITestApp : public cSimpleModule, protected cListener, public ILifecycl
         // module parameters
         int testNumber;
 
+        bool isOperational;
         TraCIMobility* traci;
         std::set<std::string> visitedEdges; /**< set of edges this vehicle visited */
         bool hasStopped; /**< true if at some point in time this vehicle travelled at negligible speed */
@@ -114,11 +114,16 @@ IPvXAddress UDPBasicApp::chooseDestAddr()
 }
 
 void UDPBasicApp::sendPacket()
+{
+    sendPacket(par("messageLength").longValue());
+}
+
+void UDPBasicApp::sendPacket(long length)
 {
     char msgName[32];
     sprintf(msgName, "UDPBasicAppData-%d", numSent);
     cPacket *payload = new cPacket(msgName);
-    payload->setByteLength(par("messageLength").longValue());
+    payload->setByteLength(length);
 
     IPvXAddress destAddr = chooseDestAddr();
 
@@ -133,6 +138,10 @@ void UDPBasicApp::processStart()
     socket.bind(localPort);
     setSocketOptions();
 
+    const char *traceFile = par("traceFile");
+    if (*traceFile)
+        trace.open(traceFile);
+
     const char *destAddrs = par("destAddresses");
     cStringTokenizer tokenizer(destAddrs);
     const char *token;
@@ -163,6 +172,12 @@ void UDPBasicApp::processStart()
 
 void UDPBasicApp::processSend()
 {
+    if (trace.isOpen())
+    {
+        processSendTrace();
+        return;
+    }
+
     sendPacket();
     simtime_t d = simTime() + par("sendInterval").doubleValue();
     if (stopTime < SIMTIME_ZERO || d < stopTime)
@@ -177,6 +192,35 @@ void UDPBasicApp::processSend()
     }
 }
 
+void UDPBasicApp::processSendTrace()
+{
+    // one event per packet, like in the default mode
+    long length;
+    simtime_t interval;
+    if (!trace.readPacket(length, interval))
+    {
+        // end of the trace
+        if (stopTime >= SIMTIME_ZERO)
+        {
+            selfMsg->setKind(STOP);
+            scheduleAt(stopTime, selfMsg);
+        }
+        return;
+    }
+    sendPacket(length);
+    simtime_t d = simTime() + interval;
+    if (stopTime < SIMTIME_ZERO || d < stopTime)
+    {
+        selfMsg->setKind(SEND);
+        scheduleAt(d, selfMsg);
+    }
+    else
+    {
+        selfMsg->setKind(STOP);
+        scheduleAt(stopTime, selfMsg);
+    }
+}
+
 void UDPBasicApp::processStop()
 {
     socket.close();
@@ -25,6 +25,7 @@
 #include "INETDefs.h"
 
 #include "ApplicationBase.h"
+#include "TrafficTraceReader.h"
 #include "UDPSocket.h"
 
 
@@ -41,6 +42,7 @@ class INET_API UDPBasicApp : public ApplicationBase
     std::vector<IPvXAddress> destAddresses;
     simtime_t startTime;
     simtime_t stopTime;
+    TrafficTraceReader trace;
     cMessage *selfMsg;
 
     // statistics
@@ -53,6 +55,7 @@ class INET_API UDPBasicApp : public ApplicationBase
     // chooses random destination address
     virtual IPvXAddress chooseDestAddr();
     virtual void sendPacket();
+    virtual void sendPacket(long length);
     virtual void processPacket(cPacket *msg);
     virtual void setSocketOptions();
 
@@ -68,6 +71,7 @@ class INET_API UDPBasicApp : public ApplicationBase
 
     virtual void processStart();
     virtual void processSend();
+    virtual void processSendTrace();
     virtual void processStop();
 
     virtual bool handleNodeStart(IDoneCallback *doneCallback);
@@ -0,0 +1,172 @@
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <stdio.h>
+
+#include "VoIPStreamCache.h"
+
+
+#define CACHE_FILE_MAGIC  "INET-VoIPStream-1"
+
+VoIPStreamCache::StreamMap VoIPStreamCache::streams;
+DecodedAudioCache VoIPStreamCache::decodedAudio;
+
+static bool readInt(FILE *f, int& value)
+{
+    return fread(&value, sizeof(value), 1, f) == 1;
+}
+
+static bool readString(FILE *f, std::string& s)
+{
+    int length;
+    if (!readInt(f, length) || length < 0)
+        return false;
+    s.resize(length);
+    return length == 0 || fread(&s[0], 1, length, f) == (size_t)length;
+}
+
+static void writeInt(FILE *f, int value)
+{
+    fwrite(&value, sizeof(value), 1, f);
+}
+
+static void writeString(FILE *f, const std::string& s)
+{
+    writeInt(f, s.size());
+    fwrite(s.data(), 1, s.size(), f);
+}
+
+bool EncodedAudioStream::load(const char *fileName, const std::string& key)
+{
+    FILE *f = fopen(fileName, "rb");
+    if (!f)
+        return false;
+
+    std::string magic, fileKey;
+    int numPackets;
+    bool ok = readString(f, magic) && magic == CACHE_FILE_MAGIC
+            && readString(f, fileKey) && fileKey == key
+            && readInt(f, codecId) && readInt(f, bitsPerCodedSample) && readInt(f, bytesPerSample)
+            && readInt(f, numPackets) && numPackets >= 0;
+    if (ok)
+    {
+        packets.resize(numPackets);
+        for (int i = 0; ok && i < numPackets; i++)
+        {
+            int isSilent;
+            ok = readInt(f, isSilent) && readString(f, packets[i].data) && readString(f, packets[i].samples);
+            packets[i].isSilent = isSilent != 0;
+        }
+    }
+    fclose(f);
+    if (!ok)
+        packets.clear();
+    return ok;
+}
+
+void EncodedAudioStream::save(const char *fileName, const std::string& key) const
+{
+    // write a temporary file first, so that runs started in parallel never read a partial file
+    std::string tmpFileName = std::string(fileName) + ".tmp";
+    FILE *f = fopen(tmpFileName.c_str(), "wb");
+    if (!f)
+        throw cRuntimeError("Cannot write VoIP stream cache file '%s'", tmpFileName.c_str());
+
+    writeString(f, CACHE_FILE_MAGIC);
+    writeString(f, key);
+    writeInt(f, codecId);
+    writeInt(f, bitsPerCodedSample);
+    writeInt(f, bytesPerSample);
+    writeInt(f, packets.size());
+    for (std::vector<Packet>::const_iterator it = packets.begin(); it != packets.end(); ++it)
+    {
+        writeInt(f, it->isSilent ? 1 : 0);
+        writeString(f, it->data);
+        writeString(f, it->samples);
+    }
+    bool failed = ferror(f);
+    if (fclose(f) != 0 || failed)
+        throw cRuntimeError("Error writing VoIP stream cache file '%s'", tmpFileName.c_str());
+    remove(fileName);
+    if (rename(tmpFileName.c_str(), fileName) != 0)
+        throw cRuntimeError("Cannot rename '%s' to '%s'", tmpFileName.c_str(), fileName);
+}
+
+int DecodedAudioCache::getRoot(const std::string& decoderKey)
+{
+    RootMap::iterator it = roots.find(decoderKey);
+    if (it != roots.end())
+        return it->second;
+    Frame root;
+    root.parent = -1;
+    root.data = NULL;
+    root.numSamples = 0;
+    frames.push_back(root);
+    roots[decoderKey] = frames.size() - 1;
+    return frames.size() - 1;
+}
+
+int DecodedAudioCache::findFrame(int previous, const std::string& data) const
+{
+    ChildMap::const_iterator it = children.find(std::make_pair(previous, data));
+    return it != children.end() ? it->second : -1;
+}
+
+int DecodedAudioCache::addFrame(int previous, const std::string& data, const std::string& samples, int numSamples)
+{
+    int index = frames.size();
+    ChildMap::iterator it = children.insert(std::make_pair(std::make_pair(previous, data), index)).first;
+    Frame frame;
+    frame.parent = previous;
+    frame.data = &it->first.second;
+    frame.samples = samples;
+    frame.numSamples = numSamples;
+    frames.push_back(frame);
+    return index;
+}
+
+EncodedAudioStream *VoIPStreamCache::findStream(const std::string& key)
+{
+    StreamMap::iterator it = streams.find(key);
+    return it != streams.end() ? &it->second : NULL;
+}
+
+EncodedAudioStream *VoIPStreamCache::addStream(const std::string& key)
+{
+    return &streams[key];
+}
+
+std::string VoIPStreamCache::getCacheFileName(const char *cacheDir, const char *soundFile, const std::string& key)
+{
+    FILE *f = fopen(soundFile, "rb");
+    if (!f)
+        throw cRuntimeError("Audiofile '%s' open error", soundFile);
+    cHasher contentHasher;
+    char buffer[65536];
+    size_t length;
+    while ((length = fread(buffer, 1, sizeof(buffer), f)) > 0)
+        contentHasher.add(buffer, length);
+    fclose(f);
+
+    cHasher keyHasher;
+    keyHasher.add(key.c_str());
+
+    char fileName[32];
+    sprintf(fileName, "%08x-%08x.voipcache", (unsigned int)contentHasher.getHash(), (unsigned int)keyHasher.getHash());
+    std::string dir = cacheDir;
+    if (!dir.empty() && dir[dir.size() - 1] != '/')
+        dir += "/";
+    return dir + fileName;
+}
@@ -0,0 +1,128 @@
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef VOIPSTREAM_VOIPSTREAMCACHE_H
+#define VOIPSTREAM_VOIPSTREAMCACHE_H
+
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "INETDefs.h"
+
+/**
+ * The packet stream of a sound file as encoded by VoIPStreamSender.
+ * It can be saved into a cache file, and loaded back in later runs.
+ */
+class INET_API EncodedAudioStream
+{
+  public:
+    struct Packet
+    {
+        bool isSilent;
+        std::string data;       // encoded voice
+        std::string samples;    // resampled audio before encoding, for the trace file
+    };
+
+    int codecId;
+    int bitsPerCodedSample;
+    int bytesPerSample;         // of the resampled audio
+    std::vector<Packet> packets;
+
+  public:
+    EncodedAudioStream() : codecId(0), bitsPerCodedSample(0), bytesPerSample(0) {}
+
+    /**
+     * Loads the stream from the given cache file. Returns false if the file
+     * does not exist or was written for a different key.
+     */
+    bool load(const char *fileName, const std::string& key);
+
+    /** Saves the stream into the given cache file. */
+    void save(const char *fileName, const std::string& key) const;
+};
+
+/**
+ * Audio decoded by VoIPStreamReceiver. Decoders may keep state between
+ * packets, so the decoded audio of a packet depends on all packets decoded
+ * since the decoder was opened. The frames form a tree in which the path
+ * from a root to a frame is the sequence of packets decoded so far; a root
+ * stands for a freshly opened decoder with some parameters.
+ */
+class INET_API DecodedAudioCache
+{
+  public:
+    struct Frame
+    {
+        int parent;             // the previously decoded frame, -1 for a root
+        const std::string *data;    // encoded packet, stored in the key of the frame in the children map; NULL for a root
+        std::string samples;    // decoded audio
+        int numSamples;
+    };
+
+  protected:
+    typedef std::map<std::string, int> RootMap;
+    typedef std::map<std::pair<int, std::string>, int> ChildMap;
+
+    std::deque<Frame> frames;   // a deque keeps the references to frames valid
+    RootMap roots;
+    ChildMap children;
+
+  public:
+    /** Returns the root for a decoder opened with the given parameters. */
+    int getRoot(const std::string& decoderKey);
+
+    /** Returns the frame decoded from the data after the given frame, or -1 if it is not known. */
+    int findFrame(int previous, const std::string& data) const;
+
+    /** Adds the frame decoded from the data after the given frame, and returns its index. */
+    int addFrame(int previous, const std::string& data, const std::string& samples, int numSamples);
+
+    const Frame& getFrame(int index) const { return frames[index]; }
+
+    /** Returns the number of frames, roots included. Frames are never removed. */
+    int getNumFrames() const { return frames.size(); }
+};
+
+/**
+ * Process-wide caches of the VoIPStream modules, shared by all instances
+ * and by all runs in the process.
+ */
+class INET_API VoIPStreamCache
+{
+  protected:
+    typedef std::map<std::string, EncodedAudioStream> StreamMap;
+    static StreamMap streams;
+    static DecodedAudioCache decodedAudio;
+
+  public:
+    /** Returns the encoded stream with the given key, or NULL if it was not encoded in this process. */
+    static EncodedAudioStream *findStream(const std::string& key);
+
+    /** Adds an empty encoded stream with the given key. */
+    static EncodedAudioStream *addStream(const std::string& key);
+
+    /**
+     * Returns the name of the cache file for the given sound file and encoder
+     * parameters in the cache directory. The name contains a hash of the
+     * contents of the sound file, so the file is re-encoded when it changes.
+     */
+    static std::string getCacheFileName(const char *cacheDir, const char *soundFile, const std::string& key);
+
+    static DecodedAudioCache& getDecodedAudioCache() { return decodedAudio; }
+};
+
+#endif // VOIPSTREAM_VOIPSTREAMCACHE_H
@@ -55,6 +55,8 @@ void VoIPStreamReceiver::initialize(int stage)
         localPort = par("localPort");
         resultFile = par("resultFile");
         playoutDelay = par("playoutDelay");
+        shareDecodedAudio = par("shareDecodedAudio");
+        maxCachedFrames = par("maxCachedFrames");
 
         // initialize avcodec library
         av_register_all();
@@ -117,7 +119,7 @@ void VoIPStreamReceiver::Connection::writeLostSamples(int sampleCount)
     }
 }
 
-void VoIPStreamReceiver::Connection::writeAudioFrame(uint8_t *inbuf, int inbytes)
+void VoIPStreamReceiver::Connection::decodeAudioFrame(uint8_t *inbuf, int inbytes, AVFrame& decodedFrame)
 {
     AVPacket avpkt;
     av_init_packet(&avpkt);
@@ -125,16 +127,67 @@ void VoIPStreamReceiver::Connection::writeAudioFrame(uint8_t *inbuf, int inbytes
     avpkt.size = inbytes;
 
     int gotFrame;
-    AVFrame decodedFrame = {{0}};
     int consumedBytes = avcodec_decode_audio4(decCtx, &decodedFrame, &gotFrame, &avpkt);
     if (consumedBytes < 0 || !gotFrame)
         throw cRuntimeError("Error in avcodec_decode_audio4(): returns: %d, gotFrame: %d", consumedBytes, gotFrame);
     if (consumedBytes != inbytes)
         throw cRuntimeError("Model error: remained bytes after avcodec_decode_audio4(): %d = ( %d - %d )", inbytes - consumedBytes, inbytes, consumedBytes);
-    simtime_t decodedTime(1.0 * decodedFrame.nb_samples / sampleRate);
+}
+
+void VoIPStreamReceiver::Connection::catchUpDecoder()
+{
+    // give the decoder the packets whose audio was taken from the cache, to get it into the same state
+    std::vector<int> path;
+    for (int i = lastFrame; i != decoderFrame; i = decodedAudio->getFrame(i).parent)
+        path.push_back(i);
+    for (std::vector<int>::reverse_iterator it = path.rbegin(); it != path.rend(); ++it)
+    {
+        std::string data = *decodedAudio->getFrame(*it).data;
+        AVFrame decodedFrame = {{0}};
+        decodeAudioFrame((uint8_t *)&data[0], data.size(), decodedFrame);
+    }
+    decoderFrame = lastFrame;
+}
+
+void VoIPStreamReceiver::Connection::writeDecodedAudio(int numSamples, const void *samples, int len)
+{
+    simtime_t decodedTime(1.0 * numSamples / sampleRate);
     lastPacketFinish += decodedTime;
     if (outFile.isOpen())
-        outFile.write(decodedFrame.data[0], decodedFrame.linesize[0]);
+        outFile.write(const_cast<void *>(samples), len);
+}
+
+void VoIPStreamReceiver::Connection::writeAudioFrame(uint8_t *inbuf, int inbytes)
+{
+    if (!decodedAudio)
+    {
+        AVFrame decodedFrame = {{0}};
+        decodeAudioFrame(inbuf, inbytes, decodedFrame);
+        writeDecodedAudio(decodedFrame.nb_samples, decodedFrame.data[0], decodedFrame.linesize[0]);
+        return;
+    }
+
+    std::string data((const char *)inbuf, inbytes);
+    int frame = decodedAudio->findFrame(lastFrame, data);
+    if (frame == -1)
+    {
+        catchUpDecoder();
+        AVFrame decodedFrame = {{0}};
+        decodeAudioFrame(inbuf, inbytes, decodedFrame);
+        if (decodedAudio->getNumFrames() >= maxCachedFrames)
+        {
+            // the cache is full, decode the rest of the connection without it
+            EV_WARN << "Decoded audio cache is full (" << maxCachedFrames << " frames), no longer sharing decoded audio\n";
+            decodedAudio = NULL;
+            writeDecodedAudio(decodedFrame.nb_samples, decodedFrame.data[0], decodedFrame.linesize[0]);
+            return;
+        }
+        std::string samples((const char *)decodedFrame.data[0], decodedFrame.linesize[0]);
+        frame = decoderFrame = decodedAudio->addFrame(lastFrame, data, samples, decodedFrame.nb_samples);
+    }
+    lastFrame = frame;
+    const DecodedAudioCache::Frame& decoded = decodedAudio->getFrame(frame);
+    writeDecodedAudio(decoded.numSamples, decoded.samples.data(), decoded.samples.size());
 }
 
 void VoIPStreamReceiver::Connection::closeAudio()
@@ -176,6 +229,17 @@ void VoIPStreamReceiver::createConnection(VoIPStreamPacket *vp)
     if (ret < 0)
         throw cRuntimeError("could not open decoding codec %d (%s): err=%d", curConn.codec, curConn.pCodecDec->name, ret);
 
+    if (shareDecodedAudio)
+    {
+        std::ostringstream os;
+        os << curConn.codec << " " << curConn.transmitBitrate << " " << curConn.sampleRate << " " << curConn.sampleBits;
+        curConn.decodedAudio = &VoIPStreamCache::getDecodedAudioCache();
+        curConn.maxCachedFrames = maxCachedFrames;
+        curConn.lastFrame = curConn.decoderFrame = curConn.decodedAudio->getRoot(os.str());
+    }
+    else
+        curConn.decodedAudio = NULL;
+
     curConn.openAudio(resultFile);
     curConn.offline = false;
     emit(connStateSignal, 1);
@@ -40,6 +40,7 @@ extern "C" {
 #include "IPvXAddressResolver.h"
 #include "UDPControlInfo_m.h"
 #include "UDPSocket.h"
+#include "VoIPStreamCache.h"
 #include "VoIPStreamPacket_m.h"
 #include "AudioOutFile.h"
 #include "ILifecycle.h"
@@ -68,9 +69,12 @@ class VoIPStreamReceiver : public cSimpleModule, public ILifecycle
     class Connection
     {
       public:
-        Connection() : offline(true), oc(NULL), fmt(NULL), audio_st(NULL), decCtx(NULL), pCodecDec(NULL) {}
+        Connection() : offline(true), oc(NULL), fmt(NULL), audio_st(NULL), decCtx(NULL), pCodecDec(NULL), decodedAudio(NULL), maxCachedFrames(0), lastFrame(-1), decoderFrame(-1) {}
         void addAudioStream(enum CodecID codec_id);
         void openAudio(const char *fileName);
+        void decodeAudioFrame(uint8_t *buf, int len, AVFrame& decodedFrame);
+        void catchUpDecoder();
+        void writeDecodedAudio(int numSamples, const void *samples, int len);
         void writeAudioFrame(uint8_t *buf, int len);
         void writeLostSamples(int sampleCount);
         void closeAudio();
@@ -90,6 +94,10 @@ class VoIPStreamReceiver : public cSimpleModule, public ILifecycle
         AVStream *audio_st;
         AVCodecContext *decCtx;
         AVCodec *pCodecDec;
+        DecodedAudioCache *decodedAudio;    // NULL if the decoded audio is not shared
+        int maxCachedFrames;                // decodedAudio is no longer used when it has this many frames
+        int lastFrame;                      // the frame of the last packet in decodedAudio
+        int decoderFrame;                   // the frame of the last packet given to decCtx
         AudioOutFile outFile;
         IPvXAddress srcAddr;
         int srcPort;
@@ -101,6 +109,8 @@ class VoIPStreamReceiver : public cSimpleModule, public ILifecycle
     int localPort;
     simtime_t playoutDelay;
     const char *resultFile;
+    bool shareDecodedAudio;
+    int maxCachedFrames;
 
     UDPSocket socket;
 
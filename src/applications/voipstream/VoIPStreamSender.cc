@@ -42,6 +42,8 @@ VoIPStreamSender::VoIPStreamSender()
     pReSampleCtx = NULL;
     pEncoderCtx = NULL;
     pCodecEncoder = NULL;
+    stream = NULL;
+    streamPos = 0;
     timer = NULL;
 }
 
@@ -93,6 +95,8 @@ void VoIPStreamSender::initialize(int stage)
         soundFile = par("soundFile").stringValue();
         repeatCount = par("repeatCount");
         traceFileName = par("traceFileName").stringValue();
+        shareEncodedStream = par("shareEncodedStream");
+        encodedCacheDir = par("encodedCacheDir").stringValue();
 
         pReSampleCtx = NULL;
         localPort = par("localPort");
@@ -126,7 +130,13 @@ void VoIPStreamSender::initialize(int stage)
 
         av_init_packet(&packet);
 
-        openSoundFile(soundFile);
+        if (shareEncodedStream || *encodedCacheDir)
+            openEncodedStream();
+        else
+            openSoundFile(soundFile);
+
+        if (traceFileName && *traceFileName)
+            outFile.open(traceFileName, sampleRate, 8 * bytesPerSample);
 
         timer = new cMessage("sendVoIP");
         scheduleAt(startTime, timer);
@@ -153,7 +163,10 @@ void VoIPStreamSender::handleMessage(cMessage *msg)
                 if (repeatCount > 1)
                 {
                     repeatCount--;
-                    av_seek_frame(pFormatCtx, streamIndex, 0, 0);
+                    if (stream)
+                        streamPos = 0;
+                    else
+                        av_seek_frame(pFormatCtx, streamIndex, 0, 0);
                     packet = generatePacket();
                 }
             }
@@ -293,24 +306,107 @@ void VoIPStreamSender::openSoundFile(const char *name)
 #endif
     }
 
-    if (traceFileName && *traceFileName)
-        outFile.open(traceFileName, sampleRate, 8 * av_get_bytes_per_sample(pEncoderCtx->sample_fmt));
+    codecId = pEncoderCtx->codec_id;
+    bitsPerCodedSample = pEncoderCtx->bits_per_coded_sample;
+    bytesPerSample = av_get_bytes_per_sample(pEncoderCtx->sample_fmt);
+    sampleBuffer.clear(samplesPerPacket * bytesPerSample);
+}
 
-    sampleBuffer.clear(samplesPerPacket * av_get_bytes_per_sample(pEncoderCtx->sample_fmt));
+void VoIPStreamSender::openEncodedStream()
+{
+    // the packets depend on the contents of the sound file and on these parameters
+    std::ostringstream os;
+    os << codec << " " << compressedBitRate << " " << sampleRate << " " << samplesPerPacket << " " << voipSilenceThreshold;
+    std::string encoderKey = os.str();
+    std::string key = std::string(soundFile) + " " + encoderKey;
+
+    stream = VoIPStreamCache::findStream(key);
+    if (!stream)
+    {
+        stream = VoIPStreamCache::addStream(key);
+        std::string cacheFileName;
+        bool loaded = false;
+        if (*encodedCacheDir)
+        {
+            cacheFileName = VoIPStreamCache::getCacheFileName(encodedCacheDir, soundFile, encoderKey);
+            loaded = stream->load(cacheFileName.c_str(), encoderKey);
+            if (loaded)
+                EV_INFO << "Encoded stream of '" << soundFile << "' loaded from '" << cacheFileName << "'" << endl;
+        }
+        if (!loaded)
+        {
+            openSoundFile(soundFile);
+            EncodedAudioStream::Packet packet;
+            while (encodePacket(packet))
+                stream->packets.push_back(packet);
+            stream->codecId = codecId;
+            stream->bitsPerCodedSample = bitsPerCodedSample;
+            stream->bytesPerSample = bytesPerSample;
+            if (*encodedCacheDir)
+                stream->save(cacheFileName.c_str(), encoderKey);
+        }
+    }
+    codecId = stream->codecId;
+    bitsPerCodedSample = stream->bitsPerCodedSample;
+    bytesPerSample = stream->bytesPerSample;
+    streamPos = 0;
 }
 
 VoIPStreamPacket* VoIPStreamSender::generatePacket()
+{
+    EncodedAudioStream::Packet encoded;
+    const EncodedAudioStream::Packet *p = &encoded;
+    if (stream)
+    {
+        if (streamPos >= stream->packets.size())
+            return NULL;
+        p = &stream->packets[streamPos++];
+    }
+    else if (!encodePacket(encoded))
+        return NULL;
+
+    if (outFile.isOpen())
+        outFile.write(const_cast<char *>(p->samples.data()), p->samples.size());
+
+    VoIPStreamPacket *vp = new VoIPStreamPacket();
+    vp->setDataFromBuffer(p->data.data(), p->data.size());
+
+    if (p->isSilent)
+    {
+        vp->setName("SILENCE");
+        vp->setType(SILENCE);
+        vp->setByteLength(voipSilencePacketSize);
+    }
+    else
+    {
+        vp->setName("VOICE");
+        vp->setType(VOICE);
+        vp->setByteLength(voipHeaderSize + p->data.size());
+    }
+
+    vp->setTimeStamp(pktID);
+    vp->setSeqNo(pktID);
+    vp->setCodec(codecId);
+    vp->setSampleRate(sampleRate);
+    vp->setSampleBits(bitsPerCodedSample);
+    vp->setSamplesPerPacket(samplesPerPacket);
+    vp->setTransmitBitrate(compressedBitRate);
+
+    pktID++;
+    return vp;
+}
+
+bool VoIPStreamSender::encodePacket(EncodedAudioStream::Packet& result)
 {
     readFrame();
 
     if (sampleBuffer.empty())
-        return NULL;
+        return false;
 
     short int bytesPerInSample = av_get_bytes_per_sample(pEncoderCtx->sample_fmt);
     int samples = std::min(sampleBuffer.length() / (bytesPerInSample), samplesPerPacket);
     int inBytes = samples * bytesPerInSample;
-    bool isSilent = checkSilence(pEncoderCtx->sample_fmt, sampleBuffer.readPtr(), samples);
-    VoIPStreamPacket *vp = new VoIPStreamPacket();
+    result.isSilent = checkSilence(pEncoderCtx->sample_fmt, sampleBuffer.readPtr(), samples);
 
     AVPacket opacket;
     av_init_packet(&opacket);
@@ -336,34 +432,10 @@ VoIPStreamPacket* VoIPStreamSender::generatePacket()
     if(ret < 0 || gotPacket != 1)
         throw cRuntimeError("avcodec_encode_audio() error: %d gotPacket: %d", ret, gotPacket);
 
-    if (outFile.isOpen())
-        outFile.write(sampleBuffer.readPtr(), inBytes);
+    result.samples.assign(sampleBuffer.readPtr(), inBytes);
     sampleBuffer.notifyRead(inBytes);
 
-    vp->setDataFromBuffer(opacket.data, opacket.size);
-
-    if (isSilent)
-    {
-        vp->setName("SILENCE");
-        vp->setType(SILENCE);
-        vp->setByteLength(voipSilencePacketSize);
-    }
-    else
-    {
-        vp->setName("VOICE");
-        vp->setType(VOICE);
-        vp->setByteLength(voipHeaderSize + opacket.size);
-    }
-
-    vp->setTimeStamp(pktID);
-    vp->setSeqNo(pktID);
-    vp->setCodec(pEncoderCtx->codec_id);
-    vp->setSampleRate(sampleRate);
-    vp->setSampleBits(pEncoderCtx->bits_per_coded_sample);
-    vp->setSamplesPerPacket(samplesPerPacket);
-    vp->setTransmitBitrate(compressedBitRate);
-
-    pktID++;
+    result.data.assign((const char *)opacket.data, opacket.size);
 
     av_free_packet(&opacket);
 #if LIBAVCODEC_VERSION_INT >= AV_VERSION_INT(54,28,0)
@@ -371,7 +443,7 @@ VoIPStreamPacket* VoIPStreamSender::generatePacket()
 #else
     av_freep(&frame);
 #endif
-    return vp;
+    return true;
 }
 
 bool VoIPStreamSender::checkSilence(AVSampleFormat sampleFormat, void* _buf, int samples)
@@ -46,6 +46,7 @@ extern "C" {
 #include "AudioOutFile.h"
 #include "IPvXAddressResolver.h"
 #include "UDPSocket.h"
+#include "VoIPStreamCache.h"
 #include "VoIPStreamPacket_m.h"
 #include "ILifecycle.h"
 #include "LifecycleOperation.h"
@@ -68,7 +69,9 @@ class INET_API VoIPStreamSender : public cSimpleModule, public ILifecycle
     virtual void finish();
 
     virtual void openSoundFile(const char *name);
+    virtual void openEncodedStream();
     virtual VoIPStreamPacket* generatePacket();
+    virtual bool encodePacket(EncodedAudioStream::Packet& packet);
     virtual bool checkSilence(AVSampleFormat sampleFormat, void* _buf, int samples);
     virtual void readFrame();
 
@@ -115,6 +118,9 @@ class INET_API VoIPStreamSender : public cSimpleModule, public ILifecycle
     const char *traceFileName;      // name of the output trace file, NULL or empty to turn off recording
     AudioOutFile outFile;
 
+    bool shareEncodedStream;        // encode the sound file once per process, see VoIPStreamCache
+    const char *encodedCacheDir;    // directory of the encoded stream cache files, NULL or empty to turn off
+
     // AVCodec parameters
     AVFormatContext *pFormatCtx;
     AVCodecContext *pCodecCtx;
@@ -136,6 +142,11 @@ class INET_API VoIPStreamSender : public cSimpleModule, public ILifecycle
     int samplesPerPacket;
     AVPacket packet;
     Buffer sampleBuffer;
+    int codecId;
+    int bitsPerCodedSample;
+    int bytesPerSample;             // of the resampled audio
+    EncodedAudioStream *stream;     // the shared encoded packets, or NULL if the packets are encoded on the fly
+    unsigned int streamPos;         // index of the next packet in stream
 
     cMessage *timer;
 
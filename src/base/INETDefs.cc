@@ -0,0 +1,74 @@
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <string.h>
+
+#include "INETDefs.h"
+
+#if OMNETPP_VERSION < 0x500
+
+Register_PerObjectConfigOption(CFGID_LOG_LEVEL, "cmdenv-log-level", CFG_STRING, "trace", "Log level threshold of the module; messages below it are not logged. Values: trace, debug, detail, info, warn, error, fatal, off. Levels below COMPILETIME_LOGLEVEL are never logged.");
+
+std::vector<signed char> INETLog::moduleLogLevels;
+cModule *INETLog::cachedSystemModule = NULL;
+eventnumber_t INETLog::lastEventNumber = 0;
+
+LogLevel INETLog::getLogLevel(cModule *module)
+{
+    // drop the cache when a new network is set up or the simulation is restarted
+    cModule *systemModule = simulation.getSystemModule();
+    eventnumber_t eventNumber = simulation.getEventNumber();
+    if (systemModule != cachedSystemModule || eventNumber < lastEventNumber)
+    {
+        moduleLogLevels.clear();
+        cachedSystemModule = systemModule;
+    }
+    lastEventNumber = eventNumber;
+
+    if (!module)
+        module = systemModule;
+    if (!module)
+        return LOGLEVEL_TRACE;
+
+    int id = module->getId();
+    if (id >= (int)moduleLogLevels.size())
+        moduleLogLevels.resize(id + 1, -1);
+    if (moduleLogLevels[id] < 0)
+        moduleLogLevels[id] = readLogLevel(module);
+    return (LogLevel)moduleLogLevels[id];
+}
+
+void INETLog::setLogLevel(cModule *module, LogLevel level)
+{
+    getLogLevel(module);    // validates the cache and makes room for the module
+    moduleLogLevels[module->getId()] = level;
+}
+
+LogLevel INETLog::readLogLevel(cModule *module)
+{
+    std::string name = ev.getConfig()->getAsString(module->getFullPath().c_str(), CFGID_LOG_LEVEL);
+    return parseLogLevel(name.c_str());
+}
+
+LogLevel INETLog::parseLogLevel(const char *name)
+{
+    static const char *names[] = { "trace", "debug", "detail", "info", "warn", "error", "fatal", "off" };
+    for (int i = 0; i < (int)(sizeof(names) / sizeof(names[0])); i++)
+        if (!strcmp(name, names[i]))
+            return (LogLevel)i;
+    throw cRuntimeError("Unknown log level '%s'", name);
+}
+
+#endif  // OMNETPP_VERSION < 0x500
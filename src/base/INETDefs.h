@@ -22,6 +22,8 @@
 // General definitions.
 //
 
+#include <vector>
+
 #include <omnetpp.h>
 #include "Compat.h"
 
@@ -64,4 +66,92 @@ T *__checknull(T *p, const char *expr, const char *file, int line)
 
 #define PK(msg)  check_and_cast<cPacket *>(msg)    /*XXX temp def*/
 
+//
+// Level-gated logging, a backport of the OMNeT++ 5 logging macros.
+//
+// EV_FATAL ... EV_TRACE write to EV if the level is enabled for the module
+// in context. The check comes before the arguments of the << operators are
+// evaluated, so a disabled log statement costs only the test (and nothing
+// at all in express mode, where EV is disabled). Levels below
+// COMPILETIME_LOGLEVEL are removed by the compiler; release builds
+// (NDEBUG) drop EV_DEBUG and EV_TRACE by default. The runtime threshold of
+// a module is given by the per-object configuration option
+// "cmdenv-log-level", e.g. **.tcp.cmdenv-log-level = "info"; the default
+// is "trace", i.e. everything that was compiled in is logged.
+//
+#if OMNETPP_VERSION < 0x500
+
+enum LogLevel
+{
+    LOGLEVEL_TRACE,
+    LOGLEVEL_DEBUG,
+    LOGLEVEL_DETAIL,
+    LOGLEVEL_INFO,
+    LOGLEVEL_WARN,
+    LOGLEVEL_ERROR,
+    LOGLEVEL_FATAL,
+    LOGLEVEL_OFF
+};
+
+#ifndef COMPILETIME_LOGLEVEL
+#  ifdef NDEBUG
+#    define COMPILETIME_LOGLEVEL  LOGLEVEL_DETAIL
+#  else
+#    define COMPILETIME_LOGLEVEL  LOGLEVEL_TRACE
+#  endif
+#endif
+
+/**
+ * Runtime log level thresholds of the modules, read from the configuration
+ * on first use and cached by module id.
+ */
+class INET_API INETLog
+{
+  protected:
+    static std::vector<signed char> moduleLogLevels;    // by module id, -1 if not read yet
+    static cModule *cachedSystemModule;     // the network the cache belongs to
+    static eventnumber_t lastEventNumber;   // detects the restart of the simulation
+
+    static LogLevel readLogLevel(cModule *module);
+
+  public:
+    /** Returns the log level threshold of the module (of the network if NULL). */
+    static LogLevel getLogLevel(cModule *module);
+
+    /** Overrides the configured log level threshold of the module. */
+    static void setLogLevel(cModule *module, LogLevel level);
+
+    /** Returns true if messages of the given level are logged in the current context. */
+    static bool isEnabled(LogLevel level) { return level >= getLogLevel(simulation.getContextModule()); }
+
+    /** Parses "trace", "debug", ..., "fatal", "off"; throws an error for other names. */
+    static LogLevel parseLogLevel(const char *name);
+};
+
+#define EV_ENABLED(level)  ((level) >= COMPILETIME_LOGLEVEL && !ev.isDisabled() && INETLog::isEnabled(level))
+#define EV_LOG(level)  if (!EV_ENABLED(level)) ; else EV
+
+#define EV_FATAL  EV_LOG(LOGLEVEL_FATAL) << "FATAL: "
+#define EV_ERROR  EV_LOG(LOGLEVEL_ERROR) << "ERROR: "
+#define EV_WARN   EV_LOG(LOGLEVEL_WARN) << "WARN: "
+#define EV_INFO   EV_LOG(LOGLEVEL_INFO)
+#define EV_DETAIL EV_LOG(LOGLEVEL_DETAIL) << "DETAIL: "
+#define EV_DEBUG  EV_LOG(LOGLEVEL_DEBUG) << "DEBUG: "
+#define EV_TRACE  EV_LOG(LOGLEVEL_TRACE) << "TRACE: "
+
+#define EV_FATAL_C(category)  EV_LOG(LOGLEVEL_FATAL) << "[" << category << "] FATAL: "
+#define EV_ERROR_C(category)  EV_LOG(LOGLEVEL_ERROR) << "[" << category << "] ERROR: "
+#define EV_WARN_C(category)   EV_LOG(LOGLEVEL_WARN) << "[" << category << "] WARN: "
+#define EV_INFO_C(category)   EV_LOG(LOGLEVEL_INFO) << "[" << category << "] "
+#define EV_DETAIL_C(category) EV_LOG(LOGLEVEL_DETAIL) << "[" << category << "] DETAIL: "
+#define EV_DEBUG_C(category)  EV_LOG(LOGLEVEL_DEBUG) << "[" << category << "] DEBUG: "
+#define EV_TRACE_C(category)  EV_LOG(LOGLEVEL_TRACE) << "[" << category << "] TRACE: "
+
+#else
+
+// OMNeT++ 5 filters EV by itself; used by the protocol-specific macros
+#define EV_ENABLED(level)  ((level) >= COMPILETIME_LOGLEVEL)
+
+#endif  // OMNETPP_VERSION < 0x500
+
 #endif  // __INET_INETDEFS_H
@@ -0,0 +1,78 @@
+//
+// Copyright (C) 2014 OpenSim Ltd.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef __INET_MESSAGEFANOUT_H
+#define __INET_MESSAGEFANOUT_H
+
+#include "INETDefs.h"
+
+
+/**
+ * Hands out the messages needed for sending one message on several gates,
+ * e.g. for flooding a frame in a switch or repeating a signal in a hub.
+ *
+ * The simulation kernel delivers every message object to exactly one
+ * destination, so each receiver still gets its own object, but only the
+ * outermost message is duplicated: the encapsulated packets are shared by
+ * reference counting in cPacket, and they are copied only when a receiver
+ * accesses them for modification (decapsulate(), getEncapsulatedPacket()).
+ * Receivers that just forward or drop the frame never copy the payload.
+ * The original message is handed out last, so N receivers cost N-1
+ * duplicates; if no message is taken, the original is deleted.
+ *
+ * Usage:
+ * <pre>
+ * MessageFanout fanout(msg, numGates);
+ * for (int i = 0; i < numGates; i++)
+ *     send(fanout.next(), gates[i]);
+ * </pre>
+ */
+class INET_API MessageFanout
+{
+  protected:
+    cMessage *msg;
+    int remaining;
+
+  private:
+    MessageFanout(const MessageFanout& other);
+    MessageFanout& operator=(const MessageFanout& other);
+
+  public:
+    MessageFanout(cMessage *msg, int numReceivers) : msg(msg), remaining(numReceivers) {}
+
+    ~MessageFanout()
+    {
+        // nobody received the original
+        delete msg;
+    }
+
+    /** Returns the message for the next receiver; the caller takes ownership. */
+    cMessage *next()
+    {
+        ASSERT(remaining > 0);
+        if (--remaining > 0)
+            return msg->dup();
+        cMessage *last = msg;
+        msg = NULL;
+        return last;
+    }
+
+    /** Number of messages that can still be taken */
+    int getRemaining() const { return remaining; }
+};
+
+#endif
@@ -34,6 +34,8 @@ static cModule *findSubmodRecursive(cModule *curmod, const char *name)
     for (cModule::SubmoduleIterator i(curmod); !i.end(); i++)
     {
         cModule *submod = i();
+        if (submod->isPlaceholder())
+            continue;   // module in another partition of a parallel simulation
         if (!strcmp(submod->getFullName(), name))
             return submod;
         cModule *foundmod = findSubmodRecursive(submod, name);
@@ -67,7 +69,11 @@ cModule *findModuleSomewhereUp(const char *name, cModule *from)
 {
     cModule *mod = NULL;
     for (cModule *curmod=from; !mod && curmod; curmod=curmod->getParentModule())
+    {
         mod = curmod->getSubmodule(name);
+        if (mod && mod->isPlaceholder())
+            mod = NULL;
+    }
     return mod;
 }
 
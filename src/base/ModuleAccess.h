@@ -31,6 +31,9 @@ INET_API bool isNetworkNode(cModule *mod);
  *
  * Operation: gradually rises in the module hierarchy, and searches
  * recursively among all submodules at every level.
+ *
+ * Like the other find functions, it ignores the placeholders of modules
+ * that are in other partitions of a parallel simulation.
  */
 INET_API cModule *findModuleWherever(const char *name, cModule *from);
 
@@ -61,6 +61,9 @@ enum
     NF_LINK_PROMISCUOUS, // used for manet promiscuous mode, the packets that have this node how destination are no promiscuous send
     NF_LINK_FULL_PROMISCUOUS, // Used for manet promiscuous mode, all packets are promiscuous
     NF_LINK_REFRESH,     // used for refreshing a neigbour adjacency
+    NF_NEIGHBOR_ADDED,   // a neighbor was discovered by NeighborDiscovery; details: NeighborEntry
+    NF_NEIGHBOR_CHANGED, // the position or link quality of a neighbor was updated; details: NeighborEntry
+    NF_NEIGHBOR_REMOVED, // a neighbor expired or its link broke; details: NeighborEntry
 
     // - layer 3 (network)
     NF_INTERFACE_CREATED,
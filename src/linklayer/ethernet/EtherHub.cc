@@ -16,6 +16,7 @@
 */
 
 #include "EtherHub.h"
+#include "MessageFanout.h"
 
 
 Define_Module(EtherHub);
@@ -36,7 +37,9 @@ void EtherHub::initialize()
     outputGateBaseId = gateBaseId("ethg$o");
 
     numMessages = 0;
+    numCopies = 0;
     WATCH(numMessages);
+    WATCH(numCopies);
 
     // ensure we receive frames when their first bits arrive
     for (int i = 0; i < numPorts; i++)
@@ -166,6 +169,12 @@ void EtherHub::handleMessage(cMessage *msg)
         return;
     }
 
+    int numReceivers = 0;
+    for (int i = 0; i < numPorts; i++)
+        if (i != arrivalPort && gate(outputGateBaseId + i)->isConnected())
+            numReceivers++;
+
+    MessageFanout fanout(msg, numReceivers);
     for (int i = 0; i < numPorts; i++)
     {
         if (i != arrivalPort)
@@ -174,26 +183,21 @@ void EtherHub::handleMessage(cMessage *msg)
             if (!ogate->isConnected())
                 continue;
 
-            bool isLast = (arrivalPort == numPorts-1) ? (i == numPorts-2) : (i == numPorts-1);
-            cMessage *msg2 = isLast ? msg : msg->dup();
-
             // stop current transmission
             ogate->getTransmissionChannel()->forceTransmissionFinishTime(SIMTIME_ZERO);
 
             // send
-            send(msg2, ogate);
-
-            if (isLast)
-                msg = NULL;  // msg sent, do not delete it.
+            send(fanout.next(), ogate);
         }
     }
-    delete msg;
+    numCopies += numReceivers;
 }
 
 void EtherHub::finish()
 {
     simtime_t t = simTime();
     recordScalar("simulated time", t);
+    recordScalar("copies sent", numCopies);
 
     if (t > 0)
         recordScalar("messages/sec", numMessages / t);
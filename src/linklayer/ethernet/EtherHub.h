@@ -34,6 +34,7 @@ class INET_API EtherHub : public cSimpleModule, protected cListener
 
     // statistics
     long numMessages;   // number of messages handled
+    long numCopies;     // number of messages sent out on the ports
     static simsignal_t pkSignal;
 
   protected:
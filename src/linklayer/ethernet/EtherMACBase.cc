@@ -246,12 +246,19 @@ void EtherMACBase::initializeMACAddress()
     }
 }
 
+bool EtherMACBase::isLinkEndConnected(cGate *gate)
+{
+    // a placeholder module stands for the peer in another partition of a
+    // parallel simulation; its gates are not connected inside
+    return gate->isConnected() || gate->getOwnerModule()->isPlaceholder();
+}
+
 void EtherMACBase::initializeFlags()
 {
     duplexMode = true;
 
     // initialize connected flag
-    connected = physOutGate->getPathEndGate()->isConnected() && physInGate->getPathStartGate()->isConnected();
+    connected = isLinkEndConnected(physOutGate->getPathEndGate()) && isLinkEndConnected(physInGate->getPathStartGate());
 
     if (!connected)
         EV << "MAC not connected to a network.\n";
@@ -502,17 +509,22 @@ void EtherMACBase::readChannelParameters(bool errorWhenAsymmetric)
     cDatarateChannel *outTrChannel = check_and_cast_nullable<cDatarateChannel *>(physOutGate->findTransmissionChannel());
     cDatarateChannel *inTrChannel = check_and_cast_nullable<cDatarateChannel *>(physInGate->findIncomingTransmissionChannel());
 
-    connected = physOutGate->getPathEndGate()->isConnected() && physInGate->getPathStartGate()->isConnected();
+    connected = isLinkEndConnected(physOutGate->getPathEndGate()) && isLinkEndConnected(physInGate->getPathStartGate());
 
-    if (connected && ((!outTrChannel) || (!inTrChannel)))
+    // If the peer is in another partition of a parallel simulation, the
+    // incoming channel is not visible here. Like PPP, we use the outgoing
+    // channel only in that case, and assume that the link is symmetric.
+    bool rxFromTx = !inTrChannel && physInGate->getPathStartGate()->getOwnerModule()->isPlaceholder();
+
+    if (connected && ((!outTrChannel) || (!inTrChannel && !rxFromTx)))
         throw cRuntimeError("Ethernet phys gate must be connected using a transmission channel");
 
     double txRate = outTrChannel ? outTrChannel->getNominalDatarate() : 0.0;
-    double rxRate = inTrChannel ? inTrChannel->getNominalDatarate() : 0.0;
-
-    bool rxDisabled = !inTrChannel || inTrChannel->isDisabled();
     bool txDisabled = !outTrChannel || outTrChannel->isDisabled();
 
+    double rxRate = rxFromTx ? txRate : inTrChannel ? inTrChannel->getNominalDatarate() : 0.0;
+    bool rxDisabled = rxFromTx ? txDisabled : !inTrChannel || inTrChannel->isDisabled();
+
     if (errorWhenAsymmetric && (rxDisabled != txDisabled))
         throw cRuntimeError("The enablements of the input/output channels differ (rx=%s vs tx=%s)", rxDisabled?"off":"on", txDisabled?"off":"on");
 
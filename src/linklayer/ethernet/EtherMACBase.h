@@ -204,6 +204,7 @@ class INET_API EtherMACBase : public MACBase, public cListener
     virtual void initialize(int stage);
     virtual int numInitStages() const { return 2; }
     virtual void initializeFlags();
+    static bool isLinkEndConnected(cGate *gate);
     virtual void initializeMACAddress();
     virtual void initializeQueueModule();
     virtual void initializeStatistics();
@@ -19,6 +19,7 @@
 #include "Ethernet.h"
 #include "ModuleAccess.h"
 #include "NodeOperations.h"
+#include "MessageFanout.h"
 
 Define_Module(MACRelayUnit);
 
@@ -35,13 +36,18 @@ void MACRelayUnit::initialize(int stage)
         numPorts = gate("ifOut", 0)->size();
         if (gate("ifIn", 0)->size() != numPorts)
             error("the sizes of the ifIn[] and ifOut[] gate vectors must be the same");
+        outputGateBaseId = gateBaseId("ifOut");
 
         numProcessedFrames = numDiscardedFrames = 0;
+        numBroadcastFrames = numFloodedFrames = numFloodCopies = 0;
 
         addressTable = check_and_cast<IMACAddressTable *>(getModuleByPath(par("macTablePath")));
 
         WATCH(numProcessedFrames);
         WATCH(numDiscardedFrames);
+        WATCH(numBroadcastFrames);
+        WATCH(numFloodedFrames);
+        WATCH(numFloodCopies);
     }
     else if (stage == 1)
     {
@@ -76,6 +82,7 @@ void MACRelayUnit::handleAndDispatchFrame(EtherFrame *frame)
     if (frame->getDest().isBroadcast())
     {
         EV << "Broadcasting broadcast frame " << frame << endl;
+        numBroadcastFrames++;
         broadcastFrame(frame, inputport);
         return;
     }
@@ -97,11 +104,12 @@ void MACRelayUnit::handleAndDispatchFrame(EtherFrame *frame)
     if (outputport >= 0)
     {
         EV << "Sending frame " << frame << " with dest address " << frame->getDest() << " to port " << outputport << endl;
-        send(frame, "ifOut", outputport);
+        send(frame, outputGateBaseId + outputport);
     }
     else
     {
         EV << "Dest address " << frame->getDest() << " unknown, broadcasting frame " << frame << endl;
+        numFloodedFrames++;
         broadcastFrame(frame, inputport);
     }
 
@@ -109,10 +117,12 @@ void MACRelayUnit::handleAndDispatchFrame(EtherFrame *frame)
 
 void MACRelayUnit::broadcastFrame(EtherFrame *frame, int inputport)
 {
+    int numReceivers = (inputport >= 0 && inputport < numPorts) ? numPorts - 1 : numPorts;
+    MessageFanout fanout(frame, numReceivers);
     for (int i=0; i<numPorts; ++i)
         if (i != inputport)
-            send((EtherFrame*)frame->dup(), "ifOut", i);
-    delete frame;
+            send(fanout.next(), outputGateBaseId + i);
+    numFloodCopies += numReceivers;
 }
 
 void MACRelayUnit::start()
@@ -161,4 +171,7 @@ void MACRelayUnit::finish()
 {
     recordScalar("processed frames", numProcessedFrames);
     recordScalar("discarded frames", numDiscardedFrames);
+    recordScalar("broadcast frames", numBroadcastFrames);
+    recordScalar("flooded unknown unicast frames", numFloodedFrames);
+    recordScalar("flood copies", numFloodCopies);
 }
@@ -31,10 +31,14 @@ class INET_API MACRelayUnit : public cSimpleModule, public ILifecycle
     protected:
         IMACAddressTable * addressTable;
         int numPorts;
+        int outputGateBaseId;       // gate id of ifOut[0]
 
         // Parameters for statistics collection
         long numProcessedFrames;
         long numDiscardedFrames;
+        long numBroadcastFrames;    // frames with broadcast destination
+        long numFloodedFrames;      // unicast frames flooded because the destination was unknown
+        long numFloodCopies;        // frames sent out by broadcasting and flooding
 
         bool isOperational;         // for lifecycle
 
@@ -52,6 +56,7 @@ class INET_API MACRelayUnit : public cSimpleModule, public ILifecycle
 
         /**
          * Utility function: sends the frame on all ports except inputport.
+         * The ports share the payload of the frame, see MessageFanout.
          * The message pointer should not be referenced any more after this call.
          */
         virtual void broadcastFrame(EtherFrame *frame, int inputport);
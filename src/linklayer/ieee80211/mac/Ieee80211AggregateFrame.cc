@@ -0,0 +1,98 @@
+//
+// Copyright (C) 2014 OpenSim Ltd.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "Ieee80211AggregateFrame.h"
+
+Register_Class(Ieee80211AggregateFrame);
+
+// subframes are aligned to 4 bytes
+#define AGGREGATE_PADDING(x) ((((x) + 3) >> 2) << 2)
+
+Ieee80211AggregateFrame::~Ieee80211AggregateFrame()
+{
+    clean();
+}
+
+Ieee80211AggregateFrame& Ieee80211AggregateFrame::operator=(const Ieee80211AggregateFrame& other)
+{
+    if (this == &other)
+        return *this;
+    clean();
+    Ieee80211AggregateFrame_Base::operator=(other);
+    copy(other);
+    return *this;
+}
+
+void Ieee80211AggregateFrame::copy(const Ieee80211AggregateFrame& other)
+{
+    // the length is copied by the base class, so don't use addSubframe() here
+    for (std::vector<cPacket *>::const_iterator it = other.subframes.begin(); it != other.subframes.end(); ++it)
+    {
+        cPacket *subframe = (*it)->dup();
+        take(subframe);
+        subframes.push_back(subframe);
+    }
+}
+
+void Ieee80211AggregateFrame::clean()
+{
+    for (std::vector<cPacket *>::iterator it = subframes.begin(); it != subframes.end(); ++it)
+        dropAndDelete(*it);
+    subframes.clear();
+}
+
+void Ieee80211AggregateFrame::setSubframesArraySize(unsigned int size)
+{
+    throw cRuntimeError(this, "setSubframesArraySize() not supported, use addSubframe()");
+}
+
+void Ieee80211AggregateFrame::setSubframes(unsigned int k, const cPacketPtr& subframe)
+{
+    throw cRuntimeError(this, "setSubframes() not supported, use addSubframe()");
+}
+
+cPacketPtr& Ieee80211AggregateFrame::getSubframes(unsigned int k)
+{
+    return subframes.at(k);
+}
+
+int64 Ieee80211AggregateFrame::getSubframeByteLength(const cPacket *subframe) const
+{
+    if (getBlockAck())
+        return AGGREGATE_PADDING(AMPDU_DELIMITER_BYTES + subframe->getByteLength());
+    else
+        // the MAC header is replaced by the shorter subframe header
+        return AGGREGATE_PADDING(AMSDU_SUBFRAME_HEADER_BYTES + subframe->getByteLength() - LENGTH_DATAHDR / 8);
+}
+
+void Ieee80211AggregateFrame::addSubframe(Ieee80211DataFrame *subframe)
+{
+    if (subframes.empty() && !getBlockAck())
+        setByteLength(LENGTH_DATAHDR / 8);
+    take(subframe);
+    subframes.push_back(subframe);
+    addByteLength(getSubframeByteLength(subframe));
+}
+
+Ieee80211DataFrame *Ieee80211AggregateFrame::removeSubframe(unsigned int k)
+{
+    cPacket *subframe = subframes.at(k);
+    subframes.erase(subframes.begin() + k);
+    drop(subframe);
+    addByteLength(-getSubframeByteLength(subframe));
+    return (Ieee80211DataFrame *)subframe;
+}
@@ -0,0 +1,72 @@
+//
+// Copyright (C) 2014 OpenSim Ltd.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef __INET_IEEE80211AGGREGATEFRAME_H
+#define __INET_IEEE80211AGGREGATEFRAME_H
+
+#include <vector>
+
+#include "INETDefs.h"
+
+#include "Ieee80211Frame_m.h"
+
+/**
+ * A-MPDU or A-MSDU carrying several data frames for the same receiver.
+ * More info in the Ieee80211Frame.msg file (and the documentation
+ * generated from it).
+ *
+ * The aggregate owns its subframes. The length of the aggregate is kept
+ * up to date as subframes are added or removed; setBlockAck() must be
+ * called before the first subframe is added.
+ */
+class INET_API Ieee80211AggregateFrame : public Ieee80211AggregateFrame_Base
+{
+  protected:
+    std::vector<cPacket *> subframes;
+
+  private:
+    void copy(const Ieee80211AggregateFrame& other);
+    void clean();
+
+  public:
+    Ieee80211AggregateFrame(const char *name = NULL, int kind = 0) : Ieee80211AggregateFrame_Base(name, kind) {}
+    Ieee80211AggregateFrame(const Ieee80211AggregateFrame& other) : Ieee80211AggregateFrame_Base(other) { copy(other); }
+    virtual ~Ieee80211AggregateFrame();
+    Ieee80211AggregateFrame& operator=(const Ieee80211AggregateFrame& other);
+    virtual Ieee80211AggregateFrame *dup() const { return new Ieee80211AggregateFrame(*this); }
+
+    /** Generated but unused method, should not be called. */
+    virtual void setSubframesArraySize(unsigned int size);
+    /** Generated but unused method, should not be called. */
+    virtual void setSubframes(unsigned int k, const cPacketPtr& subframe);
+    virtual unsigned int getSubframesArraySize() const { return subframes.size(); }
+    virtual cPacketPtr& getSubframes(unsigned int k);
+
+    /** Number of bytes the given frame occupies inside the aggregate, including delimiter/subheader and padding */
+    virtual int64 getSubframeByteLength(const cPacket *subframe) const;
+
+    /** Appends a data frame; the aggregate takes ownership and grows accordingly */
+    virtual void addSubframe(Ieee80211DataFrame *subframe);
+
+    /** Removes and returns the kth subframe; the caller takes ownership */
+    virtual Ieee80211DataFrame *removeSubframe(unsigned int k);
+
+    unsigned int getNumSubframes() const { return subframes.size(); }
+    Ieee80211DataFrame *getSubframe(unsigned int k) const { return (Ieee80211DataFrame *)subframes.at(k); }
+};
+
+#endif
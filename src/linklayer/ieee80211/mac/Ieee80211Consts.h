@@ -22,11 +22,19 @@
 const unsigned int LENGTH_RTS = 160; //bits
 const unsigned int LENGTH_CTS = 112; //bits
 const unsigned int LENGTH_ACK = 112; //bits
+const unsigned int LENGTH_BLOCKACK = 32 * 8; //bits, compressed bitmap
 const unsigned int LENGTH_MGMT = 28 * 8; //bits
 const unsigned int LENGTH_DATAHDR = 34 * 8; //bits
 
 const unsigned int SNAP_HEADER_BYTES = 8;
 
+// frame aggregation overhead per subframe, in bytes; subframes are padded to 4 bytes
+const unsigned int AMPDU_DELIMITER_BYTES = 4;
+const unsigned int AMSDU_SUBFRAME_HEADER_BYTES = 14;
+
+/** Max number of frames acknowledged by a compressed Block ACK */
+const int MAX_BLOCKACK_FRAMES = 64;
+
 // time slot ST, short interframe space SIFS, distributed interframe
 // space DIFS, and extended interframe space EIFS
 
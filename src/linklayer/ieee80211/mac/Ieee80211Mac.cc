@@ -18,6 +18,7 @@
 //
 
 #include "Ieee80211Mac.h"
+#include "Ieee80211MinstrelRateControl.h"
 #include "RadioState.h"
 #include "IInterfaceTable.h"
 #include "InterfaceTableAccess.h"
@@ -66,6 +67,8 @@ Ieee80211Mac::Ieee80211Mac()
     mediumStateChange = NULL;
     pendingRadioConfigMsg = NULL;
     classifier = NULL;
+    rateControl = NULL;
+    recordStationStatistics = false;
 }
 
 Ieee80211Mac::~Ieee80211Mac()
@@ -97,6 +100,7 @@ Ieee80211Mac::~Ieee80211Mac()
     edcCAFOutVector.clear();
     if (pendingRadioConfigMsg)
         delete pendingRadioConfigMsg;
+    delete rateControl;
 }
 
 /****************************************************************
@@ -123,6 +127,7 @@ void Ieee80211Mac::initialize(int stage)
             catEdca.backoff = false;
             catEdca.backoffPeriod = -1;
             catEdca.retryCounter = 0;
+            catEdca.aggregation = AGGREGATION_NONE;
             edcCAF.push_back(catEdca);
         }
         // initialize parameters
@@ -197,6 +202,27 @@ void Ieee80211Mac::initialize(int stage)
         if (numCategories()==1)
             AIFSN(0) = par("AIFSN");
 
+        std::vector<std::string> aggregation = cStringTokenizer(par("aggregation").stringValue()).asVector();
+        if (aggregation.size() != 1 && (int)aggregation.size() < numCategories())
+            throw cRuntimeError("The aggregation parameter must contain one value, or one value for each access category");
+        for (int i = 0; i < numCategories(); i++)
+        {
+            const std::string& mode = aggregation.size() == 1 ? aggregation[0] : aggregation[i];
+            if (mode == "none")
+                edcCAF[i].aggregation = AGGREGATION_NONE;
+            else if (mode == "amsdu")
+                edcCAF[i].aggregation = AGGREGATION_AMSDU;
+            else if (mode == "ampdu")
+                edcCAF[i].aggregation = AGGREGATION_AMPDU;
+            else
+                throw cRuntimeError("Invalid aggregation mode '%s' for AC %d, must be none, amsdu or ampdu", mode.c_str(), i);
+        }
+        maxAggregateSubframes = par("maxAggregateSubframes");
+        if (maxAggregateSubframes < 1 || maxAggregateSubframes > MAX_BLOCKACK_FRAMES)
+            throw cRuntimeError("maxAggregateSubframes must be between 1 and %d", MAX_BLOCKACK_FRAMES);
+        maxAMsduLength = par("maxAMsduLength");
+        maxAMpduLength = par("maxAMpduLength");
+
         for (int i = 0; i < numCategories(); i++)
         {
             ASSERT(AIFSN(i) >= 0 && AIFSN(i) < 16);
@@ -348,6 +374,10 @@ void Ieee80211Mac::initialize(int stage)
         numSentTXOP = 0;
         numReceivedOther = 0;
         numAckSend = 0;
+        numAggregates = 0;
+        numAggregatedFrames = 0;
+        numSubframeErrors = 0;
+        numDuplicatedSubframes = 0;
         successCounter = 0;
         failedCounter = 0;
         recovery = 0;
@@ -424,11 +454,14 @@ void Ieee80211Mac::initWatches()
          WATCH(edcCAF[i].numDropped);
      if (throughputTimer)
          WATCH(throughputLastPeriod);
+     if (recordStationStatistics)
+         createStdMapWatcher("stationStatistics", stationStatistics.getStationStatistics());
 }
 
 void Ieee80211Mac::configureAutoBitRate()
 {
     forceBitRate = par("forceBitRate");
+    recordStationStatistics = par("recordStationStatistics");
     minSuccessThreshold = par("minSuccessThreshold");
     minTimerTimeout = par("minTimerTimeout");
     timerTimeout = par("timerTimeout");
@@ -451,14 +484,34 @@ void Ieee80211Mac::configureAutoBitRate()
         maxSuccessThreshold = par("maxSuccessThreshold");
         EV<<"MAC Transmission algorithm : AARF Rate"  <<endl;
         break;
+    case 3:
+        rateControlMode = RATE_MINSTREL;
+        EV<<"MAC Transmission algorithm : Minstrel Rate"  <<endl;
+        break;
     default:
         throw cRuntimeError("Invalid autoBitrate parameter: '%d'", autoBitrate);
         break;
     }
+
+    delete rateControl;
+    rateControl = NULL;
+    if (rateControlMode == RATE_MINSTREL)
+        rateControl = new Ieee80211MinstrelRateControl(par("minstrelUpdateInterval").doubleValue(),
+                par("minstrelEwmaWeight").doubleValue(), par("minstrelLookaroundRate").doubleValue());
+    else if (par("perStationRateControl").boolValue() && (rateControlMode == RATE_ARF || rateControlMode == RATE_AARF))
+        rateControl = new Ieee80211AarfRateControl(rateControlMode == RATE_AARF, minTimerTimeout, minSuccessThreshold,
+                par("maxSuccessThreshold").longValue(), par("successCoeff").doubleValue(), par("timerCoeff").doubleValue());
+    if (rateControl)
+    {
+        EV<<"MAC Transmission algorithm keeps separate state per receiver"  <<endl;
+        rateControl->initialize(this, opMode, rateIndex);
+    }
 }
 
 void Ieee80211Mac::finish()
 {
+    if (recordStationStatistics)
+        stationStatistics.recordStatistics(this);
     recordScalar("number of received packets", numReceived);
     recordScalar("number of collisions", numCollision);
     recordScalar("number of internal collisions", numInternalCollision);
@@ -499,6 +552,17 @@ void Ieee80211Mac::finish()
         std::string th = "numDropped AC "+os.str();
         recordScalar(th.c_str(), numDropped(i));
     }
+    for (int i=0; i<numCategories(); i++)
+    {
+        if (edcCAF[i].aggregation != AGGREGATION_NONE)
+        {
+            recordScalar("number of aggregates sent", numAggregates);
+            recordScalar("number of aggregated frames", numAggregatedFrames);
+            recordScalar("number of subframes received with errors", numSubframeErrors);
+            recordScalar("number of duplicated subframes received", numDuplicatedSubframes);
+            break;
+        }
+    }
 }
 
 InterfaceEntry *Ieee80211Mac::createInterfaceEntry()
@@ -1172,6 +1236,38 @@ void Ieee80211Mac::handleWithFSM(cMessage *msg)
                                   if (endTXOP->isScheduled()) cancelEvent(endTXOP);
                                  );
 #endif
+            FSMA_Event_Transition(Receive-BlockAck,
+                                  isLowerMsg(msg) && isForUs(frame) && isExpectedBlockAck(frame) && getNumUnacknowledgedSubframes(frame) == 0,
+                                  DEFER,
+                                  currentAC = oldcurrentAC;
+                                  processBlockAck(frame);
+                                  cancelTimeoutPeriod();
+                                  popTransmissionQueue();
+                                  resetStateVariables();
+                                  resetCurrentBackOff();
+                                  txop = false;
+                                  if (endTXOP->isScheduled()) cancelEvent(endTXOP);
+                                  );
+            FSMA_Event_Transition(Receive-BlockAck-Failed,
+                                  isLowerMsg(msg) && isForUs(frame) && isExpectedBlockAck(frame) && retryCounter(oldcurrentAC) == transmissionLimit - 1,
+                                  IDLE,
+                                  currentAC = oldcurrentAC;
+                                  processBlockAck(frame);
+                                  cancelTimeoutPeriod();
+                                  giveUpCurrentTransmission();
+                                  txop = false;
+                                  if (endTXOP->isScheduled()) cancelEvent(endTXOP);
+                                  );
+            FSMA_Event_Transition(Receive-BlockAck-Partial,
+                                  isLowerMsg(msg) && isForUs(frame) && isExpectedBlockAck(frame),
+                                  DEFER,
+                                  currentAC = oldcurrentAC;
+                                  processBlockAck(frame);
+                                  cancelTimeoutPeriod();
+                                  retryCurrentTransmission();
+                                  txop = false;
+                                  if (endTXOP->isScheduled()) cancelEvent(endTXOP);
+                                  );
             FSMA_Event_Transition(Receive-ACK-TXOP-Empty,
                                   isLowerMsg(msg) && isForUs(frame) && frameType == ST_ACK && txop && transmissionQueue(oldcurrentAC)->size() == 1,
                                   DEFER,
@@ -1378,6 +1474,12 @@ void Ieee80211Mac::handleWithFSM(cMessage *msg)
                                   sendDataFrameOnEndSIFS(getCurrentTransmission());
                                   oldcurrentAC = currentAC;
                                  );
+            FSMA_Event_Transition(Transmit-BlockAck,
+                                  msg == endSIFS && isBlockAckRequested(getFrameReceivedBeforeSIFS()),
+                                  IDLE,
+                                  sendBlockAckFrameOnEndSIFS();
+                                  finishReception();
+                                  );
             FSMA_Event_Transition(Transmit-ACK,
                                   msg == endSIFS && isDataOrMgmtFrame(getFrameReceivedBeforeSIFS()),
                                   IDLE,
@@ -1402,6 +1504,12 @@ void Ieee80211Mac::handleWithFSM(cMessage *msg)
                                      numReceivedMulticast++;
                                      finishReception();
                                      );
+            FSMA_No_Event_Transition(Immediate-Receive-Aggregate,
+                                     isLowerMsg(msg) && isForUs(frame) && dynamic_cast<Ieee80211AggregateFrame *>(frame),
+                                     WAITSIFS,
+                                     sendUpAggregate(check_and_cast<Ieee80211AggregateFrame *>(frame));
+                                     numReceived++;
+                                    );
             FSMA_No_Event_Transition(Immediate-Receive-Data,
                                      isLowerMsg(msg) && isForUs(frame) && isDataOrMgmtFrame(frame),
                                      WAITSIFS,
@@ -1663,7 +1771,7 @@ void Ieee80211Mac::scheduleDataTimeoutPeriod(Ieee80211DataOrMgmtFrame *frameToSe
             tim = duration + slot + sifs + PHY_RX_START;
         }
         else
-            tim = computeFrameDuration(frameToSend) + SIMTIME_DBL( getSlotTime()) +SIMTIME_DBL( getSIFS()) + controlFrameTxTime(LENGTH_ACK) + MAX_PROPAGATION_DELAY * 2;
+            tim = computeFrameDuration(frameToSend) + SIMTIME_DBL( getSlotTime()) +SIMTIME_DBL( getSIFS()) + controlFrameTxTime(getAckFrameLength(frameToSend)) + MAX_PROPAGATION_DELAY * 2;
         EV<<" time out="<<tim*1e6<<"us"<<endl;
         scheduleAt(simTime() + tim, endTimeout);
     }
@@ -1808,6 +1916,7 @@ void Ieee80211Mac::sendDataFrame(Ieee80211DataOrMgmtFrame *frameToSend)
     int count = 0;
     std::list<Ieee80211DataOrMgmtFrame*>::iterator frame;
 
+    frameToSend = aggregateCurrentTransmission();
     frame = transmissionQueue()->begin();
     ASSERT(*frame==frameToSend);
     if (!txop && TXOP() > 0 && transmissionQueue()->size() >= 2 )
@@ -1841,6 +1950,7 @@ void Ieee80211Mac::sendDataFrame(Ieee80211DataOrMgmtFrame *frameToSend)
 
 void Ieee80211Mac::sendRTSFrame(Ieee80211DataOrMgmtFrame *frameToSend)
 {
+    frameToSend = aggregateCurrentTransmission();
     EV << "sending RTS frame\n";
     sendDown(setControlBitrate(buildRTSFrame(frameToSend)));
 }
@@ -1853,6 +1963,16 @@ void Ieee80211Mac::sendMulticastFrame(Ieee80211DataOrMgmtFrame *frameToSend)
     sendDown(buildDataFrame(dynamic_cast<Ieee80211DataOrMgmtFrame*>(setBasicBitrate(frameToSend))));
 }
 
+void Ieee80211Mac::sendBlockAckFrameOnEndSIFS()
+{
+    Ieee80211Frame *aggregate = (Ieee80211Frame *)endSIFS->getContextPointer();
+    endSIFS->setContextPointer(NULL);
+    EV << "sending Block ACK frame\n";
+    numAckSend++;
+    sendDown(setControlBitrate(buildBlockAckFrame(check_and_cast<Ieee80211AggregateFrame *>(aggregate))));
+    delete aggregate;
+}
+
 void Ieee80211Mac::sendCTSFrameOnEndSIFS()
 {
     Ieee80211Frame *rtsFrame = (Ieee80211Frame *)endSIFS->getContextPointer();
@@ -1906,7 +2026,7 @@ Ieee80211DataOrMgmtFrame *Ieee80211Mac::buildDataFrame(Ieee80211DataOrMgmtFrame
                                + computeFrameDuration(size,bitRate));
         }
         else
-            frame->setDuration(getSIFS() + controlFrameTxTime(LENGTH_ACK));
+            frame->setDuration(getSIFS() + controlFrameTxTime(getAckFrameLength(frameToSend)));
     }
     else
         // FIXME: shouldn't we use the next frame to be sent?
@@ -1935,7 +2055,7 @@ Ieee80211RTSFrame *Ieee80211Mac::buildRTSFrame(Ieee80211DataOrMgmtFrame *frameTo
     frame->setReceiverAddress(frameToSend->getReceiverAddress());
     frame->setDuration(3 * getSIFS() + controlFrameTxTime(LENGTH_CTS) +
                        computeFrameDuration(frameToSend) +
-                       controlFrameTxTime(LENGTH_ACK));
+                       controlFrameTxTime(getAckFrameLength(frameToSend)));
 
     return frame;
 }
@@ -1967,6 +2087,18 @@ Ieee80211DataOrMgmtFrame *Ieee80211Mac::buildMulticastFrame(Ieee80211DataOrMgmtF
     return frame;
 }
 
+Ieee80211BlockAckFrame *Ieee80211Mac::buildBlockAckFrame(Ieee80211AggregateFrame *aggregate)
+{
+    Ieee80211BlockAckFrame *frame = new Ieee80211BlockAckFrame("wlan-blockack");
+    frame->setReceiverAddress(aggregate->getTransmitterAddress());
+    frame->setTransmitterAddress(address);
+    frame->setStartingSequenceNumber(aggregate->getSequenceNumber());
+    frame->setBitmap(aggregate->getReceivedBitmap());
+    frame->setDuration(0);
+
+    return frame;
+}
+
 Ieee80211Frame *Ieee80211Mac::setBasicBitrate(Ieee80211Frame *frame)
 {
     ASSERT(frame->getControlInfo()==NULL);
@@ -1987,6 +2119,22 @@ Ieee80211Frame *Ieee80211Mac::setControlBitrate(Ieee80211Frame *frame)
 
 Ieee80211Frame *Ieee80211Mac::setBitrateFrame(Ieee80211Frame *frame)
 {
+    if (rateControl && !isMulticast(frame))
+    {
+        PhyControlInfo *ctrl = dynamic_cast<PhyControlInfo*>(frame->getControlInfo());
+        if (ctrl == NULL)
+        {
+            delete frame->removeControlInfo();
+            ctrl = new PhyControlInfo();
+            frame->setControlInfo(ctrl);
+        }
+        ctrl->setBitrate(rateControl->getBitrate(frame->getReceiverAddress(), retryCounter()));
+        if (recordStationStatistics)
+            stationStatistics.attemptStarted(frame->getReceiverAddress(), ctrl->getBitrate());
+        return frame;
+    }
+    if (recordStationStatistics && !isMulticast(frame))
+        stationStatistics.attemptStarted(frame->getReceiverAddress(), getBitrate());
     if (rateControlMode == RATE_CR && forceBitRate == false)
     {
         if (frame->getControlInfo())
@@ -2012,6 +2160,14 @@ Ieee80211Frame *Ieee80211Mac::setBitrateFrame(Ieee80211Frame *frame)
  */
 void Ieee80211Mac::finishCurrentTransmission()
 {
+    Ieee80211DataOrMgmtFrame *temp = getCurrentTransmission();
+    if (temp && !isMulticast(temp))
+    {
+        if (rateControl)
+            rateControl->reportDataOk(temp->getReceiverAddress(), retryCounter());
+        if (recordStationStatistics)
+            stationStatistics.frameSent(temp->getReceiverAddress(), temp->getBitLength());
+    }
     popTransmissionQueue();
     resetStateVariables();
 }
@@ -2019,7 +2175,19 @@ void Ieee80211Mac::finishCurrentTransmission()
 void Ieee80211Mac::giveUpCurrentTransmission()
 {
     Ieee80211DataOrMgmtFrame *temp = (Ieee80211DataOrMgmtFrame*) transmissionQueue()->front();
-    nb->fireChangeNotification(NF_LINK_BREAK, temp);
+    if (rateControl)
+        rateControl->reportGiveUp(temp->getReceiverAddress(), retryCounter());
+    if (recordStationStatistics)
+        stationStatistics.frameGivenUp(temp->getReceiverAddress());
+    Ieee80211AggregateFrame *aggregate = dynamic_cast<Ieee80211AggregateFrame *>(temp);
+    if (aggregate)
+    {
+        // listeners expect the frames as they were received from the upper layer
+        for (unsigned int i = 0; i < aggregate->getNumSubframes(); i++)
+            nb->fireChangeNotification(NF_LINK_BREAK, aggregate->getSubframe(i));
+    }
+    else
+        nb->fireChangeNotification(NF_LINK_BREAK, temp);
     popTransmissionQueue();
     resetStateVariables();
     numGivenUp()++;
@@ -2029,7 +2197,14 @@ void Ieee80211Mac::retryCurrentTransmission()
 {
     ASSERT(retryCounter() < transmissionLimit - 1);
     getCurrentTransmission()->setRetry(true);
-    if (rateControlMode == RATE_AARF || rateControlMode == RATE_ARF)
+    if (recordStationStatistics)
+        stationStatistics.frameRetried(getCurrentTransmission()->getReceiverAddress());
+    if (rateControl)
+    {
+        rateControl->reportDataFailed(getCurrentTransmission()->getReceiverAddress(), retryCounter());
+        retryCounter() ++;
+    }
+    else if (rateControlMode == RATE_AARF || rateControlMode == RATE_ARF)
         reportDataFailed();
     else
         retryCounter() ++;
@@ -2063,7 +2238,7 @@ void Ieee80211Mac::setMode(Mode mode)
 void Ieee80211Mac::resetStateVariables()
 {
     backoffPeriod() = SIMTIME_ZERO;
-    if (rateControlMode == RATE_AARF || rateControlMode == RATE_ARF)
+    if (!rateControl && (rateControlMode == RATE_AARF || rateControlMode == RATE_ARF))
         reportDataOk();
     else
         retryCounter() = 0;
@@ -2159,6 +2334,247 @@ void Ieee80211Mac::popTransmissionQueue()
     delete temp;
 }
 
+bool Ieee80211Mac::isAggregatable(Ieee80211DataOrMgmtFrame *frame)
+{
+    return dynamic_cast<Ieee80211DataFrame *>(frame) && !dynamic_cast<Ieee80211AggregateFrame *>(frame)
+            && !isMulticast(frame) && !frame->getMoreFragments();
+}
+
+bool Ieee80211Mac::isBlockAckRequested(Ieee80211Frame *frame)
+{
+    Ieee80211AggregateFrame *aggregate = dynamic_cast<Ieee80211AggregateFrame *>(frame);
+    return aggregate && aggregate->getBlockAck();
+}
+
+int Ieee80211Mac::getAckFrameLength(Ieee80211Frame *frame)
+{
+    return isBlockAckRequested(frame) ? LENGTH_BLOCKACK : LENGTH_ACK;
+}
+
+Ieee80211DataOrMgmtFrame *Ieee80211Mac::aggregateCurrentTransmission()
+{
+    Ieee80211DataOrMgmtFrame *first = getCurrentTransmission();
+    int aggregation = edcCAF[currentAC].aggregation;
+    if (aggregation == AGGREGATION_NONE || !first || !isAggregatable(first))
+        return first;
+
+    bool blockAck = aggregation == AGGREGATION_AMPDU;
+    Ieee80211AggregateFrame *aggregate = new Ieee80211AggregateFrame(blockAck ? "wlan-ampdu" : "wlan-amsdu");
+    aggregate->setBlockAck(blockAck);
+    int64 maxLength = blockAck ? maxAMpduLength : maxAMsduLength;
+    int64 length = blockAck ? 0 : LENGTH_DATAHDR / 8;
+
+    // collect the frames for the same receiver; frames for other receivers are
+    // skipped, but nothing is moved ahead of a management frame
+    Ieee80211DataOrMgmtFrameList *queue = transmissionQueue();
+    std::vector<Ieee80211DataOrMgmtFrameList::iterator> selected;
+    for (Ieee80211DataOrMgmtFrameList::iterator it = queue->begin(); it != queue->end() && (int)selected.size() < maxAggregateSubframes; ++it)
+    {
+        Ieee80211DataOrMgmtFrame *frame = *it;
+        if (!dynamic_cast<Ieee80211DataFrame *>(frame))
+            break;
+        if (!isAggregatable(frame) || frame->getReceiverAddress() != first->getReceiverAddress())
+            continue;
+        // the Block ACK bitmap covers a limited range of sequence numbers
+        if (blockAck && (frame->getSequenceNumber() - first->getSequenceNumber() + 4096) % 4096 >= MAX_BLOCKACK_FRAMES)
+            continue;
+        int64 subframeLength = aggregate->getSubframeByteLength(frame);
+        if (!selected.empty() && length + subframeLength > maxLength)
+            break;
+        length += subframeLength;
+        selected.push_back(it);
+    }
+    if (selected.size() < 2)
+    {
+        delete aggregate;
+        return first;
+    }
+
+    aggregate->setTransmitterAddress(first->getTransmitterAddress());
+    aggregate->setReceiverAddress(first->getReceiverAddress());
+    aggregate->setAddress3(first->getAddress3());
+    aggregate->setToDS(first->getToDS());
+    aggregate->setFromDS(first->getFromDS());
+    aggregate->setSequenceNumber(first->getSequenceNumber());
+    aggregate->setMACArrive(first->getMACArrive());
+    if (first->getControlInfo())
+        aggregate->setControlInfo(first->removeControlInfo());
+
+    int queueSize = transmissionQueueSize();
+    for (unsigned int i = 0; i < selected.size(); i++)
+    {
+        Ieee80211DataOrMgmtFrame *frame = *selected[i];
+        queue->erase(selected[i]);
+        delete frame->removeControlInfo();
+        frame->setRetry(false);
+        aggregate->addSubframe(check_and_cast<Ieee80211DataFrame *>(frame));
+    }
+    queue->push_front(aggregate);
+    numAggregates++;
+    numAggregatedFrames += selected.size();
+    EV << "aggregated " << selected.size() << " frames for " << aggregate->getReceiverAddress()
+       << " into " << aggregate->getName() << " of " << aggregate->getByteLength() << " bytes\n";
+
+    // refill the freed slots of the queue
+    if (queueModule)
+    {
+        if (numCategories() == 1)
+        {
+            // one frame is requested for each frame taken, see popTransmissionQueue()
+            for (unsigned int i = 1; i < selected.size(); i++)
+                queueModule->requestPacket();
+        }
+        else if (queueSize == maxQueueSize)
+        {
+            // no frame is requested while the queue is full; handleUpperMsg()
+            // requests the next one as long as there is a free slot
+            queueModule->requestPacket();
+        }
+    }
+    return aggregate;
+}
+
+void Ieee80211Mac::sendUpAggregate(Ieee80211AggregateFrame *aggregate)
+{
+    uint64 receivedBitmap = 0;
+    while (aggregate->getNumSubframes() > 0)
+    {
+        Ieee80211DataFrame *subframe = aggregate->removeSubframe(0);
+        if (subframe->hasBitError())
+        {
+            EV << "subframe " << subframe << " contains bit errors, dropping it\n";
+            numSubframeErrors++;
+            delete subframe;
+            continue;
+        }
+        int offset = (subframe->getSequenceNumber() - aggregate->getSequenceNumber() + 4096) % 4096;
+        if (offset < MAX_BLOCKACK_FRAMES)
+            receivedBitmap |= (uint64)1 << offset;
+        if (isDuplicatedSubframe(subframe, aggregate->getRetry()))
+        {
+            // received before, but its Block ACK was lost: acknowledge it again
+            EV << "subframe " << subframe << " was already received, dropping it\n";
+            numDuplicatedSubframes++;
+            delete subframe;
+            continue;
+        }
+        sendUp(subframe);
+        // duplicates are not sent up
+        if (subframe->getOwner() == this)
+            delete subframe;
+    }
+    aggregate->setReceivedBitmap(receivedBitmap);
+}
+
+bool Ieee80211Mac::isDuplicatedSubframe(Ieee80211DataFrame *subframe, bool retry)
+{
+    if (!duplicateDetect)
+        return false;
+
+    int sequenceNumber = subframe->getSequenceNumber();
+    ReceiveWindowMap::iterator it = receiveWindows.find(subframe->getTransmitterAddress());
+    if (it == receiveWindows.end())
+    {
+        ReceiveWindow window;
+        window.startSequenceNumber = sequenceNumber;
+        window.bitmap = 1;
+        receiveWindows[subframe->getTransmitterAddress()] = window;
+        return false;
+    }
+
+    ReceiveWindow& window = it->second;
+    int offset = (sequenceNumber - window.startSequenceNumber + 4096) % 4096;
+    if (offset >= 2048)
+    {
+        // behind the window: a retransmission of an old subframe, or the
+        // transmitter sent many frames to other stations in the meantime
+        if (retry)
+            return true;
+        window.startSequenceNumber = sequenceNumber;
+        window.bitmap = 0;
+        offset = 0;
+    }
+    else if (offset >= MAX_BLOCKACK_FRAMES)
+    {
+        // move the window forward so that it ends with this sequence number
+        int shift = offset - MAX_BLOCKACK_FRAMES + 1;
+        window.bitmap = shift >= MAX_BLOCKACK_FRAMES ? 0 : window.bitmap >> shift;
+        window.startSequenceNumber = (window.startSequenceNumber + shift) % 4096;
+        offset -= shift;
+    }
+    uint64 bit = (uint64)1 << offset;
+    bool received = (window.bitmap & bit) != 0;
+    window.bitmap |= bit;
+    // subframes of a first transmission are always new
+    return retry && received;
+}
+
+bool Ieee80211Mac::isExpectedBlockAck(Ieee80211Frame *frame)
+{
+    // a late or stray Block ACK is handled like any other unexpected frame
+    Ieee80211BlockAckFrame *blockAck = dynamic_cast<Ieee80211BlockAckFrame *>(frame);
+    if (!blockAck || transmissionQueue(oldcurrentAC)->empty())
+        return false;
+    Ieee80211AggregateFrame *aggregate = dynamic_cast<Ieee80211AggregateFrame *>(transmissionQueue(oldcurrentAC)->front());
+    return aggregate && aggregate->getBlockAck() && aggregate->getReceiverAddress() == blockAck->getTransmitterAddress();
+}
+
+static bool isAcknowledged(Ieee80211BlockAckFrame *blockAck, Ieee80211DataFrame *subframe)
+{
+    int offset = (subframe->getSequenceNumber() - blockAck->getStartingSequenceNumber() + 4096) % 4096;
+    return offset < MAX_BLOCKACK_FRAMES && (blockAck->getBitmap() & ((uint64)1 << offset)) != 0;
+}
+
+int Ieee80211Mac::getNumUnacknowledgedSubframes(Ieee80211Frame *frame)
+{
+    if (!isExpectedBlockAck(frame))
+        return -1;
+    Ieee80211BlockAckFrame *blockAck = static_cast<Ieee80211BlockAckFrame *>(frame);
+    Ieee80211AggregateFrame *aggregate = static_cast<Ieee80211AggregateFrame *>(transmissionQueue(oldcurrentAC)->front());
+    int count = 0;
+    for (unsigned int i = 0; i < aggregate->getNumSubframes(); i++)
+        if (!isAcknowledged(blockAck, aggregate->getSubframe(i)))
+            count++;
+    return count;
+}
+
+void Ieee80211Mac::processBlockAck(Ieee80211Frame *frame)
+{
+    Ieee80211BlockAckFrame *blockAck = check_and_cast<Ieee80211BlockAckFrame *>(frame);
+    Ieee80211AggregateFrame *aggregate = check_and_cast<Ieee80211AggregateFrame *>(getCurrentTransmission());
+    int64 ackedBits = 0;
+    for (unsigned int i = 0; i < aggregate->getNumSubframes(); )
+    {
+        if (!isAcknowledged(blockAck, aggregate->getSubframe(i)))
+        {
+            i++;
+            continue;
+        }
+        Ieee80211DataFrame *subframe = aggregate->removeSubframe(i);
+        simtime_t delay = simTime() - subframe->getMACArrive();
+        if (retryCounter() == 0)
+            numSentWithoutRetry()++;
+        numSent()++;
+        ackedBits += subframe->getBitLength();
+        macDelay()->record(delay);
+        if (maxJitter() == SIMTIME_ZERO || maxJitter() < delay)
+            maxJitter() = delay;
+        if (minJitter() == SIMTIME_ZERO || minJitter() > delay)
+            minJitter() = delay;
+        delete subframe;
+    }
+    numBits += ackedBits;
+    bits() += ackedBits;
+    EV << "Block ACK acknowledged " << ackedBits << " bits, " << aggregate->getNumSubframes() << " subframes left\n";
+    if (ackedBits > 0)
+    {
+        if (rateControl)
+            rateControl->reportDataOk(aggregate->getReceiverAddress(), retryCounter());
+        if (recordStationStatistics)
+            stationStatistics.frameSent(aggregate->getReceiverAddress(), ackedBits);
+    }
+}
+
 double Ieee80211Mac::computeFrameDuration(Ieee80211Frame *msg)
 {
 
@@ -2812,6 +3228,14 @@ bool Ieee80211Mac::isDuplicated(cMessage *msg)
 
 void Ieee80211Mac::promiscousFrame(cMessage *msg)
 {
+    Ieee80211AggregateFrame *aggregate = dynamic_cast<Ieee80211AggregateFrame *>(msg);
+    if (aggregate)
+    {
+        for (unsigned int i = 0; i < aggregate->getNumSubframes(); i++)
+            if (!aggregate->getSubframe(i)->hasBitError())
+                promiscousFrame(aggregate->getSubframe(i));
+        return;
+    }
     if (!isDuplicated(msg)) // duplicate detection filter
         nb->fireChangeNotification(NF_LINK_PROMISCUOUS, msg);
 }
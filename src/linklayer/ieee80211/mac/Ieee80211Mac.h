@@ -29,11 +29,14 @@
 #include "WirelessMacBase.h"
 #include "IPassiveQueue.h"
 #include "Ieee80211Frame_m.h"
+#include "Ieee80211AggregateFrame.h"
 #include "Ieee80211Consts.h"
 #include "NotificationBoard.h"
 #include "RadioState.h"
 #include "FSMA.h"
 #include "IQoSClassifier.h"
+#include "Ieee80211RateControl.h"
+#include "Ieee80211StationStatistics.h"
 
 /**
  * IEEE 802.11g with e Media Access Control Layer.
@@ -80,13 +83,35 @@ class INET_API Ieee80211Mac : public WirelessMacBase
 
     typedef std::map<MACAddress, Ieee80211ASFTuple> Ieee80211ASFTupleList;
 
+    /**
+     * Receive scoreboard of A-MPDU subframes from one transmitter: which
+     * sequence numbers of the Block ACK window were already received.
+     * The transmitter numbers all of its frames with a single counter, so
+     * there is one window per transmitter rather than per TID.
+     */
+    struct ReceiveWindow
+    {
+        int startSequenceNumber;
+        uint64 bitmap;      // bit i: startSequenceNumber+i was received
+    };
+
+    typedef std::map<MACAddress, ReceiveWindow> ReceiveWindowMap;
+
     enum
     {
         RATE_ARF,   // Auto Rate Fallback
         RATE_AARF,  // Adaptatice ARF
         RATE_CR,    // Constant Rate
+        RATE_MINSTREL, // Minstrel, per receiver
     } rateControlMode;
 
+    enum
+    {
+        AGGREGATION_NONE,
+        AGGREGATION_AMSDU, // A-MSDU, acknowledged as a whole
+        AGGREGATION_AMPDU, // A-MPDU with Block ACK
+    };
+
     WifiPreamble wifiPreambleType;
     ModulationType recFrameModulationType;
     bool validRecMode;
@@ -129,6 +154,11 @@ class INET_API Ieee80211Mac : public WirelessMacBase
     int minTimerTimeout;
     double successCoeff;
     double timerCoeff;
+    /** Per-receiver rate adaptation; NULL if the MAC-wide ARF/AARF/CR state above is used */
+    Ieee80211RateControl *rateControl;
+    /** Per-receiver transmission statistics, updated with any rate control if recordStationStatistics is set */
+    bool recordStationStatistics;
+    Ieee80211StationStatistics stationStatistics;
     double _snr;
     double snr;
     double lossRate;
@@ -181,6 +211,13 @@ class INET_API Ieee80211Mac : public WirelessMacBase
     /** Contention window size for multicast messages. */
     int cwMinMulticast;
 
+    /** Max number of frames packed into one aggregate */
+    int maxAggregateSubframes;
+
+    /** Max length of an A-MSDU and an A-MPDU in bytes */
+    int maxAMsduLength;
+    int maxAMpduLength;
+
     /** Messages longer than this threshold will be sent in multiple fragments. see spec 361 */
     static const int fragmentationThreshold = 2346;
     //@}
@@ -216,6 +253,7 @@ class INET_API Ieee80211Mac : public WirelessMacBase
         int AIFSN; // Arbitration interframe space number. The duration edcCAF[AC].AIFSis a duration derived from the value AIFSN[AC] by the relation
         int cwMax;
         int cwMin;
+        int aggregation; // AGGREGATION_NONE, AGGREGATION_AMSDU or AGGREGATION_AMPDU
         // queue
         Ieee80211DataOrMgmtFrameList transmissionQueue;
         // per class timers
@@ -355,6 +393,7 @@ class INET_API Ieee80211Mac : public WirelessMacBase
     simtime_t duplicateTimeOut;
     simtime_t lastTimeDelete;
     Ieee80211ASFTupleList asfTuplesList;
+    ReceiveWindowMap receiveWindows;
 
     /** Passive queue module to request messages from */
     IPassiveQueue *queueModule;
@@ -411,6 +450,10 @@ class INET_API Ieee80211Mac : public WirelessMacBase
     // long numDropped[4];
     long numReceivedOther;
     long numAckSend;
+    long numAggregates;
+    long numAggregatedFrames;
+    long numSubframeErrors;
+    long numDuplicatedSubframes;
     cOutVector stateVector;
     simtime_t  last;
     // long bits[4];
@@ -537,6 +580,7 @@ class INET_API Ieee80211Mac : public WirelessMacBase
     virtual void sendDataFrameOnEndSIFS(Ieee80211DataOrMgmtFrame *frameToSend);
     virtual void sendDataFrame(Ieee80211DataOrMgmtFrame *frameToSend);
     virtual void sendMulticastFrame(Ieee80211DataOrMgmtFrame *frameToSend);
+    virtual void sendBlockAckFrameOnEndSIFS();
     //@}
 
   protected:
@@ -549,6 +593,7 @@ class INET_API Ieee80211Mac : public WirelessMacBase
     virtual Ieee80211RTSFrame *buildRTSFrame(Ieee80211DataOrMgmtFrame *frameToSend);
     virtual Ieee80211CTSFrame *buildCTSFrame(Ieee80211RTSFrame *rtsFrame);
     virtual Ieee80211DataOrMgmtFrame *buildMulticastFrame(Ieee80211DataOrMgmtFrame *frameToSend);
+    virtual Ieee80211BlockAckFrame *buildBlockAckFrame(Ieee80211AggregateFrame *aggregate);
     //@}
 
     /**
@@ -614,6 +659,45 @@ class INET_API Ieee80211Mac : public WirelessMacBase
     /** @brief Deletes frame at the front of queue. */
     virtual void popTransmissionQueue();
 
+    /**
+     * @name Frame aggregation functions
+     */
+    //@{
+    /** @brief Returns true if the frame may be packed into an aggregate */
+    virtual bool isAggregatable(Ieee80211DataOrMgmtFrame *frame);
+
+    /** @brief Returns true if the frame is an aggregate that must be answered with a Block ACK */
+    virtual bool isBlockAckRequested(Ieee80211Frame *frame);
+
+    /** @brief Length of the frame that acknowledges the given one (ACK or Block ACK) */
+    virtual int getAckFrameLength(Ieee80211Frame *frame);
+
+    /**
+     * @brief Packs the frame at the front of the current queue and the following
+     * frames for the same receiver into an aggregate if aggregation is enabled
+     * for the current AC. Returns the frame at the front of the queue.
+     */
+    virtual Ieee80211DataOrMgmtFrame *aggregateCurrentTransmission();
+
+    /** @brief Sends up the correctly received subframes and fills in the bitmap for the Block ACK */
+    virtual void sendUpAggregate(Ieee80211AggregateFrame *aggregate);
+
+    /**
+     * @brief Returns true if the subframe of a retransmitted aggregate was already
+     * received, and records it in the receive window of its transmitter
+     */
+    virtual bool isDuplicatedSubframe(Ieee80211DataFrame *subframe, bool retry);
+
+    /** @brief Returns true if the frame is the Block ACK for the aggregate at the front of the queue */
+    virtual bool isExpectedBlockAck(Ieee80211Frame *frame);
+
+    /** @brief Number of subframes of the transmitted aggregate not acknowledged by the Block ACK, or -1 if the Block ACK is not for it */
+    virtual int getNumUnacknowledgedSubframes(Ieee80211Frame *blockAck);
+
+    /** @brief Removes the acknowledged subframes from the transmitted aggregate and updates the statistics */
+    virtual void processBlockAck(Ieee80211Frame *blockAck);
+    //@}
+
     /**
      * @brief Computes the duration (in seconds) of the transmission of a frame
      * over the physical channel. 'bits' should be the total length of the MAC frame
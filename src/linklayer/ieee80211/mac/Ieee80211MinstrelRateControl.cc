@@ -0,0 +1,132 @@
+//
+// Copyright (C) 2014 OpenSim Ltd.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "Ieee80211MinstrelRateControl.h"
+
+#include "Ieee80211DataRate.h"
+
+
+Ieee80211MinstrelRateControl::Ieee80211MinstrelRateControl(simtime_t updateInterval, double ewmaWeight, double lookaroundRate) :
+    updateInterval(updateInterval), ewmaWeight(ewmaWeight), lookaroundRate(lookaroundRate)
+{
+    if (ewmaWeight < 0 || ewmaWeight >= 1)
+        throw cRuntimeError("Minstrel EWMA weight must be in [0,1), got %g", ewmaWeight);
+    if (lookaroundRate < 0 || lookaroundRate > 1)
+        throw cRuntimeError("Minstrel lookaround rate must be in [0,1], got %g", lookaroundRate);
+}
+
+Ieee80211MinstrelRateControl::StationState& Ieee80211MinstrelRateControl::getStationState(const MACAddress& receiver)
+{
+    StationStateMap::iterator it = stationStates.find(receiver);
+    if (it != stationStates.end())
+        return it->second;
+
+    StationState& state = stationStates[receiver];
+    state.rates.resize(maxRateIndex - minRateIndex + 1);
+    // start from the configured rate until there are statistics
+    state.maxThroughputRate = initialRateIndex;
+    state.secondThroughputRate = initialRateIndex;
+    state.maxProbabilityRate = minRateIndex;
+    state.lastRate = initialRateIndex;
+    state.lastUpdate = simTime();
+    return state;
+}
+
+void Ieee80211MinstrelRateControl::updateStatistics(StationState& state)
+{
+    int numRates = state.rates.size();
+    for (int i = 0; i < numRates; i++)
+    {
+        RateStats& r = state.rates[i];
+        if (r.attempts > 0)
+        {
+            double p = (double)r.successes / r.attempts;
+            r.probability = r.sampled ? ewmaWeight * r.probability + (1 - ewmaWeight) * p : p;
+            r.sampled = true;
+        }
+        // rates with less than 10% success are considered useless (as in Minstrel)
+        r.throughput = r.probability < 0.1 ? 0 : r.probability * Ieee80211Descriptor::getDescriptor(minRateIndex + i).bitrate;
+        r.attempts = 0;
+        r.successes = 0;
+    }
+
+    int best = -1, second = -1, reliable = -1;
+    for (int i = 0; i < numRates; i++)
+    {
+        const RateStats& r = state.rates[i];
+        if (!r.sampled)
+            continue;
+        if (best == -1 || r.throughput > state.rates[best].throughput)
+        {
+            second = best;
+            best = i;
+        }
+        else if (second == -1 || r.throughput > state.rates[second].throughput)
+            second = i;
+        if (reliable == -1 || r.probability >= state.rates[reliable].probability)
+            reliable = i;
+    }
+
+    if (best != -1)
+    {
+        state.maxThroughputRate = minRateIndex + best;
+        state.secondThroughputRate = minRateIndex + (second != -1 ? second : best);
+        state.maxProbabilityRate = minRateIndex + reliable;
+    }
+    state.lastUpdate = simTime();
+}
+
+int Ieee80211MinstrelRateControl::selectRateIndex(const MACAddress& receiver, int retryCount)
+{
+    StationState& state = getStationState(receiver);
+    if (simTime() - state.lastUpdate >= updateInterval)
+        updateStatistics(state);
+
+    int rate;
+    if (retryCount == 0 && maxRateIndex > minRateIndex && owner->uniform(0, 1) < lookaroundRate)
+    {
+        // lookaround: sample a random rate other than the current best one
+        rate = owner->intuniform(minRateIndex, maxRateIndex - 1);
+        if (rate >= state.maxThroughputRate)
+            rate++;
+    }
+    else if (retryCount < 2)
+        rate = state.maxThroughputRate;
+    else if (retryCount < 4)
+        rate = state.secondThroughputRate;
+    else if (retryCount < 6)
+        rate = state.maxProbabilityRate;
+    else
+        rate = minRateIndex;
+
+    state.lastRate = rate;
+    return rate;
+}
+
+void Ieee80211MinstrelRateControl::rateSucceeded(const MACAddress& receiver, int retryCount)
+{
+    StationState& state = getStationState(receiver);
+    RateStats& r = state.rates[state.lastRate - minRateIndex];
+    r.attempts++;
+    r.successes++;
+}
+
+void Ieee80211MinstrelRateControl::rateFailed(const MACAddress& receiver, int retryCount)
+{
+    StationState& state = getStationState(receiver);
+    state.rates[state.lastRate - minRateIndex].attempts++;
+}
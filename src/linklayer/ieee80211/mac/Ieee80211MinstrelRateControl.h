@@ -0,0 +1,78 @@
+//
+// Copyright (C) 2014 OpenSim Ltd.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef __INET_IEEE80211MINSTRELRATECONTROL_H
+#define __INET_IEEE80211MINSTRELRATECONTROL_H
+
+#include <vector>
+
+#include "Ieee80211RateControl.h"
+
+/**
+ * Minstrel-like rate adaptation, after the Linux mac80211 algorithm.
+ *
+ * For each receiver and each rate, the success probability of transmission
+ * attempts is tracked and smoothed with an EWMA once per update interval.
+ * The expected throughput of a rate is its nominal bitrate weighted by the
+ * success probability. Attempts follow a retry chain: the first two use the
+ * best-throughput rate, then the second best, then the most reliable rate,
+ * and finally the lowest rate. A fraction of first attempts (the lookaround
+ * rate) samples a random other rate so that the statistics stay fresh.
+ */
+class INET_API Ieee80211MinstrelRateControl : public Ieee80211RateControl
+{
+  protected:
+    struct RateStats
+    {
+        long attempts;      ///< attempts in the current update interval
+        long successes;     ///< successes in the current update interval
+        double probability; ///< EWMA of the success probability
+        double throughput;  ///< expected throughput, bps
+        bool sampled;       ///< true if there were any attempts at all
+
+        RateStats() : attempts(0), successes(0), probability(0), throughput(0), sampled(false) {}
+    };
+
+    struct StationState
+    {
+        std::vector<RateStats> rates; ///< indexed by descriptor index - minRateIndex
+        int maxThroughputRate;
+        int secondThroughputRate;
+        int maxProbabilityRate;
+        int lastRate;                 ///< rate returned by the last selectRateIndex()
+        simtime_t lastUpdate;
+    };
+
+    typedef std::map<MACAddress, StationState> StationStateMap;
+
+    simtime_t updateInterval;
+    double ewmaWeight;       ///< weight of the old probability value, in [0,1)
+    double lookaroundRate;   ///< fraction of first attempts that are used for sampling
+    StationStateMap stationStates;
+
+  protected:
+    virtual StationState& getStationState(const MACAddress& receiver);
+    virtual void updateStatistics(StationState& state);
+    virtual int selectRateIndex(const MACAddress& receiver, int retryCount);
+    virtual void rateSucceeded(const MACAddress& receiver, int retryCount);
+    virtual void rateFailed(const MACAddress& receiver, int retryCount);
+
+  public:
+    Ieee80211MinstrelRateControl(simtime_t updateInterval, double ewmaWeight, double lookaroundRate);
+};
+
+#endif
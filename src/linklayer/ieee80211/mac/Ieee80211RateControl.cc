@@ -0,0 +1,138 @@
+//
+// Copyright (C) 2014 OpenSim Ltd.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <algorithm>
+
+#include "Ieee80211RateControl.h"
+
+#include "Ieee80211DataRate.h"
+
+
+void Ieee80211RateControl::initialize(cSimpleModule *owner, char opMode, int initialRateIndex)
+{
+    this->owner = owner;
+    this->opMode = opMode;
+    this->initialRateIndex = initialRateIndex;
+    minRateIndex = Ieee80211Descriptor::getMinIdx(opMode);
+    maxRateIndex = Ieee80211Descriptor::getMaxIdx(opMode);
+    ASSERT(minRateIndex <= initialRateIndex && initialRateIndex <= maxRateIndex);
+}
+
+double Ieee80211RateControl::getBitrate(const MACAddress& receiver, int retryCount)
+{
+    int rateIndex = selectRateIndex(receiver, retryCount);
+    ASSERT(minRateIndex <= rateIndex && rateIndex <= maxRateIndex);
+    return Ieee80211Descriptor::getDescriptor(rateIndex).bitrate;
+}
+
+void Ieee80211RateControl::reportDataOk(const MACAddress& receiver, int retryCount)
+{
+    rateSucceeded(receiver, retryCount);
+}
+
+void Ieee80211RateControl::reportDataFailed(const MACAddress& receiver, int retryCount)
+{
+    rateFailed(receiver, retryCount);
+}
+
+void Ieee80211RateControl::reportGiveUp(const MACAddress& receiver, int retryCount)
+{
+    rateFailed(receiver, retryCount);
+}
+
+//----
+
+Ieee80211AarfRateControl::Ieee80211AarfRateControl(bool adaptive, int minTimerTimeout, int minSuccessThreshold,
+        int maxSuccessThreshold, double successCoeff, double timerCoeff) :
+    adaptive(adaptive), minTimerTimeout(minTimerTimeout), minSuccessThreshold(minSuccessThreshold),
+    maxSuccessThreshold(maxSuccessThreshold), successCoeff(successCoeff), timerCoeff(timerCoeff)
+{
+}
+
+Ieee80211AarfRateControl::StationState& Ieee80211AarfRateControl::getStationState(const MACAddress& receiver)
+{
+    StationStateMap::iterator it = stationStates.find(receiver);
+    if (it != stationStates.end())
+        return it->second;
+
+    StationState& state = stationStates[receiver];
+    state.rateIndex = initialRateIndex;
+    state.successCounter = 0;
+    state.failedCounter = 0;
+    state.recovery = false;
+    state.timer = 0;
+    state.successThreshold = minSuccessThreshold;
+    state.timerTimeout = minTimerTimeout;
+    return state;
+}
+
+int Ieee80211AarfRateControl::selectRateIndex(const MACAddress& receiver, int retryCount)
+{
+    return getStationState(receiver).rateIndex;
+}
+
+void Ieee80211AarfRateControl::rateSucceeded(const MACAddress& receiver, int retryCount)
+{
+    StationState& state = getStationState(receiver);
+    state.successCounter++;
+    state.failedCounter = 0;
+    state.recovery = false;
+    if ((state.successCounter == state.successThreshold || state.timer == state.timerTimeout)
+            && Ieee80211Descriptor::incIdx(state.rateIndex))
+    {
+        state.timer = 0;
+        state.successCounter = 0;
+        state.recovery = true;
+    }
+}
+
+void Ieee80211AarfRateControl::rateFailed(const MACAddress& receiver, int retryCount)
+{
+    StationState& state = getStationState(receiver);
+    int failedAttempts = retryCount + 1;
+    state.timer++;
+    state.failedCounter++;
+    state.successCounter = 0;
+    if (state.recovery)
+    {
+        if (failedAttempts == 1)
+        {
+            // the probe at the higher rate failed
+            if (adaptive)
+            {
+                state.successThreshold = (int)std::min(state.successThreshold * successCoeff, (double)maxSuccessThreshold);
+                state.timerTimeout = (int)std::max((double)minTimerTimeout, state.successThreshold * timerCoeff);
+            }
+            Ieee80211Descriptor::decIdx(state.rateIndex);
+        }
+        state.timer = 0;
+    }
+    else
+    {
+        if ((failedAttempts - 1) % 2 == 1)
+        {
+            if (adaptive)
+            {
+                state.timerTimeout = minTimerTimeout;
+                state.successThreshold = minSuccessThreshold;
+            }
+            Ieee80211Descriptor::decIdx(state.rateIndex);
+        }
+        if (failedAttempts >= 2)
+            state.timer = 0;
+    }
+}
@@ -0,0 +1,120 @@
+//
+// Copyright (C) 2014 OpenSim Ltd.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef __INET_IEEE80211RATECONTROL_H
+#define __INET_IEEE80211RATECONTROL_H
+
+#include <map>
+
+#include "INETDefs.h"
+
+#include "MACAddress.h"
+
+/**
+ * Base class for rate adaptation algorithms that keep separate state for
+ * each receiver address. Used by Ieee80211Mac when per-station rate control
+ * is enabled.
+ *
+ * The MAC asks for the bitrate before every transmission attempt of a
+ * unicast frame, and reports the outcome of the attempt afterwards. Reports
+ * always refer to the bitrate most recently returned for that receiver.
+ * Per-station transmission statistics are kept by the MAC, see
+ * Ieee80211StationStatistics.
+ */
+class INET_API Ieee80211RateControl
+{
+  protected:
+    cSimpleModule *owner;
+    char opMode;
+    int minRateIndex;
+    int maxRateIndex;
+    int initialRateIndex;
+
+  protected:
+    /** Returns the descriptor index of the rate to use for the next attempt to the given receiver. */
+    virtual int selectRateIndex(const MACAddress& receiver, int retryCount) = 0;
+
+    /** The attempt with the last selected rate was acknowledged. */
+    virtual void rateSucceeded(const MACAddress& receiver, int retryCount) = 0;
+
+    /** The attempt with the last selected rate was not acknowledged. */
+    virtual void rateFailed(const MACAddress& receiver, int retryCount) = 0;
+
+  public:
+    Ieee80211RateControl() : owner(NULL), opMode('g'), minRateIndex(0), maxRateIndex(0), initialRateIndex(0) {}
+    virtual ~Ieee80211RateControl() {}
+
+    /**
+     * Called from the MAC's initialize(); rates are chosen from the
+     * descriptors of the given operation mode.
+     */
+    virtual void initialize(cSimpleModule *owner, char opMode, int initialRateIndex);
+
+    /** Returns the bitrate for the next transmission attempt of a unicast frame. */
+    virtual double getBitrate(const MACAddress& receiver, int retryCount);
+
+    /** The frame was acknowledged after retryCount retransmissions. */
+    virtual void reportDataOk(const MACAddress& receiver, int retryCount);
+
+    /** A transmission attempt failed (no ACK or CTS); the frame will be retried. */
+    virtual void reportDataFailed(const MACAddress& receiver, int retryCount);
+
+    /** A transmission attempt failed, and the frame has reached the retry limit. */
+    virtual void reportGiveUp(const MACAddress& receiver, int retryCount);
+};
+
+/**
+ * ARF/AARF rate adaptation with separate counters for each receiver. The
+ * algorithm is the same as the MAC-wide one in Ieee80211Mac; the AARF
+ * thresholds adapt per station as well.
+ */
+class INET_API Ieee80211AarfRateControl : public Ieee80211RateControl
+{
+  protected:
+    struct StationState
+    {
+        int rateIndex;
+        int successCounter;
+        int failedCounter;
+        bool recovery;
+        int timer;
+        int successThreshold;
+        int timerTimeout;
+    };
+
+    typedef std::map<MACAddress, StationState> StationStateMap;
+
+    bool adaptive; ///< AARF if true, ARF otherwise
+    int minTimerTimeout;
+    int minSuccessThreshold;
+    int maxSuccessThreshold;
+    double successCoeff;
+    double timerCoeff;
+    StationStateMap stationStates;
+
+  protected:
+    virtual StationState& getStationState(const MACAddress& receiver);
+    virtual int selectRateIndex(const MACAddress& receiver, int retryCount);
+    virtual void rateSucceeded(const MACAddress& receiver, int retryCount);
+    virtual void rateFailed(const MACAddress& receiver, int retryCount);
+
+  public:
+    Ieee80211AarfRateControl(bool adaptive, int minTimerTimeout, int minSuccessThreshold,
+            int maxSuccessThreshold, double successCoeff, double timerCoeff);
+};
+
+#endif
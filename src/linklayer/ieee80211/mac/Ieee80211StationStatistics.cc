@@ -0,0 +1,53 @@
+//
+// Copyright (C) 2014 OpenSim Ltd.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "Ieee80211StationStatistics.h"
+
+
+std::ostream& operator<<(std::ostream& os, const Ieee80211StationStatistics::StationStatistics& s)
+{
+    os << "bitrate=" << s.bitrate / 1e6 << "Mbps attempts=" << s.numAttempts << " sent=" << s.numSent
+       << " retries=" << s.numRetries << " givenUp=" << s.numGivenUp << " bits=" << s.bitsSent;
+    return os;
+}
+
+void Ieee80211StationStatistics::attemptStarted(const MACAddress& receiver, double bitrate)
+{
+    StationStatistics& stats = stationStatistics[receiver];
+    if (stats.numAttempts == 0)
+        stats.firstAttempt = simTime();
+    stats.lastAttempt = simTime();
+    stats.numAttempts++;
+    stats.bitrate = bitrate;
+}
+
+void Ieee80211StationStatistics::recordStatistics(cComponent *owner)
+{
+    for (StationStatisticsMap::const_iterator it = stationStatistics.begin(); it != stationStatistics.end(); ++it)
+    {
+        const StationStatistics& stats = it->second;
+        std::string prefix = "station " + it->first.str() + " ";
+        simtime_t duration = stats.lastAttempt - stats.firstAttempt;
+        owner->recordScalar((prefix + "attempts").c_str(), stats.numAttempts);
+        owner->recordScalar((prefix + "sent").c_str(), stats.numSent);
+        owner->recordScalar((prefix + "retries").c_str(), stats.numRetries);
+        owner->recordScalar((prefix + "given up").c_str(), stats.numGivenUp);
+        owner->recordScalar((prefix + "bitrate").c_str(), stats.bitrate);
+        if (duration > 0)
+            owner->recordScalar((prefix + "throughput").c_str(), stats.bitsSent / duration.dbl());
+    }
+}
@@ -0,0 +1,80 @@
+//
+// Copyright (C) 2014 OpenSim Ltd.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef __INET_IEEE80211STATIONSTATISTICS_H
+#define __INET_IEEE80211STATIONSTATISTICS_H
+
+#include <map>
+
+#include "INETDefs.h"
+
+#include "MACAddress.h"
+
+/**
+ * Transmission statistics of unicast frames, kept separately for each
+ * receiver address. Ieee80211Mac updates them with any rate control mode,
+ * MAC-wide or per-station, when its recordStationStatistics parameter is set.
+ */
+class INET_API Ieee80211StationStatistics
+{
+  public:
+    struct StationStatistics
+    {
+        long numAttempts;   ///< transmission attempts, including retries
+        long numSent;       ///< frames acknowledged
+        long numRetries;    ///< failed attempts that were retried
+        long numGivenUp;    ///< frames dropped after reaching the retry limit
+        int64 bitsSent;     ///< MAC frame bits acknowledged
+        simtime_t firstAttempt;
+        simtime_t lastAttempt;
+        double bitrate;     ///< bitrate of the last attempt
+
+        StationStatistics() :
+            numAttempts(0), numSent(0), numRetries(0), numGivenUp(0), bitsSent(0), bitrate(0) {}
+    };
+
+    typedef std::map<MACAddress, StationStatistics> StationStatisticsMap;
+
+  protected:
+    StationStatisticsMap stationStatistics;
+
+  public:
+    /** A transmission attempt to the receiver is started with the given bitrate. */
+    void attemptStarted(const MACAddress& receiver, double bitrate);
+
+    /** The frame (or part of an aggregate) was acknowledged. */
+    void frameSent(const MACAddress& receiver, int64 bits) {
+        StationStatistics& stats = stationStatistics[receiver];
+        stats.numSent++;
+        stats.bitsSent += bits;
+    }
+
+    /** A transmission attempt failed, and the frame will be retried. */
+    void frameRetried(const MACAddress& receiver) { stationStatistics[receiver].numRetries++; }
+
+    /** A transmission attempt failed, and the frame has reached the retry limit. */
+    void frameGivenUp(const MACAddress& receiver) { stationStatistics[receiver].numGivenUp++; }
+
+    StationStatisticsMap& getStationStatistics() { return stationStatistics; }
+
+    /** Records per-station scalars (throughput, retries, last bitrate) into the given module. */
+    void recordStatistics(cComponent *owner);
+};
+
+std::ostream& operator<<(std::ostream& os, const Ieee80211StationStatistics::StationStatistics& s);
+
+#endif
@@ -20,6 +20,7 @@
 
 #include "Ieee80211RadioModel.h"
 #include "Ieee80211Consts.h"
+#include "Ieee80211AggregateFrame.h"
 #include "FWMath.h"
 #include "yans-error-rate-model.h"
 #include "nist-error-rate-model.h"
@@ -147,6 +148,10 @@ PhyIndication Ieee80211RadioModel::isReceivedCorrectly(AirFrame *airframe, const
     }
     i++;
 
+    Ieee80211AggregateFrame *aggregate = dynamic_cast<Ieee80211AggregateFrame *>(frame);
+    if (aggregate && aggregate->getBlockAck())
+        return isAggregateReceivedCorrectly(airframe, aggregate, receivedList);
+
     if (snirMin <= snirThreshold)
     {
         // if snir is too low for the packet to be recognized
@@ -227,14 +232,12 @@ double Ieee80211RadioModel::getTestFrameError(double snirMin, double bitrate)
 }
 
 
-bool Ieee80211RadioModel::isPacketOK(double snirMin, int lengthMPDU, double bitrate)
+double Ieee80211RadioModel::getHeaderSuccessRate(double snirMin, double bitrate)
 {
-    double berHeader, berMPDU;
     ModulationType modeBody;
     ModulationType modeHeader;
 
     WifiPreamble preambleUsed = wifiPreamble;
-    double headerNoError;
     uint32_t headerSize;
     if (phyOpMode=='b')
         headerSize = HEADER_WITHOUT_PREAMBLE;
@@ -261,15 +264,24 @@ bool Ieee80211RadioModel::isPacketOK(double snirMin, int lengthMPDU, double bitr
         opp_error("Radio model not supported yet, must be a,b,g or p");
     }
 
-    headerNoError = errorModel->GetChunkSuccessRate(modeHeader, snirMin, headerSize);
+    return errorModel->GetChunkSuccessRate(modeHeader, snirMin, headerSize);
+}
+
+double Ieee80211RadioModel::getMpduSuccessRate(double snirMin, int lengthMPDU, double bitrate)
+{
     // probability of no bit error in the MPDU
-    double MpduNoError;
     if (fileBer)
-        MpduNoError = 1-parseTable->getPer(bitrate, snirMin, lengthMPDU/8);
-    else
-        MpduNoError = errorModel->GetChunkSuccessRate(modeBody, snirMin, lengthMPDU);
+        return 1-parseTable->getPer(bitrate, snirMin, lengthMPDU/8);
+    ModulationType modeBody = WifiModulationType::getModulationType(phyOpMode, bitrate);
+    return errorModel->GetChunkSuccessRate(modeBody, snirMin, lengthMPDU);
+}
+
+bool Ieee80211RadioModel::isPacketOK(double snirMin, int lengthMPDU, double bitrate)
+{
+    double headerNoError = getHeaderSuccessRate(snirMin, bitrate);
+    double MpduNoError = getMpduSuccessRate(snirMin, lengthMPDU, bitrate);
 
-    EV << "berHeader: " << berHeader << " berMPDU: " <<berMPDU <<" lengthMPDU: "<<lengthMPDU<<" PER: "<<1-MpduNoError<<endl;
+    EV << "headerNoError: " << headerNoError << " lengthMPDU: "<<lengthMPDU<<" PER: "<<1-MpduNoError<<endl;
     if (MpduNoError>=1 && headerNoError>=1)
         return true;
     double rand = dblrand();
@@ -282,6 +294,60 @@ bool Ieee80211RadioModel::isPacketOK(double snirMin, int lengthMPDU, double bitr
         return true; // no error
 }
 
+double Ieee80211RadioModel::getMinSnir(const SnrList& receivedList, simtime_t from, simtime_t to)
+{
+    // each entry holds the snir from its time until the time of the next entry
+    double snirMin = -1;
+    for (SnrList::const_iterator iter = receivedList.begin(); iter != receivedList.end(); iter++)
+    {
+        SnrList::const_iterator next = iter;
+        next++;
+        if (iter != receivedList.begin() && iter->time >= to)
+            break;
+        if (next != receivedList.end() && next->time <= from)
+            continue;
+        if (snirMin < 0 || iter->snr < snirMin)
+            snirMin = iter->snr;
+    }
+    return snirMin;
+}
+
+PhyIndication Ieee80211RadioModel::isAggregateReceivedCorrectly(AirFrame *airframe, Ieee80211AggregateFrame *aggregate, const SnrList& receivedList)
+{
+    // the PHY header is followed by the subframes in transmission order; every
+    // subframe is checked against the snir it was actually exposed to
+    double bitrate = airframe->getBitrate();
+    simtime_t start = receivedList.begin()->time;
+    simtime_t subframeStart = start + airframe->getDuration() - aggregate->getBitLength() / bitrate;
+
+    double headerSnir = getMinSnir(receivedList, start, subframeStart);
+    if (headerSnir <= snirThreshold)
+    {
+        EV << "COLLISION! PHY header of the aggregate got lost. Noise only\n";
+        return COLLISION;
+    }
+    if (dblrand() > getHeaderSuccessRate(headerSnir, bitrate))
+    {
+        EV << "PHY header of the aggregate has BIT ERRORS! It is lost!\n";
+        return BITERROR;
+    }
+
+    int numReceived = 0;
+    for (unsigned int k = 0; k < aggregate->getNumSubframes(); k++)
+    {
+        Ieee80211DataFrame *subframe = aggregate->getSubframe(k);
+        simtime_t subframeEnd = subframeStart + aggregate->getSubframeByteLength(subframe) * 8 / bitrate;
+        double snirMin = getMinSnir(receivedList, subframeStart, subframeEnd);
+        bool ok = snirMin > snirThreshold && dblrand() <= getMpduSuccessRate(snirMin, subframe->getBitLength(), bitrate);
+        EV << "subframe " << k << " (" << subframe->getName() << ") snrMin=" << snirMin << (ok ? " ok" : " has BIT ERRORS") << endl;
+        subframe->setBitError(!ok);
+        if (ok)
+            numReceived++;
+        subframeStart = subframeEnd;
+    }
+    return numReceived > 0 ? FRAMEOK : BITERROR;
+}
+
 double Ieee80211RadioModel::dB2fraction(double dB)
 {
     return pow(10.0, (dB / 10));
@@ -25,6 +25,8 @@
 #include "IErrorModel.h"
 #include "WifiPreambleType.h"
 
+class Ieee80211AggregateFrame;
+
 /**
  * Radio model for IEEE 802.11. The implementation is largely based on the
  * Mobility Framework's SnrEval80211 and Decider80211 modules.
@@ -73,6 +75,12 @@ class INET_API Ieee80211RadioModel : public IRadioModel
   protected:
     // utility
     virtual bool isPacketOK(double snirMin, int lengthMPDU, double bitrate);
+    virtual double getHeaderSuccessRate(double snirMin, double bitrate);
+    virtual double getMpduSuccessRate(double snirMin, int lengthMPDU, double bitrate);
+    /** Minimum snir in the [from, to) part of the reception */
+    virtual double getMinSnir(const SnrList& receivedList, simtime_t from, simtime_t to);
+    /** Marks the subframes of an A-MPDU that contain bit errors; FRAMEOK if at least one subframe is correct */
+    virtual PhyIndication isAggregateReceivedCorrectly(AirFrame *airframe, Ieee80211AggregateFrame *aggregate, const SnrList& receivedList);
     // utility
     virtual double dB2fraction(double dB);
 
@@ -273,7 +273,7 @@ void Radio::handleMessage(cMessage *msg)
         if (msg->getArrivalGateId() == upperLayerIn || msg->isSelfMessage())  //XXX can we ensure we don't receive pk from upper in OFF state?? (race condition)
             throw cRuntimeError("Radio is turned off");
         else {
-            EV << "Radio is turned off, dropping packet\n";
+            EV_INFO << "Radio is turned off, dropping packet\n";
             delete msg;
             return;
         }
@@ -314,13 +314,13 @@ void Radio::handleMessage(cMessage *msg)
         }
         else
         {
-            EV << "Radio disabled. ignoring airframe" << endl;
+            EV_INFO << "Radio disabled. ignoring airframe" << endl;
             delete msg;
         }
     }
     else
     {
-        EV << "listening to different channel when receiving message -- dropping it\n";
+        EV_INFO << "listening to different channel when receiving message -- dropping it\n";
         delete msg;
     }
 }
@@ -362,7 +362,7 @@ AirFrame *Radio::encapsulatePacket(cPacket *frame)
     airframe->setCarrierFrequency(carrierFrequency);
     delete ctrl;
 
-    EV << "Frame (" << frame->getClassName() << ")" << frame->getName()
+    EV_DEBUG << "Frame (" << frame->getClassName() << ")" << frame->getName()
     << " will be transmitted at " << (airframe->getBitrate()/1e6) << "Mbps\n";
     return airframe;
 }
@@ -386,7 +386,7 @@ void Radio::sendUp(AirFrame *airframe)
     frame->setControlInfo(cinfo);
 
     delete airframe;
-    EV << "sending up frame " << frame->getName() << endl;
+    EV_DEBUG << "sending up frame " << frame->getName() << endl;
     send(frame, upperLayerOut);
 }
 
@@ -430,7 +430,7 @@ void Radio::handleUpperMsg(AirFrame *airframe)
     // if a packet was being received, it is corrupted now as should be treated as noise
     if (snrInfo.ptr != NULL)
     {
-        EV << "Sending a message while receiving another. The received one is now corrupted.\n";
+        EV_INFO << "Sending a message while receiving another. The received one is now corrupted.\n";
 
         // remove the snr information stored for the message currently being
         // received. This message is treated as noise now and the
@@ -448,7 +448,7 @@ void Radio::handleUpperMsg(AirFrame *airframe)
     // about the "real" stuff
 
     // change radio status
-    EV << "sending, changing RadioState to TRANSMIT\n";
+    EV_DEBUG << "sending, changing RadioState to TRANSMIT\n";
     setRadioState(RadioState::TRANSMIT);
 
     cMessage *timer = new cMessage(NULL, MK_TRANSMISSION_OVER);
@@ -468,14 +468,14 @@ void Radio::handleCommand(int msgkind, cObject *ctrl)
 
         if (newChannel!=-1)
         {
-            EV << "Command received: change to channel #" << newChannel << "\n";
+            EV_DETAIL << "Command received: change to channel #" << newChannel << "\n";
 
             // do it
             if (rs.getChannelNumber()==newChannel)
-                EV << "Right on that channel, nothing to do\n"; // fine, nothing to do
+                EV_DETAIL << "Right on that channel, nothing to do\n"; // fine, nothing to do
             else if (rs.getState()==RadioState::TRANSMIT)
             {
-                EV << "We're transmitting right now, remembering to change after it's completed\n";
+                EV_DETAIL << "We're transmitting right now, remembering to change after it's completed\n";
                 this->newChannel = newChannel;
             }
             else
@@ -483,14 +483,14 @@ void Radio::handleCommand(int msgkind, cObject *ctrl)
         }
         if (newBitrate!=-1)
         {
-            EV << "Command received: change bitrate to " << (newBitrate/1e6) << "Mbps\n";
+            EV_DETAIL << "Command received: change bitrate to " << (newBitrate/1e6) << "Mbps\n";
 
             // do it
             if (rs.getBitrate()==newBitrate)
-                EV << "Right at that bitrate, nothing to do\n"; // fine, nothing to do
+                EV_DETAIL << "Right at that bitrate, nothing to do\n"; // fine, nothing to do
             else if (rs.getState()==RadioState::TRANSMIT)
             {
-                EV << "We're transmitting right now, remembering to change after it's completed\n";
+                EV_DETAIL << "We're transmitting right now, remembering to change after it's completed\n";
                 this->newBitrate = newBitrate;
             }
             else
@@ -515,10 +515,10 @@ void Radio::handleCommand(int msgkind, cObject *ctrl)
 
 void Radio::handleSelfMsg(cMessage *msg)
 {
-    EV<<"Radio::handleSelfMsg"<<msg->getKind()<<endl;
+    EV_TRACE << "Radio::handleSelfMsg"<<msg->getKind()<<endl;
     if (msg->getKind()==MK_RECEPTION_COMPLETE)
     {
-        EV << "frame is completely received now\n";
+        EV_DEBUG << "frame is completely received now\n";
 
         // unbuffer the message
         AirFrame *airframe = unbufferMsg(msg);
@@ -535,14 +535,14 @@ void Radio::handleSelfMsg(cMessage *msg)
         if (BASE_NOISE_LEVEL < sensitivity)
         {
             // set the RadioState to IDLE
-            EV << "transmission over, switch to idle mode (state:IDLE)\n";
+            EV_DEBUG << "transmission over, switch to idle mode (state:IDLE)\n";
             // setRadioState(RadioState::IDLE);
             newState = RadioState::IDLE;
         }
         else
         {
             // set the RadioState to RECV
-            EV << "transmission over but noise level too high, switch to recv mode (state:RECV)\n";
+            EV_DEBUG << "transmission over but noise level too high, switch to recv mode (state:RECV)\n";
             // setRadioState(RadioState::RECV);
             newState = RadioState::RECV;
         }
@@ -575,7 +575,7 @@ void Radio::handleSelfMsg(cMessage *msg)
     {
         error("Internal error: unknown self-message `%s'", msg->getName());
     }
-    EV<<"Radio::handleSelfMsg END"<<endl;
+    EV_TRACE << "Radio::handleSelfMsg END"<<endl;
 }
 
 
@@ -633,7 +633,7 @@ void Radio::handleLowerMsgStart(AirFrame* airframe)
     // processing ongoing transmissions during a channel change
     if (airframe->getArrivalTime() == simTime() && rcvdPower >= sensitivity && rs.getState() != RadioState::TRANSMIT && snrInfo.ptr == NULL)
     {
-        EV << "receiving frame " << airframe->getName() << endl;
+        EV_DEBUG << "receiving frame " << airframe->getName() << endl;
 
         // Put frame and related SnrList in receive buffer
         SnrList snrList;
@@ -647,14 +647,14 @@ void Radio::handleLowerMsgStart(AirFrame* airframe)
         if (rs.getState() != RadioState::RECV)
         {
             // publish new RadioState
-            EV << "publish new RadioState:RECV\n";
+            EV_DEBUG << "publish new RadioState:RECV\n";
             setRadioState(RadioState::RECV);
         }
     }
     // receive power is too low or another message is being sent or received
     else
     {
-        EV << "frame " << airframe->getName() << " is just noise\n";
+        EV_DEBUG << "frame " << airframe->getName() << " is just noise\n";
         //add receive power to the noise level
         noiseLevel += rcvdPower;
 
@@ -662,7 +662,7 @@ void Radio::handleLowerMsgStart(AirFrame* airframe)
         if (snrInfo.ptr != NULL)
         {
             // update snr info for currently being received message
-            EV << "adding new snr value to snr list of message being received\n";
+            EV_DEBUG << "adding new snr value to snr list of message being received\n";
             addNewSnr();
         }
 
@@ -670,7 +670,7 @@ void Radio::handleLowerMsgStart(AirFrame* airframe)
         // and the radio is currently not in receive or in send mode
         if (BASE_NOISE_LEVEL >= receptionThreshold && rs.getState() == RadioState::IDLE)
         {
-            EV << "setting radio state to RECV\n";
+            EV_DEBUG << "setting radio state to RECV\n";
             setRadioState(RadioState::RECV);
         }
     }
@@ -692,7 +692,7 @@ void Radio::handleLowerMsgEnd(AirFrame * airframe)
     // check if message has to be send to the decider
     if (snrInfo.ptr == airframe)
     {
-        EV << "reception of frame over, preparing to send packet to upper layer\n";
+        EV_DEBUG << "reception of frame over, preparing to send packet to upper layer\n";
         // get Packet and list out of the receive buffer:
         SnrList list;
         list = snrInfo.sList;
@@ -739,7 +739,7 @@ void Radio::handleLowerMsgEnd(AirFrame * airframe)
     // all other messages are noise
     else
     {
-        EV << "reception of noise message over, removing recvdPower from noiseLevel....\n";
+        EV_DEBUG << "reception of noise message over, removing recvdPower from noiseLevel....\n";
         // get the rcvdPower and subtract it from the noiseLevel
         noiseLevel -= recvBuff[airframe];
 
@@ -754,7 +754,7 @@ void Radio::handleLowerMsgEnd(AirFrame * airframe)
 
         // message should be deleted
         delete airframe;
-        EV << "message deleted\n";
+        EV_DEBUG << "message deleted\n";
     }
 
     // check the RadioState and update if necessary
@@ -764,7 +764,7 @@ void Radio::handleLowerMsgEnd(AirFrame * airframe)
     if (BASE_NOISE_LEVEL < receptionThreshold && rs.getState() == RadioState::RECV && snrInfo.ptr == NULL)
     {
         // publish the new RadioState:
-        EV << "new RadioState is IDLE\n";
+        EV_DEBUG << "new RadioState is IDLE\n";
         setRadioState(RadioState::IDLE);
     }
 }
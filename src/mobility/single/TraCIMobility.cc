@@ -60,16 +60,16 @@ void TraCIMobility::Statistics::watch(cSimpleModule& )
     WATCH(totalDistance);
 }
 
-void TraCIMobility::Statistics::recordScalars(cSimpleModule& module)
+void TraCIMobility::Statistics::recordScalars(cSimpleModule& module, const std::string& prefix)
 {
-    if (firstRoadNumber != MY_INFINITY) module.recordScalar("firstRoadNumber", firstRoadNumber);
-    module.recordScalar("startTime", startTime);
-    module.recordScalar("totalTime", totalTime);
-    module.recordScalar("stopTime", stopTime);
-    if (minSpeed != MY_INFINITY) module.recordScalar("minSpeed", minSpeed);
-    if (maxSpeed != -MY_INFINITY) module.recordScalar("maxSpeed", maxSpeed);
-    module.recordScalar("totalDistance", totalDistance);
-    module.recordScalar("totalCO2Emission", totalCO2Emission);
+    if (firstRoadNumber != MY_INFINITY) module.recordScalar((prefix + "firstRoadNumber").c_str(), firstRoadNumber);
+    module.recordScalar((prefix + "startTime").c_str(), startTime);
+    module.recordScalar((prefix + "totalTime").c_str(), totalTime);
+    module.recordScalar((prefix + "stopTime").c_str(), stopTime);
+    if (minSpeed != MY_INFINITY) module.recordScalar((prefix + "minSpeed").c_str(), minSpeed);
+    if (maxSpeed != -MY_INFINITY) module.recordScalar((prefix + "maxSpeed").c_str(), maxSpeed);
+    module.recordScalar((prefix + "totalDistance").c_str(), totalDistance);
+    module.recordScalar((prefix + "totalCO2Emission").c_str(), totalCO2Emission);
 }
 
 void TraCIMobility::initialize(int stage)
@@ -160,6 +160,27 @@ void TraCIMobility::preInitialize(std::string external_id, const Coord& position
     isPreInitialized = true;
 }
 
+void TraCIMobility::reinitialize(std::string external_id, const Coord& position, std::string road_id, double speed, double angle)
+{
+    // record the previous vehicle under its own name, so scalars of reused modules stay unique
+    statistics.stopTime = simTime();
+    statistics.recordScalars(*this, this->external_id + ".");
+    statistics.initialize();
+
+    this->external_id = external_id;
+    this->lastUpdate = simTime();
+    nextPos = position;
+    lastPosition = position;
+    this->road_id = road_id;
+    this->speed = speed;
+    this->angle = angle;
+    last_speed = -1;
+
+    if (ev.isGUI()) updateDisplayString();
+    emitMobilityStateChangedSignal();
+    updateVisualRepresentation();
+}
+
 void TraCIMobility::nextPosition(const Coord& position, std::string road_id, double speed, double angle, TraCIScenarioManager::VehicleSignal signals)
 {
     EV_DEBUG << "next position = " << position << " " << road_id << " " << speed << " " << angle << std::endl;
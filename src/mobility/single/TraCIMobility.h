@@ -66,7 +66,7 @@ class INET_API TraCIMobility : public MobilityBase
 
                 void initialize();
                 void watch(cSimpleModule& module);
-                void recordScalars(cSimpleModule& module);
+                void recordScalars(cSimpleModule& module, const std::string& prefix = "");
         };
 
         TraCIMobility() : MobilityBase(), isPreInitialized(false) {}
@@ -84,6 +84,11 @@ class INET_API TraCIMobility : public MobilityBase
 
         virtual void handleSelfMessage(cMessage *msg);
         virtual void preInitialize(std::string external_id, const Coord& position, std::string road_id = "", double speed = -1, double angle = -1);
+        /**
+         * Binds an already initialized module to a new vehicle (used when the TraCIScenarioManager recycles modules).
+         * Statistics of the previous vehicle are recorded, prefixed with its external id, and reset.
+         */
+        virtual void reinitialize(std::string external_id, const Coord& position, std::string road_id = "", double speed = -1, double angle = -1);
         virtual void nextPosition(const Coord& position, std::string road_id = "", double speed = -1, double angle = -1, TraCIScenarioManager::VehicleSignal signals = TraCIScenarioManager::VEH_SIGNAL_UNDEF);
         virtual void move();
         virtual void updateDisplayString();
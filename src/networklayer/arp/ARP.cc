@@ -55,6 +55,7 @@ static std::ostream& operator<<(std::ostream& out, const ARP::ARPCacheEntry& e)
 }
 
 ARP::ARPCache ARP::globalArpCache;
+ARP::MACAddressIndex ARP::globalArpCacheByMAC;
 int ARP::globalArpCacheRefCnt = 0;
 
 Define_Module(ARP);
@@ -124,11 +125,7 @@ void ARP::initialize(int stage)
             entry->pending = false;
             entry->timer = NULL;
             entry->numRetries = 0;
-            entry->macAddress = ie->getMacAddress();
-
-            ARPCache::iterator where = globalArpCache.insert(globalArpCache.begin(), std::make_pair(nextHopAddr, entry));
-            ASSERT(where->second == entry);
-            entry->myIter = where; // note: "inserting a new element into a map does not invalidate iterators that point to existing elements"
+            addGlobalEntry(nextHopAddr, entry);
         }
         NotificationBoard *nb = NotificationBoardAccess().getIfExists();
         if (nb != NULL)
@@ -148,18 +145,14 @@ ARP::~ARP()
         delete (*i).second;
         arpCache.erase(i);
     }
+    arpCacheByMAC.clear();
     --globalArpCacheRefCnt;
     // delete my entries from the globalArpCache
-    for (ARPCache::iterator it = globalArpCache.begin(); it != globalArpCache.end(); )
+    while (!globalEntriesByInterface.empty())
     {
-        if (it->second->owner == this)
-        {
-            ARPCache::iterator cur = it++;
-            delete cur->second;
-            globalArpCache.erase(cur);
-        }
-        else
-            ++it;
+        ARPCacheEntry *entry = globalEntriesByInterface.begin()->second;
+        removeGlobalEntry(entry);
+        delete entry;
     }
 }
 
@@ -244,6 +237,7 @@ void ARP::flush()
         delete entry;
         arpCache.erase(i);
     }
+    arpCacheByMAC.clear();
 }
 
 bool ARP::isNodeUp()
@@ -268,7 +262,7 @@ void ARP::initiateARPResolution(ARPCacheEntry *entry)
     entry->pending = true;
     entry->numRetries = 0;
     entry->lastUpdate = SIMTIME_ZERO;
-    entry->macAddress = MACAddress::UNSPECIFIED_ADDRESS;
+    setMACAddress(arpCacheByMAC, entry, MACAddress::UNSPECIFIED_ADDRESS);
     sendARPRequest(entry->ie, nextHopAddr);
 
     // start timer
@@ -507,12 +501,39 @@ void ARP::updateARPCache(ARPCacheEntry *entry, const MACAddress& macAddress)
         entry->timer = NULL;
         entry->numRetries = 0;
     }
-    entry->macAddress = macAddress;
+    setMACAddress(arpCacheByMAC, entry, macAddress);
     entry->lastUpdate = simTime();
     Notification signal(entry->myIter->first, macAddress, entry->ie);
     emit(completedARPResolutionSignal, &signal);
 }
 
+void ARP::setMACAddress(MACAddressIndex& index, ARPCacheEntry *entry, const MACAddress& macAddress)
+{
+    IPv4Address ipAddress = entry->myIter->first;
+    if (!entry->macAddress.isUnspecified())
+        index.erase(std::make_pair(entry->macAddress, ipAddress));
+    entry->macAddress = macAddress;
+    if (!macAddress.isUnspecified())
+        index.insert(std::make_pair(macAddress, ipAddress));
+}
+
+void ARP::addGlobalEntry(const IPv4Address& ipAddress, ARPCacheEntry *entry)
+{
+    ARPCache::iterator where = globalArpCache.insert(globalArpCache.begin(), std::make_pair(ipAddress, entry));
+    ASSERT(where->second == entry);
+    entry->myIter = where; // note: "inserting a new element into a map does not invalidate iterators that point to existing elements"
+    entry->macAddress = MACAddress::UNSPECIFIED_ADDRESS;  // not in the index yet
+    setMACAddress(globalArpCacheByMAC, entry, entry->ie->getMacAddress());
+    globalEntriesByInterface[entry->ie] = entry;
+}
+
+void ARP::removeGlobalEntry(ARPCacheEntry *entry)
+{
+    setMACAddress(globalArpCacheByMAC, entry, MACAddress::UNSPECIFIED_ADDRESS);
+    globalEntriesByInterface.erase(entry->ie);
+    globalArpCache.erase(entry->myIter);
+}
+
 MACAddress ARP::getMACAddressFor(const IPv4Address& addr) const
 {
     Enter_Method_Silent();
@@ -586,20 +607,21 @@ IPv4Address ARP::getIPv4AddressFor(const MACAddress& macAddr) const
     if (macAddr.isUnspecified())
         return IPv4Address::UNSPECIFIED_ADDRESS;
 
-    ARPCache::const_iterator it;
+    // the index is ordered by IPv4 address within a MAC address, so the lowest
+    // matching address is found first, as with a scan of the cache
+    const MACAddressIndex& index = globalARP ? globalArpCacheByMAC : arpCacheByMAC;
+    MACAddressIndex::const_iterator it = index.lower_bound(std::make_pair(macAddr, IPv4Address::UNSPECIFIED_ADDRESS));
     if (globalARP)
     {
-        for (it = globalArpCache.begin(); it != globalArpCache.end(); it++)
-            if (it->second->macAddress == macAddr)
-                return it->first;
+        if (it != index.end() && it->first == macAddr)
+            return it->second;
     }
     else
     {
         simtime_t now = simTime();
-        for (it = arpCache.begin(); it != arpCache.end(); it++)
-            if (it->second->macAddress == macAddr)
-                if (it->second->lastUpdate + cacheTimeout >= now)
-                    return it->first;
+        for ( ; it != index.end() && it->first == macAddr; it++)
+            if (arpCache.find(it->second)->second->lastUpdate + cacheTimeout >= now)
+                return it->second;
     }
     return IPv4Address::UNSPECIFIED_ADDRESS;
 }
@@ -615,14 +637,9 @@ void ARP::receiveChangeNotification(int category, const cObject *details)
         // rebuild the arp cache
         if (ie->isLoopback())
             return;
-        ARPCache::iterator it;
-        for (it=globalArpCache.begin(); it!=globalArpCache.end(); ++it)
-        {
-            if (it->second->ie == ie)
-                break;
-        }
+        InterfaceIndex::iterator it = globalEntriesByInterface.find(ie);
         ARPCacheEntry *entry = NULL;
-        if (it == globalArpCache.end())
+        if (it == globalEntriesByInterface.end())
         {
             if (!ie->ipv4Data() || ie->ipv4Data()->getIPAddress().isUnspecified())
                 return; // if the address is not defined it isn't included in the global cache
@@ -635,7 +652,7 @@ void ARP::receiveChangeNotification(int category, const cObject *details)
             // actualize
             entry = it->second;
             ASSERT(entry->owner == this);
-            globalArpCache.erase(it);
+            removeGlobalEntry(entry);
             if (!ie->ipv4Data() || ie->ipv4Data()->getIPAddress().isUnspecified())
             {
                 delete entry;
@@ -645,11 +662,7 @@ void ARP::receiveChangeNotification(int category, const cObject *details)
         entry->pending = false;
         entry->timer = NULL;
         entry->numRetries = 0;
-        entry->macAddress = ie->getMacAddress();
-        IPv4Address ipAddr = ie->ipv4Data()->getIPAddress();
-        ARPCache::iterator where = globalArpCache.insert(globalArpCache.begin(),std::make_pair(ipAddr, entry));
-        ASSERT(where->second == entry);
-        entry->myIter = where; // note: "inserting a new element into a map does not invalidate iterators that point to existing elements"
+        addGlobalEntry(ie->ipv4Data()->getIPAddress(), entry);
     }
 }
 
@@ -20,6 +20,7 @@
 #define __INET_ARP_H
 
 #include <map>
+#include <set>
 
 #include "INETDefs.h"
 
@@ -44,6 +45,8 @@ class INET_API ARP : public cSimpleModule, public IARPCache, public ILifecycle,
   public:
     struct ARPCacheEntry;
     typedef std::map<IPv4Address, ARPCacheEntry*> ARPCache;
+    typedef std::set<std::pair<MACAddress, IPv4Address> > MACAddressIndex;  // (MAC, IPv4) pairs of the entries with a known MAC address
+    typedef std::map<const InterfaceEntry *, ARPCacheEntry*> InterfaceIndex;
     typedef std::vector<cMessage*> MsgPtrVector;
 
     // IPv4Address -> MACAddress table
@@ -82,8 +85,11 @@ class INET_API ARP : public cSimpleModule, public IARPCache, public ILifecycle,
     static simsignal_t failedARPResolutionSignal;
 
     ARPCache arpCache;
+    MACAddressIndex arpCacheByMAC;
     static ARPCache globalArpCache;
+    static MACAddressIndex globalArpCacheByMAC;
     static int globalArpCacheRefCnt;
+    InterfaceIndex globalEntriesByInterface;  // our own entries in globalArpCache
 
     cGate *netwOutGate;
 
@@ -127,6 +133,9 @@ class INET_API ARP : public cSimpleModule, public IARPCache, public ILifecycle,
     virtual bool addressRecognized(IPv4Address destAddr, InterfaceEntry *ie);
     virtual void processARPPacket(ARPPacket *arp);
     virtual void updateARPCache(ARPCacheEntry *entry, const MACAddress& macAddress);
+    virtual void setMACAddress(MACAddressIndex& index, ARPCacheEntry *entry, const MACAddress& macAddress);
+    virtual void addGlobalEntry(const IPv4Address& ipAddress, ARPCacheEntry *entry);
+    virtual void removeGlobalEntry(ARPCacheEntry *entry);
 
     virtual void dumpARPPacket(ARPPacket *arp);
     virtual void updateDisplayString();
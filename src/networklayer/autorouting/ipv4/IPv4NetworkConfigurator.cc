@@ -244,6 +244,10 @@ void IPv4NetworkConfigurator::extractTopology(IPv4Topology& topology)
     {
         Node *node = (Node *)topology.getNode(i);
         cModule *module = node->getModule();
+        if (module->isPlaceholder())
+            throw cRuntimeError("Node %s is in another partition of the parallel simulation. Compute the configuration "
+                    "in a sequential run using the dumpConfig parameter, and apply it with the config parameter "
+                    "of the nodes' IPv4NodeConfigurator modules instead", module->getFullPath().c_str());
         node->module = module;
         node->interfaceTable = IPvXAddressResolver().findInterfaceTableOf(module);
         node->routingTable = IPvXAddressResolver().findRoutingTableOf(module);
@@ -1311,6 +1315,10 @@ void IPv4NetworkConfigurator::dumpConfig(IPv4Topology& topology)
             for (int j = 0; j < routingTable->getNumRoutes(); j++)
             {
                 IPv4Route *route = routingTable->getRoute(j);
+                // the routes of the directly connected networks are added by
+                // the routing table itself, so applying them would duplicate them
+                if (route->getSourceType() == IPv4Route::IFACENETMASK)
+                    continue;
                 std::stringstream stream;
                 IPv4Address netmask = route->getNetmask();
                 IPv4Address gateway = route->getGateway();
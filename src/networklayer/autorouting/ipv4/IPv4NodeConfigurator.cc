@@ -34,6 +34,7 @@ IPv4NodeConfigurator::IPv4NodeConfigurator()
     interfaceTable = NULL;
     routingTable = NULL;
     networkConfigurator = NULL;
+    configuration = NULL;
 }
 
 void IPv4NodeConfigurator::initialize(int stage)
@@ -49,6 +50,7 @@ void IPv4NodeConfigurator::initialize(int stage)
         nodeStatus = dynamic_cast<NodeStatus *>(node->getSubmodule("status"));
         interfaceTable = InterfaceTableAccess().get();
         routingTable = RoutingTableAccess().get();
+        configuration = par("config");
 
         if (!networkConfiguratorPath[0])
             networkConfigurator = NULL;
@@ -56,6 +58,9 @@ void IPv4NodeConfigurator::initialize(int stage)
             cModule *module = getModuleByPath(networkConfiguratorPath);
             if (!module)
                 throw cRuntimeError("Configurator module '%s' not found (check the 'networkConfiguratorModule' parameter)", networkConfiguratorPath);
+            if (module->isPlaceholder())
+                throw cRuntimeError("Configurator module '%s' is in another partition of the parallel simulation; "
+                        "set 'networkConfiguratorModule' to \"\" and use the 'config' parameter instead", networkConfiguratorPath);
             networkConfigurator = check_and_cast<IPv4NetworkConfigurator *>(module);
         }
     }
@@ -66,7 +71,7 @@ void IPv4NodeConfigurator::initialize(int stage)
     }
     else if (stage == 2)
     {
-        if ((!nodeStatus || nodeStatus->getState() == NodeStatus::UP) && networkConfigurator)
+        if (!nodeStatus || nodeStatus->getState() == NodeStatus::UP)
             configureNode();
     }
 }
@@ -77,7 +82,7 @@ bool IPv4NodeConfigurator::handleOperationStage(LifecycleOperation *operation, i
     if (dynamic_cast<NodeStartOperation *>(operation)) {
         if (stage == NodeStartOperation::STAGE_LINK_LAYER)
             prepareNode();
-        else if (stage == NodeStartOperation::STAGE_NETWORK_LAYER && networkConfigurator)
+        else if (stage == NodeStartOperation::STAGE_NETWORK_LAYER)
             configureNode();
     }
     else if (dynamic_cast<NodeShutdownOperation *>(operation))
@@ -122,9 +127,124 @@ void IPv4NodeConfigurator::prepareInterface(InterfaceEntry *interfaceEntry)
 
 void IPv4NodeConfigurator::configureNode()
 {
-    ASSERT(networkConfigurator);
-    for (int i = 0; i < interfaceTable->getNumInterfaces(); i++)
-        networkConfigurator->configureInterface(interfaceTable->getInterface(i));
-    if (par("configureRoutingTable").boolValue())
-        networkConfigurator->configureRoutingTable(routingTable);
+    if (networkConfigurator)
+    {
+        for (int i = 0; i < interfaceTable->getNumInterfaces(); i++)
+            networkConfigurator->configureInterface(interfaceTable->getInterface(i));
+        if (par("configureRoutingTable").boolValue())
+            networkConfigurator->configureRoutingTable(routingTable);
+    }
+    else
+    {
+        // apply the part of the configuration that belongs to this node
+        std::string nodePath = getContainingNode(this)->getFullPath();
+        configureInterfaces(nodePath.c_str());
+        if (par("configureRoutingTable").boolValue())
+            configureRoutes(nodePath.c_str());
+    }
+}
+
+bool IPv4NodeConfigurator::isNodeElement(cXMLElement *element, const char *nodePath)
+{
+    // the network name is ignored, so that the configuration may be computed
+    // with a different network type, e.g. one with a global configurator
+    const char *hostsAttr = element->getAttribute("hosts");
+    const char *hostsPath = hostsAttr ? strchr(hostsAttr, '.') : NULL;
+    const char *path = strchr(nodePath, '.');
+    return hostsPath && path && !strcmp(hostsPath, path);
+}
+
+InterfaceEntry *IPv4NodeConfigurator::getInterface(cXMLElement *element, const char *name)
+{
+    InterfaceEntry *interfaceEntry = name ? interfaceTable->getInterfaceByName(name) : NULL;
+    if (!interfaceEntry)
+        throw cRuntimeError("Interface '%s' not found, at %s", name ? name : "", element->getSourceLocation());
+    return interfaceEntry;
+}
+
+void IPv4NodeConfigurator::configureInterfaces(const char *nodePath)
+{
+    cXMLElementList interfaceElements = configuration->getChildrenByTagName("interface");
+    for (int i = 0; i < (int)interfaceElements.size(); i++)
+    {
+        cXMLElement *interfaceElement = interfaceElements[i];
+        if (!isNodeElement(interfaceElement, nodePath))
+            continue;
+        IPv4InterfaceData *interfaceData = getInterface(interfaceElement, interfaceElement->getAttribute("names"))->ipv4Data();
+        const char *addressAttr = interfaceElement->getAttribute("address");
+        const char *netmaskAttr = interfaceElement->getAttribute("netmask");
+        const char *metricAttr = interfaceElement->getAttribute("metric");
+        if (addressAttr)
+            interfaceData->setIPAddress(IPv4Address(addressAttr));
+        if (netmaskAttr)
+            interfaceData->setNetmask(IPv4Address(netmaskAttr));
+        if (metricAttr)
+            interfaceData->setMetric(atoi(metricAttr));
+    }
+
+    cXMLElementList multicastGroupElements = configuration->getChildrenByTagName("multicast-group");
+    for (int i = 0; i < (int)multicastGroupElements.size(); i++)
+    {
+        cXMLElement *multicastGroupElement = multicastGroupElements[i];
+        if (!isNodeElement(multicastGroupElement, nodePath))
+            continue;
+        IPv4InterfaceData *interfaceData = getInterface(multicastGroupElement, multicastGroupElement->getAttribute("interfaces"))->ipv4Data();
+        cStringTokenizer tokenizer(multicastGroupElement->getAttribute("address"));
+        while (tokenizer.hasMoreTokens())
+        {
+            // the dump also lists the groups joined in prepareInterface()
+            IPv4Address group(tokenizer.nextToken());
+            if (!interfaceData->isMemberOfMulticastGroup(group))
+                interfaceData->joinMulticastGroup(group);
+        }
+    }
+}
+
+static IPv4Address parseAddress(const char *s)
+{
+    return (!s || !strcmp(s, "*")) ? IPv4Address::UNSPECIFIED_ADDRESS : IPv4Address(s);
+}
+
+void IPv4NodeConfigurator::configureRoutes(const char *nodePath)
+{
+    cXMLElementList routeElements = configuration->getChildrenByTagName("route");
+    for (int i = 0; i < (int)routeElements.size(); i++)
+    {
+        cXMLElement *routeElement = routeElements[i];
+        if (!isNodeElement(routeElement, nodePath))
+            continue;
+        const char *metricAttr = routeElement->getAttribute("metric");
+        IPv4Route *route = new IPv4Route();
+        route->setSourceType(IPv4Route::MANUAL);
+        route->setDestination(parseAddress(routeElement->getAttribute("destination")));
+        route->setNetmask(parseAddress(routeElement->getAttribute("netmask")));
+        route->setGateway(parseAddress(routeElement->getAttribute("gateway")));
+        route->setInterface(getInterface(routeElement, routeElement->getAttribute("interface")));
+        if (metricAttr)
+            route->setMetric(atoi(metricAttr));
+        routingTable->addRoute(route);
+    }
+
+    cXMLElementList multicastRouteElements = configuration->getChildrenByTagName("multicast-route");
+    for (int i = 0; i < (int)multicastRouteElements.size(); i++)
+    {
+        cXMLElement *routeElement = multicastRouteElements[i];
+        if (!isNodeElement(routeElement, nodePath))
+            continue;
+        const char *parentAttr = routeElement->getAttribute("parent");
+        const char *metricAttr = routeElement->getAttribute("metric");
+        IPv4MulticastRoute *route = new IPv4MulticastRoute();
+        route->setSourceType(IPv4MulticastRoute::MANUAL);
+        route->setOrigin(parseAddress(routeElement->getAttribute("source")));
+        route->setOriginNetmask(parseAddress(routeElement->getAttribute("netmask")));
+        route->setMulticastGroup(parseAddress(routeElement->getAttribute("groups")));
+        if (parentAttr)
+            route->setInInterface(new IPv4MulticastRoute::InInterface(getInterface(routeElement, parentAttr)));
+        cStringTokenizer tokenizer(routeElement->getAttribute("children"));
+        while (tokenizer.hasMoreTokens())
+            route->addOutInterface(new IPv4MulticastRoute::OutInterface(getInterface(routeElement, tokenizer.nextToken()), false));
+        if (metricAttr)
+            route->setMetric(atoi(metricAttr));
+        routingTable->addMulticastRoute(route);
+    }
 }
@@ -53,6 +53,7 @@ class IPv4NodeConfigurator : public cSimpleModule, public ILifecycle {
         IInterfaceTable *interfaceTable;
         IRoutingTable *routingTable;
         IPv4NetworkConfigurator *networkConfigurator;
+        cXMLElement *configuration;
 
     public:
         IPv4NodeConfigurator();
@@ -65,6 +66,14 @@ class IPv4NodeConfigurator : public cSimpleModule, public ILifecycle {
         virtual void prepareNode();
         virtual void prepareInterface(InterfaceEntry *interfaceEntry);
         virtual void configureNode();
+
+        /** @name Applying a configuration written by IPv4NetworkConfigurator's dumpConfig */
+        //@{
+        virtual bool isNodeElement(cXMLElement *element, const char *nodePath);
+        virtual InterfaceEntry *getInterface(cXMLElement *element, const char *name);
+        virtual void configureInterfaces(const char *nodePath);
+        virtual void configureRoutes(const char *nodePath);
+        //@}
 };
 
 #endif
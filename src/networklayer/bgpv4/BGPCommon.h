@@ -33,11 +33,13 @@ const unsigned char TCP_PORT            = 179;
 const unsigned char START_EVENT_KIND    = 81;
 const unsigned char CONNECT_RETRY_KIND  = 82;
 const unsigned char HOLD_TIME_KIND      = 83;
+const unsigned char MIN_ROUTE_ADVERTISEMENT_KIND = 84;
 const unsigned char KEEP_ALIVE_KIND     = 89;
 const unsigned char NB_TIMERS           = 4;
 const unsigned char NB_STATS            = 6;
 const unsigned char DEFAULT_COST        = 1;
 const unsigned char NB_SESSION_MAX      = 255;
+const unsigned short MAX_MESSAGE_OCTETS = 4096;    // RFC 4271, 4.1
 
 const unsigned char ROUTE_DESTINATION_CHANGED   = 90;
 const unsigned char NEW_ROUTE_ADDED             = 91;
@@ -58,6 +60,28 @@ typedef IPv4Address       NextHop;
 typedef unsigned short  ASID;
 typedef unsigned long   SessionID;
 
+/**
+ * An IPv4 address prefix; the key of the BGP routing information bases.
+ */
+struct Prefix {
+    uint32          address;    // the masked address
+    unsigned char   length;
+
+    Prefix() : address(0), length(0) {}
+    Prefix(IPv4Address addr, unsigned char len) : address(addr.getInt() & IPv4Address::makeNetmask(len).getInt()), length(len) {}
+    Prefix(IPv4Address addr, IPv4Address netmask) : address(addr.getInt() & netmask.getInt()), length(netmask.getNetmaskLength()) {}
+
+    IPv4Address getAddress() const  { return IPv4Address(address); }
+    IPv4Address getNetmask() const  { return IPv4Address::makeNetmask(length); }
+    bool operator<(const Prefix& other) const  { return address < other.address || (address == other.address && length < other.length); }
+    bool operator==(const Prefix& other) const  { return address == other.address && length == other.length; }
+};
+
+inline std::ostream& operator<<(std::ostream& out, const Prefix& prefix)
+{
+    return out << prefix.getAddress() << '/' << (int)prefix.length;
+}
+
 struct SessionInfo{
     SessionID       sessionID;
     type            sessionType;
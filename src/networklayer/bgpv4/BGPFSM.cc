@@ -406,10 +406,12 @@ void Established::entry()
             std::string entryn = rtEntry->getNetmask().str();
             BGPEntry->addAS(session._info.ASValue);
             session.updateSendProcess(BGPEntry);
+            delete BGPEntry;
         }
     }
 
-    std::vector<BGP::RoutingTableEntry*> BGPRoutingTable = session.getBGPRoutingTable();
+    std::vector<BGP::RoutingTableEntry*> BGPRoutingTable;
+    session.getLocRIBInInstallOrder(BGPRoutingTable);
     for (std::vector<BGP::RoutingTableEntry*>::iterator it = BGPRoutingTable.begin(); it != BGPRoutingTable.end(); it++)
     {
         session.updateSendProcess((*it));
@@ -422,6 +424,13 @@ void Established::entry()
         session.findAndStartNextSession(BGP::IGP);
     }
 }
+void Established::exit()
+{
+    std::cout << "Established::exit" << std::endl;
+    BGPSession& session = TopState::box().getModule();
+    session._info.sessionEstablished = false;
+    session.clearAdjRIBOut();
+}
 void Established::ConnectRetryTimer_Expires()
 {
     EV << "Processing Established::ConnectRetryTimer_Expires" << std::endl;
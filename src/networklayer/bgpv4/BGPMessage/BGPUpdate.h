@@ -29,7 +29,9 @@ public:
     virtual BGPUpdateMessage *dup() const {return new BGPUpdateMessage(*this);}
     void setWithdrawnRoutesArraySize(unsigned int size);
     void setPathAttributeList(const BGPUpdatePathAttributeList& pathAttributeList_var);
-    void setNLRI(const BGPUpdateNLRI& NLRI_var);
+    virtual void setNLRIArraySize(unsigned int size);
+    /** Appends a prefix to the NLRI, growing the message by its 5 octets. */
+    void addNLRI(const BGPUpdateNLRI& NLRI_var);
 };
 
 #endif
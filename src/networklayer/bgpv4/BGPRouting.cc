@@ -32,9 +32,8 @@ BGPRouting::~BGPRouting(void)
     {
         (*sessionIterator).second->~BGPSession();
     }
-    _BGPRoutingTable.erase(_BGPRoutingTable.begin(), _BGPRoutingTable.end());
-    _prefixListIN.erase(_prefixListIN.begin(), _prefixListIN.end());
-    _prefixListOUT.erase(_prefixListOUT.begin(), _prefixListOUT.end());
+    // the routes of the Loc-RIB are owned by the IP routing table
+    _locRIB.clear();
 }
 
 void BGPRouting::initialize(int stage)
@@ -53,11 +52,14 @@ void BGPRouting::initialize(int stage)
         _rt = RoutingTableAccess().get();
         _inft = InterfaceTableAccess().get();
 
+        _ebgpMinRouteAdvertisementInterval = par("ebgpMinRouteAdvertisementInterval");
+        _ibgpMinRouteAdvertisementInterval = par("ibgpMinRouteAdvertisementInterval");
+
         // read BGP configuration
         cXMLElement *bgpConfig = par("bgpConfig").xmlValue();
         loadConfigFromXML(bgpConfig);
         createWatch("myAutonomousSystem", _myAS);
-        WATCH_PTRVECTOR(_BGPRoutingTable);
+        WATCH_PTRMAP(_locRIB);
     }
 }
 
@@ -100,6 +102,10 @@ void BGPRouting::handleTimer(cMessage *timer)
                 EV << "Expiring Keep Alive timer" << std::endl;
                 pSession->getFSM()->KeepaliveTimer_Expires();
                 break;
+            case BGP::MIN_ROUTE_ADVERTISEMENT_KIND:
+                EV << "Expiring MinRouteAdvertisementInterval Timer" << std::endl;
+                pSession->minRouteAdvertisementTimerExpires();
+                break;
             default :
                 throw cRuntimeError("Invalid timer kind %d", timer->getKind());
         }
@@ -114,9 +120,12 @@ bool BGPRouting::handleOperationStage(LifecycleOperation *operation, int stage,
 void BGPRouting::finish()
 {
     unsigned int statTab[BGP::NB_STATS] = {0, 0, 0, 0, 0, 0};
+    unsigned long NLRISent = 0, NLRIRcv = 0;
     for (std::map<BGP::SessionID, BGPSession*>::iterator sessionIterator = _BGPSessions.begin(); sessionIterator != _BGPSessions.end(); sessionIterator ++)
     {
         (*sessionIterator).second->getStatistics(statTab);
+        NLRISent += (*sessionIterator).second->getNLRISent();
+        NLRIRcv += (*sessionIterator).second->getNLRIRcv();
     }
     recordScalar("OPENMsgSent", statTab[0]);
     recordScalar("OPENMsgRecv", statTab[1]);
@@ -124,6 +133,9 @@ void BGPRouting::finish()
     recordScalar("KeepAliveMsgRcv", statTab[3]);
     recordScalar("UpdateMsgSent", statTab[4]);
     recordScalar("UpdateMsgRcv", statTab[5]);
+    recordScalar("UpdateNLRISent", NLRISent);
+    recordScalar("UpdateNLRIRcv", NLRIRcv);
+    recordScalar("LocRIBSize", _locRIB.size());
 }
 
 void BGPRouting::listenConnectionFromPeer(BGP::SessionID sessionID)
@@ -172,7 +184,7 @@ void BGPRouting::processMessageFromTCP(cMessage *msg)
         socket->readDataTransferModePar(*this);
         socket->setOutputGate(gate("tcpOut"));
         IPv4Address peerAddr = socket->getRemoteAddress().get4();
-        BGP::SessionID i = findIdFromPeerAddr(_BGPSessions, peerAddr);
+        BGP::SessionID i = findIdFromPeerAddr(peerAddr);
         if (i == (BGP::SessionID)-1)
         {
             socket->close();
@@ -192,7 +204,7 @@ void BGPRouting::processMessageFromTCP(cMessage *msg)
 
 void BGPRouting::socketEstablished(int connId, void *yourPtr)
 {
-    _currSessionId = findIdFromSocketConnId(_BGPSessions, connId);
+    _currSessionId = findIdFromSocketConnId(connId);
     if (_currSessionId == (BGP::SessionID)-1)
     {
         error("socket id=%d is not established", connId);
@@ -220,7 +232,7 @@ void BGPRouting::socketEstablished(int connId, void *yourPtr)
 
 void BGPRouting::socketDataArrived(int connId, void *yourPtr, cPacket *msg, bool urgent)
 {
-    _currSessionId = findIdFromSocketConnId(_BGPSessions, connId);
+    _currSessionId = findIdFromSocketConnId(connId);
     if (_currSessionId != (BGP::SessionID)-1)
     {
         BGPHeader* ptrHdr = check_and_cast<BGPHeader*>(msg);
@@ -245,7 +257,7 @@ void BGPRouting::socketDataArrived(int connId, void *yourPtr, cPacket *msg, bool
 
 void BGPRouting::socketFailure(int connId, void *yourPtr, int code)
 {
-    _currSessionId = findIdFromSocketConnId(_BGPSessions, connId);
+    _currSessionId = findIdFromSocketConnId(connId);
     if (_currSessionId != (BGP::SessionID)-1)
     {
         _BGPSessions[_currSessionId]->getFSM()->TcpConnectionFails();
@@ -267,40 +279,74 @@ void BGPRouting::processMessage(const BGPKeepAliveMessage& msg)
 void BGPRouting::processMessage(const BGPUpdateMessage& msg)
 {
     EV << "Processing BGP Update message" << std::endl;
-    _BGPSessions[_currSessionId]->getFSM()->UpdateMsgEvent();
+    BGPSession* session = _BGPSessions[_currSessionId];
+    session->getFSM()->UpdateMsgEvent();
 
-    unsigned char               decisionProcessResult;
-    IPv4Address                 netMask(IPv4Address::ALLONES_ADDRESS);
-    BGP::RoutingTableEntry*     entry = new BGP::RoutingTableEntry();
-    const unsigned char         length = msg.getNLRI().length;
-    unsigned int                ASValueCount = msg.getPathAttributeList(0).getAsPath(0).getValue(0).getAsValueArraySize();
+    if (msg.getPathAttributeListArraySize() == 0)
+    {
+        return;
+    }
 
-    entry->setDestination(msg.getNLRI().prefix);
-    netMask = IPv4Address::makeNetmask(length);
-    entry->setNetmask(netMask);
-    for (unsigned int j=0; j < ASValueCount; j++)
+    // the path attributes are shared by all prefixes of the NLRI
+    const BGPUpdatePathAttributeList& pathAttributes = msg.getPathAttributeList(0);
+    const BGPASPathSegment& ASPath = pathAttributes.getAsPath(0).getValue(0);
+    unsigned int ASValueCount = ASPath.getAsValueArraySize();
+    BGP::PathAttributes attributes;
+    attributes.origin = pathAttributes.getOrigin().getValue();
+    attributes.nextHop = pathAttributes.getNextHop().getValue();
+    for (unsigned int j = 0; j < ASValueCount; j++)
     {
-        entry->addAS(msg.getPathAttributeList(0).getAsPath(0).getValue(0).getAsValue(j));
+        attributes.asPath.push_back(ASPath.getAsValue(j));
     }
 
-    decisionProcessResult = asLoopDetection(entry, _myAS);
+    unsigned int NLRICount = msg.getNLRIArraySize();
+    session->addNLRIRcv(NLRICount);
 
-    if (decisionProcessResult == BGP::ASLOOP_NO_DETECTED)
+    _rt->beginRouteUpdate();
+    for (unsigned int i = 0; i < NLRICount; i++)
     {
-        // RFC 4271, 9.1.  Decision Process
-        decisionProcessResult = decisionProcess(msg, entry, _currSessionId);
-        //RFC 4271, 9.2.  Update-Send Process
-        if (decisionProcessResult != 0)
+        const BGPUpdateNLRI& NLRI = msg.getNLRI(i);
+        unsigned char               decisionProcessResult;
+        BGP::RoutingTableEntry*     entry = new BGP::RoutingTableEntry();
+
+        entry->setDestination(NLRI.prefix);
+        entry->setNetmask(IPv4Address::makeNetmask(NLRI.length));
+        for (unsigned int j = 0; j < ASValueCount; j++)
+        {
+            entry->addAS(attributes.asPath[j]);
+        }
+
+        decisionProcessResult = asLoopDetection(entry, _myAS);
+
+        if (decisionProcessResult == BGP::ASLOOP_NO_DETECTED)
+        {
+            // RFC 4271, 9.1.  Decision Process
+            decisionProcessResult = decisionProcess(msg, entry, _currSessionId);
+            //RFC 4271, 9.2.  Update-Send Process
+            if (decisionProcessResult != 0)
+            {
+                updateSendProcess(decisionProcessResult, _currSessionId, entry);
+            }
+        }
+        else
+        {
+            decisionProcessResult = 0;
+        }
+
+        // the route was not selected
+        if (decisionProcessResult == 0)
         {
-            updateSendProcess(decisionProcessResult, _currSessionId, entry);
+            delete entry;
         }
     }
+    _rt->commitRouteUpdate();
 }
 
 unsigned char BGPRouting::decisionProcess(const BGPUpdateMessage& msg, BGP::RoutingTableEntry* entry, BGP::SessionID sessionIndex)
 {
     //Don't add the route if it exists in PrefixListINTable or in ASListINTable
-    if (isInTable(_prefixListIN, entry) != (unsigned long)-1 || isInASList(_ASListIN, entry))
+    BGP::Prefix prefix = entry->getPrefix();
+    if (_prefixListIN.find(prefix) != _prefixListIN.end() || isInASList(_ASListIN, entry))
     {
         return 0;
     }
@@ -312,25 +358,25 @@ unsigned char BGPRouting::decisionProcess(const BGPUpdateMessage& msg, BGP::Rout
 
     //if the route already exist in BGP routing table, tieBreakingProcess();
     //(RFC 4271: 9.1.2.2 Breaking Ties)
-    unsigned long BGPindex = isInTable(_BGPRoutingTable, entry);
-    if (BGPindex != (unsigned long)-1)
+    BGP::LocRIB::iterator locRIBIt = _locRIB.find(prefix);
+    if (locRIBIt != _locRIB.end())
     {
-        if (tieBreakingProcess(_BGPRoutingTable[BGPindex], entry))
+        if (tieBreakingProcess(locRIBIt->second, entry))
         {
             return 0;
         }
         else
         {
             entry->setInterface(_BGPSessions[sessionIndex]->getLinkIntf());
-            _BGPRoutingTable.push_back(entry);
+            addToLocRIB(entry);
             _rt->addRoute(entry);
             return BGP::ROUTE_DESTINATION_CHANGED;
         }
     }
 
     //Don't add the route if it exists in IPv4 routing table except if the msg come from IGP session
-    int indexIP = isInRoutingTable(_rt, entry->getDestination());
-    if (indexIP != -1 && _rt->getRoute(indexIP)->getSourceType() != IPv4Route::BGP )
+    IPv4Route* ipRoute = findRouteInRoutingTable(_rt, entry->getDestination());
+    if (ipRoute != NULL && ipRoute->getSourceType() != IPv4Route::BGP )
     {
         if (_BGPSessions[sessionIndex]->getType() != BGP::IGP )
         {
@@ -339,18 +385,18 @@ unsigned char BGPRouting::decisionProcess(const BGPUpdateMessage& msg, BGP::Rout
         else
         {
             IPv4Route* newEntry = new IPv4Route;
-            newEntry->setDestination(_rt->getRoute(indexIP)->getDestination());
-            newEntry->setNetmask(_rt->getRoute(indexIP)->getNetmask());
-            newEntry->setGateway(_rt->getRoute(indexIP)->getGateway());
-            newEntry->setInterface(_rt->getRoute(indexIP)->getInterface());
+            newEntry->setDestination(ipRoute->getDestination());
+            newEntry->setNetmask(ipRoute->getNetmask());
+            newEntry->setGateway(ipRoute->getGateway());
+            newEntry->setInterface(ipRoute->getInterface());
             newEntry->setSourceType(IPv4Route::BGP);
-            _rt->deleteRoute(_rt->getRoute(indexIP));
+            _rt->deleteRoute(ipRoute);
             _rt->addRoute(newEntry);
         }
     }
 
     entry->setInterface(_BGPSessions[sessionIndex]->getLinkIntf());
-    _BGPRoutingTable.push_back(entry);
+    addToLocRIB(entry);
 
     if (_BGPSessions[sessionIndex]->getType() == BGP::EGP)
     {
@@ -398,67 +444,46 @@ bool BGPRouting::tieBreakingProcess(BGP::RoutingTableEntry* oldEntry, BGP::Routi
 void BGPRouting::updateSendProcess(const unsigned char type, BGP::SessionID sessionIndex, BGP::RoutingTableEntry* entry)
 {
     //Don't send the update Message if the route exists in listOUTTable
+    BGP::Prefix prefix = entry->getPrefix();
+    if (_prefixListOUT.find(prefix) != _prefixListOUT.end() || isInASList(_ASListOUT, entry))
+    {
+        return;
+    }
+
     //SESSION = EGP : send an update message to all BGP Peer (EGP && IGP)
     //if it is not the currentSession and if the session is already established
     //SESSION = IGP : send an update message to External BGP Peer (EGP) only
     //if it is not the currentSession and if the session is already established
+    BGPSession* fromSession = _BGPSessions[sessionIndex];
     for (std::map<BGP::SessionID, BGPSession*>::iterator sessionIt = _BGPSessions.begin();
         sessionIt != _BGPSessions.end(); sessionIt ++)
     {
-        if (isInTable(_prefixListOUT, entry) != (unsigned long)-1 || isInASList(_ASListOUT, entry) ||
-            ((*sessionIt).first == sessionIndex && type != BGP::NEW_SESSION_ESTABLISHED ) ||
+        if (((*sessionIt).first == sessionIndex && type != BGP::NEW_SESSION_ESTABLISHED ) ||
             (type == BGP::NEW_SESSION_ESTABLISHED && (*sessionIt).first != sessionIndex ) ||
             !(*sessionIt).second->isEstablished() )
         {
             continue;
         }
-        if ((_BGPSessions[sessionIndex]->getType()==BGP::IGP && (*sessionIt).second->getType()==BGP::EGP ) ||
-            _BGPSessions[sessionIndex]->getType() == BGP::EGP ||
+        if ((fromSession->getType()==BGP::IGP && (*sessionIt).second->getType()==BGP::EGP ) ||
+            fromSession->getType() == BGP::EGP ||
             type == BGP::ROUTE_DESTINATION_CHANGED ||
             type == BGP::NEW_SESSION_ESTABLISHED )
         {
-            BGPUpdateNLRI                   NLRI;
-            BGPUpdatePathAttributeList  content;
-
+            BGP::PathAttributes attributes;
             unsigned int nbAS = entry->getASCount();
-            content.setAsPathArraySize(1);
-            content.getAsPath(0).setValueArraySize(1);
-            content.getAsPath(0).getValue(0).setType(BGP::AS_SEQUENCE);
+
             //RFC 4271 : set My AS in first position if it is not already
+            attributes.asPath.reserve(nbAS + 1);
             if (entry->getAS(0) != _myAS)
             {
-                content.getAsPath(0).getValue(0).setAsValueArraySize(nbAS+1);
-                content.getAsPath(0).getValue(0).setLength(1);
-                content.getAsPath(0).getValue(0).setAsValue(0, _myAS);
-                for (unsigned int j = 1; j < nbAS+1; j++)
-                {
-                    content.getAsPath(0).getValue(0).setAsValue(j, entry->getAS(j-1));
-                }
-            }
-            else
-            {
-                content.getAsPath(0).getValue(0).setAsValueArraySize(nbAS);
-                content.getAsPath(0).getValue(0).setLength(1);
-                for (unsigned int j = 0; j < nbAS; j++)
-                {
-                    content.getAsPath(0).getValue(0).setAsValue(j, entry->getAS(j));
-                }
+                attributes.asPath.push_back(_myAS);
             }
+            attributes.asPath.insert(attributes.asPath.end(), entry->getASList().begin(), entry->getASList().end());
 
             InterfaceEntry*  iftEntry = (*sessionIt).second->getLinkIntf();
-            content.getOrigin().setValue((*sessionIt).second->getType());
-            content.getNextHop().setValue(iftEntry->ipv4Data()->getIPAddress());
-            IPv4Address netMask = entry->getNetmask();
-            NLRI.prefix = entry->getDestination().doAnd(netMask);
-            NLRI.length = (unsigned char) netMask.getNetmaskLength();
-            {
-                BGPUpdateMessage* updateMsg = new BGPUpdateMessage("BGPUpdate");
-                updateMsg->setPathAttributeListArraySize(1);
-                updateMsg->setPathAttributeList(content);
-                updateMsg->setNLRI(NLRI);
-                (*sessionIt).second->getSocket()->send(updateMsg);
-                (*sessionIt).second->addUpdateMsgSent();
-            }
+            attributes.origin = (*sessionIt).second->getType();
+            attributes.nextHop = iftEntry->ipv4Data()->getIPAddress();
+            (*sessionIt).second->advertiseRoute(prefix, attributes);
         }
     }
 }
@@ -573,21 +598,19 @@ std::vector<const char *> BGPRouting::loadASConfig(cXMLElementList& ASConfig)
         }
         if (nodeName == "DenyRoute" || nodeName == "DenyRouteIN" || nodeName == "DenyRouteOUT")
         {
-            BGP::RoutingTableEntry* entry = new BGP::RoutingTableEntry();
-            entry->setDestination(IPv4Address((*ASConfigIt)->getAttribute("Address")));
-            entry->setNetmask(IPv4Address((*ASConfigIt)->getAttribute("Netmask")));
+            BGP::Prefix prefix(IPv4Address((*ASConfigIt)->getAttribute("Address")), IPv4Address((*ASConfigIt)->getAttribute("Netmask")));
             if (nodeName == "DenyRouteIN")
             {
-                _prefixListIN.push_back(entry);
+                _prefixListIN.insert(prefix);
             }
             else if (nodeName == "DenyRouteOUT")
             {
-                _prefixListOUT.push_back(entry);
+                _prefixListOUT.insert(prefix);
             }
             else
             {
-                _prefixListIN.push_back(entry);
-                _prefixListOUT.push_back(entry);
+                _prefixListIN.insert(prefix);
+                _prefixListOUT.insert(prefix);
             }
         }
         else if (nodeName == "DenyAS" || nodeName == "DenyASIN" || nodeName == "DenyASOUT")
@@ -595,16 +618,16 @@ std::vector<const char *> BGPRouting::loadASConfig(cXMLElementList& ASConfig)
             BGP::ASID ASCur = atoi((*ASConfigIt)->getNodeValue());
             if (nodeName == "DenyASIN")
             {
-                _ASListIN.push_back(ASCur);
+                _ASListIN.insert(ASCur);
             }
             else if (nodeName == "DenyASOUT")
             {
-                _ASListOUT.push_back(ASCur);
+                _ASListOUT.insert(ASCur);
             }
             else
             {
-                _ASListIN.push_back(ASCur);
-                _ASListOUT.push_back(ASCur);
+                _ASListIN.insert(ASCur);
+                _ASListOUT.insert(ASCur);
             }
         }
         else
@@ -727,53 +750,58 @@ BGP::SessionID BGPRouting::createSession(BGP::type typeSession, const char* peer
     }
     newSessionId = info.sessionID;
     newSession->setInfo(info);
+    newSession->setMinRouteAdvertisementInterval(typeSession == BGP::EGP ?
+            _ebgpMinRouteAdvertisementInterval : _ibgpMinRouteAdvertisementInterval);
     _BGPSessions[newSessionId] = newSession;
+    _sessionIdsByPeerAddr.insert(std::make_pair(info.peerAddr, newSessionId));
 
     return newSessionId;
 }
 
 
-BGP::SessionID BGPRouting::findIdFromPeerAddr(std::map<BGP::SessionID, BGPSession*> sessions, IPv4Address peerAddr)
+BGP::SessionID BGPRouting::findIdFromPeerAddr(IPv4Address peerAddr)
+{
+    std::map<IPv4Address, BGP::SessionID>::const_iterator it = _sessionIdsByPeerAddr.find(peerAddr);
+    return it != _sessionIdsByPeerAddr.end() ? it->second : (BGP::SessionID)-1;
+}
+
+void BGPRouting::addToLocRIB(BGP::RoutingTableEntry* entry)
+{
+    entry->setInstallOrder(_locRIBInstallCount++);
+    _locRIB[entry->getPrefix()] = entry;
+}
+
+void BGPRouting::getLocRIBInInstallOrder(std::vector<BGP::RoutingTableEntry*>& routes)
 {
-    for (std::map<BGP::SessionID, BGPSession*>::iterator sessionIterator = sessions.begin();
-        sessionIterator != sessions.end(); sessionIterator ++)
+    std::map<unsigned long, BGP::RoutingTableEntry*> routesByOrder;
+    for (BGP::LocRIB::const_iterator it = _locRIB.begin(); it != _locRIB.end(); it++)
     {
-        if ((*sessionIterator).second->getPeerAddr().equals(peerAddr))
-        {
-            return (*sessionIterator).first;
-        }
+        routesByOrder[it->second->getInstallOrder()] = it->second;
+    }
+    routes.clear();
+    routes.reserve(routesByOrder.size());
+    for (std::map<unsigned long, BGP::RoutingTableEntry*>::const_iterator it = routesByOrder.begin(); it != routesByOrder.end(); it++)
+    {
+        routes.push_back(it->second);
     }
-    return -1;
 }
 
 /*delete BGP Routing entry, if the route deleted correctly return true, false else*/
 bool BGPRouting::deleteBGPRoutingEntry(BGP::RoutingTableEntry* entry){
-    for (std::vector<BGP::RoutingTableEntry*>::iterator it = _BGPRoutingTable.begin();
-         it != _BGPRoutingTable.end(); it++)
+    BGP::LocRIB::iterator it = _locRIB.find(entry->getPrefix());
+    if (it != _locRIB.end())
     {
-        if (((*it)->getDestination().getInt() & (*it)->getNetmask().getInt()) ==
-            (entry->getDestination().getInt() & entry->getNetmask().getInt()))
-        {
-            _BGPRoutingTable.erase(it);
-            _rt->deleteRoute(entry);
-            return true;
-        }
+        _locRIB.erase(it);
+        _rt->deleteRoute(entry);
+        return true;
     }
     return false;
 }
 
-/*return index of the IPv4 table if the route is found, -1 else*/
-int BGPRouting::isInRoutingTable(IRoutingTable* rtTable, IPv4Address addr)
+/*return the first (longest prefix) route of the IPv4 table matching the address, NULL if there is none*/
+IPv4Route* BGPRouting::findRouteInRoutingTable(IRoutingTable* rtTable, IPv4Address addr)
 {
-    for (int i = 0; i < rtTable->getNumRoutes(); i++)
-    {
-        const IPv4Route* entry = rtTable->getRoute(i);
-        if (IPv4Address::maskedAddrAreEqual(addr, entry->getDestination(), entry->getNetmask()))
-        {
-            return i;
-        }
-    }
-    return -1;
+    return rtTable->findBestMatchingRoute(addr);
 }
 
 int BGPRouting::isInInterfaceTable(IInterfaceTable* ifTable, IPv4Address addr)
@@ -788,10 +816,10 @@ int BGPRouting::isInInterfaceTable(IInterfaceTable* ifTable, IPv4Address addr)
     return -1;
 }
 
-BGP::SessionID BGPRouting::findIdFromSocketConnId(std::map<BGP::SessionID, BGPSession*> sessions, int connId)
+BGP::SessionID BGPRouting::findIdFromSocketConnId(int connId)
 {
-    for (std::map<BGP::SessionID, BGPSession*>::iterator sessionIterator = sessions.begin();
-        sessionIterator != sessions.end(); sessionIterator ++)
+    for (std::map<BGP::SessionID, BGPSession*>::const_iterator sessionIterator = _BGPSessions.begin();
+        sessionIterator != _BGPSessions.end(); sessionIterator ++)
     {
         TCPSocket* socket = (*sessionIterator).second->getSocket();
         if (socket->getConnectionId() == connId)
@@ -802,32 +830,18 @@ BGP::SessionID BGPRouting::findIdFromSocketConnId(std::map<BGP::SessionID, BGPSe
     return -1;
 }
 
-/*return index of the table if the route is found, -1 else*/
-unsigned long BGPRouting::isInTable(std::vector<BGP::RoutingTableEntry*> rtTable, BGP::RoutingTableEntry* entry)
+/*return true if the AS is found, false else*/
+bool BGPRouting::isInASList(const std::set<BGP::ASID>& ASList, BGP::RoutingTableEntry* entry)
 {
-    for (unsigned long i = 0; i < rtTable.size(); i++)
+    if (ASList.empty())
     {
-        BGP::RoutingTableEntry* entryCur = rtTable[i];
-        if ((entry->getDestination().getInt() & entry->getNetmask().getInt()) ==
-            (entryCur->getDestination().getInt() & entryCur->getNetmask().getInt()))
-        {
-            return i;
-        }
+        return false;
     }
-    return -1;
-}
-
-/*return true if the AS is found, false else*/
-bool BGPRouting::isInASList(std::vector<BGP::ASID> ASList, BGP::RoutingTableEntry* entry)
-{
-    for (std::vector<BGP::ASID>::iterator it = ASList.begin(); it != ASList.end(); it++)
+    for (unsigned int i = 0; i < entry->getASCount(); i++)
     {
-        for (unsigned int i = 0; i < entry->getASCount(); i++)
+        if (ASList.find(entry->getAS(i)) != ASList.end())
         {
-            if ((*it) == entry->getAS(i))
-            {
-                return true;
-            }
+            return true;
         }
     }
     return false;
@@ -836,6 +850,11 @@ bool BGPRouting::isInASList(std::vector<BGP::ASID> ASList, BGP::RoutingTableEntr
 /*return true if OSPF exists, false else*/
 bool BGPRouting::ospfExist(IRoutingTable* rtTable)
 {
+    // OSPF routes can only be installed by an OSPF module
+    if (OSPFRoutingAccess().getIfExists() == NULL)
+    {
+        return false;
+    }
     for (int i=0; i<rtTable->getNumRoutes(); i++)
     {
         if (rtTable->getRoute(i)->getSourceType() == IPv4Route::OSPF)
@@ -18,6 +18,9 @@
 #ifndef __INET_BGPROUTING_H
 #define __INET_BGPROUTING_H
 
+#include <map>
+#include <set>
+
 #include "INETDefs.h"
 
 #include "TCPSocket.h"
@@ -41,7 +44,7 @@ class INET_API BGPRouting : public cSimpleModule, public ILifecycle, public TCPS
 {
 public:
     BGPRouting()
-        : _myAS(0), _inft(0), _rt(0) {}
+        : _myAS(0), _inft(0), _rt(0), _locRIBInstallCount(0) {}
 
     virtual ~BGPRouting();
 
@@ -66,7 +69,11 @@ protected:
     cMessage*       getCancelEvent(cMessage* msg)               { return cancelEvent(msg);}
     cGate*          getGate(const char* gateName)               { return gate(gateName);}
     IRoutingTable*  getIPRoutingTable()                         { return _rt;}
-    std::vector<BGP::RoutingTableEntry*> getBGPRoutingTable()   { return _BGPRoutingTable;}
+    const BGP::LocRIB& getLocRIB()                              { return _locRIB;}
+    /**
+     * \brief the routes of the Loc-RIB in the order they were selected
+     */
+    void getLocRIBInInstallOrder(std::vector<BGP::RoutingTableEntry*>& routes);
     /**
      * \brief active listenSocket for a given session (used by BGPFSM)
      */
@@ -114,8 +121,8 @@ private:
     bool tieBreakingProcess(BGP::RoutingTableEntry* oldEntry, BGP::RoutingTableEntry* entry);
 
     BGP::SessionID createSession(BGP::type typeSession, const char* peerAddr);
-    bool isInASList(std::vector<BGP::ASID> ASList, BGP::RoutingTableEntry* entry);
-    unsigned long   isInTable(std::vector<BGP::RoutingTableEntry*> rtTable, BGP::RoutingTableEntry* entry);
+    bool isInASList(const std::set<BGP::ASID>& ASList, BGP::RoutingTableEntry* entry);
+    void addToLocRIB(BGP::RoutingTableEntry* entry);
 
     std::vector<const char *> loadASConfig(cXMLElementList& ASConfig);
     void loadSessionConfig(cXMLElementList& sessionList, simtime_t* delayTab);
@@ -124,10 +131,10 @@ private:
     bool ospfExist(IRoutingTable* rtTable);
     void loadTimerConfig(cXMLElementList& timerConfig, simtime_t* delayTab);
     unsigned char asLoopDetection(BGP::RoutingTableEntry* entry, BGP::ASID myAS);
-    BGP::SessionID findIdFromPeerAddr(std::map<BGP::SessionID, BGPSession*> sessions, IPv4Address peerAddr);
-    int isInRoutingTable(IRoutingTable* rtTable, IPv4Address addr);
+    BGP::SessionID findIdFromPeerAddr(IPv4Address peerAddr);
+    IPv4Route* findRouteInRoutingTable(IRoutingTable* rtTable, IPv4Address addr);
     int isInInterfaceTable(IInterfaceTable* rtTable, IPv4Address addr);
-    BGP::SessionID findIdFromSocketConnId(std::map<BGP::SessionID, BGPSession*> sessions, int connId);
+    BGP::SessionID findIdFromSocketConnId(int connId);
     unsigned int calculateStartDelay(int rtListSize, unsigned char rtPosition, unsigned char rtPeerPosition);
 
     TCPSocketMap                            _socketMap;
@@ -136,12 +143,16 @@ private:
 
     IInterfaceTable*                        _inft;
     IRoutingTable*                          _rt;                // The IP routing table
-    std::vector<BGP::RoutingTableEntry*>    _BGPRoutingTable;   // The BGP routing table
-    std::vector<BGP::RoutingTableEntry*>    _prefixListIN;
-    std::vector<BGP::RoutingTableEntry*>    _prefixListOUT;
-    std::vector<BGP::ASID>                  _ASListIN;
-    std::vector<BGP::ASID>                  _ASListOUT;
+    BGP::LocRIB                             _locRIB;            // The BGP routing table
+    unsigned long                           _locRIBInstallCount;
+    std::set<BGP::Prefix>                   _prefixListIN;
+    std::set<BGP::Prefix>                   _prefixListOUT;
+    std::set<BGP::ASID>                     _ASListIN;
+    std::set<BGP::ASID>                     _ASListOUT;
     std::map<BGP::SessionID, BGPSession*>   _BGPSessions;
+    std::map<IPv4Address, BGP::SessionID>   _sessionIdsByPeerAddr;
+    simtime_t                               _ebgpMinRouteAdvertisementInterval;
+    simtime_t                               _ibgpMinRouteAdvertisementInterval;
 
     static const int  BGP_TCP_CONNECT_VALID = 71;
     static const int  BGP_TCP_CONNECT_CONFIRM = 72;
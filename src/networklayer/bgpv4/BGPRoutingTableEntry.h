@@ -18,6 +18,9 @@
 #ifndef __INET_BGPROUTINGTABLEENTRY_H
 #define __INET_BGPROUTINGTABLEENTRY_H
 
+#include <map>
+#include <vector>
+
 #include "RoutingTable.h"
 #include "BGPCommon.h"
 
@@ -38,25 +41,63 @@ public:
     void            addAS(ASID newAS)                               { _ASList.push_back(newAS); }
     unsigned int    getASCount(void) const                          { return _ASList.size(); }
     ASID            getAS(unsigned int index) const                 { return _ASList[index]; }
+    const std::vector<ASID>& getASList(void) const                  { return _ASList; }
+    Prefix          getPrefix(void) const                           { return Prefix(getDestination(), getNetmask()); }
+    void            setInstallOrder(unsigned long order)            { _installOrder = order; }
+    unsigned long   getInstallOrder(void) const                     { return _installOrder; }
 
     private:
     // destinationID is RoutingEntry::host
     // addressMask is RoutingEntry::netmask
     RoutingPathType         _pathType;
     std::vector<ASID>       _ASList;
+    unsigned long           _installOrder;  // orders the Loc-RIB by the time of insertion
 };
 
+/**
+ * The path attributes of a route in an Adj-RIB-Out. Routes
+ * there are kept as plain values; only the routes of the Loc-RIB are
+ * installed in the IP routing table.
+ */
+struct PathAttributes
+{
+    RoutingTableEntry::RoutingPathType  origin;
+    NextHop                             nextHop;
+    std::vector<ASID>                   asPath;
+
+    PathAttributes() : origin(Incomplete) {}
+    bool operator<(const PathAttributes& other) const
+    {
+        if (origin != other.origin)
+            return origin < other.origin;
+        if (nextHop != other.nextHop)
+            return nextHop < other.nextHop;
+        return asPath < other.asPath;
+    }
+    bool operator==(const PathAttributes& other) const
+    {
+        return origin == other.origin && nextHop == other.nextHop && asPath == other.asPath;
+    }
+};
+
+/** Loc-RIB: the selected routes, indexed by prefix. */
+typedef std::map<Prefix, RoutingTableEntry*> LocRIB;
+
+/** Adj-RIB-Out of a session, indexed by prefix. */
+typedef std::map<Prefix, PathAttributes> AdjRIB;
+
 } // namespace BGP
 
 inline BGP::RoutingTableEntry::RoutingTableEntry(void) :
-    IPv4Route(), _pathType(BGP::Incomplete)
+    IPv4Route(), _pathType(BGP::Incomplete), _installOrder(0)
 {
     setNetmask(IPv4Address::ALLONES_ADDRESS);
     setMetric(BGP::DEFAULT_COST);
     setSourceType(IPv4Route::BGP);
 }
 
-inline BGP::RoutingTableEntry::RoutingTableEntry(const IPv4Route* entry)
+inline BGP::RoutingTableEntry::RoutingTableEntry(const IPv4Route* entry) :
+    _pathType(BGP::Incomplete), _installOrder(0)
 {
     setDestination(entry->getDestination());
     setNetmask(entry->getNetmask());
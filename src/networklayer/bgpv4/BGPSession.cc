@@ -24,8 +24,10 @@ BGPSession::BGPSession(BGPRouting& _bgpRouting)
     , _connectRetryTime(BGP_RETRY_TIME), _ptrConnectRetryTimer(0)
     , _holdTime(BGP_HOLD_TIME), _ptrHoldTimer(0)
     , _keepAliveTime(BGP_KEEP_ALIVE), _ptrKeepAliveTimer(0)
+    , _minRouteAdvertisementInterval(0), _ptrMinRouteAdvertisementTimer(0)
     , _openMsgSent(0), _openMsgRcv(0), _keepAliveMsgSent(0)
     , _keepAliveMsgRcv(0), _updateMsgSent(0), _updateMsgRcv(0)
+    , _NLRISent(0), _NLRIRcv(0)
 {
     _box = new BGPFSM::TopState::Box(*this);
     _fsm = new Macho::Machine<BGPFSM::TopState>(_box);
@@ -38,6 +40,7 @@ BGPSession::~BGPSession()
     _bgpRouting.getCancelAndDelete(_ptrStartEvent);
     _bgpRouting.getCancelAndDelete(_ptrHoldTimer);
     _bgpRouting.getCancelAndDelete(_ptrKeepAliveTimer);
+    _bgpRouting.getCancelAndDelete(_ptrMinRouteAdvertisementTimer);
     _info.socket->~TCPSocket();
     _info.socketListen->~TCPSocket();
 }
@@ -72,10 +75,12 @@ void BGPSession::setTimers(simtime_t* delayTab)
     _ptrConnectRetryTimer = new cMessage("BGP Connect Retry", BGP::CONNECT_RETRY_KIND);
     _ptrHoldTimer = new cMessage("BGP Hold Timer", BGP::HOLD_TIME_KIND);
     _ptrKeepAliveTimer = new cMessage("BGP Keep Alive Timer", BGP::KEEP_ALIVE_KIND);
+    _ptrMinRouteAdvertisementTimer = new cMessage("BGP MinRouteAdvertisementInterval Timer", BGP::MIN_ROUTE_ADVERTISEMENT_KIND);
 
     _ptrConnectRetryTimer->setContextPointer(this);
     _ptrHoldTimer->setContextPointer(this);
     _ptrKeepAliveTimer->setContextPointer(this);
+    _ptrMinRouteAdvertisementTimer->setContextPointer(this);
 }
 
 void BGPSession::startConnection()
@@ -136,6 +141,113 @@ void BGPSession::sendKeepAliveMessage()
     _keepAliveMsgSent ++;
 }
 
+void BGPSession::advertiseRoute(const BGP::Prefix& prefix, const BGP::PathAttributes& attributes)
+{
+    _adjRIBOut[prefix] = attributes;
+    _pendingPrefixes.insert(prefix);
+
+    if (_minRouteAdvertisementInterval == 0)
+    {
+        sendUpdateMessages();
+    }
+    else if (!_ptrMinRouteAdvertisementTimer->isScheduled())
+    {
+        // no advertisement in the last interval: send the routes collected in this event
+        _bgpRouting.getScheduleAt(_bgpRouting.getSimTime(), _ptrMinRouteAdvertisementTimer);
+    }
+}
+
+void BGPSession::minRouteAdvertisementTimerExpires()
+{
+    if (!_info.sessionEstablished)
+    {
+        // the routes are sent again when the session is re-established
+        _pendingPrefixes.clear();
+        return;
+    }
+    if (_pendingPrefixes.empty())
+    {
+        return;
+    }
+    sendUpdateMessages();
+    //RFC 4271, 9.2.1.1: the interval is jittered by a random factor between 0.75 and 1.0
+    _bgpRouting.getScheduleAt(_bgpRouting.getSimTime() + _minRouteAdvertisementInterval * uniform(0.75, 1.0),
+            _ptrMinRouteAdvertisementTimer);
+}
+
+void BGPSession::clearAdjRIBOut()
+{
+    _adjRIBOut.clear();
+    _pendingPrefixes.clear();
+    _bgpRouting.getCancelEvent(_ptrMinRouteAdvertisementTimer);
+}
+
+void BGPSession::sendUpdateMessages()
+{
+    typedef std::map<BGP::PathAttributes, std::vector<BGP::Prefix> > PrefixesByAttributes;
+    PrefixesByAttributes prefixesByAttributes;
+
+    for (std::set<BGP::Prefix>::const_iterator it = _pendingPrefixes.begin(); it != _pendingPrefixes.end(); it++)
+    {
+        BGP::AdjRIB::const_iterator ribIt = _adjRIBOut.find(*it);
+        if (ribIt != _adjRIBOut.end())
+        {
+            prefixesByAttributes[ribIt->second].push_back(*it);
+        }
+    }
+    _pendingPrefixes.clear();
+
+    for (PrefixesByAttributes::const_iterator groupIt = prefixesByAttributes.begin(); groupIt != prefixesByAttributes.end(); groupIt++)
+    {
+        const BGP::PathAttributes& attributes = groupIt->first;
+        const std::vector<BGP::Prefix>& prefixes = groupIt->second;
+        unsigned int nbAS = attributes.asPath.size();
+
+        BGPUpdatePathAttributeList content;
+        content.setAsPathArraySize(1);
+        content.getAsPath(0).setValueArraySize(1);
+        content.getAsPath(0).getValue(0).setType(BGP::AS_SEQUENCE);
+        content.getAsPath(0).getValue(0).setAsValueArraySize(nbAS);
+        content.getAsPath(0).getValue(0).setLength(1);
+        for (unsigned int j = 0; j < nbAS; j++)
+        {
+            content.getAsPath(0).getValue(0).setAsValue(j, attributes.asPath[j]);
+        }
+        content.getOrigin().setValue(attributes.origin);
+        content.getNextHop().setValue(attributes.nextHop);
+
+        unsigned int i = 0;
+        while (i < prefixes.size())
+        {
+            BGPUpdateMessage* updateMsg = new BGPUpdateMessage("BGPUpdate");
+            updateMsg->setPathAttributeListArraySize(1);
+            updateMsg->setPathAttributeList(content);
+
+            // fill the message up to the maximum message size
+            unsigned int count = (BGP::MAX_MESSAGE_OCTETS - updateMsg->getByteLength()) / 5; //5 = NLRI (length (1) + IPv4Address (4))
+            if (count == 0)
+            {
+                count = 1;
+            }
+            if (count > prefixes.size() - i)
+            {
+                count = prefixes.size() - i;
+            }
+            updateMsg->setNLRIArraySize(count);
+            for (unsigned int k = 0; k < count; k++, i++)
+            {
+                BGPUpdateNLRI NLRI;
+                NLRI.prefix = prefixes[i].getAddress();
+                NLRI.length = prefixes[i].length;
+                updateMsg->setNLRI(k, NLRI);
+            }
+            _info.socket->send(updateMsg);
+            _updateMsgSent ++;
+            _NLRISent += count;
+        }
+    }
+}
+
 void BGPSession::getStatistics(unsigned int* statTab)
 {
     statTab[0] += _openMsgSent;
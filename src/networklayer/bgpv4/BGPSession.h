@@ -18,6 +18,7 @@
 #ifndef __INET_BGPSESSION_H
 #define __INET_BGPSESSION_H
 
+#include <set>
 #include <vector>
 
 #include "INETDefs.h"
@@ -40,7 +41,6 @@ public:
     void            restartsConnectRetryTimer(bool start = true);
     void            sendOpenMessage();
     void            sendKeepAliveMessage();
-    void            addUpdateMsgSent()                          { _updateMsgSent ++;}
     void            listenConnectionFromPeer()                  { _bgpRouting.listenConnectionFromPeer(_info.sessionID);}
     void            openTCPConnectionToPeer()                   { _bgpRouting.openTCPConnectionToPeer(_info.sessionID);}
     BGP::SessionID  findAndStartNextSession(BGP::type type)     { return _bgpRouting.findNextSession(type, true);}
@@ -51,9 +51,32 @@ public:
     void            setlinkIntf(InterfaceEntry* intf)           { _info.linkIntf = intf;}
     void            setSocket(TCPSocket* socket)                { _info.socket = socket;}
     void            setSocketListen(TCPSocket* socket)          { _info.socketListen = socket;}
+    void            setMinRouteAdvertisementInterval(simtime_t interval) { _minRouteAdvertisementInterval = interval;}
+
+    /**
+     * \brief puts the route into the Adj-RIB-Out. Changed routes are sent immediately
+     * if the MinRouteAdvertisementInterval is zero, otherwise they are collected
+     * and sent together when the MinRouteAdvertisementIntervalTimer allows it.
+     */
+    void            advertiseRoute(const BGP::Prefix& prefix, const BGP::PathAttributes& attributes);
+    /**
+     * \brief sends the changed routes of the Adj-RIB-Out; prefixes with the same path
+     * attributes share UPDATE messages of at most BGP::MAX_MESSAGE_OCTETS
+     */
+    void            sendUpdateMessages();
+    void            minRouteAdvertisementTimerExpires();
+    /**
+     * \brief forgets the routes advertised to the peer when the session goes
+     * down; the Loc-RIB is advertised again when it is re-established
+     */
+    void            clearAdjRIBOut();
 
     //getters for accessing session information:
     void            getStatistics(unsigned int* statTab);
+    unsigned long   getNLRISent()                               { return _NLRISent;}
+    unsigned long   getNLRIRcv()                                { return _NLRIRcv;}
+    void            addNLRIRcv(unsigned long count)             { _NLRIRcv += count;}
+    BGP::AdjRIB&    getAdjRIBOut()                              { return _adjRIBOut;}
     bool            isEstablished()                             { return _info.sessionEstablished;}
     BGP::SessionID  getSessionID()                              { return _info.sessionID;}
     BGP::type       getType()                                   { return _info.sessionType;}
@@ -62,7 +85,8 @@ public:
     TCPSocket*      getSocket()                                 { return _info.socket;}
     TCPSocket*      getSocketListen()                           { return _info.socketListen;}
     IRoutingTable*  getIPRoutingTable()                         { return _bgpRouting.getIPRoutingTable();}
-    std::vector<BGP::RoutingTableEntry*> getBGPRoutingTable()   { return _bgpRouting.getBGPRoutingTable();}
+    const BGP::LocRIB& getLocRIB()                              { return _bgpRouting.getLocRIB();}
+    void getLocRIBInInstallOrder(std::vector<BGP::RoutingTableEntry*>& routes) { _bgpRouting.getLocRIBInInstallOrder(routes);}
     Macho::Machine<BGPFSM::TopState>&    getFSM()               { return *_fsm;}
     bool checkExternalRoute(const IPv4Route* ospfRoute)           { return _bgpRouting.checkExternalRoute(ospfRoute);}
     void updateSendProcess(BGP::RoutingTableEntry* entry)       { return _bgpRouting.updateSendProcess(BGP::NEW_SESSION_ESTABLISHED, _info.sessionID, entry);}
@@ -86,6 +110,12 @@ private:
     cMessage *      _ptrHoldTimer;
     simtime_t       _keepAliveTime;
     cMessage *      _ptrKeepAliveTimer;
+    simtime_t       _minRouteAdvertisementInterval;
+    cMessage *      _ptrMinRouteAdvertisementTimer;
+
+    //RIBs
+    BGP::AdjRIB             _adjRIBOut;         // routes advertised (or to be advertised) to the peer
+    std::set<BGP::Prefix>   _pendingPrefixes;   // Adj-RIB-Out routes not yet sent
 
     //Statistics
     unsigned int    _openMsgSent;
@@ -94,6 +124,8 @@ private:
     unsigned int    _keepAliveMsgRcv;
     unsigned int    _updateMsgSent;
     unsigned int    _updateMsgRcv;
+    unsigned long   _NLRISent;
+    unsigned long   _NLRIRcv;
 
 
     //FINAL STATE MACHINE
@@ -0,0 +1,259 @@
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <fstream>
+#include <sstream>
+
+#include "BGPTableInjector.h"
+
+#include "ModuleAccess.h"
+#include "NodeStatus.h"
+#include "BGPOpen_m.h"
+#include "BGPKeepAlive_m.h"
+#include "BGPUpdate.h"
+
+
+Define_Module(BGPTableInjector);
+
+BGPTableInjector::BGPTableInjector()
+{
+    socket = NULL;
+    keepAliveTimer = NULL;
+}
+
+BGPTableInjector::~BGPTableInjector()
+{
+    cancelAndDelete(keepAliveTimer);
+    delete socket;
+}
+
+void BGPTableInjector::initialize(int stage)
+{
+    cSimpleModule::initialize(stage);
+
+    if (stage == 0)
+    {
+        myAS = par("localAS");
+        holdTime = par("holdTime");
+        keepAliveTime = par("keepAliveTime");
+        keepAliveTimer = new cMessage("keepAliveTimer");
+        tableSent = false;
+        numRoutes = 0;
+        numUpdatesSent = numKeepAlivesSent = numUpdatesRcvd = 0;
+        tableSentTime = SIMTIME_ZERO;
+        loadRouteFile(par("routeFile"));
+        WATCH(numRoutes);
+        WATCH(numUpdatesSent);
+        WATCH(numUpdatesRcvd);
+    }
+    else if (stage == 3)
+    {
+        bool isOperational;
+        NodeStatus *nodeStatus = dynamic_cast<NodeStatus *>(findContainingNode(this)->getSubmodule("status"));
+        isOperational = (!nodeStatus) || nodeStatus->getState() == NodeStatus::UP;
+        if (!isOperational)
+            throw cRuntimeError("This module doesn't support starting in node DOWN state");
+
+        listenSocket.setOutputGate(gate("tcpOut"));
+        listenSocket.readDataTransferModePar(*this);
+        listenSocket.bind(BGP::TCP_PORT);
+        listenSocket.listen();
+    }
+}
+
+void BGPTableInjector::loadRouteFile(const char *fileName)
+{
+    std::ifstream in(fileName, std::ios::in);
+    if (in.fail())
+        throw cRuntimeError("Cannot open route file '%s'", fileName);
+
+    // one route per line: "<address>/<length> <AS> <AS> ...", '#' starts a comment
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line))
+    {
+        lineNumber++;
+        std::string::size_type commentPos = line.find('#');
+        if (commentPos != std::string::npos)
+            line.erase(commentPos);
+
+        std::istringstream fields(line);
+        std::string prefixText;
+        if (!(fields >> prefixText))
+            continue;   // empty line
+
+        std::string::size_type slashPos = prefixText.find('/');
+        std::string addressText = prefixText.substr(0, slashPos);
+        int length = slashPos == std::string::npos ? 32 : atoi(prefixText.c_str() + slashPos + 1);
+        if (!IPv4Address::isWellFormed(addressText.c_str()) || length < 0 || length > 32)
+            throw cRuntimeError("Invalid prefix '%s' at %s:%d", prefixText.c_str(), fileName, lineNumber);
+
+        // BGP speakers put their own AS in front of the path
+        std::vector<BGP::ASID> asPath;
+        unsigned long as;
+        while (fields >> as)
+        {
+            if (as == 0 || as > 0xffff)
+                throw cRuntimeError("Invalid AS number %lu at %s:%d", as, fileName, lineNumber);
+            asPath.push_back((BGP::ASID)as);
+        }
+        if (asPath.empty() || asPath[0] != myAS)
+            asPath.insert(asPath.begin(), myAS);
+
+        routes[asPath].push_back(BGP::Prefix(IPv4Address(addressText.c_str()), (unsigned char)length));
+        numRoutes++;
+    }
+    EV << "Loaded " << numRoutes << " routes with " << routes.size() << " different AS paths from " << fileName << endl;
+}
+
+void BGPTableInjector::handleMessage(cMessage *msg)
+{
+    if (msg == keepAliveTimer)
+    {
+        sendKeepAliveMessage();
+        scheduleAt(simTime() + keepAliveTime, keepAliveTimer);
+    }
+    else if (socket && socket->belongsToSocket(msg))
+    {
+        socket->processMessage(msg);
+    }
+    else if (msg->getKind() == TCP_I_ESTABLISHED)
+    {
+        // a new connection from the peer replaces the previous one
+        if (socket)
+        {
+            socket->abort();
+            delete socket;
+        }
+        cancelEvent(keepAliveTimer);
+        tableSent = false;
+        socket = new TCPSocket(msg);
+        socket->setOutputGate(gate("tcpOut"));
+        socket->readDataTransferModePar(*this);
+        socket->setCallbackObject(this);
+        socket->processMessage(msg);
+    }
+    else
+    {
+        // data or indication of an obsolete connection
+        delete msg;
+    }
+}
+
+void BGPTableInjector::socketDataArrived(int connId, void *yourPtr, cPacket *msg, bool urgent)
+{
+    BGPHeader *header = check_and_cast<BGPHeader *>(msg);
+    switch (header->getType())
+    {
+        case BGP_OPEN:
+            // accept the peer without checks, and confirm at once
+            sendOpenMessage();
+            sendKeepAliveMessage();
+            break;
+        case BGP_KEEPALIVE:
+            if (!tableSent)
+            {
+                // the session is established
+                sendTable();
+                scheduleAt(simTime() + keepAliveTime, keepAliveTimer);
+            }
+            break;
+        case BGP_UPDATE:
+            numUpdatesRcvd++;
+            break;
+        default:
+            throw cRuntimeError("Invalid BGP message type %d", header->getType());
+    }
+    delete msg;
+}
+
+void BGPTableInjector::socketPeerClosed(int connId, void *yourPtr)
+{
+    socket->close();
+    cancelEvent(keepAliveTimer);
+}
+
+void BGPTableInjector::socketFailure(int connId, void *yourPtr, int code)
+{
+    EV << "Connection to the peer broken, code " << code << endl;
+    cancelEvent(keepAliveTimer);
+}
+
+void BGPTableInjector::sendOpenMessage()
+{
+    BGPOpenMessage *openMsg = new BGPOpenMessage("BGPOpen");
+    openMsg->setMyAS(myAS);
+    openMsg->setHoldTime(holdTime);
+    openMsg->setBGPIdentifier(socket->getLocalAddress().get4());
+    socket->send(openMsg);
+}
+
+void BGPTableInjector::sendKeepAliveMessage()
+{
+    socket->send(new BGPKeepAliveMessage("BGPKeepAlive"));
+    numKeepAlivesSent++;
+}
+
+void BGPTableInjector::sendTable()
+{
+    IPv4Address nextHop = socket->getLocalAddress().get4();
+    for (RoutesByASPath::const_iterator it = routes.begin(); it != routes.end(); it++)
+    {
+        const std::vector<BGP::ASID>& asPath = it->first;
+        const std::vector<BGP::Prefix>& prefixes = it->second;
+
+        BGPUpdatePathAttributeList content;
+        content.setAsPathArraySize(1);
+        content.getAsPath(0).setValueArraySize(1);
+        content.getAsPath(0).getValue(0).setType(BGP::AS_SEQUENCE);
+        content.getAsPath(0).getValue(0).setAsValueArraySize(asPath.size());
+        content.getAsPath(0).getValue(0).setLength(1);
+        for (unsigned int j = 0; j < asPath.size(); j++)
+            content.getAsPath(0).getValue(0).setAsValue(j, asPath[j]);
+        content.getOrigin().setValue(BGP::IGP);
+        content.getNextHop().setValue(nextHop);
+
+        unsigned int i = 0;
+        while (i < prefixes.size())
+        {
+            BGPUpdateMessage *updateMsg = new BGPUpdateMessage("BGPUpdate");
+            updateMsg->setPathAttributeListArraySize(1);
+            updateMsg->setPathAttributeList(content);
+            while (i < prefixes.size() && (updateMsg->getNLRIArraySize() == 0 || updateMsg->getByteLength() + 5 <= BGP::MAX_MESSAGE_OCTETS))
+            {
+                BGPUpdateNLRI NLRI;
+                NLRI.prefix = prefixes[i].getAddress();
+                NLRI.length = prefixes[i].length;
+                updateMsg->addNLRI(NLRI);
+                i++;
+            }
+            socket->send(updateMsg);
+            numUpdatesSent++;
+        }
+    }
+    tableSent = true;
+    tableSentTime = simTime();
+    EV << "Sent " << numRoutes << " routes in " << numUpdatesSent << " UPDATE messages" << endl;
+}
+
+void BGPTableInjector::finish()
+{
+    recordScalar("routes", numRoutes);
+    recordScalar("UpdateMsgSent", numUpdatesSent);
+    recordScalar("KeepAliveMsgSent", numKeepAlivesSent);
+    recordScalar("UpdateMsgRcv", numUpdatesRcvd);
+    if (tableSent)
+        recordScalar("tableSentTime", tableSentTime);
+}
@@ -0,0 +1,74 @@
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef __INET_BGPTABLEINJECTOR_H
+#define __INET_BGPTABLEINJECTOR_H
+
+#include <map>
+#include <vector>
+
+#include "INETDefs.h"
+
+#include "TCPSocket.h"
+#include "BGPCommon.h"
+
+/**
+ * Minimal BGP speaker that feeds a routing table read from a file to a
+ * single BGPRouting peer. See the NED file for details.
+ */
+class INET_API BGPTableInjector : public cSimpleModule, public TCPSocket::CallbackInterface
+{
+  protected:
+    typedef std::map<std::vector<BGP::ASID>, std::vector<BGP::Prefix> > RoutesByASPath;
+
+    BGP::ASID myAS;
+    simtime_t holdTime;
+    simtime_t keepAliveTime;
+    RoutesByASPath routes;      // the table to inject, grouped by AS path
+    unsigned long numRoutes;
+
+    TCPSocket listenSocket;
+    TCPSocket *socket;          // connection to the peer, NULL if there is none
+    cMessage *keepAliveTimer;
+    bool tableSent;
+
+    // statistics
+    unsigned long numUpdatesSent;
+    unsigned long numKeepAlivesSent;
+    unsigned long numUpdatesRcvd;
+    simtime_t tableSentTime;
+
+  protected:
+    virtual void loadRouteFile(const char *fileName);
+    virtual void sendOpenMessage();
+    virtual void sendKeepAliveMessage();
+    virtual void sendTable();
+
+  public:
+    BGPTableInjector();
+    virtual ~BGPTableInjector();
+
+  protected:
+    virtual int numInitStages() const { return 4; }
+    virtual void initialize(int stage);
+    virtual void handleMessage(cMessage *msg);
+    virtual void finish();
+
+    virtual void socketDataArrived(int connId, void *yourPtr, cPacket *msg, bool urgent);
+    virtual void socketPeerClosed(int connId, void *yourPtr);
+    virtual void socketFailure(int connId, void *yourPtr, int code);
+};
+
+#endif
@@ -119,6 +119,8 @@ bool IPvXAddressResolver::tryResolve(const char *s, IPvXAddress& result, int add
     cModule *mod = simulation.getModuleByPath(modname.c_str());
     if (!mod)
         throw cRuntimeError("IPvXAddressResolver: module `%s' not found", modname.c_str());
+    if (mod->isPlaceholder())
+        throw cRuntimeError("IPvXAddressResolver: module `%s' is in another partition of the parallel simulation, use a literal address instead", modname.c_str());
 
 
     // check protocol
@@ -141,6 +143,8 @@ bool IPvXAddressResolver::tryResolve(const char *s, IPvXAddress& result, int add
         cModule *destnode = simulation.getModuleByPath(destnodename.c_str());
         if (!destnode)
             throw cRuntimeError("IPvXAddressResolver: destination module `%s' not found", destnodename.c_str());
+        if (destnode->isPlaceholder())
+            throw cRuntimeError("IPvXAddressResolver: destination module `%s' is in another partition of the parallel simulation", destnodename.c_str());
         result = addressOf(mod, destnode, addrType);
     }
     else if (ifname.empty())
@@ -66,6 +66,15 @@ void ICMP::sendErrorMessage(IPv4Datagram *origDatagram, int inputInterfaceId, IC
     // get ownership
     take(origDatagram);
 
+    // don't send ICMP error messages about fragments other than the first one
+    // (RFC 1122 3.2.2), they don't contain the transport header
+    if (origDatagram->getFragmentOffset() != 0)
+    {
+        EV << "won't send ICMP error messages for non-first fragment " << origDatagram << endl;
+        delete origDatagram;
+        return;
+    }
+
     // don't send ICMP error messages in response to broadcast or multicast messages
     IPv4Address origDestAddr = origDatagram->getDestAddress();
     if (origDestAddr.isMulticast() || origDestAddr.isLimitedBroadcastAddress() || possiblyLocalBroadcast(origDestAddr, inputInterfaceId))
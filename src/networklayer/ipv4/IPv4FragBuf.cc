@@ -18,6 +18,8 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <algorithm>
+#include <vector>
 
 #include "IPv4FragBuf.h"
 
@@ -61,8 +63,10 @@ IPv4Datagram *IPv4FragBuf::addFragment(IPv4Datagram *datagram, simtime_t now)
     if (i == bufs.end())
     {
         // this is the first fragment of that datagram, create reassembly buffer for it
-        buf = &bufs[key];
+        i = bufs.insert(std::make_pair(key, DatagramBuffer())).first;
+        buf = &(i->second);
         buf->datagram = NULL;
+        buf->agePos = ageList.insert(ageList.end(), key);
     }
     else
     {
@@ -101,6 +105,7 @@ IPv4Datagram *IPv4FragBuf::addFragment(IPv4Datagram *datagram, simtime_t now)
         ret->setByteLength(ret->getHeaderLength()+buf->buf.getTotalLength());
         ret->setFragmentOffset(0);
         ret->setMoreFragments(false);
+        ageList.erase(buf->agePos);
         bufs.erase(i);
         return ret;
     }
@@ -108,38 +113,40 @@ IPv4Datagram *IPv4FragBuf::addFragment(IPv4Datagram *datagram, simtime_t now)
     {
         // there are still missing fragments
         buf->lastupdate = now;
+        ageList.splice(ageList.end(), ageList, buf->agePos);
         return NULL;
     }
 }
 
 void IPv4FragBuf::purgeStaleFragments(simtime_t lastupdate)
 {
-    // this method shouldn't be called too often because iteration on
-    // an std::map is *very* slow...
-
     ASSERT(icmpModule);
 
-    for (Buffers::iterator i = bufs.begin(); i != bufs.end(); )
+    // ageList is ordered by the last update, so the stale buffers are at its
+    // front; they are removed in key order, like a scan of the map would do
+    std::vector<Key> staleKeys;
+    for (AgeList::iterator it = ageList.begin(); it != ageList.end(); ++it)
+    {
+        if (bufs.find(*it)->second.lastupdate >= lastupdate)
+            break;
+        staleKeys.push_back(*it);
+    }
+    std::sort(staleKeys.begin(), staleKeys.end());
+
+    for (std::vector<Key>::iterator it = staleKeys.begin(); it != staleKeys.end(); ++it)
     {
-        // if too old, remove it
+        Buffers::iterator i = bufs.find(*it);
         DatagramBuffer& buf = i->second;
-        if (buf.lastupdate < lastupdate)
-        {
-            // send ICMP error.
-            // Note: receiver MUST NOT call decapsulate() on the datagram fragment,
-            // because its length (being a fragment) is smaller than the encapsulated
-            // packet, resulting in "length became negative" error. Use getEncapsulatedPacket().
-            EV << "datagram fragment timed out in reassembly buffer, sending ICMP_TIME_EXCEEDED\n";
-            icmpModule->sendErrorMessage(buf.datagram, -1 /*TODO*/, ICMP_TIME_EXCEEDED, 0);
-
-            // delete
-            Buffers::iterator oldi = i++;
-            bufs.erase(oldi);
-        }
-        else
-        {
-            ++i;
-        }
+
+        // send ICMP error.
+        // Note: receiver MUST NOT call decapsulate() on the datagram fragment,
+        // because its length (being a fragment) is smaller than the encapsulated
+        // packet, resulting in "length became negative" error. Use getEncapsulatedPacket().
+        EV << "datagram fragment timed out in reassembly buffer, sending ICMP_TIME_EXCEEDED\n";
+        icmpModule->sendErrorMessage(buf.datagram, -1 /*TODO*/, ICMP_TIME_EXCEEDED, 0);
+
+        // delete
+        ageList.erase(buf.agePos);
+        bufs.erase(i);
     }
 }
-
@@ -0,0 +1,118 @@
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef __INET_IPV4FRAGMENTDECISIONS_H
+#define __INET_IPV4FRAGMENTDECISIONS_H
+
+#include <map>
+
+#include "INETDefs.h"
+
+#include "IPv4Datagram.h"
+
+/**
+ * Remembers what a netfilter hook decided about the first fragment of an
+ * IPv4 datagram (e.g. a next hop or an address translation), so that the
+ * hook can apply the same decision to the other fragments of the datagram.
+ * Only the first fragment carries the encapsulated packet (see
+ * IPv4::fragmentAndSend()), so hooks that look into the transport or
+ * routing header cannot decide about the other fragments on their own.
+ *
+ * A decision is forgotten when the last fragment is recalled, or when it
+ * is older than the timeout given to the constructor. Fragments that
+ * arrive before the first fragment of their datagram are not recognized.
+ */
+template <class T>
+class IPv4FragmentDecisions
+{
+  protected:
+    struct Key
+    {
+        ushort id;
+        IPv4Address src;
+        IPv4Address dest;
+
+        inline bool operator<(const Key& b) const {
+            return (id!=b.id) ? (id<b.id) : (src!=b.src) ? (src<b.src) : (dest<b.dest);
+        }
+    };
+
+    struct Decision
+    {
+        T value;
+        simtime_t time;
+    };
+
+    typedef std::map<Key, Decision> Decisions;
+
+    simtime_t timeout;
+    Decisions decisions;
+
+  public:
+    /** Identifies the datagram of a fragment; take it before the hook changes the addresses. */
+    class FragmentId : public Key
+    {
+      public:
+        FragmentId(const IPv4Datagram *datagram) {
+            this->id = datagram->getIdentification();
+            this->src = datagram->getSrcAddress();
+            this->dest = datagram->getDestAddress();
+        }
+    };
+
+  public:
+    IPv4FragmentDecisions(simtime_t timeout = 60.0) : timeout(timeout) {}
+
+    void setTimeout(simtime_t timeout) { this->timeout = timeout; }
+
+    /** True for the fragments that do not carry the encapsulated packet. */
+    static bool isNonFirstFragment(const IPv4Datagram *datagram) { return datagram->getFragmentOffset() != 0; }
+
+    /** True for the first fragment of a fragmented datagram. */
+    static bool isFirstFragment(const IPv4Datagram *datagram) { return datagram->getFragmentOffset() == 0 && datagram->getMoreFragments(); }
+
+    /** Stores the decision about the first fragment of a datagram; purges the stale decisions. */
+    void remember(const FragmentId& id, const T& value) {
+        simtime_t now = simTime();
+        for (typename Decisions::iterator it = decisions.begin(); it != decisions.end(); )
+        {
+            if (it->second.time < now - timeout)
+                decisions.erase(it++);
+            else
+                ++it;
+        }
+        Decision& decision = decisions[id];
+        decision.value = value;
+        decision.time = now;
+    }
+
+    /**
+     * Looks up the decision for a non-first fragment, and forgets it if this
+     * is the last fragment. Returns false if the decision is not known.
+     */
+    bool recall(const IPv4Datagram *fragment, T& value) {
+        typename Decisions::iterator it = decisions.find(FragmentId(fragment));
+        if (it == decisions.end() || it->second.time < simTime() - timeout)
+            return false;
+        value = it->second.value;
+        if (!fragment->getMoreFragments())
+            decisions.erase(it);
+        return true;
+    }
+
+    void clear() { decisions.clear(); }
+};
+
+#endif
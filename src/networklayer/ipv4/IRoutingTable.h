@@ -212,6 +212,29 @@ class INET_API IRoutingTable
      */
     virtual bool deleteMulticastRoute(IPv4MulticastRoute *entry) = 0;
 
+    /**
+     * Returns the host route (netmask 255.255.255.255) to the given destination
+     * that was added with the given source type, or NULL if there is none.
+     */
+    virtual IPv4Route *findHostRoute(const IPv4Address& dest, IPv4Route::SourceType sourceType) const = 0;
+
+    /**
+     * Returns the preferred route whose destination is the given address,
+     * regardless of its netmask and source type, or NULL if there is none.
+     */
+    virtual IPv4Route *findRouteByDestination(const IPv4Address& dest) const = 0;
+
+    /**
+     * Starts a batch of route changes: notifications, cache invalidation and
+     * display updates are coalesced until the matching commitRouteUpdate().
+     */
+    virtual void beginRouteUpdate() = 0;
+
+    /**
+     * Ends a batch of route changes started with beginRouteUpdate().
+     */
+    virtual void commitRouteUpdate() = 0;
+
     /**
      * Deletes invalid routes from the routing table. Invalid routes are those
      * where the isValid() method returns false.
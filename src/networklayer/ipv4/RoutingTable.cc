@@ -56,6 +56,9 @@ RoutingTable::RoutingTable()
 {
     ift = NULL;
     nb = NULL;
+    routeUpdateDepth = 0;
+    cacheInvalidationPending = false;
+    displayUpdatePending = false;
 }
 
 RoutingTable::~RoutingTable()
@@ -233,8 +236,9 @@ void RoutingTable::deleteInterfaceRoutes(InterfaceEntry *entry)
         if (route->getInterface() == entry)
         {
             it = routes.erase(it);
+            unindexRoute(route);
             ASSERT(route->getRoutingTable() == this); // still filled in, for the listeners' benefit
-            nb->fireChangeNotification(NF_IPv4_ROUTE_DELETED, route);
+            notifyRouteDeleted(route);
             delete route;
             changed = true;
         }
@@ -269,10 +273,7 @@ void RoutingTable::deleteInterfaceRoutes(InterfaceEntry *entry)
     }
 
     if (changed)
-    {
-        invalidateCache();
-        updateDisplayString();
-    }
+        routesChanged();
 }
 
 void RoutingTable::invalidateCache()
@@ -391,6 +392,8 @@ bool RoutingTable::isLocalAddress(const IPv4Address& dest) const
 {
     Enter_Method("isLocalAddress(%u.%u.%u.%u)", dest.getDByte(0), dest.getDByte(1), dest.getDByte(2), dest.getDByte(3)); // note: str().c_str() too slow here
 
+    flushPendingCacheInvalidation();
+
     if (localAddresses.empty())
     {
         // collect interface addresses if not yet done
@@ -410,6 +413,8 @@ bool RoutingTable::isLocalBroadcastAddress(const IPv4Address& dest) const
 {
     Enter_Method("isLocalBroadcastAddress(%u.%u.%u.%u)", dest.getDByte(0), dest.getDByte(1), dest.getDByte(2), dest.getDByte(3)); // note: str().c_str() too slow here
 
+    flushPendingCacheInvalidation();
+
     if (localBroadcastAddresses.empty())
     {
         // collect interface addresses if not yet done
@@ -467,8 +472,9 @@ void RoutingTable::purge()
         else
         {
             it = routes.erase(it);
+            unindexRoute(route);
             ASSERT(route->getRoutingTable() == this); // still filled in, for the listeners' benefit
-            nb->fireChangeNotification(NF_IPv4_ROUTE_DELETED, route);
+            notifyRouteDeleted(route);
             delete route;
             deleted = true;
         }
@@ -491,16 +497,15 @@ void RoutingTable::purge()
     }
 
     if (deleted)
-    {
-        invalidateCache();
-        updateDisplayString();
-    }
+        routesChanged();
 }
 
 IPv4Route *RoutingTable::findBestMatchingRoute(const IPv4Address& dest) const
 {
     Enter_Method("findBestMatchingRoute(%u.%u.%u.%u)", dest.getDByte(0), dest.getDByte(1), dest.getDByte(2), dest.getDByte(3)); // note: str().c_str() too slow here
 
+    flushPendingCacheInvalidation();
+
     RoutingCache::iterator it = routingCache.find(dest);
     if (it != routingCache.end())
     {
@@ -644,6 +649,7 @@ void RoutingTable::internalAddRoute(IPv4Route *entry)
     // stop at the first match when doing the longest netmask matching
     RouteVector::iterator pos = upper_bound(routes.begin(), routes.end(), entry, routeLessThan);
     routes.insert(pos, entry);
+    indexRoute(entry);
 
     entry->setRoutingTable(this);
 }
@@ -654,10 +660,9 @@ void RoutingTable::addRoute(IPv4Route *entry)
 
     internalAddRoute(entry);
 
-    invalidateCache();
-    updateDisplayString();
+    routesChanged();
 
-    nb->fireChangeNotification(NF_IPv4_ROUTE_ADDED, entry);
+    notifyRouteAdded(entry);
 }
 
 IPv4Route *RoutingTable::internalRemoveRoute(IPv4Route *entry)
@@ -666,6 +671,7 @@ IPv4Route *RoutingTable::internalRemoveRoute(IPv4Route *entry)
     if (i!=routes.end())
     {
         routes.erase(i);
+        unindexRoute(entry);
         return entry;
     }
     return NULL;
@@ -679,10 +685,9 @@ IPv4Route *RoutingTable::removeRoute(IPv4Route *entry)
 
     if (entry != NULL)
     {
-        invalidateCache();
-        updateDisplayString();
+        routesChanged();
         ASSERT(entry->getRoutingTable() == this); // still filled in, for the listeners' benefit
-        nb->fireChangeNotification(NF_IPv4_ROUTE_DELETED, entry);
+        notifyRouteDeleted(entry);
         entry->setRoutingTable(NULL);
     }
     return entry;
@@ -696,10 +701,9 @@ bool RoutingTable::deleteRoute(IPv4Route *entry)
 
     if (entry != NULL)
     {
-        invalidateCache();
-        updateDisplayString();
+        routesChanged();
         ASSERT(entry->getRoutingTable() == this); // still filled in, for the listeners' benefit
-        nb->fireChangeNotification(NF_IPv4_ROUTE_DELETED, entry);
+        notifyRouteDeleted(entry);
         delete entry;
     }
     return entry != NULL;
@@ -827,10 +831,9 @@ void RoutingTable::routeChanged(IPv4Route *entry, int fieldCode)
         ASSERT(entry != NULL);  // failure means inconsistency: route was not found in this routing table
         internalAddRoute(entry);
 
-        invalidateCache();
-        updateDisplayString();
+        routesChanged();
     }
-    nb->fireChangeNotification(NF_IPv4_ROUTE_CHANGED, entry); // TODO include fieldCode in the notification
+    notifyRouteChanged(entry); // TODO include fieldCode in the notification
 }
 
 void RoutingTable::multicastRouteChanged(IPv4MulticastRoute *entry, int fieldCode)
@@ -858,8 +861,9 @@ void RoutingTable::updateNetmaskRoutes()
             std::vector<IPv4Route *>::iterator it = routes.begin()+(k--);  // '--' is necessary because indices shift down
             IPv4Route *route = *it;
             routes.erase(it);
+            unindexRoute(route);
             ASSERT(route->getRoutingTable() == this); // still filled in, for the listeners' benefit
-            nb->fireChangeNotification(NF_IPv4_ROUTE_DELETED, route);
+            notifyRouteDeleted(route);
             delete route;
         }
     }
@@ -884,12 +888,12 @@ void RoutingTable::updateNetmaskRoutes()
             route->setRoutingTable(this);
             RouteVector::iterator pos = upper_bound(routes.begin(), routes.end(), route, routeLessThan);
             routes.insert(pos, route);
-            nb->fireChangeNotification(NF_IPv4_ROUTE_ADDED, route);
+            indexRoute(route);
+            notifyRouteAdded(route);
         }
     }
 
-    invalidateCache();
-    updateDisplayString();
+    routesChanged();
 }
 
 bool RoutingTable::handleOperationStage(LifecycleOperation *operation, int stage, IDoneCallback *doneCallback)
@@ -927,3 +931,169 @@ IPv4Route *RoutingTable::createNewRoute()
 {
     return new IPv4Route();
 }
+
+void RoutingTable::indexRoute(IPv4Route *entry)
+{
+    DestinationIndex::iterator it = routesByDestination.insert(std::make_pair(entry->getDestination().getInt(), entry));
+    destinationIndexEntries[entry] = it;
+}
+
+void RoutingTable::unindexRoute(IPv4Route *entry)
+{
+    // the destination may have been changed since the route was indexed,
+    // so its entry is looked up by the route instead of the current key
+    DestinationIndexEntries::iterator it = destinationIndexEntries.find(entry);
+    if (it != destinationIndexEntries.end())
+    {
+        routesByDestination.erase(it->second);
+        destinationIndexEntries.erase(it);
+    }
+}
+
+IPv4Route *RoutingTable::findHostRoute(const IPv4Address& dest, IPv4Route::SourceType sourceType) const
+{
+    std::pair<DestinationIndex::const_iterator, DestinationIndex::const_iterator> range =
+            routesByDestination.equal_range(dest.getInt());
+    IPv4Route *bestRoute = NULL;
+    for (DestinationIndex::const_iterator it = range.first; it != range.second; ++it)
+    {
+        IPv4Route *route = it->second;
+        if (route->getNetmask() != IPv4Address::ALLONES_ADDRESS || route->getSourceType() != sourceType)
+            continue;
+        if (bestRoute == NULL || routeLessThan(route, bestRoute))
+            bestRoute = route;
+    }
+    return bestRoute;
+}
+
+IPv4Route *RoutingTable::findRouteByDestination(const IPv4Address& dest) const
+{
+    std::pair<DestinationIndex::const_iterator, DestinationIndex::const_iterator> range =
+            routesByDestination.equal_range(dest.getInt());
+    IPv4Route *bestRoute = NULL;
+    for (DestinationIndex::const_iterator it = range.first; it != range.second; ++it)
+    {
+        if (bestRoute == NULL || routeLessThan(it->second, bestRoute))
+            bestRoute = it->second;
+    }
+    return bestRoute;
+}
+
+void RoutingTable::beginRouteUpdate()
+{
+    Enter_Method_Silent();
+    routeUpdateDepth++;
+}
+
+void RoutingTable::commitRouteUpdate()
+{
+    Enter_Method_Silent();
+
+    if (routeUpdateDepth <= 0)
+        throw cRuntimeError("commitRouteUpdate() without beginRouteUpdate()");
+    if (routeUpdateDepth > 1)
+    {
+        routeUpdateDepth--;
+        return;
+    }
+
+    // Fire the collected notifications. The transaction is kept open meanwhile,
+    // so that routes changed or deleted by the listeners are handled the same way.
+    for (size_t i = 0; i < pendingRoutes.size(); i++)
+    {
+        IPv4Route *entry = pendingRoutes[i];
+        if (entry != NULL)
+        {
+            PendingNotificationMap::iterator it = pendingNotifications.find(entry);
+            int category = it->second.first;
+            pendingNotifications.erase(it);
+            pendingRoutes[i] = NULL;
+            nb->fireChangeNotification(category, entry);
+        }
+    }
+    ASSERT(pendingNotifications.empty());
+    pendingRoutes.clear();
+    routeUpdateDepth = 0;
+
+    if (cacheInvalidationPending)
+        invalidateCache();
+    if (displayUpdatePending)
+        updateDisplayString();
+    cacheInvalidationPending = displayUpdatePending = false;
+}
+
+void RoutingTable::flushPendingCacheInvalidation() const
+{
+    if (cacheInvalidationPending)
+    {
+        routingCache.clear();
+        localAddresses.clear();
+        localBroadcastAddresses.clear();
+        cacheInvalidationPending = false;
+    }
+}
+
+void RoutingTable::routesChanged()
+{
+    if (routeUpdateDepth > 0)
+    {
+        cacheInvalidationPending = true;
+        displayUpdatePending = true;
+    }
+    else
+    {
+        invalidateCache();
+        updateDisplayString();
+    }
+}
+
+void RoutingTable::notifyRouteAdded(IPv4Route *entry)
+{
+    if (routeUpdateDepth == 0)
+    {
+        nb->fireChangeNotification(NF_IPv4_ROUTE_ADDED, entry);
+        return;
+    }
+
+    PendingNotificationMap::iterator it = pendingNotifications.find(entry);
+    if (it != pendingNotifications.end())
+        it->second.first = NF_IPv4_ROUTE_ADDED;
+    else
+    {
+        pendingNotifications[entry] = std::make_pair((int)NF_IPv4_ROUTE_ADDED, pendingRoutes.size());
+        pendingRoutes.push_back(entry);
+    }
+}
+
+void RoutingTable::notifyRouteChanged(IPv4Route *entry)
+{
+    if (routeUpdateDepth == 0)
+    {
+        nb->fireChangeNotification(NF_IPv4_ROUTE_CHANGED, entry);
+        return;
+    }
+
+    // an already pending ADDED or CHANGED notification covers this change as well
+    if (pendingNotifications.find(entry) == pendingNotifications.end())
+    {
+        pendingNotifications[entry] = std::make_pair((int)NF_IPv4_ROUTE_CHANGED, pendingRoutes.size());
+        pendingRoutes.push_back(entry);
+    }
+}
+
+void RoutingTable::notifyRouteDeleted(IPv4Route *entry)
+{
+    if (routeUpdateDepth > 0)
+    {
+        PendingNotificationMap::iterator it = pendingNotifications.find(entry);
+        if (it != pendingNotifications.end())
+        {
+            int category = it->second.first;
+            pendingRoutes[it->second.second] = NULL;
+            pendingNotifications.erase(it);
+            if (category == NF_IPv4_ROUTE_ADDED)
+                return; // the listeners have never seen this route
+        }
+    }
+    nb->fireChangeNotification(NF_IPv4_ROUTE_DELETED, entry);
+}
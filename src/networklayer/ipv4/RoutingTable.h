@@ -28,6 +28,7 @@
 #ifndef __ROUTINGTABLE_H
 #define __ROUTINGTABLE_H
 
+#include <map>
 #include <vector>
 
 #include "INETDefs.h"
@@ -96,6 +97,20 @@ class INET_API RoutingTable: public cSimpleModule, public IRoutingTable, protect
     // JcM add: to handle the local broadcast address
     mutable AddressSet localBroadcastAddresses;
 
+    // exact-match index of the unicast routes, keyed by destination
+    typedef std::multimap<uint32, IPv4Route *> DestinationIndex;
+    DestinationIndex routesByDestination;
+    typedef std::map<IPv4Route *, DestinationIndex::iterator> DestinationIndexEntries;
+    DestinationIndexEntries destinationIndexEntries; // position of each route in routesByDestination
+
+    // route update transaction state, see beginRouteUpdate()
+    int routeUpdateDepth;                  // nesting level of beginRouteUpdate() calls
+    mutable bool cacheInvalidationPending; // caches must be flushed before the next lookup
+    bool displayUpdatePending;             // the display string must be updated on commit
+    std::vector<IPv4Route *> pendingRoutes;     // routes with pending notifications, in order of the first change (NULL if cancelled)
+    typedef std::map<IPv4Route *, std::pair<int, size_t> > PendingNotificationMap;
+    PendingNotificationMap pendingNotifications; // route -> (NF_IPv4_ROUTE_ADDED or NF_IPv4_ROUTE_CHANGED, index in pendingRoutes)
+
   private:
     // The vectors storing routes are ordered by prefix length, administrative distance, and metric.
     // Subclasses should use internalAdd[Multicast]Route() and internalRemove[Multicast]Route() methods
@@ -130,6 +145,21 @@ class INET_API RoutingTable: public cSimpleModule, public IRoutingTable, protect
     // invalidates routing cache and local addresses cache
     virtual void invalidateCache();
 
+    // flushes the caches if their invalidation was deferred by a route update transaction
+    void flushPendingCacheInvalidation() const;
+
+    // invalidates the caches and updates the display string, or defers both until commitRouteUpdate()
+    virtual void routesChanged();
+
+    // fire route notifications, or record them until commitRouteUpdate()
+    virtual void notifyRouteAdded(IPv4Route *entry);
+    virtual void notifyRouteChanged(IPv4Route *entry);
+    virtual void notifyRouteDeleted(IPv4Route *entry);
+
+    // maintain the destination index
+    void indexRoute(IPv4Route *entry);
+    void unindexRoute(IPv4Route *entry);
+
     // helper for sorting routing table, used by addRoute()
     static bool routeLessThan(const IPv4Route *a, const IPv4Route *b);
 
@@ -337,6 +367,39 @@ class INET_API RoutingTable: public cSimpleModule, public IRoutingTable, protect
      */
     virtual bool deleteMulticastRoute(IPv4MulticastRoute *entry);
 
+    /**
+     * Returns the host route (netmask 255.255.255.255) to the given destination
+     * that was added with the given source type, or NULL if there is none.
+     * If there are several, the preferred one (lowest admin distance and metric)
+     * is returned. This is an exact-match lookup via an index, and does not
+     * scan the table.
+     */
+    virtual IPv4Route *findHostRoute(const IPv4Address& dest, IPv4Route::SourceType sourceType) const;
+
+    /**
+     * Returns the preferred route whose destination is the given address,
+     * regardless of its netmask and source type, or NULL if there is none.
+     * Like findHostRoute(), this is an exact-match lookup via an index.
+     */
+    virtual IPv4Route *findRouteByDestination(const IPv4Address& dest) const;
+
+    /**
+     * Starts a route update transaction. Until the matching commitRouteUpdate(),
+     * the routing cache is not flushed and the display string is not updated
+     * on every change, and the NF_IPv4_ROUTE_ADDED and NF_IPv4_ROUTE_CHANGED
+     * notifications are collected and fired once per route on commit.
+     * Routes added and deleted within the same transaction are not announced
+     * at all. NF_IPv4_ROUTE_DELETED is fired immediately, while the route object
+     * still exists. Transactions may be nested; only the outermost commit has
+     * an effect. Lookups within a transaction see the current table.
+     */
+    virtual void beginRouteUpdate();
+
+    /**
+     * Ends the route update transaction started with beginRouteUpdate().
+     */
+    virtual void commitRouteUpdate();
+
     /**
      * Deletes invalid routes from the routing table. Invalid routes are those
      * where the isValid() method returns false.
@@ -18,6 +18,7 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <algorithm>
 
 #include "INETDefs.h"
 
@@ -56,9 +57,11 @@ IPv6Datagram *IPv6FragBuf::addFragment(IPv6Datagram *datagram, IPv6FragmentHeade
     if (i==bufs.end())
     {
         // this is the first fragment of that datagram, create reassembly buffer for it
-        buf = &bufs[key];
+        i = bufs.insert(std::make_pair(key, DatagramBuffer())).first;
+        buf = &(i->second);
         buf->datagram = NULL;
         buf->createdAt = now;
+        buf->agePos = ageList.insert(ageList.end(), key);
     }
     else
     {
@@ -122,6 +125,7 @@ IPv6Datagram *IPv6FragBuf::addFragment(IPv6Datagram *datagram, IPv6FragmentHeade
         ASSERT(ret);
         ret->removeExtensionHeader(IP_PROT_IPv6EXT_FRAGMENT);
         ret->setByteLength(ret->calculateUnfragmentableHeaderByteLength()+buf->buf.getTotalLength());
+        ageList.erase(buf->agePos);
         bufs.erase(i);
         return ret;
     }
@@ -145,32 +149,31 @@ IPv6Datagram *IPv6FragBuf::addFragment(IPv6Datagram *datagram, IPv6FragmentHeade
  */
 void IPv6FragBuf::purgeStaleFragments(simtime_t lastupdate)
 {
-    // this method shouldn't be called too often because iteration on
-    // an std::map is *very* slow...
-
     ASSERT(icmpModule);
 
-    for (Buffers::iterator i=bufs.begin(); i!=bufs.end(); )
+    // ageList is ordered by the creation time, so the stale buffers are at
+    // its front; they are removed in key order, like a scan of the map would do
+    std::vector<Key> staleKeys;
+    for (AgeList::iterator it = ageList.begin(); it != ageList.end(); ++it)
+    {
+        if (bufs.find(*it)->second.createdAt >= lastupdate)
+            break;
+        staleKeys.push_back(*it);
+    }
+    std::sort(staleKeys.begin(), staleKeys.end());
+
+    for (std::vector<Key>::iterator it = staleKeys.begin(); it != staleKeys.end(); ++it)
     {
-        // if too old, remove it
+        Buffers::iterator i = bufs.find(*it);
         DatagramBuffer& buf = i->second;
-        if (buf.createdAt < lastupdate)
+        if (buf.datagram)
         {
-            if (buf.datagram)
-            {
-                // send ICMP error
-                EV << "datagram fragment timed out in reassembly buffer, sending ICMP_TIME_EXCEEDED\n";
-                icmpModule->sendErrorMessage(buf.datagram, ICMPv6_TIME_EXCEEDED, 0);
-            }
-
-            // delete
-            Buffers::iterator oldi = i++;
-            bufs.erase(oldi);
-        }
-        else
-        {
-            ++i;
+            // send ICMP error
+            EV << "datagram fragment timed out in reassembly buffer, sending ICMP_TIME_EXCEEDED\n";
+            icmpModule->sendErrorMessage(buf.datagram, ICMPv6_TIME_EXCEEDED, 0);
         }
+        // delete
+        ageList.erase(buf.agePos);
+        bufs.erase(i);
     }
 }
-
@@ -18,6 +18,7 @@
 #ifndef __IPv6FRAGBUF_H__
 #define __IPv6FRAGBUF_H__
 
+#include <list>
 #include <map>
 #include <vector>
 #include "INETDefs.h"
@@ -48,6 +49,9 @@ class INET_API IPv6FragBuf
         }
     };
 
+    // keys of the buffers in the order of creation
+    typedef std::list<Key> AgeList;
+
     //
     // Reassembly buffer for the datagram
     //
@@ -56,6 +60,7 @@ class INET_API IPv6FragBuf
         ReassemblyBuffer buf;  // reassembly buffer
         IPv6Datagram *datagram;  // the actual datagram
         simtime_t createdAt;  // time of the buffer creation (i.e. reception time of first-arriving fragment)
+        AgeList::iterator agePos;  // position in ageList
     };
 
     // we use std::map for fast lookup by datagram Id
@@ -64,6 +69,9 @@ class INET_API IPv6FragBuf
     // the reassembly buffers
     Buffers bufs;
 
+    // purgeStaleFragments() only visits the buffers that timed out
+    AgeList ageList;
+
     // needed for TIME_EXCEEDED errors
     ICMPv6 *icmpModule;
 
@@ -98,7 +106,8 @@ class INET_API IPv6FragBuf
      *
      * Timeout should be between 60 seconds and 120 seconds (RFC1122).
      * This method should be called more frequently, maybe every
-     * 10..30 seconds or so.
+     * 10..30 seconds or so. Its cost is proportional to the number of
+     * buffers removed, not to the number of buffers.
      */
     void purgeStaleFragments(simtime_t lastupdate);
 };
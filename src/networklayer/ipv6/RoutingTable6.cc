@@ -80,14 +80,35 @@ std::ostream& operator<<(std::ostream& os, const RoutingTable6::DestCacheEntry&
     return os;
 };
 
+RoutingTable6::RouteTrieNode::RouteTrieNode()
+{
+    for (int i=0; i<16; i++)
+        children[i] = NULL;
+}
+
+RoutingTable6::RouteTrieNode::~RouteTrieNode()
+{
+    for (int i=0; i<16; i++)
+        delete children[i];
+}
+
+// the i-th 4-bit digit of the address, from the most significant one
+static inline int getNibble(const IPv6Address& addr, int i)
+{
+    return (addr.words()[i / 8] >> (28 - 4 * (i % 8))) & 0xf;
+}
+
 RoutingTable6::RoutingTable6()
 {
+    destCacheSize = -1;
+    routeTrie = new RouteTrieNode();
 }
 
 RoutingTable6::~RoutingTable6()
 {
     for (unsigned int i=0; i<routeList.size(); i++)
         delete routeList[i];
+    delete routeTrie;
 }
 
 IPv6Route *RoutingTable6::createNewRoute(IPv6Address destPrefix, int prefixLength, IPv6Route::RouteSrc src)
@@ -114,6 +135,7 @@ void RoutingTable6::initialize(int stage)
         WATCH_MAP(destCache); // FIXME commented out for now
         isrouter = par("isRouter");
         multicastForward = par("forwardMulticast");
+        destCacheSize = par("destCacheSize");
         WATCH(isrouter);
 
 #ifdef WITH_xMIPv6
@@ -267,6 +289,8 @@ void RoutingTable6::routeChanged(IPv6Route *entry, int fieldCode)
      route information.*/
     if (fieldCode==IPv6Route::F_NEXTHOP || fieldCode==IPv6Route::F_IFACE)
         purgeDestCache();
+    else if (fieldCode==IPv6Route::F_EXPIRYTIME)
+        updateRouteExpiry(entry);
 
     updateDisplayString();
 
@@ -462,7 +486,7 @@ void RoutingTable6::configureTunnelFromXML(cXMLElement* cfg)
 
 InterfaceEntry *RoutingTable6::getInterfaceByAddress(const IPv6Address& addr)
 {
-    Enter_Method("getInterfaceByAddress(%s)=?", addr.str().c_str());
+    Enter_Method_Silent();  // called for every packet, don't format the address
 
     if (addr.isUnspecified())
         return NULL;
@@ -478,7 +502,7 @@ InterfaceEntry *RoutingTable6::getInterfaceByAddress(const IPv6Address& addr)
 
 bool RoutingTable6::isLocalAddress(const IPv6Address& dest) const
 {
-    Enter_Method("isLocalAddress(%s) y/n", dest.str().c_str());
+    Enter_Method_Silent();  // called for every packet, don't format the address
 
     // first, check if we have an interface with this address
     for (int i=0; i<ift->getNumInterfaces(); i++)
@@ -513,7 +537,7 @@ bool RoutingTable6::isLocalAddress(const IPv6Address& dest) const
 
 const IPv6Address& RoutingTable6::lookupDestCache(const IPv6Address& dest, int& outInterfaceId)
 {
-    Enter_Method("lookupDestCache(%s)", dest.str().c_str());
+    Enter_Method_Silent();  // called for every packet, don't format the address
 
     DestCache::iterator it = destCache.find(dest);
     if (it == destCache.end())
@@ -524,45 +548,118 @@ const IPv6Address& RoutingTable6::lookupDestCache(const IPv6Address& dest, int&
     DestCacheEntry &entry = it->second;
     if (entry.expiryTime > 0 && simTime() > entry.expiryTime)
     {
-        destCache.erase(it);
+        eraseDestCacheEntry(it);
         outInterfaceId = -1;
         return IPv6Address::UNSPECIFIED_ADDRESS;
     }
 
+    // mark as most recently used
+    destCacheLRU.splice(destCacheLRU.begin(), destCacheLRU, entry.lruPos);
+
     outInterfaceId = entry.interfaceId;
     return entry.nextHopAddr;
 }
 
 const IPv6Route *RoutingTable6::doLongestPrefixMatch(const IPv6Address& dest)
 {
-    Enter_Method("doLongestPrefixMatch(%s)", dest.str().c_str());
+    Enter_Method_Silent();  // called for every packet, don't format the address
 
-    // we'll just stop at the first match, because the table is sorted
-    // by prefix lengths and metric (see addRoute())
+    purgeExpiredPrefixes();
 
-    // bugfix - CB
-    RouteList::iterator it = routeList.begin();
-    while (it!=routeList.end())
+    // walk down the trie along the address; deeper nodes hold longer
+    // prefixes, and the routes of a node are in routeList order (see addRoute())
+    const IPv6Route *bestRoute = NULL;
+    RouteTrieNode *node = routeTrie;
+    for (int depth = 0; node; depth++)
     {
-        if (dest.matches((*it)->getDestPrefix(), (*it)->getPrefixLength()))
+        for (RouteList::const_iterator it = node->routes.begin(); it != node->routes.end(); it++)
         {
-            if (simTime() > (*it)->getExpiryTime() && (*it)->getExpiryTime() != 0)//since 0 represents infinity.
-            {
-                if ( (*it)->getSrc()==IPv6Route::FROM_RA )
-                {
-                    EV << "Expired prefix detected!!" << endl;
-                    it = routeList.erase(it);
-                    //RouteList::iterator oldIt = it++;
-                    //removeOnLinkPrefix((*oldIt)->getDestPrefix(), (*oldIt)->getPrefixLength());
-                }
-            }
-            else
-                return *it;
+            const IPv6Route *route = *it;
+            if (!dest.matches(route->getDestPrefix(), route->getPrefixLength()))
+                continue;
+            if (simTime() > route->getExpiryTime() && route->getExpiryTime() != 0) //since 0 represents infinity.
+                continue;
+            bestRoute = route;
+            break;
         }
-        else
-            ++it;
+        node = depth < 32 ? node->children[getNibble(dest, depth)] : NULL;
+    }
+    return bestRoute;
+}
+
+void RoutingTable6::purgeExpiredPrefixes()
+{
+    bool changed = false;
+    while (!expiryQueue.empty() && simTime() > expiryQueue.begin()->first)
+    {
+        IPv6Route *route = expiryQueue.begin()->second;
+        EV << "Expired prefix detected!!" << endl;
+        expiryQueuePos.erase(route);
+        expiryQueue.erase(expiryQueue.begin());
+        RouteList::iterator it = std::find(routeList.begin(), routeList.end(), route);
+        ASSERT(it != routeList.end());
+        routeList.erase(it);
+        changed = true;
+    }
+    if (changed)
+    {
+        rebuildRouteIndex();
+        updateDisplayString();
+    }
+}
+
+void RoutingTable6::rebuildRouteIndex()
+{
+    delete routeTrie;
+    routeTrie = new RouteTrieNode();
+    expiryQueue.clear();
+    expiryQueuePos.clear();
+
+    for (RouteList::iterator it = routeList.begin(); it != routeList.end(); it++)
+    {
+        IPv6Route *route = *it;
+        RouteTrieNode *node = routeTrie;
+        int depth = route->getPrefixLength() / 4;
+        for (int i = 0; i < depth; i++)
+        {
+            RouteTrieNode *&child = node->children[getNibble(route->getDestPrefix(), i)];
+            if (!child)
+                child = new RouteTrieNode();
+            node = child;
+        }
+        node->routes.push_back(route);
+
+        if (route->getSrc() == IPv6Route::FROM_RA && route->getExpiryTime() != 0)
+            expiryQueuePos[route] = expiryQueue.insert(std::make_pair(route->getExpiryTime(), route));
+    }
+}
+
+void RoutingTable6::updateRouteExpiry(IPv6Route *route)
+{
+    std::map<IPv6Route*, ExpiryQueue::iterator>::iterator it = expiryQueuePos.find(route);
+    if (it != expiryQueuePos.end())
+    {
+        expiryQueue.erase(it->second);
+        expiryQueuePos.erase(it);
     }
-    // FIXME todo: if we selected an expired route, throw it out and select again!
+
+    // routes removed by removeOnLinkPrefix() still point to this table
+    if (route->getSrc() == IPv6Route::FROM_RA && route->getExpiryTime() != 0 &&
+        std::find(routeList.begin(), routeList.end(), route) != routeList.end())
+        expiryQueuePos[route] = expiryQueue.insert(std::make_pair(route->getExpiryTime(), route));
+}
+
+IPv6Route *RoutingTable6::findRoute(const IPv6Address& prefix, int prefixLength, IPv6Route::RouteSrc src)
+{
+    RouteTrieNode *node = routeTrie;
+    for (int i = 0; node && i < prefixLength / 4; i++)
+        node = node->children[getNibble(prefix, i)];
+    if (!node)
+        return NULL;
+
+    for (RouteList::iterator it = node->routes.begin(); it != node->routes.end(); it++)
+        if ((*it)->getSrc()==src && (*it)->getDestPrefix()==prefix && (*it)->getPrefixLength()==prefixLength)
+            return *it;
     return NULL;
 }
 
@@ -576,17 +673,40 @@ bool RoutingTable6::isPrefixPresent(const IPv6Address& prefix) const
 
 void RoutingTable6::updateDestCache(const IPv6Address& dest, const IPv6Address& nextHopAddr, int interfaceId, simtime_t expiryTime)
 {
-    DestCacheEntry &entry = destCache[dest];
+    DestCache::iterator it = destCache.find(dest);
+    if (it == destCache.end())
+    {
+        // evict the least recently used entry if the cache is full
+        if (destCacheSize >= 0 && (int)destCache.size() >= destCacheSize && !destCacheLRU.empty())
+            eraseDestCacheEntry(destCache.find(destCacheLRU.back()));
+        if (destCacheSize == 0)
+            return;
+
+        it = destCache.insert(std::make_pair(dest, DestCacheEntry())).first;
+        destCacheLRU.push_front(dest);
+    }
+    else
+        destCacheLRU.splice(destCacheLRU.begin(), destCacheLRU, it->second.lruPos);
+
+    DestCacheEntry &entry = it->second;
     entry.nextHopAddr = nextHopAddr;
     entry.interfaceId = interfaceId;
     entry.expiryTime = expiryTime;
+    entry.lruPos = destCacheLRU.begin();
 
     updateDisplayString();
 }
 
+void RoutingTable6::eraseDestCacheEntry(DestCache::iterator it)
+{
+    destCacheLRU.erase(it->second.lruPos);
+    destCache.erase(it);
+}
+
 void RoutingTable6::purgeDestCache()
 {
     destCache.clear();
+    destCacheLRU.clear();
     updateDisplayString();
 }
 
@@ -597,7 +717,7 @@ void RoutingTable6::purgeDestCacheEntriesToNeighbour(const IPv6Address& nextHopA
         if (it->second.interfaceId==interfaceId && it->second.nextHopAddr==nextHopAddr)
         {
             // move the iterator past this element before removing it
-            destCache.erase(it++);
+            eraseDestCacheEntry(it++);
         }
         else
         {
@@ -615,7 +735,7 @@ void RoutingTable6::purgeDestCacheForInterfaceID(int interfaceId)
         if (it->second.interfaceId==interfaceId)
         {
             // move the iterator past this element before removing it
-            destCache.erase(it++);
+            eraseDestCacheEntry(it++);
         }
         else
         {
@@ -630,15 +750,7 @@ void RoutingTable6::addOrUpdateOnLinkPrefix(const IPv6Address& destPrefix, int p
         int interfaceId, simtime_t expiryTime)
 {
     // see if prefix exists in table
-    IPv6Route *route = NULL;
-    for (RouteList::iterator it=routeList.begin(); it!=routeList.end(); it++)
-    {
-        if ((*it)->getSrc()==IPv6Route::FROM_RA && (*it)->getDestPrefix()==destPrefix && (*it)->getPrefixLength()==prefixLength)
-        {
-            route = *it;
-            break;
-        }
-    }
+    IPv6Route *route = findRoute(destPrefix, prefixLength, IPv6Route::FROM_RA);
 
     if (route==NULL)
     {
@@ -670,15 +782,7 @@ void RoutingTable6::addOrUpdateOwnAdvPrefix(const IPv6Address& destPrefix, int p
     // FIXME this is very similar to the one above -- refactor!!
 
     // see if prefix exists in table
-    IPv6Route *route = NULL;
-    for (RouteList::iterator it=routeList.begin(); it!=routeList.end(); it++)
-    {
-        if ((*it)->getSrc()==IPv6Route::OWN_ADV_PREFIX && (*it)->getDestPrefix()==destPrefix && (*it)->getPrefixLength()==prefixLength)
-        {
-            route = *it;
-            break;
-        }
-    }
+    IPv6Route *route = findRoute(destPrefix, prefixLength, IPv6Route::OWN_ADV_PREFIX);
 
     if (route==NULL)
     {
@@ -706,14 +810,13 @@ void RoutingTable6::addOrUpdateOwnAdvPrefix(const IPv6Address& destPrefix, int p
 
 void RoutingTable6::removeOnLinkPrefix(const IPv6Address& destPrefix, int prefixLength)
 {
-    // scan the routing table for this prefix and remove it
-    for (RouteList::iterator it=routeList.begin(); it!=routeList.end(); it++)
+    // there can be only one such route, addOrUpdateOnLinkPrefix() guarantees that
+    IPv6Route *route = findRoute(destPrefix, prefixLength, IPv6Route::FROM_RA);
+    if (route)
     {
-        if ((*it)->getSrc()==IPv6Route::FROM_RA && (*it)->getDestPrefix()==destPrefix && (*it)->getPrefixLength()==prefixLength)
-        {
-            routeList.erase(it);
-            return; // there can be only one such route, addOrUpdateOnLinkPrefix() guarantees that
-        }
+        routeList.erase(std::find(routeList.begin(), routeList.end(), route));
+        rebuildRouteIndex();
+        return;
     }
 
     updateDisplayString();
@@ -784,6 +887,7 @@ void RoutingTable6::addRoute(IPv6Route *route)
     // we keep entries sorted by prefix length in routeList, so that we can
     // stop at the first match when doing the longest prefix matching
     std::sort(routeList.begin(), routeList.end(), routeLessThan);
+    rebuildRouteIndex();
 
     /*XXX: this deletes some cache entries we want to keep, but the node MUST update
      the Destination Cache in such a way that the latest route information are used.*/
@@ -801,6 +905,7 @@ void RoutingTable6::removeRoute(IPv6Route *route)
     nb->fireChangeNotification(NF_IPv6_ROUTE_DELETED, route); // rather: going to be deleted
 
     routeList.erase(it);
+    rebuildRouteIndex();
     delete route;
 
     /*XXX: this deletes some cache entries we want to keep, but the node MUST update
@@ -865,6 +970,7 @@ void RoutingTable6::removeDefaultRoutes(int interfaceID)
         else
             ++it;
     }
+    rebuildRouteIndex();
 
     updateDisplayString();
 }
@@ -878,6 +984,7 @@ void RoutingTable6::removeAllRoutes()
         delete routeList[i];
 
     routeList.clear();
+    rebuildRouteIndex();
 
     updateDisplayString();
 }
@@ -893,6 +1000,7 @@ void RoutingTable6::removePrefixes(int interfaceID)
         else
             ++it;
     }
+    rebuildRouteIndex();
 
     updateDisplayString();
 }
@@ -18,6 +18,8 @@
 #ifndef __INET_ROUTINGTABLE6_H
 #define __INET_ROUTINGTABLE6_H
 
+#include <list>
+#include <map>
 #include <vector>
 
 #include "INETDefs.h"
@@ -161,22 +163,46 @@ class INET_API RoutingTable6 : public cSimpleModule, protected INotifiable, publ
 
     // Destination Cache maps dest address to next hop and interfaceId.
     // NOTE: nextHop might be a link-local address from which interfaceId cannot be deduced
+    // The cache is bounded by destCacheSize, the least recently used entry is evicted.
+    typedef std::list<IPv6Address> DestCacheLRU;
     struct DestCacheEntry
     {
         int interfaceId;
         IPv6Address nextHopAddr;
         simtime_t expiryTime;
+        DestCacheLRU::iterator lruPos;  // position in destCacheLRU
         // more destination specific data may be added here, e.g. path MTU
     };
     friend std::ostream& operator<<(std::ostream& os, const DestCacheEntry& e);
     typedef std::map<IPv6Address,DestCacheEntry> DestCache;
     DestCache destCache;
+    DestCacheLRU destCacheLRU;  // most recently used first
+    int destCacheSize;          // -1 means unlimited
 
     // RouteList contains local prefixes, and (for routers)
     // static, OSPF, RIP etc routes as well
     typedef std::vector<IPv6Route*> RouteList;
     RouteList routeList;
 
+    // Multibit trie (4-bit stride) over routeList for the longest prefix
+    // match. A route of prefix length L is stored in the node at depth L/4,
+    // in routeList order, so the first matching route of the deepest node
+    // that has one is the same as the first match in routeList.
+    struct RouteTrieNode
+    {
+        RouteList routes;
+        RouteTrieNode *children[16];
+        RouteTrieNode();
+        ~RouteTrieNode();
+    };
+    RouteTrieNode *routeTrie;
+
+    // FROM_RA routes with finite lifetime by expiry time; expired ones are
+    // evicted from the table before the next lookup
+    typedef std::multimap<simtime_t, IPv6Route*> ExpiryQueue;
+    ExpiryQueue expiryQueue;
+    std::map<IPv6Route*, ExpiryQueue::iterator> expiryQueuePos;
+
   protected:
     // creates a new empty route, factory method overriden in subclasses that use custom routes
     virtual IPv6Route *createNewRoute(IPv6Address destPrefix, int prefixLength, IPv6Route::RouteSrc src);
@@ -185,6 +211,16 @@ class INET_API RoutingTable6 : public cSimpleModule, protected INotifiable, publ
     virtual void addRoute(IPv6Route *route);
     // helper for addRoute()
     static bool routeLessThan(const IPv6Route *a, const IPv6Route *b);
+    // rebuilds routeTrie and expiryQueue after routeList has changed
+    virtual void rebuildRouteIndex();
+    // updates the expiryQueue entry of the route
+    virtual void updateRouteExpiry(IPv6Route *route);
+    // removes the expired FROM_RA routes
+    virtual void purgeExpiredPrefixes();
+    // returns the route with the given prefix and source, or NULL
+    virtual IPv6Route *findRoute(const IPv6Address& prefix, int prefixLength, IPv6Route::RouteSrc src);
+    // internal: removes the destination cache entry
+    virtual void eraseDestCacheEntry(DestCache::iterator it);
     // internal
     virtual void configureInterfaceForIPv6(InterfaceEntry *ie);
     /**
@@ -1266,14 +1266,18 @@ bool LDP::lookupLabel(IPv4Datagram *ipdatagram, LabelOpVector& outLabel, std::st
     if (protocol == IP_PROT_OSPF)
         return false;
 
+    // non-first fragments carry no transport header, so they are classified
+    // by the destination only
+    cPacket *encapPacket = ipdatagram->getEncapsulatedPacket();
+
     // LDP traffic (both discovery...
-    if (protocol == IP_PROT_UDP && check_and_cast<UDPPacket*>(ipdatagram->getEncapsulatedPacket())->getDestinationPort() == LDP_PORT)
+    if (protocol == IP_PROT_UDP && encapPacket && check_and_cast<UDPPacket*>(encapPacket)->getDestinationPort() == LDP_PORT)
         return false;
 
     // ...and session)
-    if (protocol == IP_PROT_TCP && check_and_cast<TCPSegment*>(ipdatagram->getEncapsulatedPacket())->getDestPort() == LDP_PORT)
+    if (protocol == IP_PROT_TCP && encapPacket && check_and_cast<TCPSegment*>(encapPacket)->getDestPort() == LDP_PORT)
         return false;
-    if (protocol == IP_PROT_TCP && check_and_cast<TCPSegment*>(ipdatagram->getEncapsulatedPacket())->getSrcPort() == LDP_PORT)
+    if (protocol == IP_PROT_TCP && encapPacket && check_and_cast<TCPSegment*>(encapPacket)->getSrcPort() == LDP_PORT)
         return false;
 
     // regular traffic, classify, label etc.
@@ -991,7 +991,7 @@ NS_STATIC struct rreq_record *NS_CLASS rreq_record_insert(struct in_addr orig_ad
     rec->rreq_id = rreq_id;
 
     timer_init(&rec->rec_timer, &NS_CLASS rreq_record_timeout, rec);
-    rreq_records.push_back(rec);
+    rreq_records.insert(std::make_pair(std::make_pair(orig_addr.s_addr, rreq_id), rec));
 
 
     DEBUG(LOG_INFO, 0, "Buffering RREQ %s rreq_id=%lu time=%u",
@@ -1004,28 +1004,16 @@ NS_STATIC struct rreq_record *NS_CLASS rreq_record_insert(struct in_addr orig_ad
 NS_STATIC struct rreq_record *NS_CLASS rreq_record_find(struct in_addr orig_addr,
         u_int32_t rreq_id)
 {
-    for (unsigned int i = 0 ; i < rreq_records.size();i++)
-    {
-        struct rreq_record *rec = rreq_records[i];
-        if (rec->orig_addr.s_addr == orig_addr.s_addr &&
-                (rec->rreq_id == rreq_id))
-            return rec;
-    }
+    RreqRecords::iterator it = rreq_records.find(std::make_pair(orig_addr.s_addr, rreq_id));
+    if (it != rreq_records.end())
+        return it->second;
     return NULL;
 }
 
 void NS_CLASS rreq_record_timeout(void *arg)
 {
     struct rreq_record *rec = (struct rreq_record *) arg;
-    for (RreqRecords::iterator it = rreq_records.begin();it!=rreq_records.end();it++)
-    {
-        struct rreq_record *recAux = *it;
-        if (rec  == recAux)
-        {
-            rreq_records.erase(it);
-            break;
-        }
-    }
+    rreq_records.erase(std::make_pair(rec->orig_addr.s_addr, rec->rreq_id));
     free(rec);
 }
 
@@ -1068,15 +1056,9 @@ struct blacklist *NS_CLASS rreq_blacklist_find(struct in_addr dest_addr)
 void NS_CLASS rreq_blacklist_timeout(void *arg)
 {
     struct blacklist *bl = (struct blacklist *)arg;
-    for (RreqBlacklist::iterator it = rreq_blacklist.begin();it!=rreq_blacklist.end();it++)
-    {
-        struct blacklist *blAux = it->second;
-        if (bl == blAux)
-        {
-            rreq_blacklist.erase(it);
-
-        }
-    }
+    RreqBlacklist::iterator it = rreq_blacklist.find(bl->dest_addr.s_addr);
+    if (it != rreq_blacklist.end() && it->second == bl)
+        rreq_blacklist.erase(it);
     free(bl);
 }
 #endif
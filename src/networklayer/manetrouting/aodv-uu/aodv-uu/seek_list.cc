@@ -162,14 +162,9 @@ int NS_CLASS seek_list_remove(seek_list_t * entry)
     if (!entry)
         return 0;
 
-    for (SeekHead::iterator it =seekhead.begin();it != seekhead.end(); it++)
-    {
-        if (it->second == entry)
-        {
-            seekhead.erase(it);
-            break;
-        }
-    }
+    SeekHead::iterator it = seekhead.find(entry->dest_addr.s_addr);
+    if (it != seekhead.end() && it->second == entry)
+        seekhead.erase(it);
 
     /* Make sure any timers are removed */
     timer_remove(&entry->seek_timer);
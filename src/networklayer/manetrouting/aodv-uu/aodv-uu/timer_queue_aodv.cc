@@ -66,12 +66,11 @@ int NS_CLASS timer_init(struct timer *t, timeout_func_t f, void *data)
 void NS_CLASS timer_timeout(const simtime_t &now)
 {
 
-    while (!aodvTimerMap.empty())
+    while (!aodvTimerQueue.empty())
     {
-        if (aodvTimerMap.begin()->first > now)
+        if (aodvTimerQueue.frontExpiration() > now)
             return;
-        struct timer *t = aodvTimerMap.begin()->second;
-        aodvTimerMap.erase(aodvTimerMap.begin());
+        struct timer *t = aodvTimerQueue.pop();
         t->used = 0;
         /* Execute handler function for expired timer... */
         if (t->handler)
@@ -101,7 +100,7 @@ NS_STATIC void NS_CLASS timer_add(struct timer *t)
         timer_remove(t);
 
     t->used = 1;
-    aodvTimerMap.insert(std::make_pair(t->timeout,t));
+    aodvTimerQueue.insert(t->timeout, t);
     return;
 }
 
@@ -111,15 +110,7 @@ int NS_CLASS timer_remove(struct timer *t)
         return -1;
 
     t->used = 0;
-    for (AodvTimerMap::iterator it = aodvTimerMap.begin();it != aodvTimerMap.end();it++)
-    {
-        if (it->second == t)
-        {
-            aodvTimerMap.erase(it);
-            return 1;
-        }
-    }
-    return 0;
+    return aodvTimerQueue.remove(t) ? 1 : 0;
 }
 
 
@@ -158,9 +149,9 @@ simtime_t NS_CLASS timer_age_queue()
     simtime_t remaining;
     now = simTime();
     timer_timeout(now);
-    if (aodvTimerMap.empty())
+    if (aodvTimerQueue.empty())
         return remaining;
-    remaining =  aodvTimerMap.begin()->first - now;
+    remaining =  aodvTimerQueue.frontExpiration() - now;
     return remaining;
 }
 #else
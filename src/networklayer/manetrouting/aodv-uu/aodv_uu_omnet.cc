@@ -296,8 +296,8 @@ NS_CLASS ~ AODVUU()
 #else
     while (!rreq_records.empty())
     {
-        free (rreq_records.back());
-        rreq_records.pop_back();
+        free (rreq_records.begin()->second);
+        rreq_records.erase(rreq_records.begin());
     }
 
     while (!rreq_blacklist.empty())
@@ -777,9 +777,9 @@ void NS_CLASS scheduleNextEvent()
     simtime_t timer;
     simtime_t timeout = timer_age_queue();
 
-    if (!aodvTimerMap.empty())
+    if (!aodvTimerQueue.empty())
     {
-        timer = aodvTimerMap.begin()->first;
+        timer = aodvTimerQueue.frontExpiration();
         if (sendMessageEvent->isScheduled())
         {
             if (timer < sendMessageEvent->getArrivalTime())
@@ -64,6 +64,7 @@
 /* System-dependent datatypes */
 /* Needed by some network-related datatypes */
 #include "ManetRoutingBase.h"
+#include "ManetTimerQueue.h"
 #include "aodv-uu/list.h"
 
 #include "ICMPAccess.h"
@@ -135,8 +136,8 @@ class AODVUU : public ManetRoutingBase
         return false;
     }
     // cMessage  messageEvent;
-    typedef std::multimap<simtime_t, struct timer*> AodvTimerMap;
-    AodvTimerMap aodvTimerMap;
+    typedef ManetTimerQueue<struct timer> AodvTimerQueue;
+    AodvTimerQueue aodvTimerQueue;
     typedef std::map<ManetAddress, struct rt_table*> AodvRtTableMap;
     AodvRtTableMap aodvRtTableMap;
 
@@ -281,7 +282,7 @@ class AODVUU : public ManetRoutingBase
     list_t timeList;
 #define TQ this->timeList
 #else
-    typedef std::vector <rreq_record *>RreqRecords;
+    typedef std::map <std::pair<ManetAddress, u_int32_t>, rreq_record *>RreqRecords;
     typedef std::map <ManetAddress, struct blacklist *>RreqBlacklist;
     typedef std::map <ManetAddress, seek_list_t*>SeekHead;
 
@@ -565,25 +565,8 @@ void ManetRoutingBase::omnet_chg_rte(const ManetAddress &dst, const ManetAddress
         return;
     IPv4Address desAddress(dst.getIPv4());
 
-    bool found = false;
-    IPv4Route *oldentry = NULL;
-    for (int i=inet_rt->getNumRoutes(); i>0; --i)
-    {
-        IPv4Route *e = inet_rt->getRoute(i-1);
-        if (desAddress == e->getDestination())
-        {
-            if (del_entry && !found)
-            {
-                if (!inet_rt->deleteRoute(e))
-                    opp_error("Aodv omnet_chg_rte can't delete route entry");
-            }
-            else
-            {
-                found = true;
-                oldentry = e;
-            }
-        }
-    }
+    IPv4Route *oldentry = findOrDeleteIpRoute(desAddress, del_entry);
+    bool found = oldentry != NULL;
 
     if (del_entry)
         return;
@@ -649,25 +632,8 @@ void ManetRoutingBase::omnet_chg_rte(const ManetAddress &dst, const ManetAddress
         return;
 
     IPv4Address desAddress(dst.getIPv4());
-    bool found = false;
-    IPv4Route *oldentry = NULL;
-    for (int i=inet_rt->getNumRoutes(); i>0; --i)
-    {
-        IPv4Route *e = inet_rt->getRoute(i-1);
-        if (desAddress == e->getDestination())
-        {
-            if (del_entry && !found)
-            {
-                if (!inet_rt->deleteRoute(e))
-                    opp_error("Aodv omnet_chg_rte can't delete route entry");
-            }
-            else
-            {
-                found = true;
-                oldentry = e;
-            }
-        }
-    }
+    IPv4Route *oldentry = findOrDeleteIpRoute(desAddress, del_entry);
+    bool found = oldentry != NULL;
 
     if (del_entry)
         return;
@@ -744,6 +710,26 @@ ManetAddress ManetRoutingBase::omnet_exist_rte(ManetAddress dst)
     return ManetAddress(IPv4Address::ALLONES_ADDRESS);
 }
 
+//
+// Deletes all routes to dst if del_entry is set, otherwise returns the
+// route to dst that omnet_chg_rte() should update (NULL if there is none)
+//
+IPv4Route *ManetRoutingBase::findOrDeleteIpRoute(const IPv4Address &dst, bool del_entry)
+{
+    // any route to dst counts, whatever its netmask and source; the routing
+    // table finds them via its destination index
+    IPv4Route *e = inet_rt->findRouteByDestination(dst);
+    if (!del_entry)
+        return e;
+    while (e != NULL)
+    {
+        if (!inet_rt->deleteRoute(e))
+            opp_error("Aodv omnet_chg_rte can't delete route entry");
+        e = inet_rt->findRouteByDestination(dst);
+    }
+    return NULL;
+}
+
 //
 // Erase all the entries in the routing table
 //
@@ -756,6 +742,7 @@ void ManetRoutingBase::omnet_clean_rte()
     if (mac_layer_)
         return;
     // clean the route table wlan interface entry
+    inet_rt->beginRouteUpdate();
     for (int i=inet_rt->getNumRoutes()-1; i>=0; i--)
     {
         entry = inet_rt->getRoute(i);
@@ -764,6 +751,19 @@ void ManetRoutingBase::omnet_clean_rte()
             inet_rt->deleteRoute(entry);
         }
     }
+    inet_rt->commitRouteUpdate();
+}
+
+void ManetRoutingBase::omnet_begin_rte_update()
+{
+    if (!mac_layer_ && inet_rt)
+        inet_rt->beginRouteUpdate();
+}
+
+void ManetRoutingBase::omnet_commit_rte_update()
+{
+    if (!mac_layer_ && inet_rt)
+        inet_rt->commitRouteUpdate();
 }
 
 //
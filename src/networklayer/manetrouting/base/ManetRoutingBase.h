@@ -161,6 +161,9 @@ class INET_API ManetRoutingBase : public cSimpleModule, public INotifiable, prot
     virtual void omnet_chg_rte(const struct in_addr &dst, const struct in_addr &gtwy, const struct in_addr &netm, short int hops, bool del_entry, const struct in_addr &iface);
     virtual void omnet_chg_rte(const struct in_addr &dst, const struct in_addr &gtwy, const struct in_addr &netm, short int hops, bool del_entry, int index);
 
+    /// Returns the route omnet_chg_rte() should update, or deletes all routes to dst if del_entry is set
+    virtual IPv4Route *findOrDeleteIpRoute(const IPv4Address &dst, bool del_entry);
+
     virtual void deleteIpEntry(const ManetAddress &dst) {omnet_chg_rte(dst, dst, dst, 0, true);}
     virtual void setIpEntry(const ManetAddress &dst, const ManetAddress &gtwy, const ManetAddress &netm, short int hops, const ManetAddress &iface = ManetAddress::ZERO)
             {omnet_chg_rte(dst, gtwy, netm, hops, false, iface);}
@@ -183,6 +186,14 @@ class INET_API ManetRoutingBase : public cSimpleModule, public INotifiable, prot
     /// Erase all entries for wlan* interfaces in the routing table
     virtual void omnet_clean_rte();
 
+    /**
+     * Batch a series of omnet_chg_rte() calls: route notifications and cache
+     * invalidation of the IPv4 routing table are coalesced until the commit.
+     * See IRoutingTable::beginRouteUpdate().
+     */
+    virtual void omnet_begin_rte_update();
+    virtual void omnet_commit_rte_update();
+
     /**
      *  @name Cross layer routines
      */
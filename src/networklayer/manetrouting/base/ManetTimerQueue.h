@@ -0,0 +1,91 @@
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef __INET_MANETTIMERQUEUE_H
+#define __INET_MANETTIMERQUEUE_H
+
+#include <map>
+
+#include "INETDefs.h"
+
+/**
+ * Timer queue for the ported MANET routing daemons (AODV-UU, DYMO-UM), which
+ * keep their own timer structs and expire them from a single OMNeT++ event.
+ *
+ * Timers are ordered by expiration time; timers that expire at the same time
+ * are kept in insertion order. Besides the ordered map, an index from the timer
+ * to its position is maintained, so removing, rescheduling or checking a timer
+ * takes logarithmic time instead of a scan of the whole queue.
+ */
+template <class T>
+class ManetTimerQueue
+{
+  protected:
+    typedef std::multimap<simtime_t, T *> TimerMap;
+    typedef std::map<T *, typename TimerMap::iterator> TimerIndex;
+
+    TimerMap timers;
+    TimerIndex index;
+
+  public:
+    ManetTimerQueue() {}
+
+    bool empty() const { return timers.empty(); }
+    size_t size() const { return timers.size(); }
+
+    /** Returns true if the timer is in the queue. */
+    bool contains(T *timer) const { return index.find(timer) != index.end(); }
+
+    /** Adds the timer to the queue; a timer already in the queue is moved. */
+    void insert(const simtime_t& expiration, T *timer)
+    {
+        remove(timer);
+        index[timer] = timers.insert(std::make_pair(expiration, timer));
+    }
+
+    /** Removes the timer from the queue. Returns false if it was not queued. */
+    bool remove(T *timer)
+    {
+        typename TimerIndex::iterator it = index.find(timer);
+        if (it == index.end())
+            return false;
+        timers.erase(it->second);
+        index.erase(it);
+        return true;
+    }
+
+    /** The earliest timer; the queue must not be empty. */
+    T *front() const { return timers.begin()->second; }
+
+    /** Expiration time of the earliest timer; the queue must not be empty. */
+    const simtime_t& frontExpiration() const { return timers.begin()->first; }
+
+    /** Removes and returns the earliest timer; the queue must not be empty. */
+    T *pop()
+    {
+        T *timer = timers.begin()->second;
+        index.erase(timer);
+        timers.erase(timers.begin());
+        return timer;
+    }
+
+    void clear()
+    {
+        timers.clear();
+        index.clear();
+    }
+};
+
+#endif
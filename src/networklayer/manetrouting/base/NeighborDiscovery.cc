@@ -0,0 +1,326 @@
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <limits>
+#include <sstream>
+
+#include "NeighborDiscovery.h"
+
+#include "IInterfaceTable.h"
+#include "IMobility.h"
+#include "InterfaceTableAccess.h"
+#include "IPv4InterfaceData.h"
+#include "ModuleAccess.h"
+#include "NotificationBoard.h"
+#include "UDPControlInfo_m.h"
+#include "Ieee80211Frame_m.h"
+#include "NeighborDiscoveryBeacon_m.h"
+
+
+Define_Module(NeighborDiscovery);
+
+static double const NaN = 0.0 / 0.0;
+
+std::string NeighborEntry::info() const
+{
+    std::stringstream out;
+    out << address << " (" << macAddress << ") pos=" << position << " heard=" << lastHeard << " etx=" << etx;
+    return out.str();
+}
+
+std::ostream& operator<<(std::ostream& os, const NeighborEntry& entry)
+{
+    return os << entry.info();
+}
+
+NeighborDiscovery::NeighborDiscovery()
+{
+    beaconTimer = NULL;
+    nb = NULL;
+}
+
+NeighborDiscovery::~NeighborDiscovery()
+{
+    cancelAndDelete(beaconTimer);
+    nb = NotificationBoardAccess().getIfExists(this);
+    if (nb)
+        nb->unsubscribe(this, NF_LINK_BREAK);
+}
+
+void NeighborDiscovery::initialize(int stage)
+{
+    ApplicationBase::initialize(stage);
+
+    if (stage == 0)
+    {
+        beaconInterval = par("beaconInterval");
+        maxJitter = par("maxJitter");
+        neighborValidityInterval = par("neighborValidityInterval");
+        etxWindow = par("etxWindow");
+        useLinkLayerFeedback = par("useLinkLayerFeedback");
+        port = par("port");
+        if (maxJitter >= beaconInterval)
+            throw cRuntimeError("maxJitter must be smaller than beaconInterval");
+        if (etxWindow <= 0)
+            throw cRuntimeError("etxWindow must be positive");
+
+        cModule *host = findContainingNode(this);
+        interfaceTable = InterfaceTableAccess().get(this);
+        mobility = host ? dynamic_cast<IMobility *>(host->getSubmodule("mobility")) : NULL;
+        nb = NotificationBoardAccess().get(this);
+        beaconTimer = new cMessage("beaconTimer");
+        sequenceNumber = 0;
+        numBeaconsSent = numBeaconsRcvd = numLinkBreaks = 0;
+        WATCH_MAP(neighbors);
+        WATCH(numBeaconsSent);
+        WATCH(numBeaconsRcvd);
+    }
+    else if (stage == 3)
+    {
+        const char *interfaceName = par("interface");
+        interfaceEntry = interfaceTable->getInterfaceByName(interfaceName);
+        if (!interfaceEntry)
+            throw cRuntimeError("No interface named '%s'", interfaceName);
+        if (useLinkLayerFeedback)
+            nb->subscribe(this, NF_LINK_BREAK);
+    }
+}
+
+bool NeighborDiscovery::handleNodeStart(IDoneCallback *doneCallback)
+{
+    socket.setOutputGate(gate("udpOut"));
+    socket.bind(port);
+    socket.setBroadcast(true);
+    scheduleAt(simTime() + uniform(0, maxJitter), beaconTimer);
+    return true;
+}
+
+bool NeighborDiscovery::handleNodeShutdown(IDoneCallback *doneCallback)
+{
+    cancelEvent(beaconTimer);
+    // at the end of the simulation (no callback) the subscribers are not notified
+    if (doneCallback)
+    {
+        socket.close();
+        removeAllNeighbors();
+    }
+    return true;
+}
+
+void NeighborDiscovery::handleNodeCrash()
+{
+    cancelEvent(beaconTimer);
+    removeAllNeighbors();
+}
+
+void NeighborDiscovery::handleMessageWhenUp(cMessage *msg)
+{
+    if (msg == beaconTimer)
+    {
+        // neighbors are purged at beacon time: the expiration is accurate to beaconInterval
+        purgeNeighbors();
+        sendBeacon();
+        scheduleAt(simTime() + beaconInterval - maxJitter + uniform(0, 2 * maxJitter), beaconTimer);
+    }
+    else if (msg->getKind() == UDP_I_DATA)
+    {
+        processBeacon(check_and_cast<NeighborDiscoveryBeacon *>(msg));
+    }
+    else if (msg->getKind() == UDP_I_ERROR)
+    {
+        EV << "Ignoring UDP error report\n";
+        delete msg;
+    }
+    else
+        throw cRuntimeError("Unrecognized message (%s)%s", msg->getClassName(), msg->getName());
+}
+
+IPvXAddress NeighborDiscovery::getSelfAddress() const
+{
+    return interfaceEntry->ipv4Data() ? IPvXAddress(interfaceEntry->ipv4Data()->getIPAddress()) : IPvXAddress();
+}
+
+Coord NeighborDiscovery::getSelfPosition() const
+{
+    return mobility ? mobility->getCurrentPosition() : Coord(NaN, NaN, NaN);
+}
+
+void NeighborDiscovery::sendBeacon()
+{
+    NeighborDiscoveryBeacon *beacon = new NeighborDiscoveryBeacon("NeighborDiscoveryBeacon");
+    beacon->setAddress(getSelfAddress());
+    beacon->setMacAddress(interfaceEntry->getMacAddress());
+    beacon->setSequenceNumber(sequenceNumber++);
+    beacon->setPosition(getSelfPosition());
+    beacon->setNeighborsArraySize(neighbors.size());
+    unsigned int i = 0;
+    for (NeighborTable::const_iterator it = neighbors.begin(); it != neighbors.end(); it++, i++)
+    {
+        NeighborDiscoveryLinkInfo& info = beacon->getNeighbors(i);
+        info.address = it->first;
+        info.numReceived = it->second.receptions.size();
+    }
+    // address, MAC address, sequence number, position (3x4 bytes), and 6 bytes per neighbor
+    beacon->setByteLength(4 + 6 + 4 + 12 + 6 * neighbors.size());
+
+    UDPSocket::SendOptions options;
+    options.outInterfaceId = interfaceEntry->getInterfaceId();
+    socket.sendTo(beacon, IPv4Address::ALLONES_ADDRESS, port, &options);
+    numBeaconsSent++;
+}
+
+void NeighborDiscovery::processBeacon(NeighborDiscoveryBeacon *beacon)
+{
+    const IPvXAddress& address = beacon->getAddress();
+    if (address.isUnspecified() || address == getSelfAddress())
+    {
+        delete beacon;
+        return;
+    }
+    numBeaconsRcvd++;
+
+    NeighborTable::iterator it = neighbors.find(address);
+    bool isNew = it == neighbors.end();
+    if (isNew)
+    {
+        it = neighbors.insert(std::make_pair(address, NeighborEntry())).first;
+        it->second.address = address;
+    }
+    NeighborEntry& entry = it->second;
+    if (entry.macAddress != beacon->getMacAddress())
+    {
+        if (!entry.macAddress.isUnspecified())
+            macAddressIndex.erase(entry.macAddress);
+        entry.macAddress = beacon->getMacAddress();
+        macAddressIndex[entry.macAddress] = address;
+    }
+    entry.position = beacon->getPosition();
+    entry.lastHeard = simTime();
+    entry.receptions.push_back(simTime());
+
+    // the neighbor tells how many of our beacons it received
+    IPvXAddress selfAddress = getSelfAddress();
+    entry.reverseNumReceived = 0;
+    for (unsigned int i = 0; i < beacon->getNeighborsArraySize(); i++)
+    {
+        if (beacon->getNeighbors(i).address == selfAddress)
+        {
+            entry.reverseNumReceived = beacon->getNeighbors(i).numReceived;
+            break;
+        }
+    }
+    updateLinkQuality(entry);
+    delete beacon;
+
+    nb->fireChangeNotification(isNew ? NF_NEIGHBOR_ADDED : NF_NEIGHBOR_CHANGED, &entry);
+}
+
+void NeighborDiscovery::updateLinkQuality(NeighborEntry& entry)
+{
+    simtime_t windowStart = simTime() - etxWindow * beaconInterval;
+    while (!entry.receptions.empty() && entry.receptions.front() <= windowStart)
+        entry.receptions.pop_front();
+
+    double forwardRatio = std::min(1.0, (double)entry.receptions.size() / etxWindow);
+    double reverseRatio = std::min(1.0, (double)entry.reverseNumReceived / etxWindow);
+    if (forwardRatio > 0 && reverseRatio > 0)
+        entry.etx = 1.0 / (forwardRatio * reverseRatio);
+    else
+        entry.etx = std::numeric_limits<double>::infinity();
+}
+
+void NeighborDiscovery::purgeNeighbors()
+{
+    simtime_t expiration = simTime() - neighborValidityInterval;
+    NeighborTable::iterator it = neighbors.begin();
+    while (it != neighbors.end())
+    {
+        NeighborTable::iterator next = it;
+        next++;
+        if (it->second.lastHeard <= expiration)
+            removeNeighbor(it);
+        else
+            updateLinkQuality(it->second);
+        it = next;
+    }
+}
+
+void NeighborDiscovery::removeNeighbor(NeighborTable::iterator it)
+{
+    EV << "Removing neighbor " << it->second.info() << endl;
+    macAddressIndex.erase(it->second.macAddress);
+
+    // subscribers get the entry before it is destroyed
+    NeighborEntry entry = it->second;
+    neighbors.erase(it);
+    nb->fireChangeNotification(NF_NEIGHBOR_REMOVED, &entry);
+}
+
+void NeighborDiscovery::removeAllNeighbors()
+{
+    while (!neighbors.empty())
+        removeNeighbor(neighbors.begin());
+}
+
+void NeighborDiscovery::processLinkBreak(const MACAddress& macAddress)
+{
+    MACAddressIndex::iterator it = macAddressIndex.find(macAddress);
+    if (it == macAddressIndex.end())
+        return;
+    NeighborTable::iterator jt = neighbors.find(it->second);
+    if (jt != neighbors.end())
+    {
+        numLinkBreaks++;
+        removeNeighbor(jt);
+    }
+}
+
+void NeighborDiscovery::receiveChangeNotification(int category, const cObject *details)
+{
+    Enter_Method_Silent();
+    if (category == NF_LINK_BREAK && isOperational)
+    {
+        const Ieee80211Frame *frame = dynamic_cast<const Ieee80211Frame *>(details);
+        if (frame && !frame->getReceiverAddress().isBroadcast())
+            processLinkBreak(frame->getReceiverAddress());
+    }
+}
+
+const NeighborEntry *NeighborDiscovery::findNeighbor(const IPvXAddress& address) const
+{
+    NeighborTable::const_iterator it = neighbors.find(address);
+    return it != neighbors.end() ? &it->second : NULL;
+}
+
+Coord NeighborDiscovery::getNeighborPosition(const IPvXAddress& address) const
+{
+    const NeighborEntry *entry = findNeighbor(address);
+    return entry ? entry->position : Coord(NaN, NaN, NaN);
+}
+
+double NeighborDiscovery::getLinkETX(const IPvXAddress& address) const
+{
+    const NeighborEntry *entry = findNeighbor(address);
+    return entry ? entry->etx : std::numeric_limits<double>::infinity();
+}
+
+void NeighborDiscovery::finish()
+{
+    recordScalar("beacons sent", numBeaconsSent);
+    recordScalar("beacons received", numBeaconsRcvd);
+    recordScalar("link breaks", numLinkBreaks);
+    recordScalar("neighbors", neighbors.size());
+    ApplicationBase::finish();
+}
@@ -0,0 +1,142 @@
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef __INET_NEIGHBORDISCOVERY_H
+#define __INET_NEIGHBORDISCOVERY_H
+
+#include <deque>
+#include <map>
+
+#include "INETDefs.h"
+
+#include "ApplicationBase.h"
+#include "Coord.h"
+#include "INotifiable.h"
+#include "IPvXAddress.h"
+#include "MACAddress.h"
+#include "UDPSocket.h"
+
+class IInterfaceTable;
+class IMobility;
+class InterfaceEntry;
+class NotificationBoard;
+class NeighborDiscoveryBeacon;
+
+/**
+ * A one-hop neighbor as seen by NeighborDiscovery. It is also the details
+ * object of the NF_NEIGHBOR_ADDED, NF_NEIGHBOR_CHANGED and NF_NEIGHBOR_REMOVED
+ * notifications.
+ */
+class INET_API NeighborEntry : public cObject
+{
+  public:
+    IPvXAddress address;
+    MACAddress macAddress;
+    Coord position;
+    simtime_t lastHeard;
+    double etx;                         // infinite until the neighbor reports our beacons
+
+  protected:
+    friend class NeighborDiscovery;
+    std::deque<simtime_t> receptions;   // arrival of the beacons in the ETX window
+    unsigned int reverseNumReceived;    // our beacons received by the neighbor, as reported
+
+  public:
+    NeighborEntry() : etx(0), reverseNumReceived(0) {}
+    virtual std::string info() const;
+};
+
+/**
+ * Neighbor discovery and link quality service shared by the routing
+ * protocols of a node. See the NED file for details.
+ */
+class INET_API NeighborDiscovery : public ApplicationBase, public INotifiable
+{
+  public:
+    typedef std::map<IPvXAddress, NeighborEntry> NeighborTable;
+
+  protected:
+    typedef std::map<MACAddress, IPvXAddress> MACAddressIndex;
+
+    // parameters
+    simtime_t beaconInterval;
+    simtime_t maxJitter;
+    simtime_t neighborValidityInterval;
+    int etxWindow;
+    bool useLinkLayerFeedback;
+    int port;
+
+    // context
+    IInterfaceTable *interfaceTable;
+    InterfaceEntry *interfaceEntry;
+    IMobility *mobility;
+    NotificationBoard *nb;
+
+    // state
+    UDPSocket socket;
+    cMessage *beaconTimer;
+    unsigned int sequenceNumber;
+    NeighborTable neighbors;
+    MACAddressIndex macAddressIndex;    // neighbor addresses by MAC address, for the link layer feedback
+
+    // statistics
+    unsigned long numBeaconsSent;
+    unsigned long numBeaconsRcvd;
+    unsigned long numLinkBreaks;
+
+  protected:
+    virtual void sendBeacon();
+    virtual void processBeacon(NeighborDiscoveryBeacon *beacon);
+    virtual void purgeNeighbors();
+    virtual void removeNeighbor(NeighborTable::iterator it);
+    virtual void removeAllNeighbors();
+    virtual void updateLinkQuality(NeighborEntry& entry);
+    virtual void processLinkBreak(const MACAddress& macAddress);
+    virtual IPvXAddress getSelfAddress() const;
+    virtual Coord getSelfPosition() const;
+
+  public:
+    NeighborDiscovery();
+    virtual ~NeighborDiscovery();
+
+    /** @name Access to the neighbor table */
+    //@{
+    const NeighborTable& getNeighbors() const { return neighbors; }
+    int getNumNeighbors() const { return neighbors.size(); }
+    bool isNeighbor(const IPvXAddress& address) const { return neighbors.find(address) != neighbors.end(); }
+
+    /** Returns the neighbor with the given address, or NULL if it is not a neighbor. */
+    const NeighborEntry *findNeighbor(const IPvXAddress& address) const;
+
+    /** Returns the position of the neighbor, or a NaN coordinate if it is not a neighbor. */
+    Coord getNeighborPosition(const IPvXAddress& address) const;
+
+    /** Returns the ETX of the link to the neighbor, or infinity if it is not a neighbor. */
+    double getLinkETX(const IPvXAddress& address) const;
+    //@}
+
+  protected:
+    virtual int numInitStages() const { return 4; }
+    virtual void initialize(int stage);
+    virtual void handleMessageWhenUp(cMessage *msg);
+    virtual void finish();
+    virtual void receiveChangeNotification(int category, const cObject *details);
+
+    virtual bool handleNodeStart(IDoneCallback *doneCallback);
+    virtual bool handleNodeShutdown(IDoneCallback *doneCallback);
+    virtual void handleNodeCrash();
+};
+
+#endif
@@ -1056,10 +1056,11 @@ void DYMOUM::processPromiscuous(const cObject *details)
         // if rrep proccess the packet
         if (!no_path_acc)
         {
-            DYMO_element * dymo_msg;
+            DYMO_element * dymo_msg = NULL;
             if (!isInMacLayer())
             {
-                if (ip_msg && ip_msg->getTransportProtocol()==IP_PROT_MANET)
+                // non-first fragments carry no payload
+                if (ip_msg && ip_msg->getTransportProtocol()==IP_PROT_MANET && ip_msg->getEncapsulatedPacket())
                     dymo_msg = dynamic_cast<DYMO_element *>(ip_msg->getEncapsulatedPacket()->getEncapsulatedPacket());
             }
             else
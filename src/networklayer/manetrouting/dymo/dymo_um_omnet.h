@@ -58,6 +58,7 @@
 /* System-dependent datatypes */
 /* Needed by some network-related datatypes */
 #include "ManetRoutingBase.h"
+#include "ManetTimerQueue.h"
 #include "Ieee80211Frame_m.h"
 #include "dymoum/dlist.h"
 #include "dymo_msg_struct.h"
@@ -159,7 +160,7 @@ class DYMOUM : public ManetRoutingBase
     // cMessage messageEvent;
 
     typedef std::map<MACAddress, unsigned int> MacToIpAddress;
-    typedef std::multimap<simtime_t, struct timer*> DymoTimerMap;
+    typedef ManetTimerQueue<struct timer> DymoTimerMap;
     typedef std::map<ManetAddress, rtable_entry_t *> DymoRoutingTable;
     typedef std::map<ManetAddress, pending_rreq_t * > DymoPendingRreq;
     typedef std::vector<nb_t *> DymoNbList;
@@ -58,10 +58,7 @@ int NS_CLASS timer_init(struct timer *t, timeout_func_t f, void *data)
 int NS_CLASS timer_is_queued(struct timer *t)
 {
     if (t)
-        for (DymoTimerMap::iterator i = dymoTimerList->begin(); i != dymoTimerList->end(); i++)
-        {
-            if ((*i).second == t)return 1;
-        }
+        return dymoTimerList->contains(t) ? 1 : 0;
     return 0;
 }
 
@@ -79,7 +76,7 @@ int NS_CLASS timer_add(struct timer *t)
     simtime_t timeout = t->timeout.tv_sec;
     timeout += ((double)(t->timeout.tv_usec)/1000000.0);
 
-    dymoTimerList->insert(std::make_pair(timeout,t));
+    dymoTimerList->insert(timeout, t);
     return DLIST_SUCCESS;
 }
 
@@ -90,15 +87,7 @@ int NS_CLASS timer_remove(struct timer *t)
         return -1;
 
     t->used = 0;
-    for (DymoTimerMap::iterator i = dymoTimerList->begin(); i != dymoTimerList->end(); i++)
-    {
-        if ((*i).second == t)
-        {
-            dymoTimerList->erase(i);
-            return DLIST_SUCCESS;
-        }
-    }
-    return DLIST_FAILURE;
+    return dymoTimerList->remove(t) ? DLIST_SUCCESS : DLIST_FAILURE;
 }
 
 int NS_CLASS timer_set_timeout(struct timer *t, long msec)
@@ -119,10 +108,9 @@ int NS_CLASS timer_set_timeout(struct timer *t, long msec)
 void NS_CLASS timer_timeout(struct timeval *now)
 {
 
-    while (!dymoTimerList->empty() && (timeval_diff(&(dymoTimerList->begin()->second->timeout), now) <= 0))
+    while (!dymoTimerList->empty() && (timeval_diff(&(dymoTimerList->front()->timeout), now) <= 0))
     {
-        struct timer * t = dymoTimerList->begin()->second;
-        dymoTimerList->erase(dymoTimerList->begin());
+        struct timer * t = dymoTimerList->pop();
         if (t==NULL)
             opp_error ("timer ower is bad");
         else
@@ -142,12 +130,12 @@ struct timeval *NS_CLASS timer_age_queue()
 
     while (!dymoTimerList->empty())
     {
-        t = dymoTimerList->begin()->second;
+        t = dymoTimerList->front();
         if (t==NULL)
             opp_error ("timer ower is bad");
         if (timeval_diff(&(t->timeout), &now)>0)
             break;
-        dymoTimerList->erase(dymoTimerList->begin());
+        dymoTimerList->pop();
         if (t->handler)
             (this->*t->handler)(t->data);
     }
@@ -155,8 +143,8 @@ struct timeval *NS_CLASS timer_age_queue()
     if (dymoTimerList->empty())
         return NULL;
 
-    t = dymoTimerList->begin()->second;
-    if (timeval_diff(&(dymoTimerList->begin()->second->timeout), &now)<=0)
+    t = dymoTimerList->front();
+    if (timeval_diff(&(t->timeout), &now)<=0)
         opp_error("Dymo Time queue error");
     remaining.tv_usec   = (t->timeout.tv_usec - now.tv_usec);
     remaining.tv_sec    = (t->timeout.tv_sec - now.tv_sec);
@@ -1274,23 +1274,11 @@ OLSR::mpr_computation()
 void
 OLSR::rtable_computation()
 {
-    nsaddr_t netmask(IPv4Address::ALLONES_ADDRESS);
     // 1. All the entries from the routing table are removed.
-    //
-
-    if (par("DelOnlyRtEntriesInrtable_").boolValue())
-    {
-        for (rtable_t::const_iterator itRtTable = rtable_.getInternalTable()->begin();itRtTable != rtable_.getInternalTable()->begin();++itRtTable)
-        {
-            nsaddr_t addr = itRtTable->first;
-            omnet_chg_rte(addr, addr,netmask,1, true, addr);
-        }
-    }
-    else
-        omnet_clean_rte(); // clean IP tables
-
-    rtable_.clear();
-
+    // The previous table is kept, so that only the routes that have changed
+    // need to be pushed into the IP routing table afterwards.
+    rtable_t previous;
+    previous.swap(rtable_.rt_);
 
     // 2. The new routing entries are added starting with the
     // symmetric neighbors (h=1) as the destination nodes.
@@ -1312,16 +1300,6 @@ OLSR::rtable_computation()
                                       link_tuple->nb_iface_addr(),
                                       link_tuple->local_iface_addr(),
                                       1, link_tuple->local_iface_index());
-                    if (!useIndex)
-                        omnet_chg_rte(link_tuple->nb_iface_addr(),
-                                       link_tuple->nb_iface_addr(),
-                                       netmask,
-                                       1, false, link_tuple->local_iface_addr());
-                    else
-                        omnet_chg_rte(link_tuple->nb_iface_addr(),
-                                       link_tuple->nb_iface_addr(),
-                                       netmask,
-                                       1, false, link_tuple->local_iface_index());
 
                     if (link_tuple->nb_iface_addr() == nb_tuple->nb_main_addr())
                         nb_main_addr = true;
@@ -1333,18 +1311,6 @@ OLSR::rtable_computation()
                                   lt->nb_iface_addr(),
                                   lt->local_iface_addr(),
                                   1, lt->local_iface_index());
-
-                if (!useIndex)
-                    omnet_chg_rte(nb_tuple->nb_main_addr(),
-                                   lt->nb_iface_addr(),
-                                   netmask,// Default mask
-                                   1, false, lt->local_iface_addr());
-
-                else
-                    omnet_chg_rte(nb_tuple->nb_main_addr(),
-                                   lt->nb_iface_addr(),
-                                   netmask,// Default mask
-                                   1, false, lt->local_iface_index());
             }
         }
     }
@@ -1383,18 +1349,6 @@ OLSR::rtable_computation()
                               entry->next_addr(),
                               entry->iface_addr(),
                               2, entry->local_iface_index());
-            if (!useIndex)
-                omnet_chg_rte(nb2hop_tuple->nb2hop_addr(),
-                               entry->next_addr(),
-                               netmask,
-                               2, false, entry->iface_addr());
-
-            else
-                omnet_chg_rte(nb2hop_tuple->nb2hop_addr(),
-                               entry->next_addr(),
-                               netmask,
-                               2, false, entry->local_iface_index());
-
         }
     }
 
@@ -1421,19 +1375,6 @@ OLSR::rtable_computation()
                                   entry2->next_addr(),
                                   entry2->iface_addr(),
                                   h+1, entry2->local_iface_index(), entry2);
-
-                if (!useIndex)
-                    omnet_chg_rte(topology_tuple->dest_addr(),
-                                   entry2->next_addr(),
-                                   netmask,
-                                   h+1, false, entry2->iface_addr());
-
-                else
-                    omnet_chg_rte(topology_tuple->dest_addr(),
-                                   entry2->next_addr(),
-                                   netmask,
-                                   h+1, false, entry2->local_iface_index());
-
                 added = true;
             }
         }
@@ -1457,18 +1398,6 @@ OLSR::rtable_computation()
                                   entry1->next_addr(),
                                   entry1->iface_addr(),
                                   entry1->dist(), entry1->local_iface_index(), entry1);
-
-                if (!useIndex)
-                    omnet_chg_rte(tuple->iface_addr(),
-                                   entry1->next_addr(),
-                                   netmask,
-                                   entry1->dist(), false, entry1->iface_addr());
-
-                else
-                    omnet_chg_rte(tuple->iface_addr(),
-                                   entry1->next_addr(),
-                                   netmask,
-                                   entry1->dist(), false, entry1->local_iface_index());
                 added = true;
             }
         }
@@ -1476,9 +1405,66 @@ OLSR::rtable_computation()
         if (!added)
             break;
     }
+    update_ip_rtable(previous);
     setTopologyChanged(false);
 }
 
+///
+/// \brief Pushes the routes that differ between the given previous routing table
+///     and the current one into the IP routing table.
+///
+/// Routes that are gone are deleted, new and modified routes are (re)installed,
+/// unchanged routes are left alone. The entries of the previous table are freed.
+/// The metric of the IP routes is dist(), the hop count, as before the
+/// incremental update; OLSR_ETX also stores the hop count there, not the ETX.
+///
+/// \param previous the routing table before the last computation.
+///
+void
+OLSR::update_ip_rtable(rtable_t& previous)
+{
+    nsaddr_t netmask(IPv4Address::ALLONES_ADDRESS);
+    const rtable_t *current = rtable_.getInternalTable();
+
+    omnet_begin_rte_update();
+    for (rtable_t::iterator it = previous.begin(); it != previous.end(); it++)
+    {
+        if (current->find(it->first) == current->end())
+            omnet_chg_rte(it->first, it->first, netmask, 1, true, it->first);
+    }
+
+    for (rtable_t::const_iterator it = current->begin(); it != current->end(); it++)
+    {
+        OLSR_rt_entry* entry = it->second;
+        rtable_t::iterator old = previous.find(it->first);
+        if (old != previous.end())
+        {
+            OLSR_rt_entry* oldEntry = old->second;
+            if (oldEntry->next_addr() == entry->next_addr()
+                    && oldEntry->iface_addr() == entry->iface_addr()
+                    && oldEntry->local_iface_index() == entry->local_iface_index()
+                    && oldEntry->dist() == entry->dist())
+                continue;
+        }
+
+        if (!useIndex)
+            omnet_chg_rte(entry->dest_addr(),
+                           entry->next_addr(),
+                           netmask,
+                           entry->dist(), false, entry->iface_addr());
+        else
+            omnet_chg_rte(entry->dest_addr(),
+                           entry->next_addr(),
+                           netmask,
+                           entry->dist(), false, entry->local_iface_index());
+    }
+    omnet_commit_rte_update();
+
+    for (rtable_t::iterator it = previous.begin(); it != previous.end(); it++)
+        delete it->second;
+    previous.clear();
+}
+
 ///
 /// \brief Processes a HELLO message following RFC 3626 specification.
 ///
@@ -471,6 +471,7 @@ class OLSR : public ManetRoutingBase
 
     virtual void        mpr_computation();
     virtual void        rtable_computation();
+    virtual void        update_ip_rtable(rtable_t&);
 
     virtual bool        process_hello(OLSR_msg&, const nsaddr_t &, const nsaddr_t &, const int &);
     virtual bool        process_tc(OLSR_msg&, const nsaddr_t &, const int &);
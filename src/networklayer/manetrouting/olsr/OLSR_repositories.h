@@ -31,6 +31,7 @@
 #define __OLSR_repositories_h__
 
 #include <string.h>
+#include <map>
 #include <set>
 #include <vector>
 
@@ -332,4 +333,15 @@ typedef std::vector<OLSR_topology_tuple*>   topologyset_t;  ///< Topology Set ty
 typedef std::vector<OLSR_dup_tuple*>        dupset_t;   ///< Duplicate Set type.
 typedef std::vector<OLSR_iface_assoc_tuple*>    ifaceassocset_t; ///< Interface Association Set type.
 
+// Indices over the sets above, maintained by OLSR_state. Tuples with equal keys
+// are kept in insertion order, i.e. in the same order as in the sets.
+typedef std::multimap<nsaddr_t, OLSR_mprsel_tuple*>    mprselindex_t;  ///< MPR Selectors by main address.
+typedef std::multimap<nsaddr_t, OLSR_link_tuple*>      linkindex_t;    ///< Link tuples by neighbor interface address.
+typedef std::multimap<nsaddr_t, OLSR_nb_tuple*>        nbindex_t;      ///< Neighbor tuples by main address.
+typedef std::multimap<nsaddr_t, OLSR_nb2hop_tuple*>    nb2hopindex_t;  ///< 2-hop tuples by neighbor main address.
+typedef std::multimap<nsaddr_t, OLSR_topology_tuple*>  topologyindex_t;    ///< Topology tuples by last address.
+typedef std::pair<nsaddr_t, uint16_t>                  dupkey_t;       ///< Originator address and message sequence number.
+typedef std::multimap<dupkey_t, OLSR_dup_tuple*>       dupindex_t;     ///< Duplicate tuples by (address, sequence number).
+typedef std::multimap<nsaddr_t, OLSR_iface_assoc_tuple*> ifaceassocindex_t; ///< Interface association tuples by interface address.
+
 #endif
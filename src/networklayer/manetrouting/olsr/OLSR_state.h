@@ -45,6 +45,16 @@ class OLSR_state : public cObject
     dupset_t    dupset_;    ///< Duplicate Set (RFC 3626, section 3.4).
     ifaceassocset_t ifaceassocset_; ///< Interface Association Set (RFC 3626, section 4.1).
 
+    // Lookup indices over the sets above. The sets keep their order and are
+    // still used for iteration; every insert/erase below updates both.
+    mprselindex_t   mprselindex_;
+    linkindex_t     linkindex_;
+    nbindex_t       nbindex_;
+    nb2hopindex_t   nb2hopindex_;
+    topologyindex_t topologyindex_;
+    dupindex_t      dupindex_;
+    ifaceassocindex_t ifaceassocindex_;
+
     inline  linkset_t&      linkset()   { return linkset_; }
     inline  mprset_t&       mprset()    { return mprset_; }
     inline  mprselset_t&        mprselset() { return mprselset_; }
@@ -88,6 +98,7 @@ class OLSR_state : public cObject
     OLSR_topology_tuple*    find_topology_tuple(const nsaddr_t &, const  nsaddr_t &);
     OLSR_topology_tuple*    find_newer_topology_tuple(const nsaddr_t &, uint16_t);
     void            erase_topology_tuple(OLSR_topology_tuple*);
+    topologyset_t::iterator erase_topology_tuple(topologyset_t::iterator);
     void            erase_older_topology_tuples(const nsaddr_t &, uint16_t);
     void             print_topology_tuples_to(const nsaddr_t & dest_addr);
     void             print_topology_tuples_across(const nsaddr_t & last_addr);
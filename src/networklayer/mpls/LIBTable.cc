@@ -17,6 +17,7 @@
 #include "LIBTable.h"
 #include "XMLUtils.h"
 #include "RoutingTableAccess.h"
+#include "InterfaceTableAccess.h"
 
 Define_Module(LIBTable);
 
@@ -28,6 +29,7 @@ void LIBTable::initialize(int stage)
     if (stage == 0)
     {
         maxLabel = 0;
+        ift = InterfaceTableAccess().get();
         WATCH_VECTOR(lib);
     }
     else if (stage == 4)
@@ -49,25 +51,102 @@ void LIBTable::handleMessage(cMessage *)
 bool LIBTable::resolveLabel(std::string inInterface, int inLabel,
         LabelOpVector& outLabel, std::string& outInterface, int& color)
 {
+    if (inLabel < 0 || inLabel >= (int)ilm.size())
+        return false;
+
     bool any = (inInterface.length() == 0);
 
-    for (unsigned int i = 0; i < lib.size(); i++)
+    const EntryIndexVector& entries = ilm[inLabel];
+    for (unsigned int i = 0; i < entries.size(); i++)
     {
-        if (!any && lib[i].inInterface != inInterface)
-            continue;
-
-        if (lib[i].inLabel != inLabel)
+        const LIBEntry& entry = lib[entries[i]];
+        if (!any && entry.inInterface != inInterface)
             continue;
 
-        outLabel = lib[i].outLabel;
-        outInterface = lib[i].outInterface;
-        color = lib[i].color;
+        outLabel = entry.outLabel;
+        outInterface = entry.outInterface;
+        color = entry.color;
 
         return true;
     }
     return false;
 }
 
+const LIBTable::LIBEntry *LIBTable::findLibEntry(int inInterfaceId, int inLabel) const
+{
+    if (inLabel < 0 || inLabel >= (int)ilm.size())
+        return NULL;
+
+    const EntryIndexVector& entries = ilm[inLabel];
+    for (unsigned int i = 0; i < entries.size(); i++)
+    {
+        const LIBEntry& entry = lib[entries[i]];
+        if (inInterfaceId == -1 || entry.inInterfaceId == inInterfaceId)
+            return &entry;
+    }
+    return NULL;
+}
+
+void LIBTable::resolveEntry(LIBEntry& entry)
+{
+    InterfaceEntry *ie = entry.inInterface.empty() ? NULL : ift->getInterfaceByName(entry.inInterface.c_str());
+    entry.inInterfaceId = ie ? ie->getInterfaceId() : -1;
+
+    ie = ift->getInterfaceByName(entry.outInterface.c_str());
+    entry.outInterfaceId = ie ? ie->getInterfaceId() : -1;
+    entry.outGateIndex = ie ? ie->getNetworkLayerGateIndex() : -1;
+
+    // collapse the operations into popping some of the received labels
+    // and pushing new ones, e.g. a swap pops one label and pushes one
+    entry.numPoppedLabels = 0;
+    entry.pushedLabels.clear();
+    for (unsigned int i = 0; i < entry.outLabel.size(); i++)
+    {
+        const LabelOp& op = entry.outLabel[i];
+        switch (op.optcode)
+        {
+            case PUSH_OPER:
+                entry.pushedLabels.push_back(op.label);
+                break;
+
+            case SWAP_OPER:
+                if (entry.pushedLabels.empty())
+                {
+                    entry.numPoppedLabels++;
+                    entry.pushedLabels.push_back(op.label);
+                }
+                else
+                    entry.pushedLabels.back() = op.label;
+                break;
+
+            case POP_OPER:
+                if (entry.pushedLabels.empty())
+                    entry.numPoppedLabels++;
+                else
+                    entry.pushedLabels.pop_back();
+                break;
+
+            default:
+                throw cRuntimeError("Unknown MPLS OptCode %d", op.optcode);
+        }
+    }
+}
+
+void LIBTable::addToIncomingLabelMap(int inLabel, int pos)
+{
+    ASSERT(inLabel >= 0);
+    if (inLabel >= (int)ilm.size())
+        ilm.resize(inLabel + 1);
+    ilm[inLabel].push_back(pos);
+}
+
+void LIBTable::rebuildIncomingLabelMap()
+{
+    ilm.clear();
+    for (unsigned int i = 0; i < lib.size(); i++)
+        addToIncomingLabelMap(lib[i].inLabel, i);
+}
+
 int LIBTable::installLibEntry(int inLabel, std::string inInterface, const LabelOpVector& outLabel,
             std::string outInterface, int color)
 {
@@ -79,38 +158,32 @@ int LIBTable::installLibEntry(int inLabel, std::string inInterface, const LabelO
         newItem.outLabel = outLabel;
         newItem.outInterface = outInterface;
         newItem.color = color;
+        resolveEntry(newItem);
         lib.push_back(newItem);
+        addToIncomingLabelMap(newItem.inLabel, lib.size() - 1);
         return newItem.inLabel;
     }
     else
     {
-        for (unsigned int i = 0; i < lib.size(); i++)
-        {
-            if (lib[i].inLabel != inLabel)
-                continue;
-
-            lib[i].inInterface = inInterface;
-            lib[i].outLabel = outLabel;
-            lib[i].outInterface = outInterface;
-            lib[i].color = color;
-            return inLabel;
-        }
-        ASSERT(false);
-        return 0; // prevent warning
+        // the first entry with the label, like in the linear search
+        ASSERT(inLabel >= 0 && inLabel < (int)ilm.size() && !ilm[inLabel].empty());
+        LIBEntry& entry = lib[ilm[inLabel].front()];
+        entry.inInterface = inInterface;
+        entry.outLabel = outLabel;
+        entry.outInterface = outInterface;
+        entry.color = color;
+        resolveEntry(entry);
+        return inLabel;
     }
 }
 
 void LIBTable::removeLibEntry(int inLabel)
 {
-    for (unsigned int i = 0; i < lib.size(); i++)
-    {
-        if (lib[i].inLabel != inLabel)
-            continue;
+    ASSERT(inLabel >= 0 && inLabel < (int)ilm.size() && !ilm[inLabel].empty());
+    lib.erase(lib.begin() + ilm[inLabel].front());
 
-        lib.erase(lib.begin() + i);
-        return;
-    }
-    ASSERT(false);
+    // the positions of the following entries have changed
+    rebuildIncomingLabelMap();
 }
 
 void LIBTable::readTableFromXML(const cXMLElement* libtable)
@@ -165,10 +238,12 @@ void LIBTable::readTableFromXML(const cXMLElement* libtable)
             newItem.outLabel.push_back(l);
         }
 
-        lib.push_back(newItem);
-
         ASSERT(newItem.inLabel > 0);
 
+        resolveEntry(newItem);
+        lib.push_back(newItem);
+        addToIncomingLabelMap(newItem.inLabel, lib.size() - 1);
+
         if (newItem.inLabel > maxLabel)
             maxLabel = newItem.inLabel;
     }
@@ -25,6 +25,8 @@
 #include "IPv4Address.h"
 #include "IPv4Datagram.h"
 
+class IInterfaceTable;
+
 // label operations
 #define PUSH_OPER              0
 #define SWAP_OPER              1
@@ -57,13 +59,30 @@ class INET_API LIBTable: public cSimpleModule
 
             // FIXME colors in nam, temporary solution
             int color;
+
+            // resolved by the table when the entry is installed
+            int inInterfaceId;          // -1 if inInterface is not an interface name (e.g. "any")
+            int outInterfaceId;         // -1 if outInterface is unknown
+            int outGateIndex;           // network layer gate index of outInterface
+            int numPoppedLabels;        // the outLabel operations as one replacement:
+            std::vector<int> pushedLabels;  // pop this many labels, then push these
         };
 
     protected:
+        typedef std::vector<int> EntryIndexVector;
+
         IPv4Address routerId;
         int maxLabel;
         std::vector<LIBEntry> lib;
 
+        // Incoming label map: positions in lib of the entries by inLabel.
+        // Labels are allocated from a per-platform label space, so they
+        // index the vector directly; the entries that share a label are
+        // told apart by inInterfaceId.
+        std::vector<EntryIndexVector> ilm;
+
+        IInterfaceTable *ift;
+
     protected:
         virtual void initialize(int stage);
         virtual int numInitStages() const { return 5; }
@@ -72,11 +91,23 @@ class INET_API LIBTable: public cSimpleModule
         // static configuration
         virtual void readTableFromXML(const cXMLElement* libtable);
 
+        // fills in the resolved fields of the entry
+        virtual void resolveEntry(LIBEntry& entry);
+        virtual void addToIncomingLabelMap(int inLabel, int pos);
+        virtual void rebuildIncomingLabelMap();
+
     public:
         // label management
         virtual bool resolveLabel(std::string inInterface, int inLabel,
                           LabelOpVector& outLabel, std::string& outInterface, int& color);
 
+        /**
+         * Returns the entry of the label arriving on the interface, or NULL.
+         * An inInterfaceId of -1 matches any interface. This is the per-packet
+         * lookup of MPLS; the returned entry is valid until the table changes.
+         */
+        virtual const LIBEntry *findLibEntry(int inInterfaceId, int inLabel) const;
+
         virtual int installLibEntry(int inLabel, std::string inInterface, const LabelOpVector& outLabel,
                             std::string outInterface, int color);
 
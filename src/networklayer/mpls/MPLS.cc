@@ -79,7 +79,7 @@ void MPLS::processPacketFromL3(cMessage * msg)
     //int gateIndex = msg->getArrivalGate()->getIndex();
 
     // XXX temporary solution, until TCPSocket and IPv4 are extended to support nam tracing
-    if (ipdatagram->getTransportProtocol() == IP_PROT_TCP)
+    if (ipdatagram->getTransportProtocol() == IP_PROT_TCP && ipdatagram->getEncapsulatedPacket()) // non-first fragments have no TCP header
     {
         TCPSegment *seg = check_and_cast<TCPSegment*>(ipdatagram->getEncapsulatedPacket());
         if (seg->getDestPort() == LDP_PORT || seg->getSrcPort() == LDP_PORT)
@@ -214,11 +214,10 @@ void MPLS::processMPLSPacketFromL2(MPLSPacket *mplsPacket)
 {
     int gateIndex = mplsPacket->getArrivalGate()->getIndex();
     InterfaceEntry *ie = ift->getInterfaceByNetworkLayerGateIndex(gateIndex);
-    std::string senderInterface = ie->getName();
     ASSERT(mplsPacket->hasLabel());
     int oldLabel = mplsPacket->getTopLabel();
 
-    EV << "Received " << mplsPacket << " from L2, label=" << oldLabel << " inInterface=" << senderInterface << endl;
+    EV << "Received " << mplsPacket << " from L2, label=" << oldLabel << " inInterface=" << ie->getName() << endl;
 
     if (oldLabel==-1)
     {
@@ -232,12 +231,9 @@ void MPLS::processMPLSPacketFromL2(MPLSPacket *mplsPacket)
         return;
     }
 
-    LabelOpVector outLabel;
-    std::string outInterface;
-    int color;
-
-    bool found = lt->resolveLabel(senderInterface, oldLabel, outLabel, outInterface, color);
-    if (!found)
+    // the entry has the output gate and the label stack operations pre-resolved
+    const LIBTable::LIBEntry *entry = lt->findLibEntry(ie->getInterfaceId(), oldLabel);
+    if (!entry)
     {
         EV << "discarding packet, incoming label not resolved" << endl;
 
@@ -245,23 +241,29 @@ void MPLS::processMPLSPacketFromL2(MPLSPacket *mplsPacket)
         return;
     }
 
-    int outgoingPort = ift->getInterfaceByName(outInterface.c_str())->getNetworkLayerGateIndex();
+    if (entry->outInterfaceId == -1)
+        error("Unknown output interface '%s' for incoming label %d", entry->outInterface.c_str(), oldLabel);
+    int outgoingPort = entry->outGateIndex;
 
-    doStackOps(mplsPacket, outLabel);
+    EV << "doStackOps: " << entry->outLabel << endl;
+
+    if (mplsPacket->getNumLabels() < entry->numPoppedLabels)
+        error("Label stack of %s is too short for %s", mplsPacket->getName(), mplsPacket->info().c_str());
+    mplsPacket->replaceLabels(entry->numPoppedLabels, entry->pushedLabels);
 
     if (mplsPacket->hasLabel())
     {
         // forward labeled packet
 
-        EV << "forwarding packet to " << outInterface << endl;
+        EV << "forwarding packet to " << entry->outInterface << endl;
 
         if (mplsPacket->hasPar("color"))
         {
-            mplsPacket->par("color") = color;
+            mplsPacket->par("color") = entry->color;
         }
         else
         {
-            mplsPacket->addPar("color") = color;
+            mplsPacket->addPar("color") = entry->color;
         }
 
         //ASSERT(labelIf[outgoingPort]);
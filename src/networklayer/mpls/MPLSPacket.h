@@ -65,6 +65,22 @@ class INET_API MPLSPacket: public cPacket
      */
     inline void popLabel()  {labels.pop_back(); addBitLength(-32);}
 
+    /**
+     * Pops the given number of labels, then pushes the labels of the
+     * vector (its last element becomes the top of stack)
+     */
+    inline void replaceLabels(int numPopped, const std::vector<int>& newLabels)
+    {
+        labels.resize(labels.size() - numPopped);
+        labels.insert(labels.end(), newLabels.begin(), newLabels.end());
+        addBitLength(32 * ((int)newLabels.size() - numPopped));
+    }
+
+    /**
+     * Returns the number of labels in the label stack
+     */
+    inline int getNumLabels() const  {return labels.size();}
+
     /**
      * Returns true if the label stack is not empty
      */
@@ -64,6 +64,8 @@ void OSPFRouting::createOspfRouter()
 {
     IRoutingTable *rt = RoutingTableAccess().get();
     ospfRouter = new OSPF::Router(rt->getRouterId(), this);
+    ospfRouter->setSPFThrottling(par("spfInitialDelay").doubleValue(), par("spfHoldTime").doubleValue(), par("spfMaxHoldTime").doubleValue());
+    ospfRouter->setLSAPacingInterval(par("lsaPacingInterval").doubleValue());
 
     // read the OSPF AS configuration
     cXMLElement *ospfConfig = par("ospfConfig").xmlValue();
@@ -82,6 +84,19 @@ void OSPFRouting::handleMessage(cMessage *msg)
         ospfRouter->getMessageHandler()->messageReceived(msg);
 }
 
+void OSPFRouting::finish()
+{
+    if (ospfRouter == NULL)
+        return;
+
+    recordScalar("SPF requests", ospfRouter->getSPFRequestCount());
+    recordScalar("SPF runs", ospfRouter->getSPFRunCount());
+    recordScalar("flooded LSUs", ospfRouter->getFloodedUpdatePacketCount());
+    recordScalar("flooded LSAs", ospfRouter->getFloodedLSACount());
+    if (ospfRouter->getFloodedUpdatePacketCount() > 0)
+        recordScalar("LSAs per flooded LSU", (double)ospfRouter->getFloodedLSACount() / ospfRouter->getFloodedUpdatePacketCount());
+}
+
 void OSPFRouting::handleMessageWhenDown(cMessage *msg)
 {
     if (msg->isSelfMessage())
@@ -60,6 +60,7 @@ class OSPFRouting :  public cSimpleModule, public ILifecycle
     virtual int numInitStages() const { return 5; }
     virtual void initialize(int stage);
     virtual void handleMessage(cMessage *msg);
+    virtual void finish();
     virtual void handleMessageWhenDown(cMessage *msg);
     virtual bool handleOperationStage(LifecycleOperation *operation, int stage, IDoneCallback *doneCallback);
     virtual void createOspfRouter();
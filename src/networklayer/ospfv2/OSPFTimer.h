@@ -32,6 +32,8 @@ enum OSPFTimerType
     NEIGHBOR_UPDATE_RETRANSMISSION_TIMER = 7,
     NEIGHBOR_REQUEST_RETRANSMISSION_TIMER = 8,
     DATABASE_AGE_TIMER = 9,
+    INTERFACE_UPDATE_PACING_TIMER = 10,
+    SPF_TIMER = 11,
 };
 
 #endif
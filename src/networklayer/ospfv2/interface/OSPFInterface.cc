@@ -63,6 +63,11 @@ OSPF::Interface::Interface(OSPF::Interface::OSPFInterfaceType ifType) :
     acknowledgementTimer->setKind(INTERFACE_ACKNOWLEDGEMENT_TIMER);
     acknowledgementTimer->setContextPointer(this);
     acknowledgementTimer->setName("OSPF::Interface::InterfaceAcknowledgementTimer");
+    updatePacingTimer = new cMessage();
+    updatePacingTimer->setKind(INTERFACE_UPDATE_PACING_TIMER);
+    updatePacingTimer->setContextPointer(this);
+    updatePacingTimer->setName("OSPF::Interface::InterfaceUpdatePacingTimer");
+    pendingUpdatePacket = NULL;
     memset(authenticationKey.bytes, 0, 8 * sizeof(char));
 }
 
@@ -75,6 +80,9 @@ OSPF::Interface::~Interface()
     delete waitTimer;
     messageHandler->clearTimer(acknowledgementTimer);
     delete acknowledgementTimer;
+    messageHandler->clearTimer(updatePacingTimer);
+    delete updatePacingTimer;
+    delete pendingUpdatePacket;
     if (previousState != NULL) {
         delete previousState;
     }
@@ -116,6 +124,10 @@ void OSPF::Interface::reset()
     messageHandler->clearTimer(helloTimer);
     messageHandler->clearTimer(waitTimer);
     messageHandler->clearTimer(acknowledgementTimer);
+    messageHandler->clearTimer(updatePacingTimer);
+    delete pendingUpdatePacket;
+    pendingUpdatePacket = NULL;
+    pendingUpdateLSAKeys.clear();
     designatedRouter = NULL_DESIGNATEDROUTERID;
     backupDesignatedRouter = NULL_DESIGNATEDROUTERID;
     long neighborCount = neighboringRouters.size();
@@ -223,6 +235,9 @@ void OSPF::Interface::addNeighbor(OSPF::Neighbor* neighbor)
     neighboringRoutersByAddress[neighbor->getAddress()] = neighbor;
     neighbor->setInterface(this);
     neighboringRouters.push_back(neighbor);
+    if (parentArea != NULL) {
+        parentArea->invalidateShortestPathTree();
+    }
 }
 
 OSPF::Interface::InterfaceStateType OSPF::Interface::getState() const
@@ -340,61 +355,17 @@ bool OSPF::Interface::floodLSA(OSPFLSA* lsa, OSPF::Interface* intf, OSPF::Neighb
                  (neighbor->getNeighborID() != backupDesignatedRouter.routerID)))  // (3)
             {
                 if ((intf != this) || (getState() != OSPF::Interface::BACKUP_STATE)) {  // (4)
-                    OSPFLinkStateUpdatePacket* updatePacket = createUpdatePacket(lsa);    // (5)
-
-                    if (updatePacket != NULL) {
-                        int ttl = (interfaceType == OSPF::Interface::VIRTUAL) ? VIRTUAL_LINK_TTL : 1;
-                        OSPF::MessageHandler* messageHandler = parentArea->getRouter()->getMessageHandler();
-
-                        if (interfaceType == OSPF::Interface::BROADCAST) {
-                            if ((getState() == OSPF::Interface::DESIGNATED_ROUTER_STATE) ||
-                                (getState() == OSPF::Interface::BACKUP_STATE) ||
-                                (designatedRouter == OSPF::NULL_DESIGNATEDROUTERID))
-                            {
-                                messageHandler->sendPacket(updatePacket, IPv4Address::ALL_OSPF_ROUTERS_MCAST, ifIndex, ttl);
-                                for (long k = 0; k < neighborCount; k++) {
-                                    neighboringRouters[k]->addToTransmittedLSAList(lsaKey);
-                                    if (!neighboringRouters[k]->isUpdateRetransmissionTimerActive()) {
-                                        neighboringRouters[k]->startUpdateRetransmissionTimer();
-                                    }
-                                }
-                            } else {
-                                messageHandler->sendPacket(updatePacket, IPv4Address::ALL_OSPF_DESIGNATED_ROUTERS_MCAST, ifIndex, ttl);
-                                OSPF::Neighbor* dRouter = getNeighborByID(designatedRouter.routerID);
-                                OSPF::Neighbor* backupDRouter = getNeighborByID(backupDesignatedRouter.routerID);
-                                if (dRouter != NULL) {
-                                    dRouter->addToTransmittedLSAList(lsaKey);
-                                    if (!dRouter->isUpdateRetransmissionTimerActive()) {
-                                        dRouter->startUpdateRetransmissionTimer();
-                                    }
-                                }
-                                if (backupDRouter != NULL) {
-                                    backupDRouter->addToTransmittedLSAList(lsaKey);
-                                    if (!backupDRouter->isUpdateRetransmissionTimerActive()) {
-                                        backupDRouter->startUpdateRetransmissionTimer();
-                                    }
-                                }
-                            }
+                    unsigned int lsaSize = calculateLSASize(lsa);
+
+                    if (lsaSize > 0) {
+                        if (parentArea->getRouter()->getLSAPacingInterval() > 0) {
+                            addToPendingUpdatePacket(lsa, lsaKey, lsaSize);
                         } else {
-                            if (interfaceType == OSPF::Interface::POINTTOPOINT) {
-                                messageHandler->sendPacket(updatePacket, IPv4Address::ALL_OSPF_ROUTERS_MCAST, ifIndex, ttl);
-                                if (neighborCount > 0) {
-                                    neighboringRouters[0]->addToTransmittedLSAList(lsaKey);
-                                    if (!neighboringRouters[0]->isUpdateRetransmissionTimerActive()) {
-                                        neighboringRouters[0]->startUpdateRetransmissionTimer();
-                                    }
-                                }
-                            } else {
-                                for (long m = 0; m < neighborCount; m++) {
-                                    if (neighboringRouters[m]->getState() >= OSPF::Neighbor::EXCHANGE_STATE) {
-                                        messageHandler->sendPacket(updatePacket, neighboringRouters[m]->getAddress(), ifIndex, ttl);
-                                        neighboringRouters[m]->addToTransmittedLSAList(lsaKey);
-                                        if (!neighboringRouters[m]->isUpdateRetransmissionTimerActive()) {
-                                            neighboringRouters[m]->startUpdateRetransmissionTimer();
-                                        }
-                                    }
-                                }
-                            }
+                            OSPFLinkStateUpdatePacket* updatePacket = createEmptyUpdatePacket();    // (5)
+                            std::vector<OSPF::LSAKeyType> lsaKeys(1, lsaKey);
+
+                            addToUpdatePacket(updatePacket, lsa, lsaSize);
+                            sendUpdatePacket(updatePacket, lsaKeys);
                         }
 
                         if (intf == this) {
@@ -411,93 +382,198 @@ bool OSPF::Interface::floodLSA(OSPFLSA* lsa, OSPF::Interface* intf, OSPF::Neighb
 
 OSPFLinkStateUpdatePacket* OSPF::Interface::createUpdatePacket(OSPFLSA* lsa)
 {
-    LSAType lsaType = static_cast<LSAType> (lsa->getHeader().getLsType());
-    OSPFRouterLSA* routerLSA = (lsaType == ROUTERLSA_TYPE) ? dynamic_cast<OSPFRouterLSA*> (lsa) : NULL;
-    OSPFNetworkLSA* networkLSA = (lsaType == NETWORKLSA_TYPE) ? dynamic_cast<OSPFNetworkLSA*> (lsa) : NULL;
-    OSPFSummaryLSA* summaryLSA = ((lsaType == SUMMARYLSA_NETWORKS_TYPE) ||
-                                        (lsaType == SUMMARYLSA_ASBOUNDARYROUTERS_TYPE)) ? dynamic_cast<OSPFSummaryLSA*> (lsa) : NULL;
-    OSPFASExternalLSA* asExternalLSA = (lsaType == AS_EXTERNAL_LSA_TYPE) ? dynamic_cast<OSPFASExternalLSA*> (lsa) : NULL;
-
-    if (((lsaType == ROUTERLSA_TYPE) && (routerLSA != NULL)) ||
-        ((lsaType == NETWORKLSA_TYPE) && (networkLSA != NULL)) ||
-        (((lsaType == SUMMARYLSA_NETWORKS_TYPE) || (lsaType == SUMMARYLSA_ASBOUNDARYROUTERS_TYPE)) && (summaryLSA != NULL)) ||
-        ((lsaType == AS_EXTERNAL_LSA_TYPE) && (asExternalLSA != NULL)))
+    unsigned int lsaSize = calculateLSASize(lsa);
+
+    if (lsaSize > 0) {
+        OSPFLinkStateUpdatePacket* updatePacket = createEmptyUpdatePacket();
+        addToUpdatePacket(updatePacket, lsa, lsaSize);
+        return updatePacket;
+    }
+    return NULL;
+}
+
+OSPFLinkStateUpdatePacket* OSPF::Interface::createEmptyUpdatePacket()
+{
+    OSPFLinkStateUpdatePacket* updatePacket = new OSPFLinkStateUpdatePacket();
+
+    updatePacket->setType(LINKSTATE_UPDATE_PACKET);
+    updatePacket->setRouterID(IPv4Address(parentArea->getRouter()->getRouterID()));
+    updatePacket->setAreaID(IPv4Address(areaID));
+    updatePacket->setAuthenticationType(authenticationType);
+    for (int j = 0; j < 8; j++) {
+        updatePacket->setAuthentication(j, authenticationKey.bytes[j]);
+    }
+    updatePacket->setNumberOfLSAs(0);
+    updatePacket->setByteLength(OSPF_HEADER_LENGTH + sizeof(uint32_t));  // OSPF header + place for number of advertisements
+
+    return updatePacket;
+}
+
+/**
+ * Appends a copy of the input lsa to the update packet, incrementing its age by
+ * the interface transmission delay. The lsaSize must be calculateLSASize(lsa).
+ */
+void OSPF::Interface::addToUpdatePacket(OSPFLinkStateUpdatePacket* updatePacket, OSPFLSA* lsa, unsigned int lsaSize)
+{
+    OSPFLSAHeader* lsaHeader = NULL;
+
+    switch (lsa->getHeader().getLsType()) {
+        case ROUTERLSA_TYPE:
+            {
+                unsigned int routerLSACount = updatePacket->getRouterLSAsArraySize();
+                updatePacket->setRouterLSAsArraySize(routerLSACount + 1);
+                updatePacket->setRouterLSAs(routerLSACount, *check_and_cast<OSPFRouterLSA*> (lsa));
+                lsaHeader = &updatePacket->getRouterLSAs(routerLSACount).getHeader();
+            }
+            break;
+        case NETWORKLSA_TYPE:
+            {
+                unsigned int networkLSACount = updatePacket->getNetworkLSAsArraySize();
+                updatePacket->setNetworkLSAsArraySize(networkLSACount + 1);
+                updatePacket->setNetworkLSAs(networkLSACount, *check_and_cast<OSPFNetworkLSA*> (lsa));
+                lsaHeader = &updatePacket->getNetworkLSAs(networkLSACount).getHeader();
+            }
+            break;
+        case SUMMARYLSA_NETWORKS_TYPE:
+        case SUMMARYLSA_ASBOUNDARYROUTERS_TYPE:
+            {
+                unsigned int summaryLSACount = updatePacket->getSummaryLSAsArraySize();
+                updatePacket->setSummaryLSAsArraySize(summaryLSACount + 1);
+                updatePacket->setSummaryLSAs(summaryLSACount, *check_and_cast<OSPFSummaryLSA*> (lsa));
+                lsaHeader = &updatePacket->getSummaryLSAs(summaryLSACount).getHeader();
+            }
+            break;
+        case AS_EXTERNAL_LSA_TYPE:
+            {
+                unsigned int asExternalLSACount = updatePacket->getAsExternalLSAsArraySize();
+                updatePacket->setAsExternalLSAsArraySize(asExternalLSACount + 1);
+                updatePacket->setAsExternalLSAs(asExternalLSACount, *check_and_cast<OSPFASExternalLSA*> (lsa));
+                lsaHeader = &updatePacket->getAsExternalLSAs(asExternalLSACount).getHeader();
+            }
+            break;
+        default: throw cRuntimeError("Invalid LSA type: %d", lsa->getHeader().getLsType());
+    }
+
+    unsigned short lsAge = lsaHeader->getLsAge();
+    if (lsAge < MAX_AGE - interfaceTransmissionDelay) {
+        lsaHeader->setLsAge(lsAge + interfaceTransmissionDelay);
+    } else {
+        lsaHeader->setLsAge(MAX_AGE);
+    }
+
+    updatePacket->setNumberOfLSAs(updatePacket->getNumberOfLSAs() + 1);
+    updatePacket->setByteLength(updatePacket->getByteLength() + lsaSize);
+}
+
+/**
+ * Queues the input lsa for flooding on this interface. Queued LSAs are packed
+ * into as few Link State Update packets as the interface MTU allows; a packet is
+ * sent when it is full or when the update pacing timer fires.
+ */
+void OSPF::Interface::addToPendingUpdatePacket(OSPFLSA* lsa, const OSPF::LSAKeyType& lsaKey, unsigned int lsaSize)
+{
+    long maxPacketSize = ((IP_MAX_HEADER_BYTES + OSPF_HEADER_LENGTH + sizeof(uint32_t) + lsaSize) > mtu) ? IPV4_DATAGRAM_LENGTH : mtu;
+
+    if ((pendingUpdatePacket != NULL) &&
+        (IP_MAX_HEADER_BYTES + pendingUpdatePacket->getByteLength() + lsaSize > maxPacketSize))
     {
-        OSPFLinkStateUpdatePacket* updatePacket = new OSPFLinkStateUpdatePacket();
-        long packetLength = OSPF_HEADER_LENGTH + sizeof(uint32_t);  // OSPF header + place for number of advertisements
-
-        updatePacket->setType(LINKSTATE_UPDATE_PACKET);
-        updatePacket->setRouterID(IPv4Address(parentArea->getRouter()->getRouterID()));
-        updatePacket->setAreaID(IPv4Address(areaID));
-        updatePacket->setAuthenticationType(authenticationType);
-        for (int j = 0; j < 8; j++) {
-            updatePacket->setAuthentication(j, authenticationKey.bytes[j]);
-        }
+        sendPendingUpdatePacket();
+    }
+    if (pendingUpdatePacket == NULL) {
+        pendingUpdatePacket = createEmptyUpdatePacket();
+        parentArea->getRouter()->getMessageHandler()->startTimer(updatePacingTimer, parentArea->getRouter()->getLSAPacingInterval());
+    }
+    addToUpdatePacket(pendingUpdatePacket, lsa, lsaSize);
+    pendingUpdateLSAKeys.push_back(lsaKey);
+}
 
-        updatePacket->setNumberOfLSAs(1);
+void OSPF::Interface::sendPendingUpdatePacket()
+{
+    parentArea->getRouter()->getMessageHandler()->clearTimer(updatePacingTimer);
+    if (pendingUpdatePacket != NULL) {
+        OSPFLinkStateUpdatePacket* updatePacket = pendingUpdatePacket;
+        pendingUpdatePacket = NULL;
+        sendUpdatePacket(updatePacket, pendingUpdateLSAKeys);
+        pendingUpdateLSAKeys.clear();
+    }
+}
 
-        switch (lsaType) {
-            case ROUTERLSA_TYPE:
-                {
-                    updatePacket->setRouterLSAsArraySize(1);
-                    updatePacket->setRouterLSAs(0, *routerLSA);
-                    unsigned short lsAge = updatePacket->getRouterLSAs(0).getHeader().getLsAge();
-                    if (lsAge < MAX_AGE - interfaceTransmissionDelay) {
-                        updatePacket->getRouterLSAs(0).getHeader().setLsAge(lsAge + interfaceTransmissionDelay);
-                    } else {
-                        updatePacket->getRouterLSAs(0).getHeader().setLsAge(MAX_AGE);
-                    }
-                    packetLength += calculateLSASize(routerLSA);
+/**
+ * Sends a flooded Link State Update packet to the neighbors selected in
+ * RFC2328 Section 13.3 point (5), and puts the contained LSAs on their
+ * transmitted LSA lists.
+ */
+void OSPF::Interface::sendUpdatePacket(OSPFLinkStateUpdatePacket* updatePacket, const std::vector<OSPF::LSAKeyType>& lsaKeys)
+{
+    int ttl = (interfaceType == OSPF::Interface::VIRTUAL) ? VIRTUAL_LINK_TTL : 1;
+    OSPF::MessageHandler* messageHandler = parentArea->getRouter()->getMessageHandler();
+    long neighborCount = neighboringRouters.size();
+    unsigned long keyCount = lsaKeys.size();
+
+    parentArea->getRouter()->countFloodedUpdatePacket(updatePacket->getNumberOfLSAs());
+
+    if (interfaceType == OSPF::Interface::BROADCAST) {
+        if ((getState() == OSPF::Interface::DESIGNATED_ROUTER_STATE) ||
+            (getState() == OSPF::Interface::BACKUP_STATE) ||
+            (designatedRouter == OSPF::NULL_DESIGNATEDROUTERID))
+        {
+            messageHandler->sendPacket(updatePacket, IPv4Address::ALL_OSPF_ROUTERS_MCAST, ifIndex, ttl);
+            for (long k = 0; k < neighborCount; k++) {
+                for (unsigned long i = 0; i < keyCount; i++) {
+                    neighboringRouters[k]->addToTransmittedLSAList(lsaKeys[i]);
                 }
-                break;
-            case NETWORKLSA_TYPE:
-                {
-                    updatePacket->setNetworkLSAsArraySize(1);
-                    updatePacket->setNetworkLSAs(0, *networkLSA);
-                    unsigned short lsAge = updatePacket->getNetworkLSAs(0).getHeader().getLsAge();
-                    if (lsAge < MAX_AGE - interfaceTransmissionDelay) {
-                        updatePacket->getNetworkLSAs(0).getHeader().setLsAge(lsAge + interfaceTransmissionDelay);
-                    } else {
-                        updatePacket->getNetworkLSAs(0).getHeader().setLsAge(MAX_AGE);
-                    }
-                    packetLength += calculateLSASize(networkLSA);
+                if (!neighboringRouters[k]->isUpdateRetransmissionTimerActive()) {
+                    neighboringRouters[k]->startUpdateRetransmissionTimer();
                 }
-                break;
-            case SUMMARYLSA_NETWORKS_TYPE:
-            case SUMMARYLSA_ASBOUNDARYROUTERS_TYPE:
-                {
-                    updatePacket->setSummaryLSAsArraySize(1);
-                    updatePacket->setSummaryLSAs(0, *summaryLSA);
-                    unsigned short lsAge = updatePacket->getSummaryLSAs(0).getHeader().getLsAge();
-                    if (lsAge < MAX_AGE - interfaceTransmissionDelay) {
-                        updatePacket->getSummaryLSAs(0).getHeader().setLsAge(lsAge + interfaceTransmissionDelay);
-                    } else {
-                        updatePacket->getSummaryLSAs(0).getHeader().setLsAge(MAX_AGE);
-                    }
-                    packetLength += calculateLSASize(summaryLSA);
+            }
+        } else {
+            messageHandler->sendPacket(updatePacket, IPv4Address::ALL_OSPF_DESIGNATED_ROUTERS_MCAST, ifIndex, ttl);
+            OSPF::Neighbor* dRouter = getNeighborByID(designatedRouter.routerID);
+            OSPF::Neighbor* backupDRouter = getNeighborByID(backupDesignatedRouter.routerID);
+            if (dRouter != NULL) {
+                for (unsigned long i = 0; i < keyCount; i++) {
+                    dRouter->addToTransmittedLSAList(lsaKeys[i]);
                 }
-                break;
-            case AS_EXTERNAL_LSA_TYPE:
-                {
-                    updatePacket->setAsExternalLSAsArraySize(1);
-                    updatePacket->setAsExternalLSAs(0, *asExternalLSA);
-                    unsigned short lsAge = updatePacket->getAsExternalLSAs(0).getHeader().getLsAge();
-                    if (lsAge < MAX_AGE - interfaceTransmissionDelay) {
-                        updatePacket->getAsExternalLSAs(0).getHeader().setLsAge(lsAge + interfaceTransmissionDelay);
-                    } else {
-                        updatePacket->getAsExternalLSAs(0).getHeader().setLsAge(MAX_AGE);
+                if (!dRouter->isUpdateRetransmissionTimerActive()) {
+                    dRouter->startUpdateRetransmissionTimer();
+                }
+            }
+            if (backupDRouter != NULL) {
+                for (unsigned long i = 0; i < keyCount; i++) {
+                    backupDRouter->addToTransmittedLSAList(lsaKeys[i]);
+                }
+                if (!backupDRouter->isUpdateRetransmissionTimerActive()) {
+                    backupDRouter->startUpdateRetransmissionTimer();
+                }
+            }
+        }
+    } else {
+        if (interfaceType == OSPF::Interface::POINTTOPOINT) {
+            messageHandler->sendPacket(updatePacket, IPv4Address::ALL_OSPF_ROUTERS_MCAST, ifIndex, ttl);
+            if (neighborCount > 0) {
+                for (unsigned long i = 0; i < keyCount; i++) {
+                    neighboringRouters[0]->addToTransmittedLSAList(lsaKeys[i]);
+                }
+                if (!neighboringRouters[0]->isUpdateRetransmissionTimerActive()) {
+                    neighboringRouters[0]->startUpdateRetransmissionTimer();
+                }
+            }
+        } else {
+            // every neighbor gets its own copy of the packet
+            for (long m = 0; m < neighborCount; m++) {
+                if (neighboringRouters[m]->getState() >= OSPF::Neighbor::EXCHANGE_STATE) {
+                    messageHandler->sendPacket(updatePacket->dup(), neighboringRouters[m]->getAddress(), ifIndex, ttl);
+                    for (unsigned long i = 0; i < keyCount; i++) {
+                        neighboringRouters[m]->addToTransmittedLSAList(lsaKeys[i]);
+                    }
+                    if (!neighboringRouters[m]->isUpdateRetransmissionTimerActive()) {
+                        neighboringRouters[m]->startUpdateRetransmissionTimer();
                     }
-                    packetLength += calculateLSASize(asExternalLSA);
                 }
-                break;
-            default: throw cRuntimeError("Invalid LSA type: %d", lsaType);
+            }
+            delete updatePacket;
         }
-
-        updatePacket->setByteLength(packetLength);
-
-        return updatePacket;
     }
-    return NULL;
 }
 
 void OSPF::Interface::addDelayedAcknowledgement(OSPFLSAHeader& lsaHeader)
@@ -83,6 +83,9 @@ private:
     cMessage*                                                           helloTimer;
     cMessage*                                                           waitTimer;
     cMessage*                                                           acknowledgementTimer;
+    cMessage*                                                           updatePacingTimer;
+    OSPFLinkStateUpdatePacket*                                          pendingUpdatePacket;      ///< Flooded LSAs waiting for the update pacing timer.
+    std::vector<LSAKeyType>                                             pendingUpdateLSAKeys;     ///< The keys of the LSAs in pendingUpdatePacket.
     std::map<RouterID, Neighbor*>                                       neighboringRoutersByID;
     std::map<IPv4Address, Neighbor*>                                    neighboringRoutersByAddress;
     std::vector<Neighbor*>                                              neighboringRouters;
@@ -100,6 +103,11 @@ private:
     friend class InterfaceState;
     void changeState(InterfaceState* newState, InterfaceState* currentState);
 
+    OSPFLinkStateUpdatePacket* createEmptyUpdatePacket();
+    void                addToUpdatePacket(OSPFLinkStateUpdatePacket* updatePacket, OSPFLSA* lsa, unsigned int lsaSize);
+    void                addToPendingUpdatePacket(OSPFLSA* lsa, const LSAKeyType& lsaKey, unsigned int lsaSize);
+    void                sendUpdatePacket(OSPFLinkStateUpdatePacket* updatePacket, const std::vector<LSAKeyType>& lsaKeys);
+
 public:
     Interface(OSPFInterfaceType ifType = UNKNOWN_TYPE);
     virtual ~Interface();
@@ -120,6 +128,7 @@ public:
     void                addDelayedAcknowledgement(OSPFLSAHeader& lsaHeader);
     void                sendDelayedAcknowledgements();
     void                ageTransmittedLSALists();
+    void                sendPendingUpdatePacket();
 
     OSPFLinkStateUpdatePacket* createUpdatePacket(OSPFLSA* lsa);
 
@@ -159,6 +168,7 @@ public:
     cMessage*               getHelloTimer()  { return helloTimer; }
     cMessage*               getWaitTimer()  { return waitTimer; }
     cMessage*               getAcknowledgementTimer()  { return acknowledgementTimer; }
+    cMessage*               getUpdatePacingTimer()  { return updatePacingTimer; }
     DesignatedRouterID      getDesignatedRouter() const  { return designatedRouter; }
     DesignatedRouterID      getBackupDesignatedRouter() const  { return backupDesignatedRouter; }
     unsigned long           getNeighborCount() const  { return neighboringRouters.size(); }
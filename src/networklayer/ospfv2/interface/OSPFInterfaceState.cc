@@ -36,6 +36,7 @@ void OSPF::InterfaceState::changeState(OSPF::Interface* intf, OSPF::InterfaceSta
     bool shouldRebuildRoutingTable = false;
 
     intf->changeState(newState, currentState);
+    intf->getArea()->invalidateShortestPathTree();    // next hops depend on the interface state
 
     if ((oldState == OSPF::Interface::DOWN_STATE) ||
         (nextState == OSPF::Interface::DOWN_STATE) ||
@@ -110,7 +111,7 @@ void OSPF::InterfaceState::changeState(OSPF::Interface* intf, OSPF::InterfaceSta
     }
 
     if (shouldRebuildRoutingTable) {
-        intf->getArea()->getRouter()->rebuildRoutingTable();
+        intf->getArea()->getRouter()->scheduleRoutingTableRebuild();
     }
 }
 
@@ -317,6 +318,9 @@ void OSPF::InterfaceState::calculateDesignatedRouter(OSPF::Interface* intf)
 
     intf->designatedRouter = declaredDesignatedRouter;
     intf->backupDesignatedRouter = declaredBackup;
+    if (routersOldDesignatedRouterID != declaredDesignatedRouter.routerID) {
+        intf->getArea()->invalidateShortestPathTree();    // next hops on broadcast networks depend on the DR
+    }
 
     bool wasBackupDesignatedRouter = (routersOldBackupID == routerID);
     bool wasDesignatedRouter = (routersOldDesignatedRouterID == routerID);
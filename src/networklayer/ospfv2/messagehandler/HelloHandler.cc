@@ -165,6 +165,9 @@ void OSPF::HelloHandler::processPacket(OSPFPacket* packet, OSPF::Interface* intf
 
                     neighbor->setNeighborID(helloPacket->getRouterID());
                     neighbor->setPriority(newPriority);
+                    if (neighbor->getAddress() != srcAddress) {
+                        intf->getArea()->invalidateShortestPathTree();
+                    }
                     neighbor->setAddress(srcAddress);
                     dRouterID.routerID = newDesignatedRouter;
                     dRouterID.ipInterfaceAddress = newDesignatedRouter;
@@ -303,6 +306,8 @@ void OSPF::HelloHandler::processPacket(OSPFPacket* packet, OSPF::Interface* intf
                     if (neighborsDRStateChanged) {
                         OSPF::RouterLSA* routerLSA = intf->getArea()->findRouterLSA(router->getRouterID());
 
+                        intf->getArea()->invalidateShortestPathTree();
+
                         if (routerLSA != NULL) {
                             long sequenceNumber = routerLSA->getHeader().getLsSequenceNumber();
                             if (sequenceNumber == MAX_SEQUENCE_NUMBER) {
@@ -330,6 +335,6 @@ void OSPF::HelloHandler::processPacket(OSPFPacket* packet, OSPF::Interface* intf
     }
 
     if (shouldRebuildRoutingTable) {
-        router->rebuildRoutingTable();
+        router->scheduleRoutingTableRebuild();
     }
 }
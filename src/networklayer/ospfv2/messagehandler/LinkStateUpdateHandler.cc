@@ -201,6 +201,9 @@ void OSPF::LinkStateUpdateHandler::processPacket(OSPFPacket* packet, OSPF::Inter
                         ((lsaType == NETWORKLSA_TYPE) &&
                          (router->isLocalAddress(currentLSA->getHeader().getLinkStateID()))))
                     {
+                        if ((lsaType == ROUTERLSA_TYPE) || (lsaType == NETWORKLSA_TYPE)) {
+                            area->invalidateShortestPathTree();
+                        }
                         if (ackFlags.noLSAInstanceInDatabase) {
                             currentLSA->getHeader().setLsAge(MAX_AGE);
                             router->floodLSA(currentLSA, areaID);
@@ -268,7 +271,7 @@ void OSPF::LinkStateUpdateHandler::processPacket(OSPFPacket* packet, OSPF::Inter
     }
 
     if (shouldRebuildRoutingTable) {
-        router->rebuildRoutingTable();
+        router->scheduleRoutingTableRebuild(false);
     }
 }
 
@@ -165,6 +165,25 @@ void OSPF::MessageHandler::handleTimer(cMessage* timer)
                 router->ageDatabase();
             }
             break;
+        case INTERFACE_UPDATE_PACING_TIMER:
+            {
+                OSPF::Interface* intf;
+                if (! (intf = reinterpret_cast <OSPF::Interface*> (timer->getContextPointer()))) {
+                    // should not reach this point
+                    EV << "Discarding invalid InterfaceUpdatePacingTimer.\n";
+                    delete timer;
+                } else {
+                    printEvent("Update Pacing Timer expired", intf);
+                    intf->sendPendingUpdatePacket();
+                }
+            }
+            break;
+        case SPF_TIMER:
+            {
+                printEvent("SPF Timer expired");
+                router->runScheduledRoutingTableRebuild();
+            }
+            break;
         default: break;
     }
 }
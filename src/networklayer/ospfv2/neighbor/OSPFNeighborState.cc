@@ -31,6 +31,7 @@ void OSPF::NeighborState::changeState(OSPF::Neighbor* neighbor, OSPF::NeighborSt
     bool shouldRebuildRoutingTable = false;
 
     neighbor->changeState(newState, currentState);
+    neighbor->getInterface()->getArea()->invalidateShortestPathTree();    // next hops depend on the neighbor state
 
     if ((oldState == OSPF::Neighbor::FULL_STATE) || (nextState == OSPF::Neighbor::FULL_STATE)) {
         OSPF::RouterID routerID = neighbor->getInterface()->getArea()->getRouter()->getRouterID();
@@ -81,6 +82,6 @@ void OSPF::NeighborState::changeState(OSPF::Neighbor* neighbor, OSPF::NeighborSt
     }
 
     if (shouldRebuildRoutingTable) {
-        neighbor->getInterface()->getArea()->getRouter()->rebuildRoutingTable();
+        neighbor->getInterface()->getArea()->getRouter()->scheduleRoutingTableRebuild();
     }
 }
@@ -103,6 +103,35 @@ unsigned int calculateLSASize(const OSPFASExternalLSA* asExternalLSA)
             (asExternalLSA->getContents().getExternalTOSInfoArraySize() * OSPF_ASEXTERNALLSA_TOS_INFO_LENGTH));
 }
 
+unsigned int calculateLSASize(const OSPFLSA* lsa)
+{
+    switch (lsa->getHeader().getLsType()) {
+        case ROUTERLSA_TYPE:
+            {
+                const OSPFRouterLSA* routerLSA = dynamic_cast<const OSPFRouterLSA*> (lsa);
+                return (routerLSA != NULL) ? calculateLSASize(routerLSA) : 0;
+            }
+        case NETWORKLSA_TYPE:
+            {
+                const OSPFNetworkLSA* networkLSA = dynamic_cast<const OSPFNetworkLSA*> (lsa);
+                return (networkLSA != NULL) ? calculateLSASize(networkLSA) : 0;
+            }
+        case SUMMARYLSA_NETWORKS_TYPE:
+        case SUMMARYLSA_ASBOUNDARYROUTERS_TYPE:
+            {
+                const OSPFSummaryLSA* summaryLSA = dynamic_cast<const OSPFSummaryLSA*> (lsa);
+                return (summaryLSA != NULL) ? calculateLSASize(summaryLSA) : 0;
+            }
+        case AS_EXTERNAL_LSA_TYPE:
+            {
+                const OSPFASExternalLSA* asExternalLSA = dynamic_cast<const OSPFASExternalLSA*> (lsa);
+                return (asExternalLSA != NULL) ? calculateLSASize(asExternalLSA) : 0;
+            }
+        default:
+            return 0;
+    }
+}
+
 void printLSAHeader(const OSPFLSAHeader& lsaHeader, std::ostream& output) {
     output << "LSAHeader: age=" << lsaHeader.getLsAge()
            << ", type=";
@@ -36,14 +36,28 @@ struct NextHop {
 
 class RoutingInfo
 {
+public:
+    /**
+     * Membership of the vertex during the shortest path calculation; replaces
+     * searching the candidate list and the tree.
+     */
+    enum SPFState {
+        SPF_UNVISITED = 0,
+        SPF_CANDIDATE = 1,
+        SPF_ON_TREE = 2
+    };
+
 private:
     std::vector<NextHop>  nextHops;
     unsigned long         distance;
     OSPFLSA*              parent;
+    SPFState              spfState;
+    unsigned long         candidateOrder;
 
 public:
-    RoutingInfo() : distance(0), parent(NULL) {}
-    RoutingInfo(const RoutingInfo& routingInfo) : nextHops(routingInfo.nextHops), distance(routingInfo.distance), parent(routingInfo.parent) {}
+    RoutingInfo() : distance(0), parent(NULL), spfState(SPF_UNVISITED), candidateOrder(0) {}
+    RoutingInfo(const RoutingInfo& routingInfo) : nextHops(routingInfo.nextHops), distance(routingInfo.distance), parent(routingInfo.parent),
+                                                  spfState(routingInfo.spfState), candidateOrder(routingInfo.candidateOrder) {}
     virtual ~RoutingInfo() {}
 
     void            addNextHop(NextHop nextHop)  { nextHops.push_back(nextHop); }
@@ -54,6 +68,10 @@ public:
     unsigned long   getDistance() const  { return distance; }
     void            setParent(OSPFLSA* p)  { parent = p; }
     OSPFLSA*        getParent() const  { return parent; }
+    void            setSPFState(SPFState state)  { spfState = state; }
+    SPFState        getSPFState() const  { return spfState; }
+    void            setCandidateOrder(unsigned long order)  { candidateOrder = order; }
+    unsigned long   getCandidateOrder() const  { return candidateOrder; }
 };
 
 class LSATrackingInfo
@@ -188,6 +206,7 @@ unsigned int calculateLSASize(const OSPFRouterLSA* routerLSA);
 unsigned int calculateLSASize(const OSPFNetworkLSA* networkLSA);
 unsigned int calculateLSASize(const OSPFSummaryLSA* summaryLSA);
 unsigned int calculateLSASize(const OSPFASExternalLSA* asExternalLSA);
+unsigned int calculateLSASize(const OSPFLSA* lsa);  // dispatches on the LS type; 0 if the type is unknown
 void printLSAHeader(const OSPFLSAHeader& lsaHeader, std::ostream& output);
 
 inline std::ostream& operator<<(std::ostream& ostr, const OSPFLSA& lsa)
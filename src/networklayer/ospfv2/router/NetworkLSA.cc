@@ -20,7 +20,9 @@
 bool OSPF::NetworkLSA::update(const OSPFNetworkLSA* lsa)
 {
     bool different = differsFrom(lsa);
-    (*this) = (*lsa);
+    // keep the routing info: an unchanged LSA stays on the cached shortest path tree
+    OSPFNetworkLSA::operator=(*lsa);
+    setSource(LSATrackingInfo::FLOODED);
     resetInstallTime();
     if (different) {
         clearNextHops();
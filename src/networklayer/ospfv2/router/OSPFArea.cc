@@ -25,6 +25,7 @@ OSPF::Area::Area(OSPF::AreaID id) :
     externalRoutingCapability(true),
     stubDefaultCost(1),
     spfTreeRoot(NULL),
+    shortestPathTreeValid(false),
     parentRouter(NULL)
 {
 }
@@ -264,11 +265,16 @@ bool OSPF::Area::installRouterLSA(OSPFRouterLSA* lsa)
         lsaKey.advertisingRouter = lsa->getHeader().getAdvertisingRouter();
 
         removeFromAllRetransmissionLists(lsaKey);
-        return lsaIt->second->update(lsa);
+        bool changed = lsaIt->second->update(lsa);
+        if (changed) {
+            invalidateShortestPathTree();
+        }
+        return changed;
     } else {
         OSPF::RouterLSA* lsaCopy = new OSPF::RouterLSA(*lsa);
         routerLSAsByID[linkStateID] = lsaCopy;
         routerLSAs.push_back(lsaCopy);
+        invalidateShortestPathTree();
         return true;
     }
 }
@@ -284,11 +290,16 @@ bool OSPF::Area::installNetworkLSA(OSPFNetworkLSA* lsa)
         lsaKey.advertisingRouter = lsa->getHeader().getAdvertisingRouter();
 
         removeFromAllRetransmissionLists(lsaKey);
-        return lsaIt->second->update(lsa);
+        bool changed = lsaIt->second->update(lsa);
+        if (changed) {
+            invalidateShortestPathTree();
+        }
+        return changed;
     } else {
         OSPF::NetworkLSA* lsaCopy = new OSPF::NetworkLSA(*lsa);
         networkLSAsByID[linkStateID] = lsaCopy;
         networkLSAs.push_back(lsaCopy);
+        invalidateShortestPathTree();
         return true;
     }
 }
@@ -389,6 +400,9 @@ void OSPF::Area::ageDatabase()
         bool selfOriginated = (lsa->getHeader().getAdvertisingRouter() == parentRouter->getRouterID());
         bool unreachable = parentRouter->isDestinationUnreachable(lsa);
 
+        if ((selfOriginated && (lsAge == (LS_REFRESH_TIME - 1))) || (lsAge >= MAX_AGE - 1)) {
+            invalidateShortestPathTree();    // the LSA is reoriginated, or reaches MaxAge and leaves the tree
+        }
         if ((selfOriginated && (lsAge < (LS_REFRESH_TIME - 1))) || (!selfOriginated && (lsAge < (MAX_AGE - 1)))) {
             lsa->getHeader().setLsAge(lsAge + 1);
             if ((lsAge + 1) % CHECK_AGE == 0) {
@@ -478,6 +492,9 @@ void OSPF::Area::ageDatabase()
             selfOriginated = true;
         }
 
+        if ((selfOriginated && (lsAge == (LS_REFRESH_TIME - 1))) || (lsAge >= MAX_AGE - 1)) {
+            invalidateShortestPathTree();    // the LSA is reoriginated, or reaches MaxAge and leaves the tree
+        }
         if ((selfOriginated && (lsAge < (LS_REFRESH_TIME - 1))) || (!selfOriginated && (lsAge < (MAX_AGE - 1)))) {
             lsa->getHeader().setLsAge(lsAge + 1);
             if ((lsAge + 1) % CHECK_AGE == 0) {
@@ -659,7 +676,7 @@ void OSPF::Area::ageDatabase()
     }
 
     if (shouldRebuildRoutingTable) {
-        parentRouter->rebuildRoutingTable();
+        parentRouter->scheduleRoutingTableRebuild(false);
     }
 }
 
@@ -1349,12 +1366,8 @@ OSPF::SummaryLSA* OSPF::Area::originateSummaryLSA(const OSPF::SummaryLSA* summar
 void OSPF::Area::calculateShortestPathTree(std::vector<OSPF::RoutingTableEntry*>& newRoutingTable)
 {
     OSPF::RouterID routerID = parentRouter->getRouterID();
-    bool finished = false;
-    std::vector<OSPFLSA*> treeVertices;
-    OSPFLSA* justAddedVertex;
-    std::vector<OSPFLSA*> candidateVertices;
+    std::vector<OSPF::NextHop> newNextHops;
     unsigned long            i, j, k;
-    unsigned long lsaCount;
 
     if (spfTreeRoot == NULL) {
         OSPF::RouterLSA* newLSA = originateRouterLSA();
@@ -1371,278 +1384,87 @@ void OSPF::Area::calculateShortestPathTree(std::vector<OSPF::RoutingTableEntry*>
         return;
     }
 
-    lsaCount = routerLSAs.size();
-    for (i = 0; i < lsaCount; i++) {
-        routerLSAs[i]->clearNextHops();
-    }
-    lsaCount = networkLSAs.size();
-    for (i = 0; i < lsaCount; i++) {
-        networkLSAs[i]->clearNextHops();
+    if (!shortestPathTreeValid) {
+        buildShortestPathTree();
+    } else {
+        EV << "Shortest path tree of area " << areaID.str(false) << " is unchanged.\n";
     }
-    spfTreeRoot->setDistance(0);
-    treeVertices.push_back(spfTreeRoot);
-    justAddedVertex = spfTreeRoot;          // (1)
-
-    do {
-        LSAType vertexType = static_cast<LSAType> (justAddedVertex->getHeader().getLsType());
-
-        if ((vertexType == ROUTERLSA_TYPE)) {
-            OSPF::RouterLSA* routerVertex = check_and_cast<OSPF::RouterLSA*> (justAddedVertex);
-            if (routerVertex->getV_VirtualLinkEndpoint()) {    // (2)
-                transitCapability = true;
-            }
-
-            unsigned int linkCount = routerVertex->getLinksArraySize();
-            for (i = 0; i < linkCount; i++) {
-                Link& link = routerVertex->getLinks(i);
-                LinkType linkType = static_cast<LinkType> (link.getType());
-                OSPFLSA* joiningVertex;
-                LSAType joiningVertexType;
-
-                if (linkType == STUB_LINK) {     // (2) (a)
-                    continue;
-                }
-
-                if (linkType == TRANSIT_LINK) {
-                    joiningVertex = findNetworkLSA(link.getLinkID());
-                    joiningVertexType = NETWORKLSA_TYPE;
-                } else {
-                    joiningVertex = findRouterLSA(link.getLinkID());
-                    joiningVertexType = ROUTERLSA_TYPE;
-                }
-
-                if ((joiningVertex == NULL) ||
-                    (joiningVertex->getHeader().getLsAge() == MAX_AGE) ||
-                    (!hasLink(joiningVertex, justAddedVertex)))  // (from, to)     (2) (b)
-                {
-                    continue;
-                }
-
-                unsigned int treeSize = treeVertices.size();
-                bool alreadyOnTree = false;
 
-                for (j = 0; j < treeSize; j++) {
-                    if (treeVertices[j] == joiningVertex) {
-                        alreadyOnTree = true;
-                        break;
-                    }
-                }
-                if (alreadyOnTree) {    // (2) (c)
-                    continue;
-                }
-
-                unsigned long linkStateCost = routerVertex->getDistance() + link.getLinkCost();
-                unsigned int candidateCount = candidateVertices.size();
-                OSPFLSA* candidate = NULL;
-
-                for (j = 0; j < candidateCount; j++) {
-                    if (candidateVertices[j] == joiningVertex) {
-                        candidate = candidateVertices[j];
-                    }
-                }
-                if (candidate != NULL) {    // (2) (d)
-                    OSPF::RoutingInfo* routingInfo = check_and_cast<OSPF::RoutingInfo*> (candidate);
-                    unsigned long candidateDistance = routingInfo->getDistance();
-
-                    if (linkStateCost > candidateDistance) {
-                        continue;
-                    }
-                    if (linkStateCost < candidateDistance) {
-                        routingInfo->setDistance(linkStateCost);
-                        routingInfo->clearNextHops();
-                    }
-                    std::vector<OSPF::NextHop>* newNextHops = calculateNextHops(joiningVertex, justAddedVertex); // (destination, parent)
-                    unsigned int nextHopCount = newNextHops->size();
-                    for (k = 0; k < nextHopCount; k++) {
-                        routingInfo->addNextHop((*newNextHops)[k]);
-                    }
-                    delete newNextHops;
-                } else {
-                    if (joiningVertexType == ROUTERLSA_TYPE) {
-                        OSPF::RouterLSA* joiningRouterVertex = check_and_cast<OSPF::RouterLSA*> (joiningVertex);
-                        joiningRouterVertex->setDistance(linkStateCost);
-                        std::vector<OSPF::NextHop>* newNextHops = calculateNextHops(joiningVertex, justAddedVertex); // (destination, parent)
-                        unsigned int nextHopCount = newNextHops->size();
-                        for (k = 0; k < nextHopCount; k++) {
-                            joiningRouterVertex->addNextHop((*newNextHops)[k]);
-                        }
-                        delete newNextHops;
-                        OSPF::RoutingInfo* vertexRoutingInfo = check_and_cast<OSPF::RoutingInfo*> (joiningRouterVertex);
-                        vertexRoutingInfo->setParent(justAddedVertex);
+    // the tree is copied, because bringing up a virtual link below may rebuild the routing table recursively
+    std::vector<OSPFLSA*> treeVertices(shortestPathTree);
+    unsigned int treeSize = treeVertices.size();
 
-                        candidateVertices.push_back(joiningRouterVertex);
-                    } else {
-                        OSPF::NetworkLSA* joiningNetworkVertex = check_and_cast<OSPF::NetworkLSA*> (joiningVertex);
-                        joiningNetworkVertex->setDistance(linkStateCost);
-                        std::vector<OSPF::NextHop>* newNextHops = calculateNextHops(joiningVertex, justAddedVertex); // (destination, parent)
-                        unsigned int nextHopCount = newNextHops->size();
-                        for (k = 0; k < nextHopCount; k++) {
-                            joiningNetworkVertex->addNextHop((*newNextHops)[k]);
-                        }
-                        delete newNextHops;
-                        OSPF::RoutingInfo* vertexRoutingInfo = check_and_cast<OSPF::RoutingInfo*> (joiningNetworkVertex);
-                        vertexRoutingInfo->setParent(justAddedVertex);
+    for (j = 1; j < treeSize; j++) {
+        OSPFLSA* closestVertex = treeVertices[j];
+        OSPFLSA* justAddedVertex = treeVertices[j - 1];
 
-                        candidateVertices.push_back(joiningNetworkVertex);
-                    }
-                }
-            }
-        }
+        if (closestVertex->getHeader().getLsType() == ROUTERLSA_TYPE) {
+            OSPF::RouterLSA* routerLSA = check_and_cast<OSPF::RouterLSA*> (closestVertex);
+            if (routerLSA->getB_AreaBorderRouter() || routerLSA->getE_ASBoundaryRouter()) {
+                OSPF::RoutingTableEntry* entry = new OSPF::RoutingTableEntry;
+                OSPF::RouterID destinationID = routerLSA->getHeader().getLinkStateID();
+                unsigned int nextHopCount = routerLSA->getNextHopCount();
+                OSPF::RoutingTableEntry::RoutingDestinationType destinationType = OSPF::RoutingTableEntry::NETWORK_DESTINATION;
 
-        if ((vertexType == NETWORKLSA_TYPE)) {
-            OSPF::NetworkLSA* networkVertex = check_and_cast<OSPF::NetworkLSA*> (justAddedVertex);
-            unsigned int routerCount = networkVertex->getAttachedRoutersArraySize();
-
-            for (i = 0; i < routerCount; i++) {     // (2)
-                OSPF::RouterLSA* joiningVertex = findRouterLSA(networkVertex->getAttachedRouters(i));
-                if ((joiningVertex == NULL) ||
-                    (joiningVertex->getHeader().getLsAge() == MAX_AGE) ||
-                    (!hasLink(joiningVertex, justAddedVertex)))  // (from, to)     (2) (b)
-                {
-                    continue;
-                }
-
-                unsigned int treeSize = treeVertices.size();
-                bool alreadyOnTree = false;
-
-                for (j = 0; j < treeSize; j++) {
-                    if (treeVertices[j] == joiningVertex) {
-                        alreadyOnTree = true;
-                        break;
-                    }
-                }
-                if (alreadyOnTree) {    // (2) (c)
-                    continue;
+                entry->setDestination(destinationID);
+                entry->setLinkStateOrigin(routerLSA);
+                entry->setArea(areaID);
+                entry->setPathType(OSPF::RoutingTableEntry::INTRAAREA);
+                entry->setCost(routerLSA->getDistance());
+                if (routerLSA->getB_AreaBorderRouter()) {
+                    destinationType |= OSPF::RoutingTableEntry::AREA_BORDER_ROUTER_DESTINATION;
                 }
-
-                unsigned long linkStateCost = networkVertex->getDistance();   // link cost from network to router is always 0
-                unsigned int candidateCount = candidateVertices.size();
-                OSPFLSA* candidate = NULL;
-
-                for (j = 0; j < candidateCount; j++) {
-                    if (candidateVertices[j] == joiningVertex) {
-                        candidate = candidateVertices[j];
-                    }
+                if (routerLSA->getE_ASBoundaryRouter()) {
+                    destinationType |= OSPF::RoutingTableEntry::AS_BOUNDARY_ROUTER_DESTINATION;
                 }
-                if (candidate != NULL) {    // (2) (d)
-                    OSPF::RoutingInfo* routingInfo = check_and_cast<OSPF::RoutingInfo*> (candidate);
-                    unsigned long candidateDistance = routingInfo->getDistance();
-
-                    if (linkStateCost > candidateDistance) {
-                        continue;
-                    }
-                    if (linkStateCost < candidateDistance) {
-                        routingInfo->setDistance(linkStateCost);
-                        routingInfo->clearNextHops();
-                    }
-                    std::vector<OSPF::NextHop>* newNextHops = calculateNextHops(joiningVertex, justAddedVertex); // (destination, parent)
-                    unsigned int nextHopCount = newNextHops->size();
-                    for (k = 0; k < nextHopCount; k++) {
-                        routingInfo->addNextHop((*newNextHops)[k]);
-                    }
-                    delete newNextHops;
-                } else {
-                    joiningVertex->setDistance(linkStateCost);
-                    std::vector<OSPF::NextHop>* newNextHops = calculateNextHops(joiningVertex, justAddedVertex); // (destination, parent)
-                    unsigned int nextHopCount = newNextHops->size();
-                    for (k = 0; k < nextHopCount; k++) {
-                        joiningVertex->addNextHop((*newNextHops)[k]);
-                    }
-                    delete newNextHops;
-                    OSPF::RoutingInfo* vertexRoutingInfo = check_and_cast<OSPF::RoutingInfo*> (joiningVertex);
-                    vertexRoutingInfo->setParent(justAddedVertex);
-
-                    candidateVertices.push_back(joiningVertex);
+                entry->setDestinationType(destinationType);
+                entry->setOptionalCapabilities(routerLSA->getHeader().getLsOptions());
+                for (i = 0; i < nextHopCount; i++) {
+                    entry->addNextHop(routerLSA->getNextHop(i));
                 }
-            }
-        }
 
-        if (candidateVertices.empty()) {  // (3)
-            finished = true;
-        } else {
-            unsigned int candidateCount = candidateVertices.size();
-            unsigned long minDistance = LS_INFINITY;
-            OSPFLSA* closestVertex = candidateVertices[0];
-
-            for (i = 0; i < candidateCount; i++) {
-                OSPF::RoutingInfo* routingInfo = check_and_cast<OSPF::RoutingInfo*> (candidateVertices[i]);
-                unsigned long currentDistance = routingInfo->getDistance();
+                newRoutingTable.push_back(entry);
 
-                if (currentDistance < minDistance) {
-                    closestVertex = candidateVertices[i];
-                    minDistance = currentDistance;
+                OSPF::Area* backbone;
+                if (areaID != OSPF::BACKBONE_AREAID) {
+                    backbone = parentRouter->getAreaByID(OSPF::BACKBONE_AREAID);
                 } else {
-                    if (currentDistance == minDistance) {
-                        if ((closestVertex->getHeader().getLsType() == ROUTERLSA_TYPE) &&
-                            (candidateVertices[i]->getHeader().getLsType() == NETWORKLSA_TYPE))
-                        {
-                            closestVertex = candidateVertices[i];
-                        }
-                    }
-                }
-            }
-
-            treeVertices.push_back(closestVertex);
-
-            for (std::vector<OSPFLSA*>::iterator it = candidateVertices.begin(); it != candidateVertices.end(); it++) {
-                if ((*it) == closestVertex) {
-                    candidateVertices.erase(it);
-                    break;
+                    backbone = this;
                 }
-            }
-
-            if (closestVertex->getHeader().getLsType() == ROUTERLSA_TYPE) {
-                OSPF::RouterLSA* routerLSA = check_and_cast<OSPF::RouterLSA*> (closestVertex);
-                if (routerLSA->getB_AreaBorderRouter() || routerLSA->getE_ASBoundaryRouter()) {
-                    OSPF::RoutingTableEntry* entry = new OSPF::RoutingTableEntry;
-                    OSPF::RouterID destinationID = routerLSA->getHeader().getLinkStateID();
-                    unsigned int nextHopCount = routerLSA->getNextHopCount();
-                    OSPF::RoutingTableEntry::RoutingDestinationType destinationType = OSPF::RoutingTableEntry::NETWORK_DESTINATION;
-
-                    entry->setDestination(destinationID);
-                    entry->setLinkStateOrigin(routerLSA);
-                    entry->setArea(areaID);
-                    entry->setPathType(OSPF::RoutingTableEntry::INTRAAREA);
-                    entry->setCost(routerLSA->getDistance());
-                    if (routerLSA->getB_AreaBorderRouter()) {
-                        destinationType |= OSPF::RoutingTableEntry::AREA_BORDER_ROUTER_DESTINATION;
-                    }
-                    if (routerLSA->getE_ASBoundaryRouter()) {
-                        destinationType |= OSPF::RoutingTableEntry::AS_BOUNDARY_ROUTER_DESTINATION;
-                    }
-                    entry->setDestinationType(destinationType);
-                    entry->setOptionalCapabilities(routerLSA->getHeader().getLsOptions());
-                    for (i = 0; i < nextHopCount; i++) {
-                        entry->addNextHop(routerLSA->getNextHop(i));
-                    }
-
-                    newRoutingTable.push_back(entry);
-
-                    OSPF::Area* backbone;
-                    if (areaID != OSPF::BACKBONE_AREAID) {
-                        backbone = parentRouter->getAreaByID(OSPF::BACKBONE_AREAID);
-                    } else {
-                        backbone = this;
-                    }
-                    if (backbone != NULL) {
-                        OSPF::Interface* virtualIntf = backbone->findVirtualLink(destinationID);
-                        if ((virtualIntf != NULL) && (virtualIntf->getTransitAreaID() == areaID)) {
-                            OSPF::IPv4AddressRange range;
-                            range.address = getInterface(routerLSA->getNextHop(0).ifIndex)->getAddressRange().address;
-                            range.mask = IPv4Address::ALLONES_ADDRESS;
-                            virtualIntf->setAddressRange(range);
-                            virtualIntf->setIfIndex(routerLSA->getNextHop(0).ifIndex);
-                            virtualIntf->setOutputCost(routerLSA->getDistance());
-                            OSPF::Neighbor* virtualNeighbor = virtualIntf->getNeighbor(0);
-                            if (virtualNeighbor != NULL) {
-                                unsigned int linkCount = routerLSA->getLinksArraySize();
-                                OSPF::RouterLSA* toRouterLSA = dynamic_cast<OSPF::RouterLSA*> (justAddedVertex);
-                                if (toRouterLSA != NULL) {
+                if (backbone != NULL) {
+                    OSPF::Interface* virtualIntf = backbone->findVirtualLink(destinationID);
+                    if ((virtualIntf != NULL) && (virtualIntf->getTransitAreaID() == areaID)) {
+                        OSPF::IPv4AddressRange range;
+                        range.address = getInterface(routerLSA->getNextHop(0).ifIndex)->getAddressRange().address;
+                        range.mask = IPv4Address::ALLONES_ADDRESS;
+                        virtualIntf->setAddressRange(range);
+                        virtualIntf->setIfIndex(routerLSA->getNextHop(0).ifIndex);
+                        virtualIntf->setOutputCost(routerLSA->getDistance());
+                        OSPF::Neighbor* virtualNeighbor = virtualIntf->getNeighbor(0);
+                        if (virtualNeighbor != NULL) {
+                            unsigned int linkCount = routerLSA->getLinksArraySize();
+                            OSPF::RouterLSA* toRouterLSA = dynamic_cast<OSPF::RouterLSA*> (justAddedVertex);
+                            if (toRouterLSA != NULL) {
+                                for (i = 0; i < linkCount; i++) {
+                                    Link& link = routerLSA->getLinks(i);
+
+                                    if ((link.getType() == POINTTOPOINT_LINK) &&
+                                        (link.getLinkID() == toRouterLSA->getHeader().getLinkStateID()) &&
+                                        (virtualIntf->getState() < OSPF::Interface::WAITING_STATE))
+                                    {
+                                        virtualNeighbor->setAddress(IPv4Address(link.getLinkData()));
+                                        virtualIntf->processEvent(OSPF::Interface::INTERFACE_UP);
+                                        break;
+                                    }
+                                }
+                            } else {
+                                OSPF::NetworkLSA* toNetworkLSA = dynamic_cast<OSPF::NetworkLSA*> (justAddedVertex);
+                                if (toNetworkLSA != NULL) {
                                     for (i = 0; i < linkCount; i++) {
                                         Link& link = routerLSA->getLinks(i);
 
-                                        if ((link.getType() == POINTTOPOINT_LINK) &&
-                                            (link.getLinkID() == toRouterLSA->getHeader().getLinkStateID()) &&
+                                        if ((link.getType() == TRANSIT_LINK) &&
+                                            (link.getLinkID() == toNetworkLSA->getHeader().getLinkStateID()) &&
                                             (virtualIntf->getState() < OSPF::Interface::WAITING_STATE))
                                         {
                                             virtualNeighbor->setAddress(IPv4Address(link.getLinkData()));
@@ -1650,89 +1472,70 @@ void OSPF::Area::calculateShortestPathTree(std::vector<OSPF::RoutingTableEntry*>
                                             break;
                                         }
                                     }
-                                } else {
-                                    OSPF::NetworkLSA* toNetworkLSA = dynamic_cast<OSPF::NetworkLSA*> (justAddedVertex);
-                                    if (toNetworkLSA != NULL) {
-                                        for (i = 0; i < linkCount; i++) {
-                                            Link& link = routerLSA->getLinks(i);
-
-                                            if ((link.getType() == TRANSIT_LINK) &&
-                                                (link.getLinkID() == toNetworkLSA->getHeader().getLinkStateID()) &&
-                                                (virtualIntf->getState() < OSPF::Interface::WAITING_STATE))
-                                            {
-                                                virtualNeighbor->setAddress(IPv4Address(link.getLinkData()));
-                                                virtualIntf->processEvent(OSPF::Interface::INTERFACE_UP);
-                                                break;
-                                            }
-                                        }
-                                    }
                                 }
                             }
                         }
                     }
                 }
             }
+        }
 
-            if (closestVertex->getHeader().getLsType() == NETWORKLSA_TYPE) {
-                OSPF::NetworkLSA* networkLSA = check_and_cast<OSPF::NetworkLSA*> (closestVertex);
-                IPv4Address destinationID = (networkLSA->getHeader().getLinkStateID() & networkLSA->getNetworkMask());
-                unsigned int nextHopCount = networkLSA->getNextHopCount();
-                bool overWrite = false;
-                OSPF::RoutingTableEntry* entry = NULL;
-                unsigned long routeCount = newRoutingTable.size();
-                IPv4Address longestMatch(0u);
-
-                for (i = 0; i < routeCount; i++) {
-                    if (newRoutingTable[i]->getDestinationType() == OSPF::RoutingTableEntry::NETWORK_DESTINATION) {
-                        OSPF::RoutingTableEntry* routingEntry = newRoutingTable[i];
-                        IPv4Address entryAddress = routingEntry->getDestination();
-                        IPv4Address entryMask = routingEntry->getNetmask();
-
-                        if ((entryAddress & entryMask) == (destinationID & entryMask)) {
-                            if ((destinationID & entryMask) > longestMatch) {
-                                longestMatch = (destinationID & entryMask);
-                                entry = routingEntry;
-                            }
+        if (closestVertex->getHeader().getLsType() == NETWORKLSA_TYPE) {
+            OSPF::NetworkLSA* networkLSA = check_and_cast<OSPF::NetworkLSA*> (closestVertex);
+            IPv4Address destinationID = (networkLSA->getHeader().getLinkStateID() & networkLSA->getNetworkMask());
+            unsigned int nextHopCount = networkLSA->getNextHopCount();
+            bool overWrite = false;
+            OSPF::RoutingTableEntry* entry = NULL;
+            unsigned long routeCount = newRoutingTable.size();
+            IPv4Address longestMatch(0u);
+
+            for (i = 0; i < routeCount; i++) {
+                if (newRoutingTable[i]->getDestinationType() == OSPF::RoutingTableEntry::NETWORK_DESTINATION) {
+                    OSPF::RoutingTableEntry* routingEntry = newRoutingTable[i];
+                    IPv4Address entryAddress = routingEntry->getDestination();
+                    IPv4Address entryMask = routingEntry->getNetmask();
+
+                    if ((entryAddress & entryMask) == (destinationID & entryMask)) {
+                        if ((destinationID & entryMask) > longestMatch) {
+                            longestMatch = (destinationID & entryMask);
+                            entry = routingEntry;
                         }
                     }
                 }
-                if (entry != NULL) {
-                    const OSPFLSA* entryOrigin = entry->getLinkStateOrigin();
-                    if ((entry->getCost() != networkLSA->getDistance()) ||
-                        (entryOrigin->getHeader().getLinkStateID() >= networkLSA->getHeader().getLinkStateID()))
-                    {
-                        overWrite = true;
-                    }
+            }
+            if (entry != NULL) {
+                const OSPFLSA* entryOrigin = entry->getLinkStateOrigin();
+                if ((entry->getCost() != networkLSA->getDistance()) ||
+                    (entryOrigin->getHeader().getLinkStateID() >= networkLSA->getHeader().getLinkStateID()))
+                {
+                    overWrite = true;
                 }
+            }
 
-                if ((entry == NULL) || (overWrite)) {
-                    if (entry == NULL) {
-                        entry = new OSPF::RoutingTableEntry;
-                    }
+            if ((entry == NULL) || (overWrite)) {
+                if (entry == NULL) {
+                    entry = new OSPF::RoutingTableEntry;
+                }
 
-                    entry->setDestination(IPv4Address(destinationID));
-                    entry->setNetmask(networkLSA->getNetworkMask());
-                    entry->setLinkStateOrigin(networkLSA);
-                    entry->setArea(areaID);
-                    entry->setPathType(OSPF::RoutingTableEntry::INTRAAREA);
-                    entry->setCost(networkLSA->getDistance());
-                    entry->setDestinationType(OSPF::RoutingTableEntry::NETWORK_DESTINATION);
-                    entry->setOptionalCapabilities(networkLSA->getHeader().getLsOptions());
-                    for (i = 0; i < nextHopCount; i++) {
-                        entry->addNextHop(networkLSA->getNextHop(i));
-                    }
+                entry->setDestination(IPv4Address(destinationID));
+                entry->setNetmask(networkLSA->getNetworkMask());
+                entry->setLinkStateOrigin(networkLSA);
+                entry->setArea(areaID);
+                entry->setPathType(OSPF::RoutingTableEntry::INTRAAREA);
+                entry->setCost(networkLSA->getDistance());
+                entry->setDestinationType(OSPF::RoutingTableEntry::NETWORK_DESTINATION);
+                entry->setOptionalCapabilities(networkLSA->getHeader().getLsOptions());
+                for (i = 0; i < nextHopCount; i++) {
+                    entry->addNextHop(networkLSA->getNextHop(i));
+                }
 
-                    if (!overWrite) {
-                        newRoutingTable.push_back(entry);
-                    }
+                if (!overWrite) {
+                    newRoutingTable.push_back(entry);
                 }
             }
-
-            justAddedVertex = closestVertex;
         }
-    } while (!finished);
+    }
 
-    unsigned int treeSize = treeVertices.size();
     for (i = 0; i < treeSize; i++) {
         OSPF::RouterLSA* routerVertex = dynamic_cast<OSPF::RouterLSA*> (treeVertices[i]);
         if (routerVertex == NULL) {
@@ -1793,12 +1596,11 @@ void OSPF::Area::calculateShortestPathTree(std::vector<OSPF::RoutingTableEntry*>
                         throw cRuntimeError("Can not cast class '%s' to OSPF::RouterLSA or OSPF::NetworkLSA", lsOrigin->getClassName());
                     }
                 }
-                std::vector<OSPF::NextHop>* newNextHops = calculateNextHops(link, routerVertex); // (destination, parent)
-                unsigned int nextHopCount = newNextHops->size();
+                calculateNextHops(link, routerVertex, newNextHops); // (destination, parent)
+                unsigned int nextHopCount = newNextHops.size();
                 for (k = 0; k < nextHopCount; k++) {
-                    entry->addNextHop((*newNextHops)[k]);
+                    entry->addNextHop(newNextHops[k]);
                 }
-                delete newNextHops;
             } else {
                 //FIXME remove
                 //if(parentRouter->getRouterID() == 0xC0A80302) {
@@ -1814,12 +1616,11 @@ void OSPF::Area::calculateShortestPathTree(std::vector<OSPF::RoutingTableEntry*>
                 entry->setCost(distance);
                 entry->setDestinationType(OSPF::RoutingTableEntry::NETWORK_DESTINATION);
                 entry->setOptionalCapabilities(routerVertex->getHeader().getLsOptions());
-                std::vector<OSPF::NextHop>* newNextHops = calculateNextHops(link, routerVertex); // (destination, parent)
-                unsigned int nextHopCount = newNextHops->size();
+                calculateNextHops(link, routerVertex, newNextHops); // (destination, parent)
+                unsigned int nextHopCount = newNextHops.size();
                 for (k = 0; k < nextHopCount; k++) {
-                    entry->addNextHop((*newNextHops)[k]);
+                    entry->addNextHop(newNextHops[k]);
                 }
-                delete newNextHops;
 
                 newRoutingTable.push_back(entry);
             }
@@ -1827,9 +1628,164 @@ void OSPF::Area::calculateShortestPathTree(std::vector<OSPF::RoutingTableEntry*>
     }
 }
 
-std::vector<OSPF::NextHop>* OSPF::Area::calculateNextHops(OSPFLSA* destination, OSPFLSA* parent) const
+
+void OSPF::Area::buildShortestPathTree()
 {
-    std::vector<OSPF::NextHop>* hops = new std::vector<OSPF::NextHop>;
+    SPFCandidateQueue candidateVertices;
+    unsigned long candidateCount = 0;
+    std::vector<OSPF::NextHop> nextHops;
+    OSPFLSA* justAddedVertex;
+    unsigned long i;
+    unsigned long lsaCount;
+
+    lsaCount = routerLSAs.size();
+    for (i = 0; i < lsaCount; i++) {
+        routerLSAs[i]->clearNextHops();
+        routerLSAs[i]->setSPFState(OSPF::RoutingInfo::SPF_UNVISITED);
+    }
+    lsaCount = networkLSAs.size();
+    for (i = 0; i < lsaCount; i++) {
+        networkLSAs[i]->clearNextHops();
+        networkLSAs[i]->setSPFState(OSPF::RoutingInfo::SPF_UNVISITED);
+    }
+    shortestPathTree.clear();
+    spfTreeRoot->setDistance(0);
+    spfTreeRoot->setSPFState(OSPF::RoutingInfo::SPF_ON_TREE);
+    shortestPathTree.push_back(spfTreeRoot);
+    justAddedVertex = spfTreeRoot;          // (1)
+
+    while (true) {
+        LSAType vertexType = static_cast<LSAType> (justAddedVertex->getHeader().getLsType());
+
+        if ((vertexType == ROUTERLSA_TYPE)) {
+            OSPF::RouterLSA* routerVertex = check_and_cast<OSPF::RouterLSA*> (justAddedVertex);
+            if (routerVertex->getV_VirtualLinkEndpoint()) {    // (2)
+                transitCapability = true;
+            }
+
+            unsigned int linkCount = routerVertex->getLinksArraySize();
+            for (i = 0; i < linkCount; i++) {
+                Link& link = routerVertex->getLinks(i);
+                LinkType linkType = static_cast<LinkType> (link.getType());
+                OSPFLSA* joiningVertex;
+
+                if (linkType == STUB_LINK) {     // (2) (a)
+                    continue;
+                }
+
+                if (linkType == TRANSIT_LINK) {
+                    joiningVertex = findNetworkLSA(link.getLinkID());
+                } else {
+                    joiningVertex = findRouterLSA(link.getLinkID());
+                }
+
+                if ((joiningVertex == NULL) ||
+                    (joiningVertex->getHeader().getLsAge() == MAX_AGE) ||
+                    (!hasLink(joiningVertex, justAddedVertex)))  // (from, to)     (2) (b)
+                {
+                    continue;
+                }
+
+                unsigned long linkStateCost = routerVertex->getDistance() + link.getLinkCost();
+                examineSPFCandidate(joiningVertex, justAddedVertex, linkStateCost, candidateVertices, candidateCount, nextHops);
+            }
+        }
+
+        if ((vertexType == NETWORKLSA_TYPE)) {
+            OSPF::NetworkLSA* networkVertex = check_and_cast<OSPF::NetworkLSA*> (justAddedVertex);
+            unsigned int routerCount = networkVertex->getAttachedRoutersArraySize();
+
+            for (i = 0; i < routerCount; i++) {     // (2)
+                OSPF::RouterLSA* joiningVertex = findRouterLSA(networkVertex->getAttachedRouters(i));
+                if ((joiningVertex == NULL) ||
+                    (joiningVertex->getHeader().getLsAge() == MAX_AGE) ||
+                    (!hasLink(joiningVertex, justAddedVertex)))  // (from, to)     (2) (b)
+                {
+                    continue;
+                }
+
+                unsigned long linkStateCost = networkVertex->getDistance();   // link cost from network to router is always 0
+                examineSPFCandidate(joiningVertex, justAddedVertex, linkStateCost, candidateVertices, candidateCount, nextHops);
+            }
+        }
+
+        // (3) queue entries left behind by a decreased candidate distance are skipped
+        OSPFLSA* closestVertex = NULL;
+        while ((closestVertex == NULL) && !candidateVertices.empty()) {
+            const SPFCandidate& candidate = candidateVertices.top();
+            OSPF::RoutingInfo* routingInfo = check_and_cast<OSPF::RoutingInfo*> (candidate.vertex);
+            if ((routingInfo->getSPFState() == OSPF::RoutingInfo::SPF_CANDIDATE) &&
+                (routingInfo->getDistance() == candidate.distance))
+            {
+                routingInfo->setSPFState(OSPF::RoutingInfo::SPF_ON_TREE);
+                closestVertex = candidate.vertex;
+            }
+            candidateVertices.pop();
+        }
+        if (closestVertex == NULL) {
+            break;
+        }
+
+        shortestPathTree.push_back(closestVertex);
+        justAddedVertex = closestVertex;
+    }
+
+    shortestPathTreeValid = true;
+}
+
+void OSPF::Area::examineSPFCandidate(OSPFLSA* joiningVertex, OSPFLSA* parentVertex, unsigned long linkStateCost,
+                                     SPFCandidateQueue& candidateVertices, unsigned long& candidateCount,
+                                     std::vector<OSPF::NextHop>& nextHops)
+{
+    OSPF::RoutingInfo* routingInfo = check_and_cast<OSPF::RoutingInfo*> (joiningVertex);
+    OSPF::RoutingInfo::SPFState spfState = routingInfo->getSPFState();
+
+    if (spfState == OSPF::RoutingInfo::SPF_ON_TREE) {    // (2) (c)
+        return;
+    }
+
+    if (spfState == OSPF::RoutingInfo::SPF_CANDIDATE) {    // (2) (d)
+        unsigned long candidateDistance = routingInfo->getDistance();
+
+        if (linkStateCost > candidateDistance) {
+            return;
+        }
+        if (linkStateCost < candidateDistance) {
+            routingInfo->setDistance(linkStateCost);
+            routingInfo->clearNextHops();
+
+            SPFCandidate candidate;
+            candidate.distance = linkStateCost;
+            candidate.routerVertex = (joiningVertex->getHeader().getLsType() == ROUTERLSA_TYPE);
+            candidate.order = routingInfo->getCandidateOrder();
+            candidate.vertex = joiningVertex;
+            candidateVertices.push(candidate);
+        }
+    } else {
+        routingInfo->setDistance(linkStateCost);
+        routingInfo->setParent(parentVertex);
+        routingInfo->setSPFState(OSPF::RoutingInfo::SPF_CANDIDATE);
+        routingInfo->setCandidateOrder(candidateCount++);
+
+        SPFCandidate candidate;
+        candidate.distance = linkStateCost;
+        candidate.routerVertex = (joiningVertex->getHeader().getLsType() == ROUTERLSA_TYPE);
+        candidate.order = routingInfo->getCandidateOrder();
+        candidate.vertex = joiningVertex;
+        candidateVertices.push(candidate);
+    }
+
+    calculateNextHops(joiningVertex, parentVertex, nextHops); // (destination, parent)
+    unsigned int nextHopCount = nextHops.size();
+    for (unsigned int i = 0; i < nextHopCount; i++) {
+        routingInfo->addNextHop(nextHops[i]);
+    }
+}
+
+
+void OSPF::Area::calculateNextHops(OSPFLSA* destination, OSPFLSA* parent, std::vector<OSPF::NextHop>& hops) const
+{
+    hops.clear();
     unsigned long               i, j;
 
     OSPF::RouterLSA* routerLSA = dynamic_cast<OSPF::RouterLSA*> (parent);
@@ -1837,9 +1793,9 @@ std::vector<OSPF::NextHop>* OSPF::Area::calculateNextHops(OSPFLSA* destination,
         if (routerLSA != spfTreeRoot) {
             unsigned int nextHopCount = routerLSA->getNextHopCount();
             for (i = 0; i < nextHopCount; i++) {
-                hops->push_back(routerLSA->getNextHop(i));
+                hops.push_back(routerLSA->getNextHop(i));
             }
-            return hops;
+            return;
         } else {
             OSPF::RouterLSA* destinationRouterLSA = dynamic_cast<OSPF::RouterLSA*> (destination);
             if (destinationRouterLSA != NULL) {
@@ -1857,7 +1813,7 @@ std::vector<OSPF::NextHop>* OSPF::Area::calculateNextHops(OSPFLSA* destination,
                                 nextHop.ifIndex = associatedInterfaces[i]->getIfIndex();
                                 nextHop.hopAddress = ptpNeighbor->getAddress();
                                 nextHop.advertisingRouter = destinationRouterLSA->getHeader().getAdvertisingRouter();
-                                hops->push_back(nextHop);
+                                hops.push_back(nextHop);
                                 break;
                             }
                         }
@@ -1874,7 +1830,7 @@ std::vector<OSPF::NextHop>* OSPF::Area::calculateNextHops(OSPFLSA* destination,
                                     nextHop.ifIndex = associatedInterfaces[i]->getIfIndex();
                                     nextHop.hopAddress = IPv4Address(link.getLinkData());
                                     nextHop.advertisingRouter = destinationRouterLSA->getHeader().getAdvertisingRouter();
-                                    hops->push_back(nextHop);
+                                    hops.push_back(nextHop);
                                 }
                             }
                             break;
@@ -1899,7 +1855,7 @@ std::vector<OSPF::NextHop>* OSPF::Area::calculateNextHops(OSPFLSA* destination,
                             //nextHop.hopAddress = (range.address & range.mask); //TODO revise it!
                             nextHop.hopAddress = IPv4Address::UNSPECIFIED_ADDRESS; //TODO revise it!
                             nextHop.advertisingRouter = destinationNetworkLSA->getHeader().getAdvertisingRouter();
-                            hops->push_back(nextHop);
+                            hops.push_back(nextHop);
                         }
                     }
                 }
@@ -1911,9 +1867,9 @@ std::vector<OSPF::NextHop>* OSPF::Area::calculateNextHops(OSPFLSA* destination,
             if (networkLSA->getParent() != spfTreeRoot) {
                 unsigned int nextHopCount = networkLSA->getNextHopCount();
                 for (i = 0; i < nextHopCount; i++) {
-                    hops->push_back(networkLSA->getNextHop(i));
+                    hops.push_back(networkLSA->getNextHop(i));
                 }
-                return hops;
+                return;
             } else {
                 IPv4Address parentLinkStateID = parent->getHeader().getLinkStateID();
 
@@ -1942,7 +1898,7 @@ std::vector<OSPF::NextHop>* OSPF::Area::calculateNextHops(OSPFLSA* destination,
                                         nextHop.ifIndex = associatedInterfaces[j]->getIfIndex();
                                         nextHop.hopAddress = nextHopNeighbor->getAddress();
                                         nextHop.advertisingRouter = destinationRouterLSA->getHeader().getAdvertisingRouter();
-                                        hops->push_back(nextHop);
+                                        hops.push_back(nextHop);
                                     }
                                 }
                             }
@@ -1953,21 +1909,20 @@ std::vector<OSPF::NextHop>* OSPF::Area::calculateNextHops(OSPFLSA* destination,
         }
     }
 
-    return hops;
 }
 
-std::vector<OSPF::NextHop>* OSPF::Area::calculateNextHops(Link& destination, OSPFLSA* parent) const
+void OSPF::Area::calculateNextHops(Link& destination, OSPFLSA* parent, std::vector<OSPF::NextHop>& hops) const
 {
-    std::vector<OSPF::NextHop>* hops = new std::vector<OSPF::NextHop>;
+    hops.clear();
     unsigned long i;
 
     OSPF::RouterLSA* routerLSA = check_and_cast<OSPF::RouterLSA*> (parent);
     if (routerLSA != spfTreeRoot) {
         unsigned int nextHopCount = routerLSA->getNextHopCount();
         for (i = 0; i < nextHopCount; i++) {
-            hops->push_back(routerLSA->getNextHop(i));
+            hops.push_back(routerLSA->getNextHop(i));
         }
-        return hops;
+        return;
     } else {
         unsigned long interfaceNum = associatedInterfaces.size();
         for (i = 0; i < interfaceNum; i++) {
@@ -1991,7 +1946,7 @@ std::vector<OSPF::NextHop>* OSPF::Area::calculateNextHops(Link& destination, OSP
                         nextHop.ifIndex = interface->getIfIndex();
                         nextHop.hopAddress = neighborAddress;
                         nextHop.advertisingRouter = parentRouter->getRouterID();
-                        hops->push_back(nextHop);
+                        hops.push_back(nextHop);
                         break;
                     }
                 }
@@ -2006,7 +1961,7 @@ std::vector<OSPF::NextHop>* OSPF::Area::calculateNextHops(Link& destination, OSP
                     // TODO: this has been commented because the linkID is not a real IP address in this case and we don't know the next hop address here, verify
                     // nextHop.hopAddress = destination.getLinkID();
                     nextHop.advertisingRouter = parentRouter->getRouterID();
-                    hops->push_back(nextHop);
+                    hops.push_back(nextHop);
                     break;
                 }
             }
@@ -2021,7 +1976,7 @@ std::vector<OSPF::NextHop>* OSPF::Area::calculateNextHops(Link& destination, OSP
                         nextHop.ifIndex = interface->getIfIndex();
                         nextHop.hopAddress = interface->getAddressRange().address;
                         nextHop.advertisingRouter = parentRouter->getRouterID();
-                        hops->push_back(nextHop);
+                        hops.push_back(nextHop);
                         break;
                     }
                 }
@@ -2032,7 +1987,7 @@ std::vector<OSPF::NextHop>* OSPF::Area::calculateNextHops(Link& destination, OSP
                         nextHop.ifIndex = interface->getIfIndex();
                         nextHop.hopAddress = neighbor->getAddress();
                         nextHop.advertisingRouter = parentRouter->getRouterID();
-                        hops->push_back(nextHop);
+                        hops.push_back(nextHop);
                         break;
                     }
                 }
@@ -2040,7 +1995,7 @@ std::vector<OSPF::NextHop>* OSPF::Area::calculateNextHops(Link& destination, OSP
             // next hops for virtual links are generated later, after examining transit areas' SummaryLSAs
         }
 
-        if (hops->size() == 0) {
+        if (hops.empty()) {
             unsigned long hostRouteCount = hostRoutes.size();
             for (i = 0; i < hostRouteCount; i++) {
                 if ((destination.getLinkID() == hostRoutes[i].address) &&
@@ -2050,14 +2005,13 @@ std::vector<OSPF::NextHop>* OSPF::Area::calculateNextHops(Link& destination, OSP
                     nextHop.ifIndex = hostRoutes[i].ifIndex;
                     nextHop.hopAddress = hostRoutes[i].address;
                     nextHop.advertisingRouter = parentRouter->getRouterID();
-                    hops->push_back(nextHop);
+                    hops.push_back(nextHop);
                     break;
                 }
             }
         }
     }
 
-    return hops;
 }
 
 bool OSPF::Area::hasLink(OSPFLSA* fromLSA, OSPFLSA* toLSA) const
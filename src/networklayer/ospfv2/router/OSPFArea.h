@@ -20,6 +20,8 @@
 
 #include <vector>
 #include <map>
+#include <functional>
+#include <queue>
 
 #include "LSA.h"
 #include "OSPFcommon.h"
@@ -48,6 +50,8 @@ private:
     bool                                                    externalRoutingCapability;
     Metric                                                  stubDefaultCost;
     RouterLSA*                                              spfTreeRoot;
+    std::vector<OSPFLSA*>                                   shortestPathTree;   // vertices in the order they were added to the tree
+    bool                                                    shortestPathTreeValid;
 
     Router*                                                 parentRouter;
 public:
@@ -113,6 +117,20 @@ public:
     SummaryLSA*       originateSummaryLSA(const RoutingTableEntry* entry,
                                           const std::map<LSAKeyType, bool, LSAKeyType_Less>& originatedLSAs,
                                           SummaryLSA*& lsaToReoriginate);
+    /**
+     * Marks the shortest path tree of the area out of date, so that the next
+     * calculateShortestPathTree() call runs the Dijkstra algorithm again.
+     * Must be called whenever a router or network LSA, or the state of an
+     * interface or neighbor of the area changes.
+     */
+    void              invalidateShortestPathTree()  { shortestPathTreeValid = false; }
+    bool              isShortestPathTreeValid() const  { return shortestPathTreeValid; }
+
+    /**
+     * Adds the intra-area routes to newRoutingTable. The shortest path tree
+     * is only recalculated if it was invalidated since the last call.
+     * @sa RFC2328 Section 16.1.
+     */
     void              calculateShortestPathTree(std::vector<RoutingTableEntry*>& newRoutingTable);
     void              calculateInterAreaRoutes(std::vector<RoutingTableEntry*>& newRoutingTable);
     void              recheckSummaryLSAs(std::vector<RoutingTableEntry*>& newRoutingTable);
@@ -121,10 +139,35 @@ public:
     std::string       detailedInfo() const;
 
 private:
+    /**
+     * Entry of the SPF candidate list. Ordered by distance; at equal distance
+     * network vertices come before router vertices, then the vertex that
+     * became a candidate first (RFC2328 Section 16.1 step 3).
+     */
+    struct SPFCandidate {
+        unsigned long distance;
+        bool          routerVertex;
+        unsigned long order;
+        OSPFLSA*      vertex;
+
+        bool operator>(const SPFCandidate& other) const {
+            if (distance != other.distance)
+                return distance > other.distance;
+            if (routerVertex != other.routerVertex)
+                return routerVertex;
+            return order > other.order;
+        }
+    };
+    typedef std::priority_queue<SPFCandidate, std::vector<SPFCandidate>, std::greater<SPFCandidate> > SPFCandidateQueue;
+
     SummaryLSA*           originateSummaryLSA(const OSPF::SummaryLSA* summaryLSA);
     bool                  hasLink(OSPFLSA* fromLSA, OSPFLSA* toLSA) const;
-    std::vector<NextHop>* calculateNextHops(OSPFLSA* destination, OSPFLSA* parent) const;
-    std::vector<NextHop>* calculateNextHops(Link& destination, OSPFLSA* parent) const;
+    void                  calculateNextHops(OSPFLSA* destination, OSPFLSA* parent, std::vector<NextHop>& hops) const;
+    void                  calculateNextHops(Link& destination, OSPFLSA* parent, std::vector<NextHop>& hops) const;
+    void                  buildShortestPathTree();
+    void                  examineSPFCandidate(OSPFLSA* joiningVertex, OSPFLSA* parentVertex, unsigned long linkStateCost,
+                                              SPFCandidateQueue& candidates, unsigned long& candidateCount,
+                                              std::vector<NextHop>& nextHops);
 
     LinkStateID           getUniqueLinkStateID(IPv4AddressRange destination,
                                                Metric destinationCost,
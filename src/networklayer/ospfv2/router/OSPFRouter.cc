@@ -23,7 +23,18 @@
 
 OSPF::Router::Router(OSPF::RouterID id, cSimpleModule* containingModule) :
     routerID(id),
-    rfc1583Compatibility(false)
+    rfc1583Compatibility(false),
+    spfInitialDelay(0),
+    spfHoldTime(0),
+    spfMaxHoldTime(0),
+    spfCurrentHoldTime(0),
+    lastSPFRun(0),
+    spfRecalculateAllAreas(false),
+    lsaPacingInterval(0),
+    spfRequestCount(0),
+    spfRunCount(0),
+    floodedUpdatePacketCount(0),
+    floodedLSACount(0)
 {
     messageHandler = new OSPF::MessageHandler(this, containingModule);
     ageTimer = new cMessage();
@@ -31,6 +42,10 @@ OSPF::Router::Router(OSPF::RouterID id, cSimpleModule* containingModule) :
     ageTimer->setContextPointer(this);
     ageTimer->setName("OSPF::Router::DatabaseAgeTimer");
     messageHandler->startTimer(ageTimer, 1.0);
+    spfTimer = new cMessage();
+    spfTimer->setKind(SPF_TIMER);
+    spfTimer->setContextPointer(this);
+    spfTimer->setName("OSPF::Router::SPFTimer");
 }
 
 
@@ -50,6 +65,8 @@ OSPF::Router::~Router()
     }
     messageHandler->clearTimer(ageTimer);
     delete ageTimer;
+    messageHandler->clearTimer(spfTimer);
+    delete spfTimer;
     delete messageHandler;
 }
 
@@ -60,6 +77,22 @@ void OSPF::Router::addWatches()
     WATCH_PTRVECTOR(areas);
     WATCH_PTRVECTOR(asExternalLSAs);
     WATCH_PTRVECTOR(routingTable);
+    WATCH(spfRequestCount);
+    WATCH(spfRunCount);
+    WATCH(spfCurrentHoldTime);
+    WATCH(floodedUpdatePacketCount);
+    WATCH(floodedLSACount);
+}
+
+void OSPF::Router::setSPFThrottling(simtime_t initialDelay, simtime_t holdTime, simtime_t maxHoldTime)
+{
+    if ((initialDelay < 0) || (holdTime < 0) || (maxHoldTime < 0)) {
+        throw cRuntimeError("Invalid SPF scheduling parameters: the delays must not be negative");
+    }
+    spfInitialDelay = initialDelay;
+    spfHoldTime = holdTime;
+    spfMaxHoldTime = (maxHoldTime > holdTime) ? maxHoldTime : holdTime;
+    spfCurrentHoldTime = spfHoldTime;
 }
 
 
@@ -396,7 +429,7 @@ void OSPF::Router::ageDatabase()
     messageHandler->startTimer(ageTimer, 1.0);
 
     if (shouldRebuildRoutingTable) {
-        rebuildRoutingTable();
+        scheduleRoutingTableRebuild(false);
     }
 }
 
@@ -703,7 +736,7 @@ OSPF::RoutingTableEntry* OSPF::Router::lookup(IPv4Address destination, std::vect
 }
 
 
-void OSPF::Router::rebuildRoutingTable()
+void OSPF::Router::rebuildRoutingTable(bool recalculateAllAreas)
 {
     unsigned long areaCount = areas.size();
     bool hasTransitAreas = false;
@@ -712,6 +745,21 @@ void OSPF::Router::rebuildRoutingTable()
 
     EV << "Rebuilding routing table:\n";
 
+    // a pending scheduled rebuild is done by this one
+    if (spfTimer->isScheduled()) {
+        messageHandler->clearTimer(spfTimer);
+        recalculateAllAreas = recalculateAllAreas || spfRecalculateAllAreas;
+    }
+    spfRecalculateAllAreas = false;
+    spfRunCount++;
+    lastSPFRun = simTime();
+
+    if (recalculateAllAreas) {
+        for (i = 0; i < areaCount; i++) {
+            areas[i]->invalidateShortestPathTree();
+        }
+    }
+
     for (i = 0; i < areaCount; i++) {
         areas[i]->calculateShortestPathTree(newTable);
         if (areas[i]->getTransitCapability()) {
@@ -788,6 +836,46 @@ void OSPF::Router::rebuildRoutingTable()
     }
 }
 
+void OSPF::Router::scheduleRoutingTableRebuild(bool recalculateAllAreas)
+{
+    spfRequestCount++;
+
+    if ((spfInitialDelay == 0) && (spfHoldTime == 0)) {
+        rebuildRoutingTable(recalculateAllAreas);
+        return;
+    }
+
+    if (recalculateAllAreas) {
+        spfRecalculateAllAreas = true;
+    }
+    if (spfTimer->isScheduled()) {
+        EV << "Routing table rebuild is already scheduled at " << spfTimer->getArrivalTime() << ".\n";
+        return;
+    }
+
+    simtime_t delay = spfInitialDelay;
+    if (spfRunCount > 0) {
+        simtime_t sinceLastRun = simTime() - lastSPFRun;
+        if (sinceLastRun < spfCurrentHoldTime) {
+            // the network is still changing: wait for the end of the hold time, and back off
+            if (spfCurrentHoldTime - sinceLastRun > delay) {
+                delay = spfCurrentHoldTime - sinceLastRun;
+            }
+            spfCurrentHoldTime = (2 * spfCurrentHoldTime < spfMaxHoldTime) ? 2 * spfCurrentHoldTime : spfMaxHoldTime;
+        } else if (sinceLastRun >= 2 * spfCurrentHoldTime) {
+            spfCurrentHoldTime = spfHoldTime;
+        }
+    }
+
+    EV << "Scheduling routing table rebuild in " << delay << "s.\n";
+    messageHandler->startTimer(spfTimer, delay);
+}
+
+void OSPF::Router::runScheduledRoutingTableRebuild()
+{
+    rebuildRoutingTable(spfRecalculateAllAreas);
+}
+
 
 bool OSPF::Router::hasRouteToASBoundaryRouter(const std::vector<OSPF::RoutingTableEntry*>& inRoutingTable, OSPF::RouterID asbrRouterID) const
 {
@@ -1373,7 +1461,7 @@ void OSPF::Router::updateExternalRoute(IPv4Address networkAddress, const OSPFASE
     delete asExternalLSA;
 
     if (rebuild) {
-        rebuildRoutingTable();
+        scheduleRoutingTableRebuild(false);
     }
 }
 
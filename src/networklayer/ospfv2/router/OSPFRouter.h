@@ -50,6 +50,18 @@ private:
     std::vector<RoutingTableEntry*>                                    routingTable;            ///< The OSPF routing table - contains more information than the one in the IP layer.
     MessageHandler*                                                    messageHandler;          ///< The message dispatcher class.
     bool                                                               rfc1583Compatibility;    ///< Decides whether to handle the preferred routing table entry to an AS boundary router as defined in RFC1583 or not.
+    cMessage*                                                          spfTimer;                ///< Fires when a scheduled routing table calculation is due.
+    simtime_t                                                          spfInitialDelay;         ///< Delay of the first calculation after a quiet period.
+    simtime_t                                                          spfHoldTime;             ///< Minimum time between two calculations in a stable network.
+    simtime_t                                                          spfMaxHoldTime;          ///< Upper limit of the exponentially growing hold time.
+    simtime_t                                                          spfCurrentHoldTime;      ///< Minimum time between the last and the next calculation.
+    simtime_t                                                          lastSPFRun;              ///< Time of the last routing table calculation.
+    bool                                                               spfRecalculateAllAreas;  ///< Whether the scheduled calculation must recalculate the shortest path trees of all areas.
+    simtime_t                                                          lsaPacingInterval;       ///< Time the flooded LSAs are collected on an interface before they are sent; 0 sends them immediately.
+    unsigned long                                                      spfRequestCount;         ///< Number of routing table calculations requested.
+    unsigned long                                                      spfRunCount;             ///< Number of routing table calculations performed.
+    unsigned long                                                      floodedUpdatePacketCount;///< Number of Link State Update packets sent by flooding.
+    unsigned long                                                      floodedLSACount;         ///< Number of LSAs in these packets.
 
 public:
     /**
@@ -72,6 +84,23 @@ public:
 
     MessageHandler*          getMessageHandler()  { return messageHandler; }
 
+    /**
+     * Sets the SPF scheduling parameters. Routing table calculations requested
+     * after a quiet period run after initialDelay; further calculations are held
+     * back by the hold time, which doubles up to maxHoldTime while requests keep
+     * arriving within it. If both initialDelay and holdTime are zero, the routing
+     * table is rebuilt synchronously on every request.
+     */
+    void                     setSPFThrottling(simtime_t initialDelay, simtime_t holdTime, simtime_t maxHoldTime);
+    void                     setLSAPacingInterval(simtime_t interval)  { lsaPacingInterval = interval; }
+    simtime_t                getLSAPacingInterval() const  { return lsaPacingInterval; }
+
+    unsigned long            getSPFRequestCount() const  { return spfRequestCount; }
+    unsigned long            getSPFRunCount() const  { return spfRunCount; }
+    unsigned long            getFloodedUpdatePacketCount() const  { return floodedUpdatePacketCount; }
+    unsigned long            getFloodedLSACount() const  { return floodedLSACount; }
+    void                     countFloodedUpdatePacket(unsigned int lsaCount)  { floodedUpdatePacketCount++; floodedLSACount += lsaCount; }
+
     unsigned long            getASExternalLSACount() const  { return asExternalLSAs.size(); }
     ASExternalLSA*           getASExternalLSA(unsigned long i)  { return asExternalLSAs[i]; }
     const ASExternalLSA*     getASExternalLSA(unsigned long i) const  { return asExternalLSAs[i]; }
@@ -204,9 +233,27 @@ public:
 
     /**
      * Rebuilds the routing table from scratch(based on the LSA database).
+     * If recalculateAllAreas is false, the shortest path trees of the areas
+     * are only recalculated where a router or network LSA, or an interface or
+     * neighbor changed since the last rebuild; changes of summary and
+     * AS-external LSAs do not need a new intra-area calculation.
      * @sa RFC2328 Section 16.
      */
-    void                 rebuildRoutingTable();
+    void                 rebuildRoutingTable(bool recalculateAllAreas = true);
+
+    /**
+     * Requests a routing table rebuild according to the SPF scheduling
+     * parameters (see setSPFThrottling()). Requests arriving while a
+     * calculation is already scheduled are merged into it.
+     * @param recalculateAllAreas [in] See rebuildRoutingTable().
+     */
+    void                 scheduleRoutingTableRebuild(bool recalculateAllAreas = true);
+
+    /**
+     * Performs the routing table rebuild scheduled by scheduleRoutingTableRebuild().
+     * Called on the firing of the SPF_TIMER.
+     */
+    void                 runScheduledRoutingTableRebuild();
 
     /**
      * Scans through the router's areas' preconfigured address ranges and returns
@@ -22,7 +22,9 @@
 bool OSPF::RouterLSA::update(const OSPFRouterLSA* lsa)
 {
     bool different = differsFrom(lsa);
-    (*this) = (*lsa);
+    // keep the routing info: an unchanged LSA stays on the cached shortest path tree
+    OSPFRouterLSA::operator=(*lsa);
+    setSource(LSATrackingInfo::FLOODED);
     resetInstallTime();
     if (different) {
         clearNextHops();
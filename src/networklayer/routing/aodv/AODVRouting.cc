@@ -24,6 +24,9 @@
 #include "UDPControlInfo.h"
 #include "ModuleAccess.h"
 #include "NodeOperations.h"
+#ifdef WITH_MANET
+#include "NeighborDiscovery.h"
+#endif
 #include "RoutingTableAccess.h"
 
 Define_Module(AODVRouting);
@@ -65,6 +68,20 @@ void AODVRouting::initialize(int stage)
         netTraversalTime = par("netTraversalTime");
         nextHopWait = par("nextHopWait");
         pathDiscoveryTime = par("pathDiscoveryTime");
+
+        const char *neighborDiscoveryModule = par("neighborDiscoveryModule");
+        useNeighborDiscovery = *neighborDiscoveryModule;
+        if (useNeighborDiscovery) {
+#ifdef WITH_MANET
+            if (useHelloMessages)
+                throw cRuntimeError("The useHelloMessages and neighborDiscoveryModule parameters are mutually exclusive");
+            // the neighbor routes live as long as the neighbors of the shared NeighborDiscovery module
+            NeighborDiscovery *neighborDiscovery = check_and_cast<NeighborDiscovery *>(getModuleByPath(neighborDiscoveryModule));
+            neighborValidityInterval = neighborDiscovery->par("neighborValidityInterval");
+#else
+            throw cRuntimeError("The neighborDiscoveryModule parameter requires the MANET feature");
+#endif
+        }
     }
     else if (stage == 4) {
         NodeStatus *nodeStatus = dynamic_cast<NodeStatus *>(host->getSubmodule("status"));
@@ -75,6 +92,11 @@ void AODVRouting::initialize(int stage)
         networkProtocol->registerHook(0, this);
         nb = NotificationBoardAccess().get();
         nb->subscribe(this, NF_LINK_BREAK);
+        if (useNeighborDiscovery) {
+            nb->subscribe(this, NF_NEIGHBOR_ADDED);
+            nb->subscribe(this, NF_NEIGHBOR_CHANGED);
+            nb->subscribe(this, NF_NEIGHBOR_REMOVED);
+        }
 
         if (useHelloMessages) {
             helloMsgTimer = new cMessage("HelloMsgTimer");
@@ -220,6 +242,7 @@ AODVRouting::AODVRouting()
     routingTable = NULL;
     isOperational = false;
     networkProtocol = NULL;
+    useNeighborDiscovery = false;
     helloMsgTimer = NULL;
     expungeTimer = NULL;
     blacklistTimer = NULL;
@@ -1010,6 +1033,25 @@ void AODVRouting::receiveChangeNotification(int signalID, const cObject *obj)
         else
             throw cRuntimeError("Unknown packet type in NF_LINK_BREAK notification");
     }
+#ifdef WITH_MANET
+    else if (signalID == NF_NEIGHBOR_ADDED || signalID == NF_NEIGHBOR_CHANGED) {
+        const NeighborEntry *neighbor = check_and_cast<const NeighborEntry *>(obj);
+        if (isOperational && !neighbor->address.isIPv6())
+            handleNeighborHeard(neighbor->address.get4());
+    }
+    else if (signalID == NF_NEIGHBOR_REMOVED) {
+        // RFC 3561 6.11 (i): a neighbor timeout is handled as a link break
+        const NeighborEntry *neighbor = check_and_cast<const NeighborEntry *>(obj);
+        if (isOperational && !neighbor->address.isIPv6()) {
+            IPv4Address neighborAddr = neighbor->address.get4();
+            IPv4Route *route = routingTable->findBestMatchingRoute(neighborAddr);
+            if (route && route->getSource() == this && route->getGateway() == neighborAddr) {
+                EV_DETAIL << "Lost neighbor " << neighborAddr << endl;
+                handleLinkBreakSendRERR(neighborAddr);
+            }
+        }
+    }
+#endif
 }
 
 void AODVRouting::handleLinkBreakSendRERR(const IPv4Address& unreachableAddr)
@@ -1388,7 +1430,8 @@ void AODVRouting::handleHelloMessage(AODVRREP *helloMessage)
         updateRoutingTable(routeHelloOriginator, helloOriginatorAddr, 1, true, latestDestSeqNum, true, std::max(lifeTime, newLifeTime));
     }
 
-    // TODO: This feature has not implemented yet.
+    // TODO: This feature has not implemented yet, except with the
+    // neighborDiscoveryModule parameter (see receiveChangeNotification()).
     // A node MAY determine connectivity by listening for packets from its
     // set of neighbors.  If, within the past DELETE_PERIOD, it has received
     // a Hello message from a neighbor, and then for that neighbor does not
@@ -1398,6 +1441,23 @@ void AODVRouting::handleHelloMessage(AODVRREP *helloMessage)
     // happens, the node SHOULD proceed as in Section 6.11.
 }
 
+void AODVRouting::handleNeighborHeard(const IPv4Address& neighborAddr)
+{
+    // Same as a Hello message (RFC 3561 6.9), but the NeighborDiscovery
+    // beacons carry no AODV sequence number: a new route to the neighbor
+    // has no valid one, an existing route keeps its own.
+    IPv4Route *routeNeighbor = routingTable->findBestMatchingRoute(neighborAddr);
+    simtime_t newLifeTime = simTime() + neighborValidityInterval;
+
+    if (!routeNeighbor || routeNeighbor->getSource() != this)
+        createRoute(neighborAddr, neighborAddr, 1, false, 0, true, newLifeTime);
+    else {
+        AODVRouteData *routeData = check_and_cast<AODVRouteData *>(routeNeighbor->getProtocolData());
+        simtime_t lifeTime = routeData->getLifeTime();
+        updateRoutingTable(routeNeighbor, neighborAddr, 1, routeData->hasValidDestNum(), routeData->getDestSeqNum(), true, std::max(lifeTime, newLifeTime));
+    }
+}
+
 void AODVRouting::expungeRoutes()
 {
     for (int i = 0; i < routingTable->getNumRoutes(); i++) {
@@ -1662,7 +1722,13 @@ AODVRouting::~AODVRouting()
     delete blacklistTimer;
 
     nb = NotificationBoardAccess().getIfExists(this);
-    if (nb)
+    if (nb) {
         nb->unsubscribe(this, NF_LINK_BREAK);
+        if (useNeighborDiscovery) {
+            nb->unsubscribe(this, NF_NEIGHBOR_ADDED);
+            nb->unsubscribe(this, NF_NEIGHBOR_CHANGED);
+            nb->unsubscribe(this, NF_NEIGHBOR_REMOVED);
+        }
+    }
 }
 
@@ -81,6 +81,8 @@ class INET_API AODVRouting : public cSimpleModule, public ILifecycle, public INe
     unsigned int aodvUDPPort;
     bool askGratuitousRREP;
     bool useHelloMessages;
+    bool useNeighborDiscovery;    // neighbors are taken from a NeighborDiscovery module instead of Hello messages
+    simtime_t neighborValidityInterval;    // of the NeighborDiscovery module
     simtime_t maxJitter;
     simtime_t activeRouteTimeout;
     simtime_t helloInterval;
@@ -163,6 +165,7 @@ class INET_API AODVRouting : public cSimpleModule, public ILifecycle, public INe
     void handleRREQ(AODVRREQ *rreq, const IPv4Address& sourceAddr, unsigned int timeToLive);
     void handleRERR(AODVRERR *rerr, const IPv4Address& sourceAddr);
     void handleHelloMessage(AODVRREP *helloMessage);
+    void handleNeighborHeard(const IPv4Address& neighborAddr);
     void handleRREPACK(AODVRREPACK *rrepACK, const IPv4Address& neighborAddr);
 
     /* Control Packet sender methods */
@@ -22,6 +22,9 @@
 #include "IPSocket.h"
 #include "IPv4ControlInfo.h"
 #include "NodeOperations.h"
+#ifdef WITH_MANET
+#include "NeighborDiscovery.h"
+#endif
 
 Define_Module(GPSR);
 
@@ -49,6 +52,8 @@ GPSR::GPSR()
     networkProtocol = NULL;
     beaconTimer = NULL;
     purgeNeighborsTimer = NULL;
+    planarNeighborsValid = false;
+    useNeighborDiscovery = false;
 }
 
 GPSR::~GPSR()
@@ -56,8 +61,14 @@ GPSR::~GPSR()
     cancelAndDelete(beaconTimer);
     cancelAndDelete(purgeNeighborsTimer);
     nb = NotificationBoardAccess().getIfExists(this);
-    if (nb)
+    if (nb) {
         nb->unsubscribe(this, NF_LINK_BREAK);
+        if (useNeighborDiscovery) {
+            nb->unsubscribe(this, NF_NEIGHBOR_ADDED);
+            nb->unsubscribe(this, NF_NEIGHBOR_CHANGED);
+            nb->unsubscribe(this, NF_NEIGHBOR_REMOVED);
+        }
+    }
 }
 
 //
@@ -76,6 +87,8 @@ void GPSR::initialize(int stage)
         beaconInterval = par("beaconInterval");
         maxJitter = par("maxJitter");
         neighborValidityInterval = par("neighborValidityInterval");
+        fragmentNextHops.setTimeout(neighborValidityInterval);
+        planarizationTolerance = par("planarizationTolerance");
         // context
         host = getContainingNode(this);
         nodeStatus = dynamic_cast<NodeStatus *>(host->getSubmodule("status"));
@@ -84,9 +97,20 @@ void GPSR::initialize(int stage)
         routingTable = check_and_cast<IRoutingTable *>(getModuleByPath(par("routingTableModule")));
         networkProtocol = check_and_cast<INetfilter *>(getModuleByPath(par("networkProtocolModule")));
         // internal
+        const char * neighborDiscoveryModule = par("neighborDiscoveryModule");
+        useNeighborDiscovery = *neighborDiscoveryModule;
+        if (useNeighborDiscovery) {
+#ifdef WITH_MANET
+            // positions come from the shared NeighborDiscovery module instead of GPSR beacons
+            check_and_cast<NeighborDiscovery *>(getModuleByPath(neighborDiscoveryModule));
+#else
+            throw cRuntimeError("The neighborDiscoveryModule parameter requires the MANET feature");
+#endif
+        }
         beaconTimer = new cMessage("BeaconTimer");
         purgeNeighborsTimer = new cMessage("PurgeNeighborsTimer");
-        scheduleBeaconTimer();
+        if (!useNeighborDiscovery)
+            scheduleBeaconTimer();
         schedulePurgeNeighborsTimer();
     }
     else if (stage == 5)
@@ -97,6 +121,11 @@ void GPSR::initialize(int stage)
         globalPositionTable.clear();
         nb = NotificationBoardAccess().get();
         nb->subscribe(this, NF_LINK_BREAK);
+        if (useNeighborDiscovery) {
+            nb->subscribe(this, NF_NEIGHBOR_ADDED);
+            nb->subscribe(this, NF_NEIGHBOR_CHANGED);
+            nb->subscribe(this, NF_NEIGHBOR_REMOVED);
+        }
         networkProtocol->registerHook(0, this);
         if (isNodeUp())
             configureInterfaces();
@@ -240,7 +269,7 @@ void GPSR::sendBeacon(GPSRBeacon * beacon, double delay)
 void GPSR::processBeacon(GPSRBeacon * beacon)
 {
     GPSR_EV << "Processing beacon: address = " << beacon->getAddress() << ", position = " << beacon->getPosition() << endl;
-    neighborPositionTable.setPosition(beacon->getAddress(), beacon->getPosition());
+    setNeighborPosition(beacon->getAddress(), beacon->getPosition());
     delete beacon;
 }
 
@@ -327,6 +356,17 @@ Coord GPSR::getNeighborPosition(const IPvXAddress & address) const
     return neighborPositionTable.getPosition(address);
 }
 
+void GPSR::setNeighborPosition(const IPvXAddress & address, const Coord & position)
+{
+    // the planar subgraph only changes if the neighbor is new or moved noticeably
+    if (planarNeighborsValid) {
+        Coord planarizationPosition = planarizationPositionTable.getPosition(address);
+        if (isNaN(planarizationPosition.x) || planarizationPosition.distance(position) > planarizationTolerance)
+            invalidatePlanarNeighbors();
+    }
+    neighborPositionTable.setPosition(address, position);
+}
+
 //
 // angle
 //
@@ -384,25 +424,25 @@ simtime_t GPSR::getNextNeighborExpiration()
 
 void GPSR::purgeNeighbors()
 {
+    int numNeighbors = neighborPositionTable.getNumPositions();
     neighborPositionTable.removeOldPositions(simTime() - neighborValidityInterval);
+    if (neighborPositionTable.getNumPositions() != numNeighbors)
+        invalidatePlanarNeighbors();
 }
 
-std::vector<IPvXAddress> GPSR::getPlanarNeighbors()
+void GPSR::computePlanarNeighbors(const Coord & selfPosition)
 {
-    std::vector<IPvXAddress> planarNeighbors;
-    std::vector<IPvXAddress> neighborAddresses = neighborPositionTable.getAddresses();
-    Coord selfPosition = mobility->getCurrentPosition();
-    for (std::vector<IPvXAddress>::iterator it = neighborAddresses.begin(); it != neighborAddresses.end(); it++) {
-        const IPvXAddress & neighborAddress = *it;
-        Coord neighborPosition = neighborPositionTable.getPosition(neighborAddress);
+    const PositionTable::EntryVector & neighbors = neighborPositionTable.getEntries();
+    planarNeighbors.clear();
+    for (PositionTable::EntryVector::const_iterator it = neighbors.begin(); it != neighbors.end(); it++) {
+        const Coord & neighborPosition = it->position;
         if (planarizationMode == GPSR_RNG_PLANARIZATION) {
             double neighborDistance = (neighborPosition - selfPosition).length();
-            for (std::vector<IPvXAddress>::iterator jt = neighborAddresses.begin(); jt != neighborAddresses.end(); jt++) {
-                const IPvXAddress & witnessAddress = *jt;
-                Coord witnessPosition = neighborPositionTable.getPosition(witnessAddress);
+            for (PositionTable::EntryVector::const_iterator jt = neighbors.begin(); jt != neighbors.end(); jt++) {
+                const Coord & witnessPosition = jt->position;
                 double witnessDistance = (witnessPosition - selfPosition).length();;
                 double neighborWitnessDistance = (witnessPosition - neighborPosition).length();
-                if (*it == *jt)
+                if (it == jt)
                     continue;
                 else if (neighborDistance > std::max(witnessDistance, neighborWitnessDistance))
                     goto eliminate;
@@ -411,11 +451,10 @@ std::vector<IPvXAddress> GPSR::getPlanarNeighbors()
         else if (planarizationMode == GPSR_GG_PLANARIZATION) {
             Coord middlePosition = (selfPosition + neighborPosition) / 2;
             double neighborDistance = (neighborPosition - middlePosition).length();
-            for (std::vector<IPvXAddress>::iterator jt = neighborAddresses.begin(); jt != neighborAddresses.end(); jt++) {
-                const IPvXAddress & witnessAddress = *jt;
-                Coord witnessPosition = neighborPositionTable.getPosition(witnessAddress);
+            for (PositionTable::EntryVector::const_iterator jt = neighbors.begin(); jt != neighbors.end(); jt++) {
+                const Coord & witnessPosition = jt->position;
                 double witnessDistance = (witnessPosition - middlePosition).length();;
-                if (*it == *jt)
+                if (it == jt)
                     continue;
                 else if (witnessDistance < neighborDistance)
                     goto eliminate;
@@ -423,9 +462,21 @@ std::vector<IPvXAddress> GPSR::getPlanarNeighbors()
         }
         else
             throw cRuntimeError("Unknown planarization mode");
-        planarNeighbors.push_back(*it);
+        planarNeighbors.push_back(it->address);
         eliminate: ;
     }
+    planarizationSelfPosition = selfPosition;
+    planarizationPositionTable = neighborPositionTable;
+    planarNeighborsValid = true;
+}
+
+const std::vector<IPvXAddress> & GPSR::getPlanarNeighbors()
+{
+    // the planar subgraph is recomputed only if a neighbor appeared, disappeared,
+    // or moved (including ourselves) more than the tolerance since the last time
+    Coord selfPosition = mobility->getCurrentPosition();
+    if (!planarNeighborsValid || planarizationSelfPosition.distance(selfPosition) > planarizationTolerance)
+        computePlanarNeighbors(selfPosition);
     return planarNeighbors;
 }
 
@@ -434,8 +485,8 @@ IPvXAddress GPSR::getNextPlanarNeighborCounterClockwise(const IPvXAddress& start
     GPSR_EV << "Finding next planar neighbor (counter clockwise): startAddress = " << startNeighborAddress << ", startAngle = " << startNeighborAngle << endl;
     IPvXAddress bestNeighborAddress = startNeighborAddress;
     double bestNeighborAngleDifference = 2 * PI;
-    std::vector<IPvXAddress> neighborAddresses = getPlanarNeighbors();
-    for (std::vector<IPvXAddress>::iterator it = neighborAddresses.begin(); it != neighborAddresses.end(); it++) {
+    const std::vector<IPvXAddress> & neighborAddresses = getPlanarNeighbors();
+    for (std::vector<IPvXAddress>::const_iterator it = neighborAddresses.begin(); it != neighborAddresses.end(); it++) {
         const IPvXAddress & neighborAddress = *it;
         double neighborAngle = getNeighborAngle(neighborAddress);
         double neighborAngleDifference = neighborAngle - startNeighborAngle;
@@ -474,14 +525,12 @@ IPvXAddress GPSR::findGreedyRoutingNextHop(IPv4Datagram * datagram, const IPvXAd
     Coord destinationPosition = packet->getDestinationPosition();
     double bestDistance = (destinationPosition - selfPosition).length();
     IPvXAddress bestNeighbor;
-    std::vector<IPvXAddress> neighborAddresses = neighborPositionTable.getAddresses();
-    for (std::vector<IPvXAddress>::iterator it = neighborAddresses.begin(); it != neighborAddresses.end(); it++) {
-        const IPvXAddress & neighborAddress = *it;
-        Coord neighborPosition = neighborPositionTable.getPosition(neighborAddress);
-        double neighborDistance = (destinationPosition - neighborPosition).length();
+    const PositionTable::EntryVector & neighbors = neighborPositionTable.getEntries();
+    for (PositionTable::EntryVector::const_iterator it = neighbors.begin(); it != neighbors.end(); it++) {
+        double neighborDistance = (destinationPosition - it->position).length();
         if (neighborDistance < bestDistance) {
             bestDistance = neighborDistance;
-            bestNeighbor = neighborAddress.get4();
+            bestNeighbor = it->address.get4();
         }
     }
     if (bestNeighbor.isUnspecified()) {
@@ -556,6 +605,17 @@ INetfilter::IHook::Result GPSR::routeDatagram(IPv4Datagram * datagram, const Int
 {
     const IPvXAddress source = datagram->getSrcAddress();
     const IPvXAddress destination = datagram->getDestAddress();
+    if (fragmentNextHops.isNonFirstFragment(datagram)) {
+        // only the first fragment carries the GPSR packet, so follow its route
+        if (!fragmentNextHops.recall(datagram, nextHop)) {
+            GPSR_EV << "No next hop known for fragment, dropping packet: source = " << source << ", destination = " << destination << endl;
+            return DROP;
+        }
+        GPSR_EV << "Next hop of first fragment used: source = " << source << ", destination = " << destination << ", nextHop: " << nextHop << endl;
+        // KLUDGE: find output interface
+        outputInterfaceEntry = interfaceTable->getInterface(1);
+        return ACCEPT;
+    }
     GPSR_EV << "Finding next hop: source = " << source << ", destination = " << destination << endl;
     nextHop = findNextHop(datagram, destination).get4();
     if (nextHop.isUnspecified()) {
@@ -566,6 +626,8 @@ INetfilter::IHook::Result GPSR::routeDatagram(IPv4Datagram * datagram, const Int
         GPSR_EV << "Next hop found: source = " << source << ", destination = " << destination << ", nextHop: " << nextHop << endl;
         GPSRPacket * packet = check_and_cast<GPSRPacket *>(dynamic_cast<cPacket *>(datagram)->getEncapsulatedPacket());
         packet->setSenderAddress(getSelfAddress());
+        if (fragmentNextHops.isFirstFragment(datagram))
+            fragmentNextHops.remember(datagram, nextHop);
         // KLUDGE: find output interface
         outputInterfaceEntry = interfaceTable->getInterface(1);
         return ACCEPT;
@@ -623,13 +685,19 @@ bool GPSR::handleOperationStage(LifecycleOperation * operation, int stage, IDone
             configureInterfaces();
     }
     else if (dynamic_cast<NodeShutdownOperation *>(operation)) {
-        if (stage == NodeShutdownOperation::STAGE_APPLICATION_LAYER)
+        if (stage == NodeShutdownOperation::STAGE_APPLICATION_LAYER) {
             // TODO: send a beacon to remove ourself from peers neighbor position table
             neighborPositionTable.clear();
+            invalidatePlanarNeighbors();
+            fragmentNextHops.clear();
+        }
     }
     else if (dynamic_cast<NodeCrashOperation *>(operation)) {
-        if (stage == NodeCrashOperation::STAGE_CRASH)
+        if (stage == NodeCrashOperation::STAGE_CRASH) {
             neighborPositionTable.clear();
+            invalidatePlanarNeighbors();
+            fragmentNextHops.clear();
+        }
     }
     else throw cRuntimeError("Unsupported lifecycle operation '%s'", operation->getClassName());
     return true;
@@ -646,4 +714,18 @@ void GPSR::receiveChangeNotification(int signalID, const cObject *obj)
         GPSR_EV << "Received link break" << endl;
         // TODO: shall we remove the neighbor?
     }
+#ifdef WITH_MANET
+    else if (signalID == NF_NEIGHBOR_ADDED || signalID == NF_NEIGHBOR_CHANGED) {
+        const NeighborEntry * neighbor = check_and_cast<const NeighborEntry *>(obj);
+        if (!isNaN(neighbor->position.x))
+            setNeighborPosition(neighbor->address, neighbor->position);
+    }
+    else if (signalID == NF_NEIGHBOR_REMOVED) {
+        const NeighborEntry * neighbor = check_and_cast<const NeighborEntry *>(obj);
+        if (neighborPositionTable.hasPosition(neighbor->address)) {
+            neighborPositionTable.removePosition(neighbor->address);
+            invalidatePlanarNeighbors();
+        }
+    }
+#endif
 }
@@ -24,6 +24,7 @@
 #include "ILifecycle.h"
 #include "IMobility.h"
 #include "INetfilter.h"
+#include "IPv4FragmentDecisions.h"
 #include "IRoutingTable.h"
 #include "NodeStatus.h"
 #include "NotificationBoard.h"
@@ -38,7 +39,6 @@
  * For more information on the routing algorithm, see the GPSR paper
  * http://www.eecs.harvard.edu/~htk/publication/2000-mobi-karp-kung.pdf
  */
-// TODO: optimize internal data structures for performance to use less lookups and be more prepared for routing a packet
 // KLUDGE: implement position registry protocol instead of using a global variable
 // KLUDGE: the GPSR packet is now used to wrap the content of network datagrams
 // KLUDGE: we should rather add these fields as header extensions
@@ -51,6 +51,8 @@ class INET_API GPSR : public cSimpleModule, public ILifecycle, public INotifiabl
         simtime_t beaconInterval;
         simtime_t maxJitter;
         simtime_t neighborValidityInterval;
+        double planarizationTolerance;
+        bool useNeighborDiscovery;
 
         // context
         cModule * host;
@@ -67,6 +69,15 @@ class INET_API GPSR : public cSimpleModule, public ILifecycle, public INotifiabl
         cMessage * purgeNeighborsTimer;
         PositionTable neighborPositionTable;
 
+        // planar subgraph cache, see getPlanarNeighbors()
+        bool planarNeighborsValid;
+        std::vector<IPvXAddress> planarNeighbors;
+        Coord planarizationSelfPosition;
+        PositionTable planarizationPositionTable; // neighbor positions used for the planarization
+
+        // next hops of the first fragments, used for the other fragments that carry no GPSR packet
+        IPv4FragmentDecisions<IPv4Address> fragmentNextHops;
+
     public:
         GPSR();
         virtual ~GPSR();
@@ -111,6 +122,7 @@ class INET_API GPSR : public cSimpleModule, public ILifecycle, public INotifiabl
         Coord intersectSections(Coord & begin1, Coord & end1, Coord & begin2, Coord & end2);
         Coord getDestinationPosition(const IPvXAddress & address) const;
         Coord getNeighborPosition(const IPvXAddress & address) const;
+        void setNeighborPosition(const IPvXAddress & address, const Coord & position);
 
         // angle
         double getVectorAngle(Coord vector);
@@ -125,7 +137,9 @@ class INET_API GPSR : public cSimpleModule, public ILifecycle, public INotifiabl
         // neighbor
         simtime_t getNextNeighborExpiration();
         void purgeNeighbors();
-        std::vector<IPvXAddress> getPlanarNeighbors();
+        void invalidatePlanarNeighbors() { planarNeighborsValid = false; }
+        void computePlanarNeighbors(const Coord & selfPosition);
+        const std::vector<IPvXAddress> & getPlanarNeighbors();
         IPvXAddress getNextPlanarNeighborCounterClockwise(const IPvXAddress & startNeighborAddress, double startNeighborAngle);
 
         // next hop
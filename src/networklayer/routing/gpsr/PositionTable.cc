@@ -16,56 +16,79 @@
 // Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 //
 
+#include <algorithm>
 #include "PositionTable.h"
 
 static double const NaN = 0.0 / 0.0;
 
+static bool entryLessThan(const PositionTable::Entry & entry, const IPvXAddress & address) {
+    return entry.address < address;
+}
+
+PositionTable::EntryVector::iterator PositionTable::findEntry(const IPvXAddress & address) {
+    EntryVector::iterator it = std::lower_bound(entries.begin(), entries.end(), address, entryLessThan);
+    return it != entries.end() && it->address == address ? it : entries.end();
+}
+
+PositionTable::EntryVector::const_iterator PositionTable::findEntry(const IPvXAddress & address) const {
+    EntryVector::const_iterator it = std::lower_bound(entries.begin(), entries.end(), address, entryLessThan);
+    return it != entries.end() && it->address == address ? it : entries.end();
+}
+
 std::vector<IPvXAddress> PositionTable::getAddresses() const {
     std::vector<IPvXAddress> addresses;
-    for (AddressToPositionMap::const_iterator it = addressToPositionMap.begin(); it != addressToPositionMap.end(); it++)
-        addresses.push_back(it->first);
+    addresses.reserve(entries.size());
+    for (EntryVector::const_iterator it = entries.begin(); it != entries.end(); it++)
+        addresses.push_back(it->address);
     return addresses;
 }
 
 bool PositionTable::hasPosition(const IPvXAddress & address) const {
-    AddressToPositionMap::const_iterator it = addressToPositionMap.find(address);
-    return it != addressToPositionMap.end();
+    return findEntry(address) != entries.end();
 }
 
 Coord PositionTable::getPosition(const IPvXAddress & address) const {
-    AddressToPositionMap::const_iterator it = addressToPositionMap.find(address);
-    if (it == addressToPositionMap.end())
+    EntryVector::const_iterator it = findEntry(address);
+    if (it == entries.end())
         return Coord(NaN, NaN, NaN);
     else
-        return it->second.second;
+        return it->position;
 }
 
 void PositionTable::setPosition(const IPvXAddress & address, const Coord & coord) {
     ASSERT(!address.isUnspecified());
-    addressToPositionMap[address] = AddressToPositionMapValue(simTime(), coord);
+    EntryVector::iterator it = std::lower_bound(entries.begin(), entries.end(), address, entryLessThan);
+    if (it == entries.end() || it->address != address) {
+        Entry entry;
+        entry.address = address;
+        it = entries.insert(it, entry);
+    }
+    it->timestamp = simTime();
+    it->position = coord;
 }
 
 void PositionTable::removePosition(const IPvXAddress & address) {
-    AddressToPositionMap::iterator it = addressToPositionMap.find(address);
-    addressToPositionMap.erase(it);
+    EntryVector::iterator it = findEntry(address);
+    if (it != entries.end())
+        entries.erase(it);
 }
 
 void PositionTable::removeOldPositions(simtime_t timestamp) {
-    for (AddressToPositionMap::iterator it = addressToPositionMap.begin(); it != addressToPositionMap.end();)
-        if (it->second.first <= timestamp)
-            addressToPositionMap.erase(it++);
-        else
-            it++;
+    EntryVector::iterator jt = entries.begin();
+    for (EntryVector::iterator it = entries.begin(); it != entries.end(); it++)
+        if (it->timestamp > timestamp)
+            *jt++ = *it;
+    entries.erase(jt, entries.end());
 }
 
 void PositionTable::clear() {
-    addressToPositionMap.clear();
+    entries.clear();
 }
 
 simtime_t PositionTable::getOldestPosition() const {
     simtime_t oldestPosition = SimTime::getMaxTime();
-    for (AddressToPositionMap::const_iterator it = addressToPositionMap.begin(); it != addressToPositionMap.end(); it++) {
-        const simtime_t & time = it->second.first;
+    for (EntryVector::const_iterator it = entries.begin(); it != entries.end(); it++) {
+        const simtime_t & time = it->timestamp;
         if (time < oldestPosition)
             oldestPosition = time;
     }
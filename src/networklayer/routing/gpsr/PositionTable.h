@@ -20,24 +20,37 @@
 #define __INET_POSITIONTABLE_H_
 
 #include <vector>
-#include <map>
 #include "INETDefs.h"
 #include "IPvXAddress.h"
 #include "Coord.h"
 
 /**
  * This class provides a mapping between node addresses and their positions.
+ * The entries are stored in a flat vector sorted by address, so they can be
+ * iterated without lookups; finding an address takes logarithmic time.
  */
 class INET_API PositionTable {
+    public:
+        struct Entry {
+            IPvXAddress address;
+            simtime_t timestamp;
+            Coord position;
+        };
+        typedef std::vector<Entry> EntryVector;
+
+    private:
+        EntryVector entries;
+
     private:
-        typedef std::pair<simtime_t, Coord> AddressToPositionMapValue;
-        typedef std::map<IPvXAddress, AddressToPositionMapValue> AddressToPositionMap;
-        AddressToPositionMap addressToPositionMap;
+        EntryVector::iterator findEntry(const IPvXAddress & address);
+        EntryVector::const_iterator findEntry(const IPvXAddress & address) const;
 
     public:
         PositionTable() { }
 
         std::vector<IPvXAddress> getAddresses() const;
+        const EntryVector & getEntries() const { return entries; }
+        int getNumPositions() const { return entries.size(); }
 
         bool hasPosition(const IPvXAddress & address) const;
         Coord getPosition(const IPvXAddress & address) const;
@@ -31,8 +31,9 @@
 
 Define_Module(RIPRouting);
 
-#define RIP_EV EV << "RIP at " << getHostName() << " "
-#define RIP_DEBUG EV << "RIP at " << getHostName() << " "
+// arguments are not evaluated if the level is disabled
+#define RIP_EV EV_INFO << "RIP at " << getHostName() << " "
+#define RIP_DEBUG EV_DEBUG << "RIP at " << getHostName() << " "
 
 
 std::ostream& operator<<(std::ostream& os, const RIPRoute& e)
@@ -180,6 +181,8 @@ void RIPRouting::initialize(int stage)
         routeExpiryTime = par("routeExpiryTime").doubleValue();
         routePurgeTime = par("routePurgeTime").doubleValue();
         shutdownTime = par("shutdownTime").doubleValue();
+        triggeredUpdateHoldTime = par("triggeredUpdateHoldTime").doubleValue();
+        lastTriggeredUpdateTime = -triggeredUpdateHoldTime;
 
         updateTimer = new cMessage("RIP-timer");
         triggeredUpdateTimer = new cMessage("RIP-trigger");
@@ -260,7 +263,7 @@ RIPRoute* RIPRouting::importRoute(IPv4Route *route, RIPRoute::RouteType type, in
         ripRoute->setInterface(ie);
     }
 
-    ripRoutes.push_back(ripRoute);
+    addRIPRoute(ripRoute);
     emit(numRoutesSignal, ripRoutes.size());
     return ripRoute;
 }
@@ -386,8 +389,10 @@ void RIPRouting::receiveChangeNotification(int signalID, const cObject *obj)
                                route->getNetmask() != IPv4Address::makeNetmask(ripRoute->getPrefixLength()) ||
                                route->getGateway() != ripRoute->getNextHop().get4() ||
                                route->getInterface() != ripRoute->getInterface();
+                removeRIPRouteFromIndex(ripRoute);
                 ripRoute->setDestination(route->getDestination());
                 ripRoute->setPrefixLength(route->getNetmask().getNetmaskLength());
+                ripRouteIndex.insert(std::make_pair(RouteKey(ripRoute->getDestination(), ripRoute->getPrefixLength()), ripRoute));
                 ripRoute->setNextHop(route->getGateway());
                 ripRoute->setInterface(route->getInterface());
                 if (changed)
@@ -420,8 +425,10 @@ bool RIPRouting::handleOperationStage(LifecycleOperation *operation, int stage,
             for (RouteVector::iterator it = ripRoutes.begin(); it != ripRoutes.end(); ++it)
                 invalidateRoute(*it);
             // send updates to neighbors
+            RouteVector routes;
+            collectRoutes(false, routes);
             for (InterfaceVector::iterator it = ripInterfaces.begin(); it != ripInterfaces.end(); ++it)
-                sendRoutes(IPv4Address::ALL_RIP_ROUTERS_MCAST, ripUdpPort, *it, false);
+                sendRoutes(IPv4Address::ALL_RIP_ROUTERS_MCAST, ripUdpPort, *it, routes);
 
             stopRIPRouting();
 
@@ -500,6 +507,7 @@ void RIPRouting::stopRIPRouting()
 
     // clear data
     ripRoutes.clear();
+    ripRouteIndex.clear();
     ripInterfaces.clear();
 }
 
@@ -523,6 +531,7 @@ void RIPRouting::handleMessage(cMessage *msg)
         else if (msg == triggeredUpdateTimer)
         {
             processUpdate(true);
+            lastTriggeredUpdateTime = simTime();
         }
         else if (msg == startupTimer)
         {
@@ -565,9 +574,21 @@ void RIPRouting::processUpdate(bool triggered)
     else
         RIP_EV << "sending regular updates on all interfaces\n";
 
+    // the advertised routes are collected once, the interfaces apply their split horizon mode while sending
+    RouteVector routes;
+    bool collected = false;
     for (InterfaceVector::iterator it = ripInterfaces.begin(); it != ripInterfaces.end(); ++it)
+    {
         if (it->mode != NO_RIP)
-            sendRoutes(IPv4Address::ALL_RIP_ROUTERS_MCAST, ripUdpPort, *it, triggered);
+        {
+            if (!collected)
+            {
+                collectRoutes(triggered, routes);
+                collected = true;
+            }
+            sendRoutes(IPv4Address::ALL_RIP_ROUTERS_MCAST, ripUdpPort, *it, routes);
+        }
+    }
 
     // clear changed flags
     for (RouteVector::iterator it = ripRoutes.begin(); it != ripRoutes.end(); ++it)
@@ -648,14 +669,46 @@ void RIPRouting::processRequest(RIPPacket *packet)
     socket.sendTo(packet, srcAddr, srcPort);
 }
 
+/**
+ * Collects the valid routes, or only the changed ones, that should be advertised.
+ * Expired routes are invalidated or purged on the way, and are not included.
+ */
+void RIPRouting::collectRoutes(bool changedOnly, RouteVector &routes)
+{
+    unsigned int i = 0;
+    while (i < ripRoutes.size())
+    {
+        RIPRoute *ripRoute = ripRoutes[i];
+        RIPRoute *validRoute = checkRouteIsExpired(ripRoute);
+        // purged routes are removed from ripRoutes
+        if (i < ripRoutes.size() && ripRoutes[i] == ripRoute)
+            i++;
+        if (validRoute && (!changedOnly || validRoute->isChanged()))
+            routes.push_back(validRoute);
+    }
+}
+
 /**
  * Send all or changed part of the routing table to address/port on the specified interface.
- * This method is called by regular updates (every 30s), triggered updates (when some route changed),
- * and when RIP requests are processed.
+ * This method is called when RIP requests are processed; regular updates (every 30s),
+ * triggered updates (when some route changed) and shutdown collect the routes only
+ * once for all interfaces.
  */
 void RIPRouting::sendRoutes(const IPvXAddress &address, int port, const RIPInterfaceEntry &ripInterface, bool changedOnly)
 {
-    RIP_DEBUG << "Sending " << (changedOnly ? "changed" : "all") << " routes on " << ripInterface.ie->getFullName() << std::endl;
+    RouteVector routes;
+    collectRoutes(changedOnly, routes);
+    sendRoutes(address, port, ripInterface, routes);
+}
+
+/**
+ * Sends the given routes to address/port on the specified interface, applying
+ * the split horizon mode of the interface. The routes are usually collected
+ * once for all interfaces by collectRoutes().
+ */
+void RIPRouting::sendRoutes(const IPvXAddress &address, int port, const RIPInterfaceEntry &ripInterface, const RouteVector &routes)
+{
+    RIP_DEBUG << "Sending " << routes.size() << " routes on " << ripInterface.ie->getFullName() << std::endl;
 
     int maxEntries = mode == RIPv2 ? 25 : (ripInterface.ie->getMTU() - 40/*IPv6_HEADER_BYTES*/ - UDP_HEADER_BYTES - RIP_HEADER_SIZE) / RIP_RTE_SIZE;
 
@@ -664,14 +717,9 @@ void RIPRouting::sendRoutes(const IPvXAddress &address, int port, const RIPInter
     packet->setEntryArraySize(maxEntries);
     int k = 0; // index into RIP entries
 
-    for (RouteVector::iterator it = ripRoutes.begin(); it != ripRoutes.end(); ++it)
+    for (RouteVector::const_iterator it = routes.begin(); it != routes.end(); ++it)
     {
-        RIPRoute *ripRoute = checkRouteIsExpired(*it);
-        if (!ripRoute)
-            continue;
-
-        if (changedOnly && !ripRoute->isChanged())
-            continue;
+        RIPRoute *ripRoute = *it;
 
         // Split Horizon check:
         //   Omit routes learned from one neighbor in updates sent to that neighbor.
@@ -914,7 +962,7 @@ void RIPRouting::addRoute(const IPvXAddress &dest, int prefixLength, const Inter
     ripRoute->setFrom(from);
     ripRoute->setLastUpdateTime(simTime());
     ripRoute->setChanged(true);
-    ripRoutes.push_back(ripRoute);
+    addRIPRoute(ripRoute);
     emit(numRoutesSignal, ripRoutes.size());
     triggerUpdate();
 }
@@ -984,8 +1032,10 @@ void RIPRouting::updateRoute(RIPRoute *ripRoute, const InterfaceEntry *ie, const
 }
 
 /**
- * Sets the update timer to trigger an update in the [1s,5s] interval.
- * If the update is already scheduled, it does nothing.
+ * Sets the update timer to trigger an update in the [1s,5s] interval,
+ * but not earlier than triggeredUpdateHoldTime after the previous triggered update.
+ * If the update is already scheduled, it does nothing, so all changes until then
+ * are sent in the same update.
  */
 void RIPRouting::triggerUpdate()
 {
@@ -993,6 +1043,8 @@ void RIPRouting::triggerUpdate()
     {
         double delay = par("triggeredUpdateDelay");
         simtime_t updateTime = simTime() + delay;
+        if (updateTime < lastTriggeredUpdateTime + triggeredUpdateHoldTime)
+            updateTime = lastTriggeredUpdateTime + triggeredUpdateHoldTime;
         // Triggered updates may be suppressed if a regular
         // update is due by the time the triggered update would be sent.
         if (!updateTimer->isScheduled() || updateTimer->getArrivalTime() > updateTime)
@@ -1064,6 +1116,7 @@ void RIPRouting::purgeRoute(RIPRoute *ripRoute)
     RouteVector::iterator end = std::remove(ripRoutes.begin(), ripRoutes.end(), ripRoute);
     if (end != ripRoutes.end())
         ripRoutes.erase(end, ripRoutes.end());
+    removeRIPRouteFromIndex(ripRoute);
     delete ripRoute;
 
     emit(numRoutesSignal, ripRoutes.size());
@@ -1107,17 +1160,18 @@ RIPInterfaceEntry *RIPRouting::findInterfaceById(int interfaceId)
 
 RIPRoute *RIPRouting::findRoute(const IPvXAddress &destination, int prefixLength)
 {
-    for (RouteVector::iterator it = ripRoutes.begin(); it != ripRoutes.end(); ++it)
-        if ((*it)->getDestination() == destination && (*it)->getPrefixLength() == prefixLength)
-            return *it;
+    RouteIndex::iterator it = ripRouteIndex.lower_bound(RouteKey(destination, prefixLength));
+    if (it != ripRouteIndex.end() && it->first.first == destination && it->first.second == prefixLength)
+        return it->second;
     return NULL;
 }
 
 RIPRoute *RIPRouting::findRoute(const IPvXAddress &destination, int prefixLength, RIPRoute::RouteType type)
 {
-    for (RouteVector::iterator it = ripRoutes.begin(); it != ripRoutes.end(); ++it)
-        if ((*it)->getType() == type && (*it)->getDestination() == destination && (*it)->getPrefixLength() == prefixLength)
-            return *it;
+    std::pair<RouteIndex::iterator, RouteIndex::iterator> range = ripRouteIndex.equal_range(RouteKey(destination, prefixLength));
+    for (RouteIndex::iterator it = range.first; it != range.second; ++it)
+        if (it->second->getType() == type)
+            return it->second;
     return NULL;
 }
 
@@ -1137,6 +1191,25 @@ RIPRoute *RIPRouting::findRoute(const InterfaceEntry *ie, RIPRoute::RouteType ty
     return NULL;
 }
 
+void RIPRouting::addRIPRoute(RIPRoute *ripRoute)
+{
+    ripRoutes.push_back(ripRoute);
+    ripRouteIndex.insert(std::make_pair(RouteKey(ripRoute->getDestination(), ripRoute->getPrefixLength()), ripRoute));
+}
+
+void RIPRouting::removeRIPRouteFromIndex(RIPRoute *ripRoute)
+{
+    std::pair<RouteIndex::iterator, RouteIndex::iterator> range = ripRouteIndex.equal_range(RouteKey(ripRoute->getDestination(), ripRoute->getPrefixLength()));
+    for (RouteIndex::iterator it = range.first; it != range.second; ++it)
+    {
+        if (it->second == ripRoute)
+        {
+            ripRouteIndex.erase(it);
+            break;
+        }
+    }
+}
+
 void RIPRouting::addInterface(const InterfaceEntry *ie, cXMLElement *config)
 {
     RIPInterfaceEntry ripInterface(ie);
@@ -1160,6 +1233,7 @@ void RIPRouting::deleteInterface(const InterfaceEntry *ie)
     {
         if ((*it)->getInterface() == ie)
         {
+            removeRIPRouteFromIndex(*it);
             it = ripRoutes.erase(it);
             emitNumRoutesSignal = true;
         }
@@ -18,6 +18,8 @@
 #ifndef __INET_RIPROUTING_H_
 #define __INET_RIPROUTING_H_
 
+#include <map>
+
 #include "INETDefs.h"
 #include "IPv4Route.h"
 #include "IRoutingTable.h"
@@ -135,6 +137,8 @@ class INET_API RIPRouting : public cSimpleModule, public INotifiable, public ILi
     enum Mode { RIPv2, RIPng };
     typedef std::vector<RIPInterfaceEntry> InterfaceVector;
     typedef std::vector<RIPRoute*> RouteVector;
+    typedef std::pair<IPvXAddress, int> RouteKey;   // destination and prefix length
+    typedef std::multimap<RouteKey, RIPRoute*> RouteIndex;
     // environment
     cModule *host;                  // the host module that owns this module
     IInterfaceTable *ift;           // interface table of the host
@@ -142,6 +146,7 @@ class INET_API RIPRouting : public cSimpleModule, public INotifiable, public ILi
     // state
     InterfaceVector ripInterfaces;  // interfaces on which RIP is used
     RouteVector ripRoutes;          // all advertised routes (imported or learned)
+    RouteIndex ripRouteIndex;       // ripRoutes by destination and prefix length; equal keys are in ripRoutes order
     UDPSocket socket;               // bound to the RIP port (see udpPort parameter)
     cMessage *updateTimer;          // for sending unsolicited Response messages in every ~30 seconds.
     cMessage *triggeredUpdateTimer; // scheduled when there are pending changes
@@ -154,6 +159,8 @@ class INET_API RIPRouting : public cSimpleModule, public INotifiable, public ILi
     simtime_t routeExpiryTime;      // learned routes becomes invalid if no update received in this period of time
     simtime_t routePurgeTime;       // invalid routes are deleted after this period of time is elapsed
     simtime_t shutdownTime;         // time of shutdown processing
+    simtime_t triggeredUpdateHoldTime; // minimum time between triggered updates
+    simtime_t lastTriggeredUpdateTime;
     bool isOperational;
 
     // signals
@@ -171,6 +178,8 @@ class INET_API RIPRouting : public cSimpleModule, public INotifiable, public ILi
     RIPRoute *findRoute(const IPvXAddress &destination, int prefixLength, RIPRoute::RouteType type);
     RIPRoute *findRoute(const IPv4Route *route);
     RIPRoute *findRoute(const InterfaceEntry *ie, RIPRoute::RouteType type);
+    void addRIPRoute(RIPRoute *ripRoute);
+    void removeRIPRouteFromIndex(RIPRoute *ripRoute);
     void addInterface(const InterfaceEntry *ie, cXMLElement *config);
     void deleteInterface(const InterfaceEntry *ie);
     void invalidateRoutes(const InterfaceEntry *ie);
@@ -198,7 +207,9 @@ class INET_API RIPRouting : public cSimpleModule, public INotifiable, public ILi
 
     virtual void processRequest(RIPPacket *packet);
     virtual void processUpdate(bool triggered);
+    virtual void collectRoutes(bool changedOnly, RouteVector &routes);
     virtual void sendRoutes(const IPvXAddress &address, int port, const RIPInterfaceEntry &ripInterface, bool changedOnly);
+    virtual void sendRoutes(const IPvXAddress &address, int port, const RIPInterfaceEntry &ripInterface, const RouteVector &routes);
 
     virtual void processResponse(RIPPacket *packet);
     virtual bool isValidResponse(RIPPacket *packet);
@@ -12,6 +12,8 @@
 // See the GNU Lesser General Public License for more details.
 //
 
+#include <algorithm>
+
 #include "RSVP.h"
 #include "IPv4ControlInfo.h"
 #include "IPvXAddressResolver.h"
@@ -41,6 +43,19 @@
 
 Define_Module(RSVP);
 
+struct StateBlockIdLess
+{
+    template<typename T>
+    bool operator()(const T& a, int id) const { return a.id < id; }
+};
+
+// binary search in PSBList or RSBList, which are ordered by id
+template<typename T>
+static typename std::vector<T>::iterator findById(std::vector<T>& list, int id)
+{
+    typename std::vector<T>::iterator it = std::lower_bound(list.begin(), list.end(), id, StateBlockIdLess());
+    return (it != list.end() && it->id == id) ? it : list.end();
+}
 
 RSVP::RSVP()
 {
@@ -317,6 +332,7 @@ void RSVP::readTrafficSessionFromXML(const cXMLElement *session)
         EV << "adding new session into database" << endl;
 
         traffic.push_back(newSession);
+        sessionIndex[newSession.sobj] = traffic.size() - 1;
     }
 }
 
@@ -998,8 +1014,7 @@ RSVP::ResvStateBlock_t* RSVP::createRSB(RSVPResvMsg *msg)
         rsbEle.inLabelVector.push_back(-1);
     }
 
-    RSBList.push_back(rsbEle);
-    ResvStateBlock_t *rsb = &(*(RSBList.end() - 1));
+    ResvStateBlock_t *rsb = addRSB(rsbEle);
 
     EV << "created new RSB " << rsb->id << endl;
 
@@ -1093,15 +1108,19 @@ void RSVP::removeRSB(ResvStateBlock_t *rsb)
         allocateResource(rsb->OI, rsb->Session_Object, -rsb->Flowspec_Object.req_bandwidth);
     }
 
-    for (RSBVector::iterator it = RSBList.begin(); it != RSBList.end(); it++)
+    std::pair<RSBIndex::iterator, RSBIndex::iterator> range = rsbIndex.equal_range(rsb->Session_Object);
+    for (RSBIndex::iterator it = range.first; it != range.second; it++)
     {
-        if (it->id != rsb->id)
+        if (it->second != rsb->id)
             continue;
 
-        RSBList.erase(it);
-        return;
+        rsbIndex.erase(it);
+        break;
     }
-    ASSERT(false);
+
+    RSBVector::iterator it = findById(RSBList, rsb->id);
+    ASSERT(it != RSBList.end());
+    RSBList.erase(it);
 }
 
 void RSVP::removePSB(PathStateBlock_t *psb)
@@ -1131,15 +1150,19 @@ void RSVP::removePSB(PathStateBlock_t *psb)
     delete psb->timerMsg;
     delete psb->timeoutMsg;
 
-    for (PSBVector::iterator it = PSBList.begin(); it != PSBList.end(); it++)
+    std::pair<PSBIndex::iterator, PSBIndex::iterator> range = psbIndex.equal_range(std::make_pair(psb->Session_Object, psb->Sender_Template_Object));
+    for (PSBIndex::iterator it = range.first; it != range.second; it++)
     {
-        if (it->id != psb->id)
+        if (it->second != psb->id)
             continue;
 
-        PSBList.erase(it);
-        return;
+        psbIndex.erase(it);
+        break;
     }
-    ASSERT(false);
+
+    PSBVector::iterator it = findById(PSBList, psb->id);
+    ASSERT(it != PSBList.end());
+    PSBList.erase(it);
 }
 
 bool RSVP::evalNextHopInterface(IPv4Address destAddr, const EroVector& ERO, IPv4Address& OI)
@@ -1256,8 +1279,7 @@ RSVP::PathStateBlock_t* RSVP::createPSB(RSVPPathMsg *msg)
     psbEle.color = msg->getColor();
     psbEle.handler = -1;
 
-    PSBList.push_back(psbEle);
-    PathStateBlock_t *cPSB = &(*(PSBList.end() - 1));
+    PathStateBlock_t *cPSB = addPSB(psbEle);
 
     EV << "created new PSB " << cPSB->id << endl;
 
@@ -1305,8 +1327,7 @@ RSVP::PathStateBlock_t* RSVP::createIngressPSB(const traffic_session_t& session,
 
     psbEle.handler = path.owner;
 
-    PSBList.push_back(psbEle);
-    PathStateBlock_t *cPSB = &(*(PSBList.end() - 1));
+    PathStateBlock_t *cPSB = addPSB(psbEle);
 
     return cPSB;
 }
@@ -1340,8 +1361,7 @@ RSVP::ResvStateBlock_t* RSVP::createEgressRSB(PathStateBlock_t *psb)
     rsbEle.FlowDescriptor.push_back(flow);
     rsbEle.inLabelVector.push_back(-1);
 
-    RSBList.push_back(rsbEle);
-    ResvStateBlock_t *rsb = &(*(RSBList.end() - 1));
+    ResvStateBlock_t *rsb = addRSB(rsbEle);
 
     EV << "created new (egress) RSB " << rsb->id << endl;
 
@@ -1872,16 +1892,18 @@ void RSVP::processPATH_NOTIFY(PathNotifyMsg* msg)
 
 std::vector<RSVP::traffic_session_t>::iterator RSVP::findSession(const SessionObj_t& session)
 {
-    std::vector<traffic_session_t>::iterator it;
-    for (it = traffic.begin(); it != traffic.end(); it++)
-    {
-        if (it->sobj != session)
-            continue;
+    SessionIndex::iterator it = sessionIndex.find(session);
+    if (it == sessionIndex.end())
+        return traffic.end();
 
-        break;
-    }
+    return traffic.begin() + it->second;
+}
 
-    return it;
+void RSVP::rebuildSessionIndex()
+{
+    sessionIndex.clear();
+    for (unsigned int i = 0; i < traffic.size(); i++)
+        sessionIndex[traffic[i].sobj] = i;
 }
 
 void RSVP::addSession(const cXMLElement& node)
@@ -1964,6 +1986,7 @@ void RSVP::delSession(const cXMLElement& node)
     if (!paths)
     {
         traffic.erase(sit);
+        rebuildSessionIndex();
     }
 }
 
@@ -2096,12 +2119,12 @@ void RSVP::scheduleCommitTimer(ResvStateBlock_t *rsbEle)
 
 RSVP::ResvStateBlock_t* RSVP::findRSB(const SessionObj_t& session, const SenderTemplateObj_t& sender, unsigned int& index)
 {
-    RSBVector::iterator it;
+    // the RSBs of the session, in the order of RSBList
+    std::pair<RSBIndex::iterator, RSBIndex::iterator> range = rsbIndex.equal_range(session);
 
-    for (it = RSBList.begin(); it != RSBList.end(); it++)
+    for (RSBIndex::iterator rit = range.first; rit != range.second; rit++)
     {
-        if (it->Session_Object != session)
-            continue;
+        ResvStateBlock_t *it = findRsbById(rit->second);
 
         FlowDescriptorVector::iterator fit;
         index = 0;
@@ -2113,7 +2136,7 @@ RSVP::ResvStateBlock_t* RSVP::findRSB(const SessionObj_t& session, const SenderT
                 continue;
             }
 
-            return &(*it);
+            return it;
         }
 
         // don't break here, may be in different (if outInterface is different)
@@ -2123,46 +2146,45 @@ RSVP::ResvStateBlock_t* RSVP::findRSB(const SessionObj_t& session, const SenderT
 
 RSVP::PathStateBlock_t* RSVP::findPSB(const SessionObj_t& session, const SenderTemplateObj_t& sender)
 {
-    PSBVector::iterator it;
-    for (it = PSBList.begin(); it != PSBList.end(); it++)
-    {
-        if (it->Session_Object != session)
-            continue;
-
-        if (it->Sender_Template_Object != sender)
-            continue;
-
-        return &(*it);
-    }
+    // the first one created, as in the order of PSBList
+    PSBIndex::iterator it = psbIndex.find(std::make_pair(session, sender));
+    if (it == psbIndex.end())
+        return NULL;
 
-    return NULL;
+    return findPsbById(it->second);
 }
 
 RSVP::PathStateBlock_t* RSVP::findPsbById(int id)
 {
-    for (unsigned int i = 0; i < PSBList.size(); i++)
-    {
-        if (PSBList[i].id != id)
-            continue;
-
-        return &PSBList[i];
-    }
-    ASSERT(false);
-    return NULL; // prevent warning
+    PSBVector::iterator it = findById(PSBList, id);
+    ASSERT(it != PSBList.end());
+    return &(*it);
 }
 
 
 RSVP::ResvStateBlock_t* RSVP::findRsbById(int id)
 {
-    for (unsigned int i = 0; i < RSBList.size(); i++)
-    {
-        if (RSBList[i].id != id)
-            continue;
+    RSBVector::iterator it = findById(RSBList, id);
+    ASSERT(it != RSBList.end());
+    return &(*it);
+}
 
-        return &RSBList[i];
-    }
-    ASSERT(false);
-    return NULL; // prevent warning
+RSVP::PathStateBlock_t* RSVP::addPSB(const PathStateBlock_t& psbEle)
+{
+    ASSERT(PSBList.empty() || PSBList.back().id < psbEle.id);
+
+    PSBList.push_back(psbEle);
+    psbIndex.insert(std::make_pair(std::make_pair(psbEle.Session_Object, psbEle.Sender_Template_Object), psbEle.id));
+    return &PSBList.back();
+}
+
+RSVP::ResvStateBlock_t* RSVP::addRSB(const ResvStateBlock_t& rsbEle)
+{
+    ASSERT(RSBList.empty() || RSBList.back().id < rsbEle.id);
+
+    RSBList.push_back(rsbEle);
+    rsbIndex.insert(std::make_pair(rsbEle.Session_Object, rsbEle.id));
+    return &RSBList.back();
 }
 
 RSVP::HelloState_t* RSVP::findHello(IPv4Address peer)
@@ -2177,6 +2199,31 @@ RSVP::HelloState_t* RSVP::findHello(IPv4Address peer)
     return NULL;
 }
 
+bool RSVP::ObjLess::operator()(const SessionObj_t& a, const SessionObj_t& b) const
+{
+    if (a.DestAddress != b.DestAddress)
+        return a.DestAddress < b.DestAddress;
+    if (a.Tunnel_Id != b.Tunnel_Id)
+        return a.Tunnel_Id < b.Tunnel_Id;
+    return a.Extended_Tunnel_Id < b.Extended_Tunnel_Id;
+}
+
+bool RSVP::ObjLess::operator()(const SenderTemplateObj_t& a, const SenderTemplateObj_t& b) const
+{
+    if (a.SrcAddress != b.SrcAddress)
+        return a.SrcAddress < b.SrcAddress;
+    return a.Lsp_Id < b.Lsp_Id;
+}
+
+bool RSVP::ObjLess::operator()(const std::pair<SessionObj_t, SenderTemplateObj_t>& a, const std::pair<SessionObj_t, SenderTemplateObj_t>& b) const
+{
+    if ((*this)(a.first, b.first))
+        return true;
+    if ((*this)(b.first, a.first))
+        return false;
+    return (*this)(a.second, b.second);
+}
+
 bool operator==(const SessionObj_t& a, const SessionObj_t& b)
 {
     return (a.DestAddress == b.DestAddress &&
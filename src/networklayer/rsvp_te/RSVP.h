@@ -15,6 +15,7 @@
 #ifndef __INET_RSVP_H
 #define __INET_RSVP_H
 
+#include <map>
 #include <vector>
 
 #include "INETDefs.h"
@@ -65,6 +66,22 @@ class INET_API RSVP : public cSimpleModule, public IScriptable, public ILifecycl
 
     std::vector<traffic_session_t> traffic;
 
+    /**
+     * Ordering of SESSION and SENDER_TEMPLATE objects consistent with
+     * their operator== (setupPri and holdingPri are not compared),
+     * used by the lookup indices.
+     */
+    struct ObjLess
+    {
+        bool operator()(const SessionObj_t& a, const SessionObj_t& b) const;
+        bool operator()(const SenderTemplateObj_t& a, const SenderTemplateObj_t& b) const;
+        bool operator()(const std::pair<SessionObj_t, SenderTemplateObj_t>& a, const std::pair<SessionObj_t, SenderTemplateObj_t>& b) const;
+    };
+
+    typedef std::map<SessionObj_t, unsigned int, ObjLess> SessionIndex;
+
+    SessionIndex sessionIndex; // index into traffic[] by session
+
     /**
      * Path State Block (PSB) structure
      */
@@ -107,6 +124,9 @@ class INET_API RSVP : public cSimpleModule, public IScriptable, public ILifecycl
 
     typedef std::vector<PathStateBlock_t> PSBVector;
 
+    // PSB ids by (session, sender); equal keys are kept in creation order
+    typedef std::multimap<std::pair<SessionObj_t, SenderTemplateObj_t>, int, ObjLess> PSBIndex;
+
     /**
      * Reservation State Block (RSB) structure
      */
@@ -144,6 +164,9 @@ class INET_API RSVP : public cSimpleModule, public IScriptable, public ILifecycl
 
     typedef std::vector<ResvStateBlock_t> RSBVector;
 
+    // RSB ids by session; equal keys are kept in creation order
+    typedef std::multimap<SessionObj_t, int, ObjLess> RSBIndex;
+
     /**
      * RSVP Hello State structure
      */
@@ -187,10 +210,14 @@ class INET_API RSVP : public cSimpleModule, public IScriptable, public ILifecycl
 
     IPv4Address routerId;
 
+    // PSBList and RSBList are ordered by id, as ids are assigned increasingly
     PSBVector PSBList;
     RSBVector RSBList;
     HelloVector HelloList;
 
+    PSBIndex psbIndex;
+    RSBIndex rsbIndex;
+
   protected:
     virtual void processSignallingMessage(SignallingMsg *msg);
     virtual void processPSB_TIMER(PsbTimerMsg *msg);
@@ -254,6 +281,10 @@ class INET_API RSVP : public cSimpleModule, public IScriptable, public ILifecycl
     virtual PathStateBlock_t* findPsbById(int id);
     virtual ResvStateBlock_t* findRsbById(int id);
 
+    virtual PathStateBlock_t* addPSB(const PathStateBlock_t& psbEle);
+    virtual ResvStateBlock_t* addRSB(const ResvStateBlock_t& rsbEle);
+    virtual void rebuildSessionIndex();
+
     std::vector<traffic_session_t>::iterator findSession(const SessionObj_t& session);
     std::vector<traffic_path_t>::iterator findPath(traffic_session_t *session, const SenderTemplateObj_t &sender);
 
@@ -13,6 +13,8 @@
 //
 
 #include <algorithm>
+#include <functional>
+#include <queue>
 
 #include "INETDefs.h"
 
@@ -35,6 +37,7 @@ TED::TED()
 {
     rt = NULL;
     ift = NULL;
+    numIndexedLinks = 0;
 }
 
 TED::~TED()
@@ -48,7 +51,11 @@ void TED::initialize(int stage)
     // we have to wait for stage 2 until interfaces get registered (stage 0)
     // and get their auto-assigned IPv4 addresses (stage 2); routerId gets
     // assigned in stage 3
-    if (stage == 4)
+    if (stage == 0)
+    {
+        dijkstraCSPF = par("dijkstraCSPF");
+    }
+    else if (stage == 4)
     {
         maxMessageId = 0;
 
@@ -183,12 +190,12 @@ std::ostream & operator<<(std::ostream & os, const TELinkStateInfo& info)
 }
 
 // FIXME should this be called findOrCreateVertex() or something like that?
-int TED::assignIndex(std::vector<vertex_t>& vertices, IPv4Address nodeAddr)
+int TED::assignIndex(std::vector<vertex_t>& vertices, VertexIndex& index, IPv4Address nodeAddr)
 {
     // find node in vertices[] whose IPv4 address is nodeAddr
-    for (unsigned int i = 0; i < vertices.size(); i++)
-        if (vertices[i].node == nodeAddr)
-            return i;
+    VertexIndex::iterator it = index.find(nodeAddr);
+    if (it != index.end())
+        return it->second;
 
     // if not found, create
     vertex_t newVertex;
@@ -197,9 +204,64 @@ int TED::assignIndex(std::vector<vertex_t>& vertices, IPv4Address nodeAddr)
     newVertex.parent = -1;
 
     vertices.push_back(newVertex);
+    index[nodeAddr] = vertices.size() - 1;
     return vertices.size() - 1;
 }
 
+int TED::findOrCreateGraphVertex(IPv4Address nodeAddr)
+{
+    VertexIndex::iterator it = vertexIndex.find(nodeAddr);
+    if (it != vertexIndex.end())
+        return it->second;
+
+    int vertex = vertexNodes.size();
+    vertexIndex[nodeAddr] = vertex;
+    vertexNodes.push_back(nodeAddr);
+    outLinks.push_back(std::vector<int>());
+    return vertex;
+}
+
+void TED::clearLinkIndex()
+{
+    numIndexedLinks = 0;
+    vertexIndex.clear();
+    vertexNodes.clear();
+    outLinks.clear();
+    linkDest.clear();
+    linkByRouters.clear();
+    localLinkByPeer.clear();
+    localLinkByAddress.clear();
+}
+
+void TED::updateLinkIndex()
+{
+    // ted[] was cleared (and possibly refilled) behind our back
+    if (numIndexedLinks > ted.size())
+        clearLinkIndex();
+
+    if (vertexNodes.empty() && !routerId.isUnspecified())
+        findOrCreateGraphVertex(routerId);
+
+    for (; numIndexedLinks < ted.size(); numIndexedLinks++)
+    {
+        int i = numIndexedLinks;
+        const TELinkStateInfo& link = ted[i];
+
+        // the lookups return the first match, like the linear searches did
+        linkByRouters.insert(std::make_pair(std::make_pair(link.advrouter, link.linkid), i));
+        if (link.advrouter == routerId)
+        {
+            localLinkByPeer.insert(std::make_pair(link.linkid, i));
+            localLinkByAddress.insert(std::make_pair(link.local, i));
+        }
+
+        int src = findOrCreateGraphVertex(link.advrouter);
+        int dest = findOrCreateGraphVertex(link.linkid);
+        outLinks[src].push_back(i);
+        linkDest.push_back(dest);
+    }
+}
+
 IPAddressVector TED::calculateShortestPath(IPAddressVector dest,
             const TELinkStateInfoVector& topology, double req_bandwidth, int priority)
 {
@@ -332,39 +394,39 @@ void TED::rebuildRoutingTable()
 
 IPv4Address TED::getInterfaceAddrByPeerAddress(IPv4Address peerIP)
 {
-    std::vector<TELinkStateInfo>::iterator it;
-    for (it = ted.begin(); it != ted.end(); it++)
-        if (it->linkid == peerIP && it->advrouter == routerId)
-            return it->local;
+    updateLinkIndex();
+    std::map<IPv4Address, int>::iterator it = localLinkByPeer.find(peerIP);
+    if (it != localLinkByPeer.end())
+        return ted[it->second].local;
     error("not a local peer: %s", peerIP.str().c_str());
     return IPv4Address(); // prevent warning
 }
 
 IPv4Address TED::peerRemoteInterface(IPv4Address peerIP)
 {
-    ASSERT(isLocalPeer(peerIP));
-    std::vector<TELinkStateInfo>::iterator it;
-    for (it = ted.begin(); it != ted.end(); it++)
-        if (it->linkid == peerIP && it->advrouter == routerId)
-            return it->remote;
+    updateLinkIndex();
+    std::map<IPv4Address, int>::iterator it = localLinkByPeer.find(peerIP);
+    if (it != localLinkByPeer.end())
+        return ted[it->second].remote;
     error("not a local peer: %s", peerIP.str().c_str());
     return IPv4Address(); // prevent warning
 }
 
 bool TED::isLocalPeer(IPv4Address inetAddr)
 {
-    std::vector<TELinkStateInfo>::iterator it;
-    for (it = ted.begin(); it != ted.end(); it++)
-        if (it->linkid == inetAddr && it->advrouter == routerId)
-            break;
-    return it != ted.end();
+    updateLinkIndex();
+    return localLinkByPeer.find(inetAddr) != localLinkByPeer.end();
 }
 
 std::vector<TED::vertex_t> TED::calculateShortestPaths(const TELinkStateInfoVector& topology,
             double req_bandwidth, int priority)
 {
+    if (dijkstraCSPF && &topology == &ted)
+        return calculateShortestPathsDijkstra(req_bandwidth, priority);
+
     std::vector<vertex_t> vertices;
     std::vector<edge_t> edges;
+    VertexIndex index;
 
     // select edges that have enough bandwidth left, and store them into edges[].
     // meanwhile, collect vertices in vectices[].
@@ -377,15 +439,15 @@ std::vector<TED::vertex_t> TED::calculateShortestPaths(const TELinkStateInfoVect
             continue;
 
         edge_t edge;
-        edge.src = assignIndex(vertices, topology[i].advrouter);
-        edge.dest = assignIndex(vertices, topology[i].linkid);
+        edge.src = assignIndex(vertices, index, topology[i].advrouter);
+        edge.dest = assignIndex(vertices, index, topology[i].linkid);
         edge.metric = topology[i].metric;
         edges.push_back(edge);
     }
 
     IPv4Address srcAddr = routerId;
 
-    int srcIndex = assignIndex(vertices, srcAddr);
+    int srcIndex = assignIndex(vertices, index, srcAddr);
     vertices[srcIndex].dist = 0.0;
 
     // FIXME comment: Dijkstra? just guessing...
@@ -420,6 +482,57 @@ std::vector<TED::vertex_t> TED::calculateShortestPaths(const TELinkStateInfoVect
     return vertices;
 }
 
+std::vector<TED::vertex_t> TED::calculateShortestPathsDijkstra(double req_bandwidth, int priority)
+{
+    updateLinkIndex();
+    int srcIndex = findOrCreateGraphVertex(routerId);
+
+    std::vector<vertex_t> vertices(vertexNodes.size());
+    for (unsigned int i = 0; i < vertices.size(); i++)
+    {
+        vertices[i].node = vertexNodes[i];
+        vertices[i].dist = LS_INFINITY;
+        vertices[i].parent = -1;
+    }
+    vertices[srcIndex].dist = 0.0;
+
+    // binary heap of (distance, vertex); stale entries are skipped when popped
+    typedef std::pair<double, int> QueueEntry;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry> > queue;
+    std::vector<bool> settled(vertices.size(), false);
+    queue.push(QueueEntry(0.0, srcIndex));
+
+    while (!queue.empty())
+    {
+        int src = queue.top().second;
+        queue.pop();
+        if (settled[src])
+            continue;
+        settled[src] = true;
+
+        const std::vector<int>& links = outLinks[src];
+        for (unsigned int j = 0; j < links.size(); j++)
+        {
+            const TELinkStateInfo& link = ted[links[j]];
+
+            // prune links that are down or don't have enough bandwidth left
+            if (!link.state || link.UnResvBandwidth[priority] < req_bandwidth)
+                continue;
+
+            int dest = linkDest[links[j]];
+            double dist = vertices[src].dist + link.metric;
+            if (settled[dest] || dist >= vertices[dest].dist)
+                continue;
+
+            vertices[dest].dist = dist;
+            vertices[dest].parent = src;
+            queue.push(QueueEntry(dist, dest));
+        }
+    }
+
+    return vertices;
+}
+
 bool TED::checkLinkValidity(TELinkStateInfo link, TELinkStateInfo *&match)
 {
     std::vector<TELinkStateInfo>::iterator it;
@@ -458,18 +571,20 @@ bool TED::checkLinkValidity(TELinkStateInfo link, TELinkStateInfo *&match)
 
 unsigned int TED::linkIndex(IPv4Address localInf)
 {
-    for (unsigned int i = 0; i < ted.size(); i++)
-        if (ted[i].advrouter == routerId && ted[i].local == localInf)
-            return i;
+    updateLinkIndex();
+    std::map<IPv4Address, int>::iterator it = localLinkByAddress.find(localInf);
+    if (it != localLinkByAddress.end())
+        return it->second;
     ASSERT(false);
     return -1; // to eliminate warning
 }
 
 unsigned int TED::linkIndex(IPv4Address advrouter, IPv4Address linkid)
 {
-    for (unsigned int i = 0; i < ted.size(); i++)
-        if (ted[i].advrouter == advrouter && ted[i].linkid == linkid)
-            return i;
+    updateLinkIndex();
+    LinkIndex::iterator it = linkByRouters.find(std::make_pair(advrouter, linkid));
+    if (it != linkByRouters.end())
+        return it->second;
     ASSERT(false);
     return -1; // to eliminate warning
 }
@@ -525,12 +640,14 @@ bool TED::handleOperationStage(LifecycleOperation *operation, int stage, IDoneCa
     else if (dynamic_cast<NodeShutdownOperation *>(operation)) {
         if (stage == NodeShutdownOperation::STAGE_APPLICATION_LAYER) {
             ted.clear();
+            clearLinkIndex();
             interfaceAddrs.clear();
         }
     }
     else if (dynamic_cast<NodeCrashOperation *>(operation)) {
         if (stage == NodeCrashOperation::STAGE_CRASH) {
             ted.clear();
+            clearLinkIndex();
             interfaceAddrs.clear();
         }
     }
@@ -15,6 +15,8 @@
 #ifndef __INET_TED_H
 #define __INET_TED_H
 
+#include <map>
+
 #include "INETDefs.h"
 
 #include "TED_m.h"
@@ -106,10 +108,33 @@ class TED : public cSimpleModule, public ILifecycle
   protected:
     int maxMessageId;
 
-    virtual int assignIndex(std::vector<vertex_t>& vertices, IPv4Address nodeAddr);
+    typedef std::map<IPv4Address, int> VertexIndex;
+    typedef std::map<std::pair<IPv4Address, IPv4Address>, int> LinkIndex;
+
+    bool dijkstraCSPF;
+
+    // Persistent graph and lookup indices over ted[]. Entries of ted[] are
+    // only appended (or all cleared), and an entry never changes its
+    // advrouter/linkid, so the graph is extended incrementally from the
+    // entries not seen yet. Link state and bandwidth are read at SPF time.
+    unsigned int numIndexedLinks;       // ted[0..numIndexedLinks) are in the graph
+    VertexIndex vertexIndex;            // router id -> vertex
+    std::vector<IPv4Address> vertexNodes;   // vertex -> router id
+    std::vector<std::vector<int> > outLinks;  // vertex -> indices of its links in ted[]
+    std::vector<int> linkDest;          // ted[] index -> vertex of linkid
+    LinkIndex linkByRouters;            // (advrouter, linkid) -> first matching ted[] index
+    std::map<IPv4Address, int> localLinkByPeer;   // linkid -> first local ted[] index
+    std::map<IPv4Address, int> localLinkByAddress;    // local -> first local ted[] index
+
+    virtual int assignIndex(std::vector<vertex_t>& vertices, VertexIndex& index, IPv4Address nodeAddr);
 
     std::vector<vertex_t> calculateShortestPaths(const TELinkStateInfoVector& topology,
         double req_bandwidth, int priority);
+    std::vector<vertex_t> calculateShortestPathsDijkstra(double req_bandwidth, int priority);
+
+    virtual void updateLinkIndex();
+    virtual void clearLinkIndex();
+    virtual int findOrCreateGraphVertex(IPv4Address nodeAddr);
 
   public: //FIXME
     virtual bool checkLinkValidity(TELinkStateInfo link, TELinkStateInfo *&match);
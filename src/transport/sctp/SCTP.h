@@ -36,7 +36,9 @@ class SCTPAssociation;
 class SCTPMessage;
 
 
-#define sctpEV3 (!SCTP::testing==true)?std::cerr:std::cerr
+// debug output of the SCTP model; arguments are not evaluated if disabled
+#define sctpEV3Enabled  EV_ENABLED(LOGLEVEL_DEBUG)
+#define sctpEV3  if (!sctpEV3Enabled) ; else EV
 
 
 
@@ -1724,7 +1724,8 @@ SCTPSackChunk* SCTPAssociation::createSack()
                 << " numNRGaps=" << numNonRevokableGaps
                 << " numDups=" << numDups
                 << endl;
-        state->gapList.print(sctpEV3);
+        if (sctpEV3Enabled)
+            state->gapList.print(EVSTREAM);
     }
     return sackChunk;
 }
@@ -29,20 +29,31 @@ void SCTPNatHook::initialize()
     ift = interfaceTableAccess.get();
     natTable = new SCTPNatTable();
     nattedPackets = 0;
+    fragmentTranslations.setTimeout(ipLayer->par("fragmentTimeout").doubleValue());
 
     ipLayer->registerHook(0, this);
 }
 
 INetfilter::IHook::Result SCTPNatHook::datagramForwardHook(IPv4Datagram* datagram, const InterfaceEntry* inIE, const InterfaceEntry*& outIE, IPv4Address& nextHopAddr)
+{
+    if (SCTPAssociation::getAddressLevel(datagram->getSrcAddress())!=3) {
+        return INetfilter::IHook::ACCEPT;
+    }
+    if (fragmentTranslations.isNonFirstFragment(datagram))
+        return translateFragment(datagram, INetfilter::IHook::DROP);
+    IPv4FragmentDecisions<Translation>::FragmentId fragmentId(datagram);
+    uint64 oldNattedPackets = nattedPackets;
+    IHook::Result result = translateForward(datagram, inIE, outIE, nextHopAddr);
+    if (fragmentTranslations.isFirstFragment(datagram) && nattedPackets != oldNattedPackets)
+        rememberTranslation(fragmentId, datagram);
+    return result;
+}
+
+INetfilter::IHook::Result SCTPNatHook::translateForward(IPv4Datagram* dgram, const InterfaceEntry* inIE, const InterfaceEntry*& outIE, IPv4Address& nextHopAddr)
 {
     SCTPNatEntry* entry;
     SCTPChunk* chunk;
-    IPv4Datagram *dgram;
 
-    dgram = dynamic_cast<IPv4Datagram *>(datagram);
-    if (SCTPAssociation::getAddressLevel(dgram->getSrcAddress())!=3) {
-        return INetfilter::IHook::ACCEPT;
-    }
     natTable->printNatTable();
     SCTPMessage* sctpMsg = check_and_cast<SCTPMessage*>(dgram->getEncapsulatedPacket());
     unsigned int numberOfChunks=sctpMsg->getChunksArraySize();
@@ -120,15 +131,25 @@ INetfilter::IHook::Result SCTPNatHook::datagramForwardHook(IPv4Datagram* datagra
 }
 
 INetfilter::IHook::Result SCTPNatHook::datagramPreRoutingHook(IPv4Datagram* datagram, const InterfaceEntry* inIE, const InterfaceEntry*& outIE, IPv4Address& nextHopAddr)
+{
+    if (SCTPAssociation::getAddressLevel(datagram->getSrcAddress())==3) {
+        return INetfilter::IHook::ACCEPT;
+    }
+    if (fragmentTranslations.isNonFirstFragment(datagram))
+        return translateFragment(datagram, INetfilter::IHook::ACCEPT);
+    IPv4FragmentDecisions<Translation>::FragmentId fragmentId(datagram);
+    uint64 oldNattedPackets = nattedPackets;
+    IHook::Result result = translatePreRouting(datagram, inIE, outIE, nextHopAddr);
+    if (fragmentTranslations.isFirstFragment(datagram) && nattedPackets != oldNattedPackets)
+        rememberTranslation(fragmentId, datagram);
+    return result;
+}
+
+INetfilter::IHook::Result SCTPNatHook::translatePreRouting(IPv4Datagram* dgram, const InterfaceEntry* inIE, const InterfaceEntry*& outIE, IPv4Address& nextHopAddr)
 {
     SCTPNatEntry* entry;
     SCTPChunk* chunk;
-    IPv4Datagram *dgram;
 
-    dgram = dynamic_cast<IPv4Datagram *>(datagram);
-    if (SCTPAssociation::getAddressLevel(dgram->getSrcAddress())==3) {
-        return INetfilter::IHook::ACCEPT;
-    }
     natTable->printNatTable();
     bool local = ((rt->isLocalAddress(dgram->getDestAddress()) & SCTPAssociation::getAddressLevel(dgram->getSrcAddress()))==3);
     SCTPMessage* sctpMsg = check_and_cast<SCTPMessage*>(dgram->getEncapsulatedPacket());
@@ -270,6 +291,28 @@ INetfilter::IHook::Result SCTPNatHook::datagramPreRoutingHook(IPv4Datagram* data
     return INetfilter::IHook::ACCEPT;
 }
 
+void SCTPNatHook::rememberTranslation(const IPv4FragmentDecisions<Translation>::FragmentId& fragmentId, IPv4Datagram* dgram)
+{
+    Translation translation;
+    translation.srcAddress = dgram->getSrcAddress();
+    translation.destAddress = dgram->getDestAddress();
+    fragmentTranslations.remember(fragmentId, translation);
+}
+
+INetfilter::IHook::Result SCTPNatHook::translateFragment(IPv4Datagram* dgram, IHook::Result unknownResult)
+{
+    Translation translation;
+    if (!fragmentTranslations.recall(dgram, translation))
+    {
+        sctpEV3<<"no translation known for fragment of "<<dgram->getSrcAddress()<<" to "<<dgram->getDestAddress()<<" id="<<dgram->getIdentification()<<"\n";
+        return unknownResult;
+    }
+    dgram->setSrcAddress(translation.srcAddress);
+    dgram->setDestAddress(translation.destAddress);
+    sctpEV3<<"fragment translated to "<<dgram->getSrcAddress()<<" to "<<dgram->getDestAddress()<<"\n";
+    return INetfilter::IHook::ACCEPT;
+}
+
 INetfilter::IHook::Result SCTPNatHook::datagramPostRoutingHook(IPv4Datagram* datagram, const InterfaceEntry* inIE, const InterfaceEntry*& outIE, IPv4Address& nextHopAddr)
 {
     return INetfilter::IHook::ACCEPT;
@@ -2,6 +2,7 @@
 #define __INET_SCTPNATHOOK_H
 
 #include "INetfilter.h"
+#include "IPv4FragmentDecisions.h"
 #include "SCTPNatTable.h"
 #include "INETDefs.h"
 #include "InterfaceTableAccess.h"
@@ -16,8 +17,22 @@ class INET_API SCTPNatHook : public cSimpleModule, INetfilter::IHook
         IRoutingTable *rt;
         IInterfaceTable *ift;
         uint64 nattedPackets;
+
+        // addresses of the translated first fragments, used for the other
+        // fragments, which carry no SCTP message
+        struct Translation
+        {
+            IPv4Address srcAddress;
+            IPv4Address destAddress;
+        };
+        IPv4FragmentDecisions<Translation> fragmentTranslations;
+
         void initialize();
         void finish();
+        IHook::Result translateForward(IPv4Datagram* dgram, const InterfaceEntry* inIE, const InterfaceEntry*& outIE, IPv4Address& nextHopAddr);
+        IHook::Result translatePreRouting(IPv4Datagram* dgram, const InterfaceEntry* inIE, const InterfaceEntry*& outIE, IPv4Address& nextHopAddr);
+        void rememberTranslation(const IPv4FragmentDecisions<Translation>::FragmentId& fragmentId, IPv4Datagram* dgram);
+        IHook::Result translateFragment(IPv4Datagram* dgram, IHook::Result unknownResult);
 
     public:
       SCTPNatHook();
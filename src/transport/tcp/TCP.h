@@ -34,14 +34,14 @@ class TCPSegment;
 class TCPSendQueue;
 class TCPReceiveQueue;
 
-// macro for normal EV<< logging (Note: deliberately no parens in macro def)
-#define tcpEV (ev.isDisabled()||TCP::testing)?EV:EV
+// macro for normal EV<< logging; arguments are not evaluated if disabled
+#define tcpEV if (!EV_ENABLED(LOGLEVEL_DETAIL)) ; else EV
 
-// macro for more verbose EV<< logging (Note: deliberately no parens in macro def)
-#define tcpEV2 (ev.isDisabled()||TCP::testing||!TCP::logverbose)?EV:EV
+// macro for more verbose EV<< logging
+#define tcpEV2 if (!EV_ENABLED(LOGLEVEL_DEBUG)) ; else EV
 
 // testingEV writes log that automated test cases can check (*.test files)
-#define testingEV (ev.isDisabled()||!TCP::testing)?EV:EV
+#define testingEV if (!EV_ENABLED(LOGLEVEL_INFO)) ; else EV
 
 
 
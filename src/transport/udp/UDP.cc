@@ -100,6 +100,18 @@ UDP::SockDesc::SockDesc(int sockId_, int appGateIndex_) {
     multicastLoop = DEFAULT_MULTICAST_LOOP;
     ttl = -1;
     typeOfService = 0;
+    seqNum = 0;
+}
+
+bool UDP::SockPairKey::operator<(const SockPairKey& other) const
+{
+    if (localPort != other.localPort)
+        return localPort < other.localPort;
+    if (remotePort != other.remotePort)
+        return remotePort < other.remotePort;
+    if (localAddr != other.localAddr)
+        return localAddr < other.localAddr;
+    return remoteAddr < other.remoteAddr;
 }
 
 //--------
@@ -125,6 +137,7 @@ void UDP::initialize(int stage)
         WATCH_MAP(socketsByPortMap);
 
         lastEphemeralPort = EPHEMERAL_PORTRANGE_START;
+        lastSeqNum = 0;
         icmp = NULL;
         icmpv6 = NULL;
 
@@ -357,7 +370,8 @@ void UDP::processUDPPacket(UDPPacket *udpPacket)
     else
     {
         // multicast packet: find all matching sockets, and send up a copy to each
-        std::vector<SockDesc*> sds = findSocketsForMcastBcastPacket(destAddr, destPort, srcAddr, srcPort, isMulticast, isBroadcast);
+        std::vector<SockDesc*>& sds = mcastBcastSockets;
+        findSocketsForMcastBcastPacket(destAddr, destPort, srcAddr, srcPort, isMulticast, isBroadcast, sds);
         if (sds.empty())
         {
             EV << "No socket registered on port " << destPort << "\n";
@@ -502,12 +516,18 @@ void UDP::bind(int sockId, int gateIndex, const IPvXAddress& localAddr, int loca
             error("bind: socket is already bound (sockId=%d)", sockId);
 
         sd->isBound = true;
-        sd->localAddr = localAddr;
         if (localPort != -1 && sd->localPort != localPort)
         {
-            socketsByPortMap[sd->localPort].remove(sd);
+            removeSocketFromPort(sd);
+            sd->localAddr = localAddr;
             sd->localPort = localPort;
-            socketsByPortMap[sd->localPort].push_back(sd);
+            addSocketToPort(sd);
+        }
+        else
+        {
+            unindexSocket(sd);
+            sd->localAddr = localAddr;
+            indexSocket(sd);
         }
     }
     else
@@ -525,9 +545,11 @@ void UDP::connect(int sockId, int gateIndex, const IPvXAddress& remoteAddr, int
         error("connect: invalid remote port number %d", remotePort);
 
     SockDesc *sd = getOrCreateSocket(sockId, gateIndex);
+    unindexSocket(sd);
     sd->remoteAddr = remoteAddr;
     sd->remotePort = remotePort;
     sd->onlyLocalPortIsSet = false;
+    indexSocket(sd);
 
     EV << "Socket connected: " << *sd << "\n";
 }
@@ -545,8 +567,7 @@ UDP::SockDesc *UDP::createSocket(int sockId, int gateIndex, const IPvXAddress& l
     socketsByIdMap[sockId] = sd;
 
     // add to socketsByPortMap
-    SockDescList& list = socketsByPortMap[sd->localPort]; // create if doesn't exist
-    list.push_back(sd);
+    addSocketToPort(sd);
 
     EV << "Socket created: " << *sd << "\n";
     return sd;
@@ -564,13 +585,87 @@ void UDP::close(int sockId)
     EV << "Closing socket: " << *sd << "\n";
 
     // remove from socketsByPortMap
+    removeSocketFromPort(sd);
+    delete sd;
+}
+
+void UDP::addSocketToPort(SockDesc *sd)
+{
+    sd->seqNum = ++lastSeqNum;
+    socketsByPortMap[sd->localPort].push_back(sd); // create if doesn't exist
+    indexSocket(sd);
+
+    for (std::map<IPvXAddress,int>::iterator it = sd->multicastAddrs.begin(); it != sd->multicastAddrs.end(); ++it)
+        socketsByMulticastAddrMap[it->first][sd->seqNum] = sd;
+}
+
+void UDP::removeSocketFromPort(SockDesc *sd)
+{
+    for (std::map<IPvXAddress,int>::iterator it = sd->multicastAddrs.begin(); it != sd->multicastAddrs.end(); ++it)
+    {
+        SocketsByMulticastAddrMap::iterator jt = socketsByMulticastAddrMap.find(it->first);
+        jt->second.erase(sd->seqNum);
+        if (jt->second.empty())
+            socketsByMulticastAddrMap.erase(jt);
+    }
+
+    unindexSocket(sd);
+
     SockDescList& list = socketsByPortMap[sd->localPort];
     for (SockDescList::iterator it = list.begin(); it != list.end(); ++it)
         if (*it == sd)
             {list.erase(it); break;}
     if (list.empty())
         socketsByPortMap.erase(sd->localPort);
-    delete sd;
+}
+
+bool UDP::isConnectedSocket(SockDesc *sd)
+{
+    return !sd->onlyLocalPortIsSet && sd->remotePort != -1 &&
+            !sd->localAddr.isUnspecified() && !sd->remoteAddr.isUnspecified();
+}
+
+void UDP::indexSocket(SockDesc *sd)
+{
+    if (isConnectedSocket(sd))
+    {
+        SockPairKey key(sd->localAddr, sd->localPort, sd->remoteAddr, sd->remotePort);
+        connectedSockets.insert(std::make_pair(key, sd));
+    }
+    else
+    {
+        // keep the socketsByPortMap order, the socket is usually the last one
+        SockDescList& list = unconnectedSocketsByPortMap[sd->localPort];
+        SockDescList::iterator it = list.end();
+        while (it != list.begin())
+        {
+            SockDescList::iterator prev = it;
+            --prev;
+            if ((*prev)->seqNum < sd->seqNum)
+                break;
+            it = prev;
+        }
+        list.insert(it, sd);
+    }
+}
+
+void UDP::unindexSocket(SockDesc *sd)
+{
+    if (isConnectedSocket(sd))
+    {
+        SockPairKey key(sd->localAddr, sd->localPort, sd->remoteAddr, sd->remotePort);
+        std::pair<SocketsByPairMap::iterator, SocketsByPairMap::iterator> range = connectedSockets.equal_range(key);
+        for (SocketsByPairMap::iterator it = range.first; it != range.second; ++it)
+            if (it->second == sd)
+                {connectedSockets.erase(it); break;}
+    }
+    else
+    {
+        SockDescList& list = unconnectedSocketsByPortMap[sd->localPort];
+        list.remove(sd);
+        if (list.empty())
+            unconnectedSocketsByPortMap.erase(sd->localPort);
+    }
 }
 
 void UDP::clearAllSockets()
@@ -582,6 +677,9 @@ void UDP::clearAllSockets()
         it->second.clear();
     }
     socketsByPortMap.clear();
+    connectedSockets.clear();
+    unconnectedSocketsByPortMap.clear();
+    socketsByMulticastAddrMap.clear();
     for (SocketsByIdMap::iterator it = socketsByIdMap.begin(); it != socketsByIdMap.end(); ++it)
         delete it->second;
     socketsByIdMap.clear();
@@ -625,11 +723,20 @@ UDP::SockDesc *UDP::findFirstSocketByLocalAddress(const IPvXAddress& localAddr,
 
 UDP::SockDesc *UDP::findSocketForUnicastPacket(const IPvXAddress& localAddr, ushort localPort, const IPvXAddress& remoteAddr, ushort remotePort)
 {
-    SocketsByPortMap::iterator it = socketsByPortMap.find(localPort);
-    if (it == socketsByPortMap.end())
-        return NULL;
+    // Select the last socket (in socketsByPortMap order) bound to localAddr,
+    // or if there is none, the first one bound to ANY_ADDR. Connected sockets
+    // are found by exact match; the few others are searched on the port.
+    SockDesc *socketBoundToLocalAddress = NULL;
+    std::pair<SocketsByPairMap::iterator, SocketsByPairMap::iterator> range =
+            connectedSockets.equal_range(SockPairKey(localAddr, localPort, remoteAddr, remotePort));
+    for (SocketsByPairMap::iterator it = range.first; it != range.second; ++it)
+        if (!socketBoundToLocalAddress || it->second->seqNum > socketBoundToLocalAddress->seqNum)
+            socketBoundToLocalAddress = it->second;
+
+    SocketsByPortMap::iterator it = unconnectedSocketsByPortMap.find(localPort);
+    if (it == unconnectedSocketsByPortMap.end())
+        return socketBoundToLocalAddress;
 
-    // select the socket bound to ANY_ADDR only if there is no socket bound to localAddr
     SockDescList& list = it->second;
     SockDesc *socketBoundToAnyAddress = NULL;
     for (SockDescList::reverse_iterator it = list.rbegin(); it != list.rend(); ++it)
@@ -643,26 +750,31 @@ UDP::SockDesc *UDP::findSocketForUnicastPacket(const IPvXAddress& localAddr, ush
             if (sd->localAddr.isUnspecified())
                 socketBoundToAnyAddress = sd;
             else
-                return sd;
+            {
+                if (!socketBoundToLocalAddress || sd->seqNum > socketBoundToLocalAddress->seqNum)
+                    socketBoundToLocalAddress = sd;
+                break;
+            }
         }
     }
-    return socketBoundToAnyAddress;
+    return socketBoundToLocalAddress ? socketBoundToLocalAddress : socketBoundToAnyAddress;
 }
 
-std::vector<UDP::SockDesc*> UDP::findSocketsForMcastBcastPacket(const IPvXAddress& localAddr, ushort localPort, const IPvXAddress& remoteAddr, ushort remotePort, bool isMulticast, bool isBroadcast)
+void UDP::findSocketsForMcastBcastPacket(const IPvXAddress& localAddr, ushort localPort, const IPvXAddress& remoteAddr, ushort remotePort, bool isMulticast, bool isBroadcast, std::vector<SockDesc*>& result)
 {
     ASSERT(isMulticast || isBroadcast);
-    std::vector<SockDesc*> result;
-    SocketsByPortMap::iterator it = socketsByPortMap.find(localPort);
-    if (it == socketsByPortMap.end())
-        return result;
+    result.clear();
 
-    SockDescList& list = it->second;
-    for (SockDescList::iterator it = list.begin(); it != list.end(); ++it)
+    if (isBroadcast)
     {
-        SockDesc *sd = *it;
-        if (isBroadcast)
+        SocketsByPortMap::iterator it = socketsByPortMap.find(localPort);
+        if (it == socketsByPortMap.end())
+            return;
+
+        SockDescList& list = it->second;
+        for (SockDescList::iterator it = list.begin(); it != list.end(); ++it)
         {
+            SockDesc *sd = *it;
             if (sd->isBroadcast)
             {
                 if ((sd->remotePort == -1 || sd->remotePort == remotePort) &&
@@ -670,17 +782,24 @@ std::vector<UDP::SockDesc*> UDP::findSocketsForMcastBcastPacket(const IPvXAddres
                     result.push_back(sd);
             }
         }
-        else if (isMulticast)
+    }
+    else
+    {
+        // the sockets that joined the group, in socketsByPortMap order
+        SocketsByMulticastAddrMap::iterator it = socketsByMulticastAddrMap.find(localAddr);
+        if (it == socketsByMulticastAddrMap.end())
+            return;
+
+        SocketsBySeqNumMap& sockets = it->second;
+        for (SocketsBySeqNumMap::iterator it = sockets.begin(); it != sockets.end(); ++it)
         {
-            if (sd->multicastAddrs.find(localAddr) != sd->multicastAddrs.end())
-            {
-                if ((sd->remotePort == -1 || sd->remotePort == remotePort) &&
-                    (sd->remoteAddr.isUnspecified() || sd->remoteAddr == remoteAddr))
-                    result.push_back(sd);
-            }
+            SockDesc *sd = it->second;
+            if (sd->localPort == localPort &&
+                (sd->remotePort == -1 || sd->remotePort == remotePort) &&
+                (sd->remoteAddr.isUnspecified() || sd->remoteAddr == remoteAddr))
+                result.push_back(sd);
         }
     }
-    return result;
 }
 
 void UDP::sendUp(cPacket *payload, SockDesc *sd, const IPvXAddress& srcAddr, ushort srcPort, const IPvXAddress& destAddr, ushort destPort, int interfaceId, int ttl, unsigned char tos)
@@ -838,6 +957,7 @@ void UDP::joinMulticastGroups(SockDesc *sd, const std::vector<IPvXAddress>& mult
         int interfaceId = k < interfaceIdsLen ? interfaceIds[k] : -1;
         ASSERT(multicastAddr.isMulticast());
         sd->multicastAddrs[multicastAddr] = interfaceId;
+        socketsByMulticastAddrMap[multicastAddr][sd->seqNum] = sd;
 
         // add the multicast address to the selected interface or all interfaces
         IInterfaceTable *ift = InterfaceTableAccess().get(this);
@@ -876,7 +996,15 @@ void UDP::addMulticastAddressToInterface(InterfaceEntry *ie, const IPvXAddress&
 void UDP::leaveMulticastGroups(SockDesc *sd, const std::vector<IPvXAddress>& multicastAddresses)
 {
     for (unsigned int i = 0; i < multicastAddresses.size(); i++)
-        sd->multicastAddrs.erase(multicastAddresses[i]);
+    {
+        if (sd->multicastAddrs.erase(multicastAddresses[i]))
+        {
+            SocketsByMulticastAddrMap::iterator it = socketsByMulticastAddrMap.find(multicastAddresses[i]);
+            it->second.erase(sd->seqNum);
+            if (it->second.empty())
+                socketsByMulticastAddrMap.erase(it);
+        }
+    }
     // note: we cannot remove the address from the interface, because someone else may still use it
 }
 
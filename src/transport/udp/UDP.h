@@ -22,6 +22,7 @@
 
 #include <map>
 #include <list>
+#include <vector>
 
 #include "ILifecycle.h"
 #include "UDPControlInfo.h"
@@ -63,17 +64,40 @@ class INET_API UDP : public cSimpleModule, public ILifecycle
         int ttl;
         unsigned char typeOfService;
         std::map<IPvXAddress,int> multicastAddrs; // key: multicast address; value: output interface Id or -1
+        unsigned long seqNum;   // order of the socket in its socketsByPortMap list
+    };
+
+    // local address/port and remote address/port of a connected socket
+    struct SockPairKey
+    {
+        IPvXAddress localAddr;
+        IPvXAddress remoteAddr;
+        int localPort;
+        int remotePort;
+        SockPairKey(const IPvXAddress& localAddr, int localPort, const IPvXAddress& remoteAddr, int remotePort) :
+            localAddr(localAddr), remoteAddr(remoteAddr), localPort(localPort), remotePort(remotePort) {}
+        bool operator<(const SockPairKey& other) const;
     };
 
     typedef std::list<SockDesc *> SockDescList;   // might contain duplicated local addresses if their reuseAddr flag is set
     typedef std::map<int,SockDesc *> SocketsByIdMap;
     typedef std::map<int,SockDescList> SocketsByPortMap;
+    typedef std::multimap<SockPairKey,SockDesc *> SocketsByPairMap;   // several sockets if their reuseAddr flag is set
+    typedef std::map<unsigned long,SockDesc *> SocketsBySeqNumMap;
+    typedef std::map<IPvXAddress,SocketsBySeqNumMap> SocketsByMulticastAddrMap;
 
   protected:
     // sockets
     SocketsByIdMap socketsByIdMap;
     SocketsByPortMap socketsByPortMap;
 
+    // demultiplexing indices of the sockets in socketsByPortMap
+    SocketsByPairMap connectedSockets;              // sockets with all four of the addresses and ports set
+    SocketsByPortMap unconnectedSocketsByPortMap;   // the other sockets, in socketsByPortMap order
+    SocketsByMulticastAddrMap socketsByMulticastAddrMap; // sockets that joined the group, in socketsByPortMap order
+    unsigned long lastSeqNum;
+    std::vector<SockDesc *> mcastBcastSockets;      // result buffer reused by processUDPPacket()
+
     // other state vars
     ushort lastEphemeralPort;
     ICMP *icmp;
@@ -115,11 +139,18 @@ class INET_API UDP : public cSimpleModule, public ILifecycle
     virtual void leaveMulticastGroups(SockDesc *sd, const std::vector<IPvXAddress>& multicastAddresses);
     virtual void addMulticastAddressToInterface(InterfaceEntry *ie, const IPvXAddress& multicastAddr);
 
+    // socket indices
+    virtual void addSocketToPort(SockDesc *sd);
+    virtual void removeSocketFromPort(SockDesc *sd);
+    virtual void indexSocket(SockDesc *sd);
+    virtual void unindexSocket(SockDesc *sd);
+    virtual bool isConnectedSocket(SockDesc *sd);
+
     // ephemeral port
     virtual ushort getEphemeralPort();
 
     virtual SockDesc *findSocketForUnicastPacket(const IPvXAddress& localAddr, ushort localPort, const IPvXAddress& remoteAddr, ushort remotePort);
-    virtual std::vector<SockDesc*> findSocketsForMcastBcastPacket(const IPvXAddress& localAddr, ushort localPort, const IPvXAddress& remoteAddr, ushort remotePort, bool isMulticast, bool isBroadcast);
+    virtual void findSocketsForMcastBcastPacket(const IPvXAddress& localAddr, ushort localPort, const IPvXAddress& remoteAddr, ushort remotePort, bool isMulticast, bool isBroadcast, std::vector<SockDesc*>& result);
     virtual SockDesc *findFirstSocketByLocalAddress(const IPvXAddress& localAddr, ushort localPort);
     virtual void sendUp(cPacket *payload, SockDesc *sd, const IPvXAddress& srcAddr, ushort srcPort, const IPvXAddress& destAddr, ushort destPort, int interfaceId, int ttl, unsigned char tos);
     virtual void sendDown(cPacket *appData, const IPvXAddress& srcAddr, ushort srcPort, const IPvXAddress& destAddr, ushort destPort, int interfaceId, bool multicastLoop, int ttl, unsigned char tos);
@@ -555,7 +555,10 @@ void PacketDump::dumpIPv4(bool l2r, const char *label, IPv4Datagram *dgram, cons
          out << buf;
 
          // packet class and name
-         out << "? " << encapmsg->getClassName() << " \"" << encapmsg->getName() << "\"";
+         if (encapmsg)
+             out << "? " << encapmsg->getClassName() << " \"" << encapmsg->getName() << "\"";
+         else
+             out << dgram->getSrcAddress() << " > " << dgram->getDestAddress() << ": fragment offset " << dgram->getFragmentOffset();
 
          // comment
          if (comment)
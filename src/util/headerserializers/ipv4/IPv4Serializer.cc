@@ -95,7 +95,14 @@ int IPv4Serializer::serialize(const IPv4Datagram *dgram, unsigned char *buf, uns
 
     cMessage *encapPacket = dgram->getEncapsulatedPacket();
 
-    switch (dgram->getTransportProtocol())
+    if (!encapPacket)
+    {
+        // non-first fragment: the payload is not modelled, only its length
+        unsigned int payloadLength = std::min((unsigned int)(dgram->getByteLength() - dgram->getHeaderLength()), bufsize - IP_HEADER_BYTES);
+        memset(buf + IP_HEADER_BYTES, 0, payloadLength);
+        packetLength += payloadLength;
+    }
+    else switch (dgram->getTransportProtocol())
     {
       case IP_PROT_ICMP:
         packetLength += ICMPSerializer().serialize(check_and_cast<ICMPMessage *>(encapPacket),
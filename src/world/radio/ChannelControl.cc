@@ -21,7 +21,7 @@
 
 #include "AirFrame_m.h"
 
-#define coreEV (ev.isDisabled()||!coreDebug) ? EV : EV << "ChannelControl: "
+#define coreEV if (!coreDebug || !EV_ENABLED(LOGLEVEL_DEBUG)) ; else EV << "ChannelControl: "
 
 Define_Module(ChannelControl);
 
@@ -37,6 +37,8 @@
 #include "world/traci/TraCIScenarioManager.h"
 #include "world/traci/TraCIConstants.h"
 #include "mobility/single/TraCIMobility.h"
+#include "LifecycleController.h"
+#include "NodeOperations.h"
 
 Define_Module(TraCIScenarioManager);
 
@@ -66,6 +68,9 @@ void TraCIScenarioManager::initialize(int stage)
         port = par("port");
         autoShutdown = par("autoShutdown");
         margin = par("margin");
+        pipelineSteps = par("pipelineSteps");
+        recycleModules = par("recycleModules");
+        maxRecycledModules = par("maxRecycledModules");
         std::string roiRoads_s = par("roiRoads");
         std::string roiRects_s = par("roiRects");
 
@@ -93,13 +98,30 @@ void TraCIScenarioManager::initialize(int stage)
             roiRects.push_back(std::pair<TraCICoord, TraCICoord>(TraCICoord(x1, y1), TraCICoord(x2, y2)));
         }
 
+        lifecycleController = 0;
+        if (recycleModules) {
+            std::string lifecycleControllerModule = par("lifecycleControllerModule").stdstringValue();
+            lifecycleController = dynamic_cast<LifecycleController*>(simulation.getModuleByPath(lifecycleControllerModule.c_str()));
+            if (!lifecycleController) error("recycleModules requires a LifecycleController module named \"%s\"", lifecycleControllerModule.c_str());
+        }
+
         nextNodeVectorIndex = 0;
         hosts.clear();
+        recycledModules.clear();
+        retiringModules.clear();
+        numModulesCreated = 0;
+        numModulesReused = 0;
+        WATCH(numModulesCreated);
+        WATCH(numModulesReused);
         subscribedVehicles.clear();
         activeVehicleCount = 0;
         autoShutdownTriggered = false;
 
         socketPtr = 0;
+        stepPending = false;
+        stepResultReceived = false;
+        pendingStepTargetTime = 0;
+        pendingStepResult.clear();
 
         connectAndStartTrigger = new cMessage("connect");
         scheduleAt(connectAt, connectAndStartTrigger);
@@ -133,12 +155,14 @@ std::string TraCIScenarioManager::receiveTraCIMessage() {
     }
 
     uint32_t bufLength = msgLength - sizeof(msgLength);
-    char buf[bufLength];
+    if (bufLength == 0) return std::string();
+    if (receiveBuffer.size() < bufLength) receiveBuffer.resize(bufLength);
+    char* buf = &receiveBuffer[0];
     {
         EV_DEBUG << "Reading TraCI message of " << bufLength << " bytes" << endl;
         uint32_t bytesRead = 0;
         while (bytesRead < bufLength) {
-            int receivedBytes = ::recv(MYSOCKET, reinterpret_cast<char*>(&buf) + bytesRead, bufLength - bytesRead, 0);
+            int receivedBytes = ::recv(MYSOCKET, buf + bytesRead, bufLength - bytesRead, 0);
             if (receivedBytes > 0) {
                 bytesRead += receivedBytes;
             } else if (receivedBytes == 0) {
@@ -199,9 +223,13 @@ std::string TraCIScenarioManager::makeTraCICommand(uint8_t commandId, TraCIBuffe
 }
 
 TraCIScenarioManager::TraCIBuffer TraCIScenarioManager::queryTraCI(uint8_t commandId, const TraCIBuffer& buf) {
+    drainPendingStep();
     sendTraCIMessage(makeTraCICommand(commandId, buf));
+    return parseTraCIResponse(commandId, receiveTraCIMessage());
+}
 
-    TraCIBuffer obuf(receiveTraCIMessage());
+TraCIScenarioManager::TraCIBuffer TraCIScenarioManager::parseTraCIResponse(uint8_t commandId, const std::string& msg) {
+    TraCIBuffer obuf(msg);
     uint8_t cmdLength; obuf >> cmdLength;
     uint8_t commandResp; obuf >> commandResp;
     ASSERT(commandResp == commandId);
@@ -214,6 +242,7 @@ TraCIScenarioManager::TraCIBuffer TraCIScenarioManager::queryTraCI(uint8_t comma
 }
 
 TraCIScenarioManager::TraCIBuffer TraCIScenarioManager::queryTraCIOptional(uint8_t commandId, const TraCIBuffer& buf, bool& success, std::string* errorMsg) {
+    drainPendingStep();
     sendTraCIMessage(makeTraCICommand(commandId, buf));
 
     TraCIBuffer obuf(receiveTraCIMessage());
@@ -338,9 +367,14 @@ void TraCIScenarioManager::finish() {
         delete &MYSOCKET;
         socketPtr = 0;
     }
+    recycleModules = false;
     while (hosts.begin() != hosts.end()) {
         deleteModule(hosts.begin()->first);
     }
+    deleteRecycledModules();
+
+    recordScalar("modulesCreated", numModulesCreated);
+    recordScalar("modulesReused", numModulesReused);
 }
 
 void TraCIScenarioManager::handleMessage(cMessage *msg) {
@@ -611,6 +645,14 @@ void TraCIScenarioManager::addModule(std::string nodeId, std::string type, std::
         return;
     }
 
+    if (recycleModules) {
+        cModule* mod = reuseModule(type, nodeId, displayString, position, road_id, speed, angle);
+        if (mod) {
+            hosts[nodeId] = mod;
+            return;
+        }
+    }
+
     int32_t nodeVectorIndex = nextNodeVectorIndex++;
 
     cModule* parentmod = getParentModule();
@@ -636,6 +678,7 @@ void TraCIScenarioManager::addModule(std::string nodeId, std::string type, std::
 
     mod->callInitialize();
     hosts[nodeId] = mod;
+    numModulesCreated++;
 }
 
 cModule* TraCIScenarioManager::getManagedModule(std::string nodeId) {
@@ -655,10 +698,100 @@ void TraCIScenarioManager::deleteModule(std::string nodeId) {
     if (!mod->getSubmodule("notificationBoard")) error("host has no submodule notificationBoard");
 
     hosts.erase(nodeId);
+
+    if (recycleModules) {
+        // modules whose shutdown is still in progress will end up in the pool, too
+        std::string type = mod->getNedTypeName();
+        size_t numRecycled = recycledModules[type].size();
+        for (std::map<cModule*, RetireCallback*>::const_iterator i = retiringModules.begin(); i != retiringModules.end(); ++i) {
+            if (type == i->first->getNedTypeName()) numRecycled++;
+        }
+        if ((maxRecycledModules == -1) || (numRecycled < (size_t)maxRecycledModules)) {
+            retireModule(mod);
+            return;
+        }
+    }
+
     mod->callFinish();
     mod->deleteModule();
 }
 
+void TraCIScenarioManager::retireModule(cModule* mod) {
+    EV_DEBUG << "Retiring module " << mod->getFullPath() << endl;
+
+    NodeShutdownOperation* operation = new NodeShutdownOperation();
+    LifecycleOperation::StringMap params;
+    operation->initialize(mod, params);
+
+    RetireCallback* callback = new RetireCallback(this, mod, operation);
+    retiringModules[mod] = callback;
+    if (lifecycleController->initiateOperation(operation, callback)) {
+        // shutdown completed synchronously, so the controller will not invoke the callback
+        moduleRetired(callback);
+    }
+}
+
+void TraCIScenarioManager::moduleRetired(RetireCallback* callback) {
+    Enter_Method_Silent();
+
+    cModule* mod = callback->mod;
+    retiringModules.erase(mod);
+    delete callback->operation;
+    delete callback;
+
+    recycledModules[mod->getNedTypeName()].push_back(mod);
+}
+
+cModule* TraCIScenarioManager::reuseModule(std::string type, std::string nodeId, std::string displayString, const Coord& position, std::string road_id, double speed, double angle) {
+    ModuleTypeToModulesMap::iterator it = recycledModules.find(type);
+    if (it == recycledModules.end() || it->second.empty()) return 0;
+
+    cModule* mod = it->second.front();
+    it->second.pop_front();
+
+    EV_DEBUG << "Reusing module " << mod->getFullPath() << " for vehicle " << nodeId << endl;
+
+    mod->getDisplayString().parse(displayString.c_str());
+
+    // rebind TraCIMobility to the new vehicle
+    for (cModule::SubmoduleIterator iter(mod); !iter.end(); iter++) {
+        cModule* submod = iter();
+        TraCIMobility* mm = dynamic_cast<TraCIMobility*>(submod);
+        if (!mm) continue;
+        mm->reinitialize(nodeId, position, road_id, speed, angle);
+    }
+
+    NodeStartOperation* operation = new NodeStartOperation();
+    LifecycleOperation::StringMap params;
+    operation->initialize(mod, params);
+    StartCallback* callback = new StartCallback(operation);
+    if (lifecycleController->initiateOperation(operation, callback)) {
+        // startup completed synchronously, so the controller will not invoke the callback
+        callback->invoke();
+    }
+
+    numModulesReused++;
+    return mod;
+}
+
+void TraCIScenarioManager::deleteRecycledModules() {
+    for (ModuleTypeToModulesMap::iterator it = recycledModules.begin(); it != recycledModules.end(); ++it) {
+        for (std::list<cModule*>::iterator j = it->second.begin(); j != it->second.end(); ++j) {
+            (*j)->callFinish();
+            (*j)->deleteModule();
+        }
+    }
+    recycledModules.clear();
+
+    for (std::map<cModule*, RetireCallback*>::iterator it = retiringModules.begin(); it != retiringModules.end(); ++it) {
+        it->first->callFinish();
+        it->first->deleteModule();
+        delete it->second->operation;
+        delete it->second;
+    }
+    retiringModules.clear();
+}
+
 bool TraCIScenarioManager::isInRegionOfInterest(const TraCICoord& position, std::string road_id, double speed, double angle) {
     if ((roiRoads.size() == 0) && (roiRects.size() == 0)) return true;
     if (roiRoads.size() > 0) {
@@ -685,7 +818,19 @@ void TraCIScenarioManager::executeOneTimestep() {
     uint32_t targetTime = getCurrentTimeMs();
 
     if (targetTime > round(connectAt.dbl() * 1000)) {
-        TraCIBuffer buf = queryTraCI(CMD_SIMSTEP2, TraCIBuffer() << targetTime);
+        TraCIBuffer buf;
+        if (stepPending) {
+            // results of a step requested ahead of time
+            ASSERT(pendingStepTargetTime == targetTime);
+            drainPendingStep();
+            stepPending = false;
+            stepResultReceived = false;
+            buf = parseTraCIResponse(CMD_SIMSTEP2, pendingStepResult);
+            pendingStepResult.clear();
+        }
+        else {
+            buf = queryTraCI(CMD_SIMSTEP2, TraCIBuffer() << targetTime);
+        }
 
         uint32_t count; buf >> count;
         EV_DEBUG << "Getting " << count << " subscription results" << endl;
@@ -694,8 +839,35 @@ void TraCIScenarioManager::executeOneTimestep() {
         }
     }
 
-    if (!autoShutdownTriggered) scheduleAt(simTime()+updateInterval, executeOneTimestepTrigger);
+    if (!autoShutdownTriggered) {
+        scheduleAt(simTime()+updateInterval, executeOneTimestepTrigger);
+
+        // let the TraCI server compute the next step while we process this interval's events
+        if (pipelineSteps && (targetTime > round(connectAt.dbl() * 1000))) {
+            requestSimulationStep(static_cast<uint32_t>(round((simTime() + updateInterval).dbl() * 1000)));
+        }
+    }
+
+}
+
+void TraCIScenarioManager::requestSimulationStep(uint32_t targetTime) {
+    ASSERT(!stepPending);
 
+    EV_DEBUG << "Requesting TraCI server simulation advance to t=" << targetTime << "ms ahead of time" << endl;
+
+    sendTraCIMessage(makeTraCICommand(CMD_SIMSTEP2, TraCIBuffer() << targetTime));
+    stepPending = true;
+    stepResultReceived = false;
+    pendingStepTargetTime = targetTime;
+}
+
+void TraCIScenarioManager::drainPendingStep() {
+    if (!stepPending || stepResultReceived) return;
+
+    // Note: commands sent from now on until the step boundary will be executed
+    // by the TraCI server after the pending step, i.e. they take effect one step later
+    pendingStepResult = receiveTraCIMessage();
+    stepResultReceived = true;
 }
 
 
@@ -1128,11 +1300,11 @@ template<> void TraCIScenarioManager::TraCIBuffer::write(std::string inv) {
 template<> std::string TraCIScenarioManager::TraCIBuffer::read() {
     uint32_t length = read<uint32_t> ();
     if (length == 0) return std::string();
-    char obuf[length + 1];
+    if (length > buf.length() - buf_index) throw cRuntimeError("Attempted to read past end of byte buffer");
 
-    for (size_t i = 0; i < length; ++i) read<char> (obuf[i]);
-    obuf[length] = 0;
+    std::string obuf = buf.substr(buf_index, length);
+    buf_index += length;
 
-    return std::string(obuf, length);
+    return obuf;
 }
 
@@ -24,6 +24,7 @@
 #include <utility>
 #include <map>
 #include <list>
+#include <vector>
 #include <sstream>
 #include <iomanip>
 
@@ -32,6 +33,10 @@
 #include "INETDefs.h"
 #include "Coord.h"
 #include "ModuleAccess.h"
+#include "ILifecycle.h"
+
+class LifecycleController;
+class LifecycleOperation;
 
 /**
  * @brief
@@ -248,6 +253,9 @@ class INET_API TraCIScenarioManager : public cSimpleModule
         double penetrationRate;
         std::list<std::string> roiRoads; /**< which roads (e.g. "hwy1 hwy2") are considered to consitute the region of interest, if not empty */
         std::list<std::pair<TraCICoord, TraCICoord> > roiRects; /**< which rectangles (e.g. "0,0-10,10 20,20-30,30) are considered to consitute the region of interest, if not empty */
+        bool recycleModules; /**< shut down and park modules of vehicles that leave the simulation, and reuse them for new vehicles of the same type */
+        int maxRecycledModules; /**< maximum number of parked modules per module type (-1: unlimited) */
+        LifecycleController* lifecycleController; /**< used for shutting down and restarting recycled modules */
 
         void* socketPtr;
         TraCICoord netbounds1; /* network boundaries as reported by TraCI (x1, y1) */
@@ -262,10 +270,62 @@ class INET_API TraCIScenarioManager : public cSimpleModule
         cMessage* connectAndStartTrigger; /**< self-message scheduled for when to connect to TraCI server and start running */
         cMessage* executeOneTimestepTrigger; /**< self-message scheduled for when to next call executeOneTimestep */
 
+        bool pipelineSteps; /**< request the next simulation step from the TraCI server ahead of time, so both simulators run concurrently */
+        bool stepPending; /**< a CMD_SIMSTEP2 has been sent, but its results have not been processed yet */
+        bool stepResultReceived; /**< the response to the pending CMD_SIMSTEP2 has already been read into pendingStepResult */
+        uint32_t pendingStepTargetTime; /**< target time (in ms) of the pending CMD_SIMSTEP2 */
+        std::string pendingStepResult; /**< response to the pending CMD_SIMSTEP2, if it had to be read before reaching the step boundary */
+        std::vector<char> receiveBuffer; /**< reused by receiveTraCIMessage() */
+
+        /**
+         * Invoked by the LifecycleController when the shutdown of a retired module has completed
+         */
+        class RetireCallback : public IDoneCallback {
+            public:
+                RetireCallback(TraCIScenarioManager* manager, cModule* mod, LifecycleOperation* operation) : manager(manager), mod(mod), operation(operation) {}
+                virtual void invoke() {
+                    manager->moduleRetired(this);
+                }
+
+                TraCIScenarioManager* manager;
+                cModule* mod;
+                LifecycleOperation* operation;
+        };
+
+        /**
+         * Invoked by the LifecycleController when the startup of a reused module has completed
+         */
+        class StartCallback : public IDoneCallback {
+            public:
+                StartCallback(LifecycleOperation* operation) : operation(operation) {}
+                virtual void invoke() {
+                    delete operation;
+                    delete this;
+                }
+
+                LifecycleOperation* operation;
+        };
+
+        typedef std::map<std::string, std::list<cModule*> > ModuleTypeToModulesMap;
+        ModuleTypeToModulesMap recycledModules; /**< parked modules, ready to be reused, by module type */
+        std::map<cModule*, RetireCallback*> retiringModules; /**< modules whose shutdown is still in progress */
+        uint32_t numModulesCreated; /**< number of modules that had to be built from scratch */
+        uint32_t numModulesReused; /**< number of modules taken from the recycling pool */
+
         uint32_t getCurrentTimeMs(); /**< get current simulation time (in ms) */
 
         void executeOneTimestep(); /**< read and execute all commands for the next timestep */
 
+        /**
+         * sends a CMD_SIMSTEP2 for the given target time without waiting for the response (used if pipelineSteps is set)
+         */
+        void requestSimulationStep(uint32_t targetTime);
+
+        /**
+         * reads the response to a pending CMD_SIMSTEP2 into pendingStepResult, so other commands can be exchanged
+         */
+        void drainPendingStep();
+
         void connect();
         virtual void init_traci();
 
@@ -273,6 +333,22 @@ class INET_API TraCIScenarioManager : public cSimpleModule
         cModule* getManagedModule(std::string nodeId); /**< returns a pointer to the managed module named moduleName, or 0 if no module can be found */
         void deleteModule(std::string nodeId);
 
+        /**
+         * shuts down a module that is no longer managed and parks it for reuse once the shutdown completes
+         */
+        void retireModule(cModule* mod);
+        void moduleRetired(RetireCallback* callback);
+
+        /**
+         * returns a parked module of the given type (already restarted and bound to the new vehicle), or 0 if there is none
+         */
+        cModule* reuseModule(std::string type, std::string nodeId, std::string displayString, const Coord& position, std::string road_id, double speed, double angle);
+
+        /**
+         * finishes and deletes all parked and retiring modules
+         */
+        void deleteRecycledModules();
+
         bool isModuleUnequipped(std::string nodeId); /**< returns true if this vehicle is Unequipped */
 
         /**
@@ -291,6 +367,11 @@ class INET_API TraCIScenarioManager : public cSimpleModule
          */
         TraCIScenarioManager::TraCIBuffer queryTraCIOptional(uint8_t commandId, const TraCIBuffer& buf, bool& success, std::string* errorMsg = 0);
 
+        /**
+         * checks the status response to a command, returns additional responses
+         */
+        TraCIBuffer parseTraCIResponse(uint8_t commandId, const std::string& msg);
+
         /**
          * returns byte-buffer containing a TraCI command with optional parameters
          */
@@ -0,0 +1,258 @@
+#!/usr/bin/env python
+#
+# Minimal TraCI server for benchmarking the TraCIScenarioManager without SUMO.
+#
+# Implements just enough of the TraCI protocol for the TraCIScenarioManager:
+# version query, network bounding box, sim/vehicle variable subscriptions and
+# CMD_SIMSTEP2. Vehicles depart at a fixed rate, drive east on parallel lanes
+# and arrive after a fixed number of steps. Each simulation step busy-waits
+# for a configurable time to model the cost of a real road traffic simulation.
+#
+# Usage: ./mockTraCIServer.py [--port 9998] [--vehicles 200] [--departs-per-step 2]
+#                             [--trip-steps 100] [--step-cost 0.01]
+#
+
+import optparse
+import socket
+import struct
+import sys
+import time
+
+CMD_GETVERSION = 0x00
+CMD_SIMSTEP2 = 0x02
+CMD_CLOSE = 0x7F
+CMD_SET_VEHICLE_VARIABLE = 0xc4
+CMD_SUBSCRIBE_VEHICLE_VARIABLE = 0xd4
+RESPONSE_SUBSCRIBE_VEHICLE_VARIABLE = 0xe4
+CMD_GET_SIM_VARIABLE = 0xab
+RESPONSE_GET_SIM_VARIABLE = 0xbb
+CMD_SUBSCRIBE_SIM_VARIABLE = 0xdb
+RESPONSE_SUBSCRIBE_SIM_VARIABLE = 0xeb
+
+POSITION_2D = 0x01
+TYPE_BOUNDINGBOX = 0x05
+TYPE_INTEGER = 0x09
+TYPE_DOUBLE = 0x0B
+TYPE_STRING = 0x0C
+TYPE_STRINGLIST = 0x0E
+
+RTYPE_OK = 0x00
+RTYPE_NOTIMPLEMENTED = 0x01
+
+ID_LIST = 0x00
+VAR_SPEED = 0x40
+VAR_POSITION = 0x42
+VAR_ANGLE = 0x43
+VAR_ROAD_ID = 0x50
+VAR_SIGNALS = 0x5b
+VAR_TIME_STEP = 0x70
+VAR_DEPARTED_VEHICLES_IDS = 0x74
+VAR_ARRIVED_VEHICLES_IDS = 0x7a
+VAR_NET_BOUNDING_BOX = 0x7c
+
+SPEED = 10.0
+LANES = 50
+
+
+def pack_string(s):
+    b = s.encode('ascii')
+    return struct.pack('!I', len(b)) + b
+
+
+def pack_stringlist(l):
+    return struct.pack('!BI', TYPE_STRINGLIST, len(l)) + b''.join([pack_string(s) for s in l])
+
+
+def pack_command(commandId, content):
+    if len(content) + 2 > 0xFF:
+        return struct.pack('!BIB', 0, len(content) + 6, commandId) + content
+    return struct.pack('!BB', len(content) + 2, commandId) + content
+
+
+def pack_status(commandId, result=RTYPE_OK, description=''):
+    return pack_command(commandId, struct.pack('!B', result) + pack_string(description))
+
+
+def pack_subscription(commandId, objectId, variables):
+    content = pack_string(objectId) + struct.pack('!B', len(variables))
+    for (variableId, value) in variables:
+        content += struct.pack('!BB', variableId, RTYPE_OK) + value
+    # subscription results always use the extended length field
+    return struct.pack('!BIB', 0, len(content) + 6, commandId) + content
+
+
+class Reader(object):
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def read(self, fmt):
+        values = struct.unpack_from(fmt, self.data, self.pos)
+        self.pos += struct.calcsize(fmt)
+        return values if len(values) > 1 else values[0]
+
+    def read_string(self):
+        length = self.read('!I')
+        s = self.data[self.pos:self.pos + length].decode('ascii')
+        self.pos += length
+        return s
+
+    def eof(self):
+        return self.pos >= len(self.data)
+
+
+class MockSimulation(object):
+    def __init__(self, options):
+        self.options = options
+        self.time = 0
+        self.step = 0
+        self.numDeparted = 0
+        self.vehicles = {}  # id -> departure step
+        self.subscribed = set()
+        self.departed = []
+        self.arrived = []
+
+    def advance(self, targetTime):
+        # model the cost of a real road traffic simulation step
+        until = time.time() + self.options.step_cost
+        while time.time() < until:
+            pass
+
+        self.time = targetTime
+        self.step += 1
+        self.departed = []
+        self.arrived = []
+        for (vehicleId, departure) in list(self.vehicles.items()):
+            if self.step - departure >= self.options.trip_steps:
+                del self.vehicles[vehicleId]
+                self.arrived.append(vehicleId)
+        for i in range(self.options.departs_per_step):
+            if self.numDeparted >= self.options.vehicles:
+                break
+            vehicleId = 'veh%d' % self.numDeparted
+            self.vehicles[vehicleId] = self.step
+            self.departed.append(vehicleId)
+            self.numDeparted += 1
+
+    def position(self, vehicleId):
+        index = int(vehicleId[3:])
+        x = 100 + SPEED * (self.step - self.vehicles[vehicleId])
+        y = 100 + 10 * (index % LANES)
+        return (x, y)
+
+    def sim_subscription(self):
+        return pack_subscription(RESPONSE_SUBSCRIBE_SIM_VARIABLE, '', [
+            (VAR_DEPARTED_VEHICLES_IDS, pack_stringlist(self.departed)),
+            (VAR_ARRIVED_VEHICLES_IDS, pack_stringlist(self.arrived)),
+            (VAR_TIME_STEP, struct.pack('!Bi', TYPE_INTEGER, self.time))])
+
+    def id_list_subscription(self):
+        return pack_subscription(RESPONSE_SUBSCRIBE_VEHICLE_VARIABLE, '', [
+            (ID_LIST, pack_stringlist(sorted(self.vehicles.keys())))])
+
+    def vehicle_subscription(self, vehicleId):
+        (x, y) = self.position(vehicleId)
+        return pack_subscription(RESPONSE_SUBSCRIBE_VEHICLE_VARIABLE, vehicleId, [
+            (VAR_POSITION, struct.pack('!Bdd', POSITION_2D, x, y)),
+            (VAR_ROAD_ID, struct.pack('!B', TYPE_STRING) + pack_string('r0')),
+            (VAR_SPEED, struct.pack('!Bd', TYPE_DOUBLE, SPEED)),
+            (VAR_ANGLE, struct.pack('!Bd', TYPE_DOUBLE, 90.0)),
+            (VAR_SIGNALS, struct.pack('!Bi', TYPE_INTEGER, 0))])
+
+    def handle(self, commandId, r):
+        if commandId == CMD_GETVERSION:
+            return pack_status(commandId) + pack_command(CMD_GETVERSION, struct.pack('!I', 3) + pack_string('mockTraCIServer'))
+
+        if commandId == CMD_GET_SIM_VARIABLE:
+            variableId = r.read('!B')
+            objectId = r.read_string()
+            if variableId != VAR_NET_BOUNDING_BOX:
+                return pack_status(commandId, RTYPE_NOTIMPLEMENTED, 'unsupported sim variable')
+            return pack_status(commandId) + pack_command(RESPONSE_GET_SIM_VARIABLE,
+                struct.pack('!B', variableId) + pack_string(objectId) + struct.pack('!Bdddd', TYPE_BOUNDINGBOX, 0, 0, 10000, 1000))
+
+        if commandId == CMD_SUBSCRIBE_SIM_VARIABLE:
+            return pack_status(commandId) + self.sim_subscription()
+
+        if commandId == CMD_SUBSCRIBE_VEHICLE_VARIABLE:
+            (beginTime, endTime) = r.read('!II')
+            objectId = r.read_string()
+            variableNumber = r.read('!B')
+            if objectId == '':
+                return pack_status(commandId) + self.id_list_subscription()
+            if variableNumber == 0:
+                self.subscribed.discard(objectId)
+                return pack_status(commandId)
+            self.subscribed.add(objectId)
+            return pack_status(commandId) + self.vehicle_subscription(objectId)
+
+        if commandId == CMD_SIMSTEP2:
+            targetTime = r.read('!I')
+            self.advance(targetTime)
+            results = [self.sim_subscription(), self.id_list_subscription()]
+            results += [self.vehicle_subscription(v) for v in sorted(self.subscribed) if v in self.vehicles]
+            return pack_status(commandId) + struct.pack('!I', len(results)) + b''.join(results)
+
+        if commandId == CMD_SET_VEHICLE_VARIABLE:
+            return pack_status(commandId)
+
+        if commandId == CMD_CLOSE:
+            return pack_status(commandId)
+
+        return pack_status(commandId, RTYPE_NOTIMPLEMENTED, 'not implemented by mockTraCIServer')
+
+
+def recv_exactly(conn, n):
+    data = b''
+    while len(data) < n:
+        chunk = conn.recv(n - len(data))
+        if not chunk:
+            return None
+        data += chunk
+    return data
+
+
+def serve(options):
+    listener = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    listener.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    listener.bind(('localhost', options.port))
+    listener.listen(1)
+    (conn, addr) = listener.accept()
+    conn.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+
+    sim = MockSimulation(options)
+    while True:
+        header = recv_exactly(conn, 4)
+        if header is None:
+            break
+        length = struct.unpack('!I', header)[0]
+        r = Reader(recv_exactly(conn, length - 4))
+        response = b''
+        closing = False
+        while not r.eof():
+            start = r.pos
+            cmdLength = r.read('!B')
+            if cmdLength == 0:
+                cmdLength = r.read('!I')
+            commandId = r.read('!B')
+            response += sim.handle(commandId, r)
+            r.pos = start + cmdLength
+            closing = closing or (commandId == CMD_CLOSE)
+        conn.sendall(struct.pack('!I', len(response) + 4) + response)
+        if closing:
+            break
+
+    conn.close()
+    listener.close()
+    sys.stderr.write('mockTraCIServer: %d steps, %d vehicles\n' % (sim.step, sim.numDeparted))
+
+
+if __name__ == '__main__':
+    parser = optparse.OptionParser()
+    parser.add_option('--port', type='int', default=9998)
+    parser.add_option('--vehicles', type='int', default=200)
+    parser.add_option('--departs-per-step', dest='departs_per_step', type='int', default=2)
+    parser.add_option('--trip-steps', dest='trip_steps', type='int', default=100)
+    parser.add_option('--step-cost', dest='step_cost', type='float', default=0.01, help='seconds of CPU time per simulation step')
+    (options, args) = parser.parse_args()
+    serve(options)
@@ -0,0 +1,13 @@
+#!/bin/sh
+#
+# Compares lockstep and pipelined TraCI synchronization against mockTraCIServer.py.
+# Extra arguments are passed to mockTraCIServer.py (e.g. --vehicles 1000 --step-cost 0.02).
+#
+
+for config in Mock MockPipelined; do
+    ./mockTraCIServer.py "$@" &
+    sleep 1
+    echo "$config:"
+    /usr/bin/time -f "  %e s elapsed, %U s user" opp_run -l../../src/inet -n"../../src;." -u Cmdenv -c $config > /dev/null
+    wait
+done